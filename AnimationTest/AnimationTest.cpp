@@ -0,0 +1,192 @@
+//-------------------------------------------------------------------------------------
+// AnimationTest.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include "pch.h"
+#include "Animation.h"
+
+#include <chrono>
+#include <iterator>
+#include <random>
+
+using namespace DirectX;
+
+//-------------------------------------------------------------------------------------
+// Types and globals
+
+using TestFN = bool (*)();
+
+struct TestInfo
+{
+    const char *name;
+    TestFN func;
+};
+
+extern bool Test01();
+extern bool Test02();
+extern bool Test03();
+extern bool Test04();
+extern bool Test05();
+extern bool Test06();
+extern bool Benchmark01();
+extern bool Benchmark02();
+extern bool Benchmark03();
+extern bool Benchmark04();
+
+TestInfo g_Tests[] =
+{
+    { "AnimationSDKMESH", Test01 },
+    { "AnimationSDKMESH (interpolation)", Test02 },
+    { "AnimationSDKMESH (resampling)", Test03 },
+    { "AnimationCMO", Test04 },
+    { "AnimationSDKMESH (batched)", Test05 },
+    { "AnimationCMO (batched)", Test06 },
+};
+
+TestInfo g_Benchmarks[] =
+{
+    { "AnimationSDKMESH sampling throughput", Benchmark01 },
+    { "AnimationSDKMESH resampling", Benchmark02 },
+    { "AnimationCMO long clip sampling", Benchmark03 },
+    { "AnimationSDKMESH crowd evaluation", Benchmark04 },
+};
+
+extern int ResampleTool(const wchar_t* inputFile, const wchar_t* outputFile, uint32_t animationFPS, DX::AnimationSDKMESH::Interpolation mode);
+
+
+//-------------------------------------------------------------------------------------
+bool RunTests(const TestInfo* tests, size_t count)
+{
+    size_t nPass = 0;
+    size_t nFail = 0;
+
+    for(size_t i=0; i < count; ++i)
+    {
+        printf("%s: ", tests[i].name );
+
+        if ( tests[i].func() )
+        {
+            ++nPass;
+            printf("PASS\n");
+        }
+        else
+        {
+            ++nFail;
+            printf("FAIL\n");
+        }
+    }
+
+    printf("Ran %zu tests, %zu pass, %zu fail\n", nPass+nFail, nPass, nFail);
+
+    return (nFail == 0);
+}
+
+
+//-------------------------------------------------------------------------------------
+int __cdecl wmain(int argc, wchar_t* argv[])
+{
+    printf("**************************************************************\n");
+    printf("*** AnimationTest\n" );
+    printf("**************************************************************\n");
+
+    // animationtest -resample <fps> <input> <output> [-nlerp]
+    if (argc >= 5 && !_wcsicmp(argv[1], L"-resample"))
+    {
+        const auto animationFPS = static_cast<uint32_t>(wcstoul(argv[2], nullptr, 10));
+        const bool nlerp = (argc > 5 && !_wcsicmp(argv[5], L"-nlerp"));
+
+        return ResampleTool(argv[3], argv[4], animationFPS,
+            nlerp ? DX::AnimationSDKMESH::Interpolation::Linear : DX::AnimationSDKMESH::Interpolation::Spherical);
+    }
+
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!_wcsicmp(argv[i], L"-bench"))
+        {
+            benchmark = true;
+        }
+    }
+
+    if (benchmark)
+    {
+        if ( !RunTests(g_Benchmarks, std::size(g_Benchmarks)) )
+            return -1;
+    }
+    else if ( !RunTests(g_Tests, std::size(g_Tests)) )
+        return -1;
+
+    return 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Creates a model with a binary-tree bone hierarchy and random bind pose
+std::unique_ptr<Model> CreateSyntheticModel(size_t nbones, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> offset(-1.f, 1.f);
+    std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+
+    auto model = std::make_unique<Model>();
+    model->name = L"synthetic";
+    model->bones.resize(nbones);
+    model->boneMatrices = ModelBone::MakeArray(nbones);
+    model->invBindPoseMatrices = ModelBone::MakeArray(nbones);
+
+    wchar_t name[32] = {};
+    for (size_t j = 0; j < nbones; ++j)
+    {
+        auto& bone = model->bones[j];
+        swprintf_s(name, L"Bone%03zu", j);
+        bone.name = name;
+        bone.parentIndex = (j > 0) ? static_cast<uint32_t>((j - 1) / 2) : ModelBone::c_Invalid;
+        bone.childIndex = (2 * j + 1 < nbones) ? static_cast<uint32_t>(2 * j + 1) : ModelBone::c_Invalid;
+        bone.siblingIndex = ((j & 1) && (j + 1 < nbones)) ? static_cast<uint32_t>(j + 1) : ModelBone::c_Invalid;
+
+        model->boneMatrices[j] = XMMatrixMultiply(
+            XMMatrixRotationRollPitchYaw(angle(rng), angle(rng), angle(rng)),
+            XMMatrixTranslation(offset(rng), offset(rng), offset(rng)));
+
+        model->invBindPoseMatrices[j] = XMMatrixMultiply(
+            XMMatrixTranslation(offset(rng), offset(rng), offset(rng)),
+            XMMatrixRotationRollPitchYaw(angle(rng), angle(rng), angle(rng)));
+    }
+
+    return model;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Returns true if the transforms match within a relative tolerance
+bool CompareTransforms(const XMMATRIX* expected, const XMMATRIX* actual, size_t count, float tolerance)
+{
+    for (size_t j = 0; j < count; ++j)
+    {
+        XMFLOAT4X4 a, b;
+        XMStoreFloat4x4(&a, expected[j]);
+        XMStoreFloat4x4(&b, actual[j]);
+
+        for (size_t k = 0; k < 16; ++k)
+        {
+            const float va = a.m[k / 4][k % 4];
+            const float vb = b.m[k / 4][k % 4];
+            const float scale = std::max(1.f, std::max(std::abs(va), std::abs(vb)));
+            if (!(std::abs(va - vb) <= tolerance * scale))
+            {
+                printf("ERROR: Bone %zu element %zu mismatch (%f vs. %f)\n", j, k, double(va), double(vb));
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+double ElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,412 @@
+//-------------------------------------------------------------------------------------
+// cmo.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include "pch.h"
+#include "Animation.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <system_error>
+
+using namespace DirectX;
+
+namespace
+{
+#pragma pack(push,1)
+
+    struct Clip
+    {
+        float StartTime;
+        float EndTime;
+        uint32_t keys;
+    };
+
+    static_assert(sizeof(Clip) == 12, "CMO Mesh structure size incorrect");
+
+    struct Keyframe
+    {
+        uint32_t BoneIndex;
+        float Time;
+        DirectX::XMFLOAT4X4 Transform;
+    };
+
+    static_assert(sizeof(Keyframe) == 72, "CMO Mesh structure size incorrect");
+
+#pragma pack(pop)
+
+    // Animation clips are read from an offset into the .cmo file
+    constexpr size_t c_ClipOffset = 16;
+
+    // Key times are multiples of 1/32, and playback steps by 1/64, so playback lands exactly on keys
+    constexpr float c_KeyInterval = 1.f / 32.f;
+
+    struct SyntheticCMOClip
+    {
+        std::wstring            name;
+        Clip                    clip;
+        std::vector<Keyframe>   keys;
+    };
+
+    // Keys are sorted by time with several keys per timestamp; every seventh bone has no keys and
+    // keeps its bind pose. If 'unsorted' is set, some neighboring keys are swapped out of time order.
+    void CreateSyntheticCMOClip(const wchar_t* name, size_t nbones, uint32_t keyCount, bool unsorted, std::mt19937& rng, SyntheticCMOClip& result)
+    {
+        std::uniform_int_distribution<size_t> boneDist(0, nbones - 1);
+        std::uniform_int_distribution<uint32_t> stepDist(0, 3);
+        std::uniform_real_distribution<float> offset(-1.f, 1.f);
+        std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+
+        result.name = name;
+        result.keys.resize(keyCount);
+
+        uint32_t timeStep = 8;
+        for (uint32_t k = 0; k < keyCount; ++k)
+        {
+            size_t bone = boneDist(rng);
+            if ((bone % 7) == 5)
+                bone = (bone + 1) % nbones;
+
+            timeStep += (stepDist(rng) == 0) ? 1u : 0u;
+
+            auto& key = result.keys[k];
+            key.BoneIndex = static_cast<uint32_t>(bone);
+            key.Time = float(timeStep) * c_KeyInterval;
+            XMStoreFloat4x4(&key.Transform, XMMatrixMultiply(
+                XMMatrixRotationRollPitchYaw(angle(rng), angle(rng), angle(rng)),
+                XMMatrixTranslation(offset(rng), offset(rng), offset(rng))));
+        }
+
+        if (unsorted)
+        {
+            for (uint32_t k = 1; k < keyCount; k += 9)
+            {
+                std::swap(result.keys[k - 1], result.keys[k]);
+            }
+        }
+
+        result.clip.StartTime = 8.f * c_KeyInterval;
+        result.clip.EndTime = float(timeStep + 4) * c_KeyInterval;
+        result.clip.keys = keyCount;
+    }
+
+    bool WriteSyntheticCMOClips(const std::filesystem::path& path, const std::vector<SyntheticCMOClip>& clips)
+    {
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        // Stand-in for the mesh data that precedes the clips in a .cmo file
+        const uint8_t padding[c_ClipOffset] = {};
+        out.write(reinterpret_cast<const char*>(padding), sizeof(padding));
+
+        const auto nClips = static_cast<uint32_t>(clips.size());
+        out.write(reinterpret_cast<const char*>(&nClips), sizeof(nClips));
+
+        for (const auto& it : clips)
+        {
+            const auto nName = static_cast<uint32_t>(it.name.size() + 1);
+            out.write(reinterpret_cast<const char*>(&nName), sizeof(nName));
+            out.write(reinterpret_cast<const char*>(it.name.c_str()), static_cast<std::streamsize>(sizeof(wchar_t) * nName));
+            out.write(reinterpret_cast<const char*>(&it.clip), sizeof(Clip));
+            out.write(reinterpret_cast<const char*>(it.keys.data()), static_cast<std::streamsize>(sizeof(Keyframe) * it.keys.size()));
+        }
+
+        out.close();
+        return !out.fail();
+    }
+
+    // Linear scan of the keys in file order, as AnimationCMO::Apply did before per-bone tracks
+    void ReferenceApply(
+        const SyntheticCMOClip& clip,
+        const Model& model,
+        float animTime,
+        XMMATRIX* animBones,
+        XMMATRIX* boneTransforms)
+    {
+        const size_t nbones = model.bones.size();
+
+        model.CopyBoneTransformsTo(nbones, animBones);
+
+        if (animTime >= clip.clip.StartTime)
+        {
+            for (const auto& key : clip.keys)
+            {
+                if (key.Time > animTime)
+                    break;
+
+                animBones[key.BoneIndex] = XMLoadFloat4x4(&key.Transform);
+            }
+        }
+
+        model.CopyAbsoluteBoneTransforms(nbones, animBones, boneTransforms);
+
+        for (size_t j = 0; j < nbones; ++j)
+        {
+            boneTransforms[j] = XMMatrixMultiply(model.invBindPoseMatrices[j], boneTransforms[j]);
+        }
+    }
+
+    // Matches AnimationCMO::Update
+    void AdvanceTime(float& animTime, float delta, const SyntheticCMOClip& clip)
+    {
+        animTime += delta;
+        if (animTime > clip.clip.EndTime)
+        {
+            animTime -= clip.clip.EndTime;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------
+
+extern std::unique_ptr<Model> CreateSyntheticModel(size_t nbones, std::mt19937& rng);
+extern bool CompareTransforms(const XMMATRIX* expected, const XMMATRIX* actual, size_t count, float tolerance);
+extern double ElapsedMilliseconds(std::chrono::steady_clock::time_point start);
+
+//-------------------------------------------------------------------------------------
+// CMO animation playback matches a linear scan of the keys
+bool Test04()
+{
+    constexpr size_t c_Bones = 40;
+
+    bool success = true;
+
+    std::mt19937 rng(97531);
+
+    const auto path = std::filesystem::temp_directory_path() / L"animationtest.cmo";
+
+    auto model = CreateSyntheticModel(c_Bones, rng);
+
+    std::vector<SyntheticCMOClip> clips(3);
+    CreateSyntheticCMOClip(L"Idle", c_Bones, 300, false, rng, clips[0]);
+    CreateSyntheticCMOClip(L"Walk", c_Bones, 1000, false, rng, clips[1]);
+    CreateSyntheticCMOClip(L"Unsorted", c_Bones, 500, true, rng, clips[2]);
+
+    if (!WriteSyntheticCMOClips(path, clips))
+    {
+        printf("ERROR: Failed writing synthetic CMO animation:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    auto animBones = ModelBone::MakeArray(c_Bones);
+    auto expected = ModelBone::MakeArray(c_Bones);
+    auto actual = ModelBone::MakeArray(c_Bones);
+
+    // The first clip is used if no name is given
+    const wchar_t* clipNames[] = { nullptr, L"walk", L"Unsorted" };
+
+    for (size_t j = 0; j < std::size(clipNames); ++j)
+    {
+        const auto& clip = clips[j];
+
+        DX::AnimationCMO anim;
+        HRESULT hr = anim.Load(path.wstring().c_str(), c_ClipOffset, clipNames[j]);
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("ERROR: Failed loading CMO clip '%ls' (HRESULT %08X)\n", clip.name.c_str(), static_cast<unsigned int>(hr));
+            continue;
+        }
+
+        anim.Bind(*model);
+
+        // Play from before the clip start through two loops
+        const float delta = c_KeyInterval * 0.5f;
+        const auto steps = static_cast<uint32_t>(2.f * clip.clip.EndTime / delta);
+
+        float animTime = 0.f;
+        for (uint32_t step = 0; step < steps; ++step)
+        {
+            ReferenceApply(clip, *model, animTime, animBones.get(), expected.get());
+            anim.Apply(*model, c_Bones, actual.get());
+
+            if (!CompareTransforms(expected.get(), actual.get(), c_Bones, 0.f))
+            {
+                success = false;
+                printf("ERROR: CMO clip '%ls' mismatch at time %f\n", clip.name.c_str(), double(animTime));
+                break;
+            }
+
+            anim.Update(delta);
+            AdvanceTime(animTime, delta, clip);
+        }
+    }
+
+    // Unknown clip name
+    {
+        DX::AnimationCMO anim;
+        HRESULT hr = anim.Load(path.wstring().c_str(), c_ClipOffset, L"Run");
+        if (SUCCEEDED(hr))
+        {
+            success = false;
+            printf("ERROR: Expected failure for missing clip\n");
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Per-frame sampling cost as clip length grows
+bool Benchmark03()
+{
+    constexpr size_t c_BenchmarkBones = 64;
+    constexpr uint32_t c_Frames = 1000;
+
+    bool success = true;
+
+    std::mt19937 rng(86420);
+
+    auto model = CreateSyntheticModel(c_BenchmarkBones, rng);
+
+    const auto path = std::filesystem::temp_directory_path() / L"animationtest_benchmark.cmo";
+
+    auto animBones = ModelBone::MakeArray(c_BenchmarkBones);
+    auto expected = ModelBone::MakeArray(c_BenchmarkBones);
+    auto actual = ModelBone::MakeArray(c_BenchmarkBones);
+
+    printf("\n\t%zu bones, %u frames spread over each clip\n\t   keys   linear scan (us/frame)   tracks (us/frame)\n", c_BenchmarkBones, c_Frames);
+
+    for (const uint32_t keyCount : { 1000u, 10000u, 100000u })
+    {
+        std::vector<SyntheticCMOClip> clips(1);
+        CreateSyntheticCMOClip(L"Cinematic", c_BenchmarkBones, keyCount, false, rng, clips[0]);
+        const auto& clip = clips[0];
+
+        if (!WriteSyntheticCMOClips(path, clips))
+        {
+            printf("ERROR: Failed writing benchmark CMO animation:\n%ls\n", path.wstring().c_str());
+            return false;
+        }
+
+        DX::AnimationCMO anim;
+        HRESULT hr = anim.Load(path.wstring().c_str(), c_ClipOffset);
+        if (FAILED(hr))
+        {
+            printf("ERROR: Failed loading benchmark CMO animation (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            return false;
+        }
+
+        anim.Bind(*model);
+
+        const float delta = clip.clip.EndTime / float(c_Frames + 1);
+
+        float animTime = 0.f;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t j = 0; j < c_Frames; ++j)
+        {
+            AdvanceTime(animTime, delta, clip);
+            ReferenceApply(clip, *model, animTime, animBones.get(), expected.get());
+        }
+        const double referenceTime = ElapsedMilliseconds(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t j = 0; j < c_Frames; ++j)
+        {
+            anim.Update(delta);
+            anim.Apply(*model, c_BenchmarkBones, actual.get());
+        }
+        const double trackTime = ElapsedMilliseconds(start);
+
+        if (!CompareTransforms(expected.get(), actual.get(), c_BenchmarkBones, 0.f))
+        {
+            success = false;
+            printf("ERROR: CMO benchmark mismatch (%u keys)\n", keyCount);
+        }
+
+        printf("\t%7u  %22.2f  %18.2f\n", keyCount,
+            referenceTime * 1000.0 / double(c_Frames), trackTime * 1000.0 / double(c_Frames));
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Batched evaluation matches applying each instance in turn
+bool Test06()
+{
+    constexpr size_t c_Bones = 40;
+    constexpr size_t c_Instances = 200;
+
+    bool success = true;
+
+    std::mt19937 rng(24816);
+
+    const auto path = std::filesystem::temp_directory_path() / L"animationtest_batch.cmo";
+
+    auto model = CreateSyntheticModel(c_Bones, rng);
+
+    std::vector<SyntheticCMOClip> clips(1);
+    CreateSyntheticCMOClip(L"Crowd", c_Bones, 800, true, rng, clips[0]);
+    const auto& clip = clips[0];
+
+    if (!WriteSyntheticCMOClips(path, clips))
+    {
+        printf("ERROR: Failed writing synthetic CMO animation:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    DX::AnimationCMO anim;
+    HRESULT hr = anim.Load(path.wstring().c_str(), c_ClipOffset);
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    if (FAILED(hr))
+    {
+        printf("ERROR: Failed loading CMO clip (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        return false;
+    }
+
+    anim.Bind(*model);
+
+    // Each instance is one step of an irregular playback that starts before the clip and wraps around
+    std::uniform_real_distribution<float> step(0.f, clip.clip.EndTime / float(c_Instances / 3));
+
+    std::vector<float> animTimes(c_Instances);
+    auto expected = ModelBone::MakeArray(c_Instances * c_Bones);
+
+    float animTime = 0.f;
+    for (size_t j = 0; j < c_Instances; ++j)
+    {
+        animTimes[j] = animTime;
+        anim.Apply(*model, c_Bones, expected.get() + j * c_Bones);
+
+        const float delta = step(rng);
+        anim.Update(delta);
+        AdvanceTime(animTime, delta, clip);
+    }
+
+    auto actual = ModelBone::MakeArray(c_Instances * c_Bones);
+
+    DX::AnimationThreadPool pool(3);
+
+    for (auto threadPool : { static_cast<DX::AnimationThreadPool*>(nullptr), &pool })
+    {
+        memset(static_cast<void*>(actual.get()), 0xff, sizeof(XMMATRIX) * c_Instances * c_Bones);
+
+        anim.ApplyBatch(*model, c_Instances, animTimes.data(), c_Bones, actual.get(), threadPool);
+
+        if (!CompareTransforms(expected.get(), actual.get(), c_Instances * c_Bones, 1e-5f))
+        {
+            success = false;
+            printf("ERROR: Batched CMO bone transforms mismatch (%s)\n", threadPool ? "thread pool" : "serial");
+        }
+    }
+
+    return success;
+}
@@ -0,0 +1,994 @@
+//-------------------------------------------------------------------------------------
+// sdkmesh.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include "pch.h"
+#include "Animation.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+using namespace DirectX;
+
+namespace
+{
+#pragma pack(push,8)
+
+    constexpr uint32_t SDKMESH_FILE_VERSION = 101;
+    constexpr uint32_t MAX_FRAME_NAME = 100;
+
+    struct SDKANIMATION_FILE_HEADER
+    {
+        uint32_t Version;
+        uint8_t  IsBigEndian;
+        uint32_t FrameTransformType;
+        uint32_t NumFrames;
+        uint32_t NumAnimationKeys;
+        uint32_t AnimationFPS;
+        uint64_t AnimationDataSize;
+        uint64_t AnimationDataOffset;
+    };
+
+    static_assert(sizeof(SDKANIMATION_FILE_HEADER) == 40, "SDK Mesh structure size incorrect");
+
+    struct SDKANIMATION_DATA
+    {
+        XMFLOAT3 Translation;
+        XMFLOAT4 Orientation;
+        XMFLOAT3 Scaling;
+    };
+
+    static_assert(sizeof(SDKANIMATION_DATA) == 40, "SDK Mesh structure size incorrect");
+
+    struct SDKANIMATION_FRAME_DATA
+    {
+        char FrameName[MAX_FRAME_NAME];
+        uint64_t DataOffset;
+    };
+
+    static_assert(sizeof(SDKANIMATION_FRAME_DATA) == 112, "SDK Mesh structure size incorrect");
+
+#pragma pack(pop)
+
+    constexpr uint32_t c_AnimationFPS = 30;
+    constexpr float c_Tolerance = 1e-4f;
+
+    using Interpolation = DX::AnimationSDKMESH::Interpolation;
+
+    // Keys for the clip as written to disk, plus the bone-to-track mapping Bind is expected to find
+    struct SyntheticClip
+    {
+        uint32_t                                    fps;
+        uint32_t                                    keyCount;
+        std::vector<std::string>                    trackNames;
+        std::vector<std::vector<SDKANIMATION_DATA>> tracks;
+        std::vector<uint32_t>                       boneToTrack;
+    };
+
+    // Every fifth bone is left without a track, tracks are stored in reverse bone order, and one
+    // track has no matching bone. Some keys have a zero orientation, which plays back as identity.
+    void CreateSyntheticClip(size_t nbones, uint32_t keyCount, std::mt19937& rng, SyntheticClip& clip)
+    {
+        std::uniform_real_distribution<float> offset(-2.f, 2.f);
+        std::uniform_real_distribution<float> component(-1.f, 1.f);
+        std::uniform_real_distribution<float> scale(0.8f, 1.25f);
+
+        clip.fps = c_AnimationFPS;
+        clip.keyCount = keyCount;
+        clip.trackNames.clear();
+        clip.tracks.clear();
+        clip.boneToTrack.assign(nbones, ModelBone::c_Invalid);
+
+        char name[MAX_FRAME_NAME] = {};
+        for (size_t j = nbones; j-- > 0; )
+        {
+            if ((j % 5) == 3)
+                continue;
+
+            // Bind matches frame names case-insensitively
+            sprintf_s(name, "BONE%03zu", j);
+
+            clip.boneToTrack[j] = static_cast<uint32_t>(clip.tracks.size());
+            clip.trackNames.emplace_back(name);
+            clip.tracks.emplace_back(keyCount);
+        }
+
+        clip.trackNames.emplace_back("Unused");
+        clip.tracks.emplace_back(keyCount);
+
+        for (size_t track = 0; track < clip.tracks.size(); ++track)
+        {
+            for (uint32_t key = 0; key < keyCount; ++key)
+            {
+                auto& data = clip.tracks[track][key];
+                data.Translation = XMFLOAT3(offset(rng), offset(rng), offset(rng));
+                data.Scaling = XMFLOAT3(scale(rng), scale(rng), scale(rng));
+
+                if (!(track % 3) && !(key % 7))
+                {
+                    data.Orientation = XMFLOAT4(0.f, 0.f, 0.f, 0.f);
+                }
+                else
+                {
+                    // Not unit length, so playback must normalize
+                    data.Orientation = XMFLOAT4(component(rng), component(rng), component(rng), component(rng) + 2.f);
+                }
+            }
+        }
+    }
+
+    // Looping motion baked at a high rate: constant angular velocity about a per-track axis,
+    // a small sinusoidal translation, and constant scale
+    void CreateSmoothClip(size_t nbones, uint32_t keyCount, uint32_t fps, std::mt19937& rng, SyntheticClip& clip)
+    {
+        std::uniform_real_distribution<float> component(-1.f, 1.f);
+
+        clip.fps = fps;
+        clip.keyCount = keyCount;
+        clip.trackNames.clear();
+        clip.tracks.clear();
+        clip.boneToTrack.resize(nbones);
+
+        char name[MAX_FRAME_NAME] = {};
+        for (size_t j = 0; j < nbones; ++j)
+        {
+            sprintf_s(name, "Bone%03zu", j);
+
+            clip.boneToTrack[j] = static_cast<uint32_t>(j);
+            clip.trackNames.emplace_back(name);
+            clip.tracks.emplace_back(keyCount);
+
+            const XMVECTOR axis = XMVector3Normalize(XMVectorSet(component(rng), component(rng), component(rng) + 2.f, 0.f));
+            const XMFLOAT3 offset(component(rng), component(rng), component(rng));
+            const float turns = float(1 + (j % 2));
+
+            for (uint32_t key = 0; key < keyCount; ++key)
+            {
+                const float phase = XM_2PI * float(key) / float(keyCount);
+
+                auto& data = clip.tracks[j][key];
+                data.Translation = XMFLOAT3(offset.x + 0.1f * std::sin(phase), offset.y, offset.z + 0.1f * std::cos(phase));
+                XMStoreFloat4(&data.Orientation, XMQuaternionRotationNormal(axis, phase * turns));
+                data.Scaling = XMFLOAT3(1.f, 1.5f, 1.f);
+            }
+        }
+    }
+
+    bool WriteSyntheticClip(const std::filesystem::path& path, const SyntheticClip& clip)
+    {
+        const auto nframes = static_cast<uint32_t>(clip.tracks.size());
+        const uint64_t trackSize = sizeof(SDKANIMATION_DATA) * uint64_t(clip.keyCount);
+
+        SDKANIMATION_FILE_HEADER header = {};
+        header.Version = SDKMESH_FILE_VERSION;
+        header.NumFrames = nframes;
+        header.NumAnimationKeys = clip.keyCount;
+        header.AnimationFPS = clip.fps;
+        header.AnimationDataOffset = sizeof(SDKANIMATION_FILE_HEADER);
+        header.AnimationDataSize = (sizeof(SDKANIMATION_FRAME_DATA) + trackSize) * nframes;
+
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        // Frame data offsets are relative to the end of the file header
+        for (uint32_t j = 0; j < nframes; ++j)
+        {
+            SDKANIMATION_FRAME_DATA frame = {};
+            strncpy_s(frame.FrameName, clip.trackNames[j].c_str(), _TRUNCATE);
+            frame.DataOffset = sizeof(SDKANIMATION_FRAME_DATA) * uint64_t(nframes) + trackSize * j;
+            out.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+        }
+
+        for (const auto& track : clip.tracks)
+        {
+            out.write(reinterpret_cast<const char*>(track.data()), static_cast<std::streamsize>(trackSize));
+        }
+
+        out.close();
+        return !out.fail();
+    }
+
+    XMVECTOR ReferenceOrientation(const SDKANIMATION_DATA& data)
+    {
+        XMVECTOR quat = XMVectorSet(data.Orientation.x, data.Orientation.y, data.Orientation.z, data.Orientation.w);
+        if (XMVector4Equal(quat, g_XMZero))
+            return XMQuaternionIdentity();
+
+        return XMQuaternionNormalize(quat);
+    }
+
+    // Per-bone evaluation of the original key layout, as AnimationSDKMESH::Apply did before SoA transcoding,
+    // with interpolation between adjacent keys of the looping track
+    void ReferenceApply(
+        const SyntheticClip& clip,
+        const Model& model,
+        double frame,
+        Interpolation mode,
+        XMMATRIX* animBones,
+        XMMATRIX* boneTransforms)
+    {
+        const size_t nbones = model.bones.size();
+
+        const uint32_t tick = static_cast<uint32_t>(frame) % clip.keyCount;
+        const uint32_t next = (tick + 1) % clip.keyCount;
+        const auto t = static_cast<float>(frame - std::floor(frame));
+
+        for (size_t j = 0; j < nbones; ++j)
+        {
+            if (clip.boneToTrack[j] == ModelBone::c_Invalid)
+            {
+                animBones[j] = model.boneMatrices[j];
+                continue;
+            }
+
+            const auto& track = clip.tracks[clip.boneToTrack[j]];
+            auto data = &track[tick];
+
+            XMVECTOR translation = XMLoadFloat3(&data->Translation);
+            XMVECTOR quat = ReferenceOrientation(*data);
+            XMVECTOR scaling = XMLoadFloat3(&data->Scaling);
+
+            if (mode != Interpolation::None)
+            {
+                auto data1 = &track[next];
+                XMVECTOR quat1 = ReferenceOrientation(*data1);
+
+                translation = XMVectorLerp(translation, XMLoadFloat3(&data1->Translation), t);
+                scaling = XMVectorLerp(scaling, XMLoadFloat3(&data1->Scaling), t);
+
+                if (mode == Interpolation::Spherical)
+                {
+                    quat = XMQuaternionSlerp(quat, quat1, t);
+                }
+                else
+                {
+                    if (XMVectorGetX(XMQuaternionDot(quat, quat1)) < 0.f)
+                        quat1 = XMVectorNegate(quat1);
+
+                    quat = XMQuaternionNormalize(XMVectorLerp(quat, quat1, t));
+                }
+            }
+
+            XMMATRIX trans = XMMatrixTranslation(XMVectorGetX(translation), XMVectorGetY(translation), XMVectorGetZ(translation));
+            XMMATRIX rotation = XMMatrixRotationQuaternion(quat);
+            XMMATRIX scale = XMMatrixScaling(XMVectorGetX(scaling), XMVectorGetY(scaling), XMVectorGetZ(scaling));
+
+            animBones[j] = XMMatrixMultiply(XMMatrixMultiply(rotation, scale), trans);
+        }
+
+        model.CopyAbsoluteBoneTransforms(nbones, animBones, boneTransforms);
+
+        for (size_t j = 0; j < nbones; ++j)
+        {
+            boneTransforms[j] = XMMatrixMultiply(model.invBindPoseMatrices[j], boneTransforms[j]);
+        }
+    }
+
+    HRESULT LoadSyntheticClip(const std::filesystem::path& path, const SyntheticClip& clip, const Model& model, DX::AnimationSDKMESH& anim)
+    {
+        if (!WriteSyntheticClip(path, clip))
+        {
+            printf("ERROR: Failed writing synthetic animation:\n%ls\n", path.wstring().c_str());
+            return E_FAIL;
+        }
+
+        HRESULT hr = anim.Load(path.wstring().c_str());
+        if (FAILED(hr))
+        {
+            printf("ERROR: Failed loading synthetic animation (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            return hr;
+        }
+
+        if (!anim.Bind(model))
+        {
+            printf("ERROR: Failed binding synthetic animation\n");
+            return E_FAIL;
+        }
+
+        // Center playback on the first key so accumulated time never straddles a key boundary
+        anim.Update(0.5f / float(clip.fps));
+
+        return S_OK;
+    }
+}
+
+//-------------------------------------------------------------------------------------
+
+extern std::unique_ptr<Model> CreateSyntheticModel(size_t nbones, std::mt19937& rng);
+extern bool CompareTransforms(const XMMATRIX* expected, const XMMATRIX* actual, size_t count, float tolerance);
+extern double ElapsedMilliseconds(std::chrono::steady_clock::time_point start);
+
+//-------------------------------------------------------------------------------------
+// SDKMESH animation playback matches per-bone evaluation of the source keys
+bool Test01()
+{
+    bool success = true;
+
+    std::mt19937 rng(12345);
+
+    const auto path = std::filesystem::temp_directory_path() / L"animationtest.sdkmesh_anim";
+
+    // Bone counts cover partial SoA groups, exact groups, and deeper hierarchies
+    for (const size_t nbones : { 1u, 3u, 4u, 8u, 67u })
+    {
+        const uint32_t keyCount = 17;
+
+        auto model = CreateSyntheticModel(nbones, rng);
+
+        SyntheticClip clip;
+        CreateSyntheticClip(nbones, keyCount, rng, clip);
+
+        DX::AnimationSDKMESH anim;
+        if (FAILED(LoadSyntheticClip(path, clip, *model, anim)))
+        {
+            success = false;
+            continue;
+        }
+
+        auto animBones = ModelBone::MakeArray(nbones);
+        auto expected = ModelBone::MakeArray(nbones);
+        auto actual = ModelBone::MakeArray(nbones);
+
+        // Play through the clip twice to cover wrap-around
+        for (uint32_t frame = 0; frame < keyCount * 2; ++frame)
+        {
+            ReferenceApply(clip, *model, double(frame % keyCount), Interpolation::None, animBones.get(), expected.get());
+            anim.Apply(*model, nbones, actual.get());
+
+            if (!CompareTransforms(expected.get(), actual.get(), nbones, c_Tolerance))
+            {
+                success = false;
+                printf("ERROR: Bone transforms mismatch (%zu bones, frame %u)\n", nbones, frame);
+                break;
+            }
+
+            anim.Update(1.f / float(c_AnimationFPS));
+        }
+    }
+
+    // No matching frame names
+    {
+        auto model = CreateSyntheticModel(5, rng);
+
+        SyntheticClip clip;
+        CreateSyntheticClip(5, 4, rng, clip);
+        for (auto& it : clip.trackNames)
+        {
+            it.insert(0, "X");
+        }
+
+        DX::AnimationSDKMESH anim;
+        if (!WriteSyntheticClip(path, clip)
+            || FAILED(anim.Load(path.wstring().c_str()))
+            || anim.Bind(*model))
+        {
+            success = false;
+            printf("ERROR: Expected bind failure for unmatched frames\n");
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Interpolated playback matches per-bone evaluation of the source keys
+bool Test02()
+{
+    bool success = true;
+
+    std::mt19937 rng(24680);
+
+    const auto path = std::filesystem::temp_directory_path() / L"animationtest_interpolation.sdkmesh_anim";
+
+    for (const auto mode : { Interpolation::Linear, Interpolation::Spherical })
+    {
+        const size_t nbones = 67;
+        const uint32_t keyCount = 13;
+
+        auto model = CreateSyntheticModel(nbones, rng);
+
+        SyntheticClip clip;
+        CreateSyntheticClip(nbones, keyCount, rng, clip);
+
+        DX::AnimationSDKMESH anim;
+        anim.SetInterpolation(mode);
+        if (FAILED(LoadSyntheticClip(path, clip, *model, anim)))
+        {
+            success = false;
+            continue;
+        }
+
+        auto animBones = ModelBone::MakeArray(nbones);
+        auto expected = ModelBone::MakeArray(nbones);
+        auto actual = ModelBone::MakeArray(nbones);
+
+        // Step by a fraction of a key through several loops of the clip, tracking time the same way Update does
+        const float delta = 0.37f / float(clip.fps);
+        double animTime = double(0.5f / float(clip.fps));
+
+        for (uint32_t step = 0; step < keyCount * 8; ++step)
+        {
+            ReferenceApply(clip, *model, double(clip.fps) * animTime, mode, animBones.get(), expected.get());
+            anim.Apply(*model, nbones, actual.get());
+
+            if (!CompareTransforms(expected.get(), actual.get(), nbones, c_Tolerance))
+            {
+                success = false;
+                printf("ERROR: Interpolated bone transforms mismatch (%s, step %u)\n",
+                    (mode == Interpolation::Spherical) ? "slerp" : "nlerp", step);
+                break;
+            }
+
+            anim.Update(delta);
+            animTime += double(delta);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Resampling to a lower key rate
+bool Test03()
+{
+    constexpr size_t c_Bones = 9;
+    constexpr uint32_t c_Keys = 48;
+    constexpr uint32_t c_FPS = 60;
+
+    bool success = true;
+
+    std::mt19937 rng(13579);
+
+    const auto tempDir = std::filesystem::temp_directory_path();
+    const auto path = tempDir / L"animationtest_smooth.sdkmesh_anim";
+    const auto resampledPath = tempDir / L"animationtest_resampled.sdkmesh_anim";
+
+    auto model = CreateSyntheticModel(c_Bones, rng);
+
+    SyntheticClip clip;
+    CreateSmoothClip(c_Bones, c_Keys, c_FPS, rng, clip);
+    if (!WriteSyntheticClip(path, clip))
+    {
+        printf("ERROR: Failed writing synthetic animation:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    for (const auto mode : { Interpolation::Linear, Interpolation::Spherical })
+    {
+        DX::AnimationSDKMESH anim;
+        anim.SetInterpolation(mode);
+
+        HRESULT hr = anim.Load(path.wstring().c_str());
+        if (FAILED(hr))
+        {
+            printf("ERROR: Failed loading synthetic animation (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            return false;
+        }
+
+        // Binding first must not prevent resampling
+        if (!anim.Bind(*model))
+        {
+            success = false;
+            printf("ERROR: Failed binding synthetic animation\n");
+        }
+
+        // 48 keys at 60 FPS only divide evenly at multiples of 5 FPS
+        for (const uint32_t fps : { 0u, 16u, 60u, 90u })
+        {
+            hr = anim.Resample(fps);
+            if (hr != E_INVALIDARG)
+            {
+                success = false;
+                printf("ERROR: Expected E_INVALIDARG for resampling to %u FPS (HRESULT %08X)\n", fps, static_cast<unsigned int>(hr));
+            }
+        }
+
+        DX::AnimationSDKMESH::ResampleReport report = {};
+        hr = anim.Resample(15, &report);
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("ERROR: Failed resampling (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            continue;
+        }
+
+        // Translation is a sinusoid, so lerp error is bounded by its curvature; slerp is exact for
+        // constant angular velocity
+        const float maxRotationError = (mode == Interpolation::Spherical) ? 1e-3f : 2e-2f;
+        if (report.originalKeys != c_Keys
+            || report.resampledKeys != 12
+            || report.resampledSize >= report.originalSize
+            || report.maxTranslationError > 0.02f
+            || report.maxRotationError > maxRotationError
+            || report.maxScaleError > 1e-5f)
+        {
+            success = false;
+            printf("ERROR: Unexpected resample report (%u -> %u keys, %zu -> %zu bytes, error %f %f %f)\n",
+                report.originalKeys, report.resampledKeys, report.originalSize, report.resampledSize,
+                double(report.maxTranslationError), double(report.maxRotationError), double(report.maxScaleError));
+        }
+
+        hr = anim.Save(resampledPath.wstring().c_str());
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("ERROR: Failed saving resampled animation (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            continue;
+        }
+
+        // The binding made before resampling is kept, so anim is not bound again
+        DX::AnimationSDKMESH reloaded;
+        reloaded.SetInterpolation(mode);
+        hr = reloaded.Load(resampledPath.wstring().c_str());
+        if (FAILED(hr)
+            || !reloaded.Bind(*model)
+            || std::filesystem::file_size(resampledPath) != report.resampledSize)
+        {
+            success = false;
+            printf("ERROR: Failed reloading resampled animation (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            continue;
+        }
+
+        auto expected = ModelBone::MakeArray(c_Bones);
+        auto actual = ModelBone::MakeArray(c_Bones);
+
+        const float delta = 0.29f / float(c_FPS);
+        for (uint32_t step = 0; step < 64; ++step)
+        {
+            anim.Apply(*model, c_Bones, expected.get());
+            reloaded.Apply(*model, c_Bones, actual.get());
+
+            if (!CompareTransforms(expected.get(), actual.get(), c_Bones, 0.f))
+            {
+                success = false;
+                printf("ERROR: Reloaded animation mismatch (step %u)\n", step);
+                break;
+            }
+
+            anim.Update(delta);
+            reloaded.Update(delta);
+        }
+    }
+
+    // Snapped playback has no way to reconstruct the removed keys
+    {
+        DX::AnimationSDKMESH anim;
+        HRESULT hr = anim.Load(path.wstring().c_str());
+        if (SUCCEEDED(hr))
+        {
+            hr = anim.Resample(15);
+        }
+
+        if (hr != E_UNEXPECTED)
+        {
+            success = false;
+            printf("ERROR: Expected E_UNEXPECTED for resampling without interpolation (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+
+        // Applying an animation that was never bound must fail cleanly
+        auto bones = ModelBone::MakeArray(c_Bones);
+        try
+        {
+            anim.Apply(*model, c_Bones, bones.get());
+
+            success = false;
+            printf("ERROR: Expected exception applying an unbound animation\n");
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    std::filesystem::remove(resampledPath, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Resamples an existing .sdkmesh_anim file, reporting error and size
+int ResampleTool(const wchar_t* inputFile, const wchar_t* outputFile, uint32_t animationFPS, Interpolation mode)
+{
+    DX::AnimationSDKMESH anim;
+    anim.SetInterpolation(mode);
+
+    HRESULT hr = anim.Load(inputFile);
+    if (FAILED(hr))
+    {
+        printf("ERROR: Failed loading animation (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), inputFile);
+        return 1;
+    }
+
+    DX::AnimationSDKMESH::ResampleReport report = {};
+    hr = anim.Resample(animationFPS, &report);
+    if (FAILED(hr))
+    {
+        printf("ERROR: Failed resampling to %u FPS (HRESULT %08X)\n", animationFPS, static_cast<unsigned int>(hr));
+        return 1;
+    }
+
+    hr = anim.Save(outputFile);
+    if (FAILED(hr))
+    {
+        printf("ERROR: Failed writing animation (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), outputFile);
+        return 1;
+    }
+
+    printf("%ls -> %ls (%s)\n", inputFile, outputFile, (mode == Interpolation::Spherical) ? "slerp" : "nlerp");
+    printf("\tkeys:        %u -> %u\n", report.originalKeys, report.resampledKeys);
+    printf("\tsize:        %zu -> %zu bytes (%.1f%% saved)\n", report.originalSize, report.resampledSize,
+        100.0 * (1.0 - double(report.resampledSize) / double(report.originalSize)));
+    printf("\ttranslation: %f max error\n", double(report.maxTranslationError));
+    printf("\trotation:    %f max error (degrees)\n", double(XMConvertToDegrees(report.maxRotationError)));
+    printf("\tscale:       %f max error\n", double(report.maxScaleError));
+
+    return 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Bones/sec for SoA sampling vs. per-bone evaluation
+bool Benchmark01()
+{
+    constexpr size_t c_BenchmarkBones = 128;
+    constexpr uint32_t c_BenchmarkKeys = 120;
+    constexpr uint32_t c_Iterations = 20000;
+
+    std::mt19937 rng(67890);
+
+    auto model = CreateSyntheticModel(c_BenchmarkBones, rng);
+
+    SyntheticClip clip;
+    CreateSyntheticClip(c_BenchmarkBones, c_BenchmarkKeys, rng, clip);
+
+    const auto path = std::filesystem::temp_directory_path() / L"animationtest_benchmark.sdkmesh_anim";
+
+    DX::AnimationSDKMESH anim;
+    if (FAILED(LoadSyntheticClip(path, clip, *model, anim)))
+        return false;
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    auto animBones = ModelBone::MakeArray(c_BenchmarkBones);
+    auto expected = ModelBone::MakeArray(c_BenchmarkBones);
+    auto actual = ModelBone::MakeArray(c_BenchmarkBones);
+
+    const float delta = 1.f / float(c_AnimationFPS);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t j = 0; j < c_Iterations; ++j)
+    {
+        ReferenceApply(clip, *model, double(j % c_BenchmarkKeys), Interpolation::None, animBones.get(), expected.get());
+    }
+    const double referenceTime = ElapsedMilliseconds(start);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t j = 0; j < c_Iterations; ++j)
+    {
+        anim.Apply(*model, c_BenchmarkBones, actual.get());
+        anim.Update(delta);
+    }
+    const double soaTime = ElapsedMilliseconds(start);
+
+    // Both loops end on the same key
+    const bool success = CompareTransforms(expected.get(), actual.get(), c_BenchmarkBones, c_Tolerance);
+
+    const double bones = double(c_BenchmarkBones) * double(c_Iterations);
+
+    printf("\n\t%zu bones, %u keys, %u iterations\n", c_BenchmarkBones, c_BenchmarkKeys, c_Iterations);
+    printf("\tper-bone: %10.2f ms  %8.2f Mbones/s\n", referenceTime, bones / (referenceTime * 1000.0));
+    printf("\tSoA:      %10.2f ms  %8.2f Mbones/s  (%.2fx)\n", soaTime, bones / (soaTime * 1000.0), referenceTime / soaTime);
+
+    // Interpolated sampling costs
+    for (const auto mode : { Interpolation::Linear, Interpolation::Spherical })
+    {
+        anim.SetInterpolation(mode);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t j = 0; j < c_Iterations; ++j)
+        {
+            anim.Apply(*model, c_BenchmarkBones, actual.get());
+            anim.Update(delta * 0.5f);
+        }
+        const double time = ElapsedMilliseconds(start);
+
+        printf("\tSoA %s: %8.2f ms  %8.2f Mbones/s\n", (mode == Interpolation::Spherical) ? "slerp" : "nlerp",
+            time, bones / (time * 1000.0));
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Error and memory saved by resampling real content
+bool Benchmark02()
+{
+    const wchar_t* c_SoldierMedia = L"AnimTest/soldier.sdkmesh_anim";
+
+    bool success = true;
+
+    for (const auto mode : { Interpolation::Linear, Interpolation::Spherical })
+    {
+        printf("\n\t%s\n\t  FPS   keys      bytes  saved  translation  rotation (deg)     scale\n",
+            (mode == Interpolation::Spherical) ? "slerp" : "nlerp");
+
+        for (const uint32_t fps : { 40u, 20u, 12u, 4u })
+        {
+            DX::AnimationSDKMESH anim;
+            anim.SetInterpolation(mode);
+
+            HRESULT hr = anim.Load(c_SoldierMedia);
+            if (FAILED(hr))
+            {
+                printf("ERROR: Failed loading animation (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), c_SoldierMedia);
+                return false;
+            }
+
+            DX::AnimationSDKMESH::ResampleReport report = {};
+            hr = anim.Resample(fps, &report);
+            if (FAILED(hr))
+            {
+                success = false;
+                printf("ERROR: Failed resampling to %u FPS (HRESULT %08X)\n", fps, static_cast<unsigned int>(hr));
+                continue;
+            }
+
+            printf("\t%5u  %5u  %9zu  %4.1f%%  %11.5f  %14.4f  %8.5f\n",
+                fps, report.resampledKeys, report.resampledSize,
+                100.0 * (1.0 - double(report.resampledSize) / double(report.originalSize)),
+                double(report.maxTranslationError), double(XMConvertToDegrees(report.maxRotationError)), double(report.maxScaleError));
+        }
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Batched evaluation matches applying each instance in turn
+bool Test05()
+{
+    constexpr size_t c_Bones = 67;
+    constexpr uint32_t c_Keys = 13;
+    constexpr size_t c_Instances = 150;
+
+    bool success = true;
+
+    std::mt19937 rng(11235);
+
+    // Every chunk is visited exactly once, and exceptions reach the caller
+    {
+        DX::AnimationThreadPool pool(4);
+
+        std::vector<std::atomic<uint32_t>> visits(1000);
+        pool.ParallelFor(visits.size(), 7, [&](size_t begin, size_t end)
+            {
+                for (size_t j = begin; j < end; ++j)
+                    ++visits[j];
+            });
+
+        for (size_t j = 0; j < visits.size(); ++j)
+        {
+            if (visits[j] != 1)
+            {
+                success = false;
+                printf("ERROR: Thread pool visited item %zu %u times\n", j, visits[j].load());
+                break;
+            }
+        }
+
+        bool caught = false;
+        try
+        {
+            pool.ParallelFor(100, 1, [](size_t begin, size_t)
+                {
+                    if (begin == 42)
+                        throw std::runtime_error("expected");
+                });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+
+        if (!caught)
+        {
+            success = false;
+            printf("ERROR: Thread pool did not rethrow worker exception\n");
+        }
+    }
+
+    const auto path = std::filesystem::temp_directory_path() / L"animationtest_batch.sdkmesh_anim";
+
+    auto model = CreateSyntheticModel(c_Bones, rng);
+
+    SyntheticClip clip;
+    CreateSyntheticClip(c_Bones, c_Keys, rng, clip);
+
+    DX::AnimationThreadPool singlePool(1);
+    DX::AnimationThreadPool pool(3);
+
+    for (const auto mode : { Interpolation::None, Interpolation::Spherical })
+    {
+        DX::AnimationSDKMESH anim;
+        anim.SetInterpolation(mode);
+        if (FAILED(LoadSyntheticClip(path, clip, *model, anim)))
+        {
+            success = false;
+            continue;
+        }
+
+        // Each instance is one step of an irregular playback, with times accumulated the same way Update does
+        std::uniform_real_distribution<float> step(0.f, 2.f / float(clip.fps));
+
+        std::vector<double> animTimes(c_Instances);
+        auto expected = ModelBone::MakeArray(c_Instances * c_Bones);
+
+        double animTime = double(0.5f / float(clip.fps));
+        for (size_t j = 0; j < c_Instances; ++j)
+        {
+            animTimes[j] = animTime;
+            anim.Apply(*model, c_Bones, expected.get() + j * c_Bones);
+
+            const float delta = step(rng);
+            anim.Update(delta);
+            animTime += double(delta);
+        }
+
+        auto actual = ModelBone::MakeArray(c_Instances * c_Bones);
+
+        for (auto threadPool : { static_cast<DX::AnimationThreadPool*>(nullptr), &singlePool, &pool })
+        {
+            memset(static_cast<void*>(actual.get()), 0xff, sizeof(XMMATRIX) * c_Instances * c_Bones);
+
+            anim.ApplyBatch(*model, c_Instances, animTimes.data(), c_Bones, actual.get(), threadPool);
+
+            if (!CompareTransforms(expected.get(), actual.get(), c_Instances * c_Bones, 1e-5f))
+            {
+                success = false;
+                printf("ERROR: Batched bone transforms mismatch (%s, %zu threads)\n",
+                    (mode == Interpolation::None) ? "keys" : "slerp", threadPool ? threadPool->GetThreadCount() : 0);
+            }
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Crowd evaluation throughput by thread count
+bool Benchmark04()
+{
+    constexpr size_t c_BenchmarkBones = 96;
+    constexpr uint32_t c_BenchmarkKeys = 120;
+    constexpr size_t c_Instances = 1000;
+    constexpr uint32_t c_Frames = 20;
+
+    std::mt19937 rng(31415);
+
+    auto model = CreateSyntheticModel(c_BenchmarkBones, rng);
+
+    SyntheticClip clip;
+    CreateSyntheticClip(c_BenchmarkBones, c_BenchmarkKeys, rng, clip);
+
+    const auto path = std::filesystem::temp_directory_path() / L"animationtest_crowd.sdkmesh_anim";
+
+    DX::AnimationSDKMESH anim;
+    anim.SetInterpolation(Interpolation::Spherical);
+    if (FAILED(LoadSyntheticClip(path, clip, *model, anim)))
+        return false;
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    // Instances are spread across the clip
+    std::uniform_real_distribution<double> phase(0.0, double(c_BenchmarkKeys) / double(clip.fps));
+    std::vector<double> animTimes(c_Instances);
+    for (auto& it : animTimes)
+    {
+        it = phase(rng);
+    }
+
+    const float delta = 1.f / 60.f;
+
+    auto expected = ModelBone::MakeArray(c_Instances * c_BenchmarkBones);
+    auto actual = ModelBone::MakeArray(c_Instances * c_BenchmarkBones);
+
+    // Baseline: one Apply per instance, stepping a single player between instance times. This is
+    // only for timing, as the player's time is rebuilt from float steps and drifts from animTimes.
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < c_Frames; ++frame)
+    {
+        double current = 0.0;
+        for (size_t j = 0; j < c_Instances; ++j)
+        {
+            anim.Update(float(animTimes[j] + double(frame) * double(delta) - current));
+            current = animTimes[j] + double(frame) * double(delta);
+
+            anim.Apply(*model, c_BenchmarkBones, actual.get() + j * c_BenchmarkBones);
+        }
+        anim.Update(float(-current));
+    }
+    const double baselineTime = ElapsedMilliseconds(start);
+
+    const double instances = double(c_Instances) * double(c_Frames);
+
+    printf("\n\t%zu instances, %zu bones, %u frames, slerp\n", c_Instances, c_BenchmarkBones, c_Frames);
+    printf("\t  Apply loop:      %10.2f ms  %8.2f instances/ms\n", baselineTime, instances / baselineTime);
+
+    std::vector<double> frameTimes(c_Instances);
+
+    auto runBatch = [&](DX::AnimationThreadPool* pool) -> double
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < c_Frames; ++frame)
+        {
+            for (size_t j = 0; j < c_Instances; ++j)
+            {
+                frameTimes[j] = animTimes[j] + double(frame) * double(delta);
+            }
+
+            anim.ApplyBatch(*model, c_Instances, frameTimes.data(), c_BenchmarkBones, actual.get(), pool);
+        }
+        return ElapsedMilliseconds(begin);
+    };
+
+    const double serialTime = runBatch(nullptr);
+    printf("\t  batch, serial:   %10.2f ms  %8.2f instances/ms  (%.2fx)\n",
+        serialTime, instances / serialTime, baselineTime / serialTime);
+
+    // Threaded results must match the serial batch
+    memcpy(static_cast<void*>(expected.get()), actual.get(), sizeof(XMMATRIX) * c_Instances * c_BenchmarkBones);
+
+    bool success = true;
+
+    const size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t threads = 1; ; threads *= 2)
+    {
+        threads = std::min(threads, maxThreads);
+
+        DX::AnimationThreadPool pool(threads);
+
+        const double time = runBatch(&pool);
+        printf("\t  batch, %2zu thread%s %10.2f ms  %8.2f instances/ms  (%.2fx)\n",
+            threads, (threads > 1) ? "s:" : ": ", time, instances / time, baselineTime / time);
+
+        if (!CompareTransforms(expected.get(), actual.get(), c_Instances * c_BenchmarkBones, 0.f))
+        {
+            success = false;
+            printf("ERROR: Crowd results mismatch (%zu threads)\n", threads);
+        }
+
+        if (threads >= maxThreads)
+            break;
+    }
+
+    return success;
+}
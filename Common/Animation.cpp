@@ -10,13 +10,145 @@
 #include "pch.h"
 #include "Animation.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
 
 using namespace DX;
 using namespace DirectX;
 
+//--------------------------------------------------------------------------------------
+// Batched evaluation
+//--------------------------------------------------------------------------------------
+namespace
+{
+    // Bones in hierarchy order (parents before children), each paired with its parent's index
+    using BoneOrder = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    // Walks the hierarchy once in the same order as Model::CopyAbsoluteBoneTransforms, so every
+    // instance in a batch can reuse it without re-traversing the bone links
+    BoneOrder GetBoneOrder(const Model& model)
+    {
+        const size_t nbones = model.bones.size();
+
+        BoneOrder order;
+        order.reserve(nbones);
+
+        std::vector<std::pair<uint32_t, uint32_t>> stack;
+        stack.emplace_back(0u, ModelBone::c_Invalid);
+        while (!stack.empty())
+        {
+            const uint32_t index = stack.back().first;
+            const uint32_t parent = stack.back().second;
+            stack.pop_back();
+
+            if (index == ModelBone::c_Invalid || index >= nbones)
+                continue;
+
+            if (order.size() >= nbones)
+            {
+                throw std::runtime_error("Model bone hierarchy contains a cycle");
+            }
+
+            order.emplace_back(index, parent);
+
+            const auto& bone = model.bones[index];
+            stack.emplace_back(bone.siblingIndex, parent);
+            stack.emplace_back(bone.childIndex, index);
+        }
+
+        return order;
+    }
+
+    // Same result as Model::CopyAbsoluteBoneTransforms followed by the bind pose adjustment in Apply
+    void ComputeInstanceTransforms(
+        const Model& model,
+        const BoneOrder& order,
+        _In_reads_(model.bones.size()) const XMMATRIX* localTransforms,
+        _Out_writes_(model.bones.size()) XMMATRIX* absoluteTransforms,
+        size_t nbones,
+        _Out_writes_(nbones) XMMATRIX* boneTransforms) noexcept
+    {
+        const size_t count = model.bones.size();
+
+        // Bones not reachable from the root are left zeroed
+        memset(static_cast<void*>(absoluteTransforms), 0, sizeof(XMMATRIX) * count);
+
+        for (const auto& it : order)
+        {
+            const XMMATRIX& local = localTransforms[it.first];
+            absoluteTransforms[it.first] = (it.second == ModelBone::c_Invalid)
+                ? local
+                : XMMatrixMultiply(local, absoluteTransforms[it.second]);
+        }
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            boneTransforms[j] = XMMatrixMultiply(model.invBindPoseMatrices[j], absoluteTransforms[j]);
+        }
+
+        if (nbones > count)
+        {
+            memset(static_cast<void*>(boneTransforms + count), 0, sizeof(XMMATRIX) * (nbones - count));
+        }
+    }
+
+    // getLocal(instance, localTransforms) fills the local bone transforms for one instance
+    template<typename TGetLocal>
+    void EvaluateBatch(
+        const Model& model,
+        size_t instanceCount,
+        size_t nbones,
+        _Out_writes_(instanceCount * nbones) XMMATRIX* boneTransforms,
+        _In_opt_ AnimationThreadPool* threadPool,
+        const TGetLocal& getLocal)
+    {
+        if (!nbones || !boneTransforms)
+        {
+            throw std::invalid_argument("Bone transforms array required");
+        }
+
+        if (nbones < model.bones.size())
+        {
+            throw std::invalid_argument("Bone transforms array is too small");
+        }
+
+        if (model.bones.empty())
+        {
+            throw std::runtime_error("Model is missing bones");
+        }
+
+        const BoneOrder order = GetBoneOrder(model);
+        const size_t count = model.bones.size();
+
+        const std::function<void(size_t, size_t)> evaluate = [&](size_t begin, size_t end)
+        {
+            auto scratch = ModelBone::MakeArray(count * 2);
+            XMMATRIX* local = scratch.get();
+            XMMATRIX* absolute = scratch.get() + count;
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                getLocal(i, local);
+                ComputeInstanceTransforms(model, order, local, absolute, nbones, boneTransforms + i * nbones);
+            }
+        };
+
+        if (!threadPool || threadPool->GetThreadCount() <= 1)
+        {
+            evaluate(0, instanceCount);
+            return;
+        }
+
+        // Several chunks per thread so uneven progress still balances out
+        const size_t grain = std::max<size_t>(1, instanceCount / (threadPool->GetThreadCount() * 4));
+        threadPool->ParallelFor(instanceCount, grain, evaluate);
+    }
+}
+
 //--------------------------------------------------------------------------------------
 // DirectX SDK SDKMESH animation
 //--------------------------------------------------------------------------------------
@@ -63,11 +195,228 @@ namespace
     static_assert(sizeof(SDKANIMATION_FRAME_DATA) == 112, "SDK Mesh structure size incorrect");
 
 #pragma pack(pop)
+
+    // Bound keys are stored as structure-of-arrays groups of four bones, one XMFLOAT4 per component
+    enum TRACK_COMPONENT : uint32_t
+    {
+        TRACK_TX = 0,
+        TRACK_TY,
+        TRACK_TZ,
+        TRACK_QX,
+        TRACK_QY,
+        TRACK_QZ,
+        TRACK_QW,
+        TRACK_SX,
+        TRACK_SY,
+        TRACK_SZ,
+        TRACK_STRIDE
+    };
+
+    constexpr size_t c_BonesPerGroup = 4;
+
+    // Above this cosine, slerp falls back to linear weights to avoid dividing by sin(omega) ~ 0
+    constexpr float c_SlerpThreshold = 1.f - 1e-5f;
+
+    using Interpolation = AnimationSDKMESH::Interpolation;
+
+    void LoadBoneGroup(_In_reads_(TRACK_STRIDE) const XMFLOAT4* src, _Out_writes_(TRACK_STRIDE) XMVECTOR* keys) noexcept
+    {
+        for (size_t k = 0; k < TRACK_STRIDE; ++k)
+        {
+            keys[k] = XMLoadFloat4(&src[k]);
+        }
+    }
+
+    // Interpolates the keys for a group of four bones by t in [0,1)
+    void XM_CALLCONV InterpolateBoneGroup(
+        FXMVECTOR t,
+        _In_reads_(TRACK_STRIDE) const XMFLOAT4* src0,
+        _In_reads_(TRACK_STRIDE) const XMFLOAT4* src1,
+        Interpolation mode,
+        _Out_writes_(TRACK_STRIDE) XMVECTOR* keys) noexcept
+    {
+        for (const size_t k : { TRACK_TX, TRACK_TY, TRACK_TZ, TRACK_SX, TRACK_SY, TRACK_SZ })
+        {
+            keys[k] = XMVectorLerpV(XMLoadFloat4(&src0[k]), XMLoadFloat4(&src1[k]), t);
+        }
+
+        const XMVECTOR qx0 = XMLoadFloat4(&src0[TRACK_QX]);
+        const XMVECTOR qy0 = XMLoadFloat4(&src0[TRACK_QY]);
+        const XMVECTOR qz0 = XMLoadFloat4(&src0[TRACK_QZ]);
+        const XMVECTOR qw0 = XMLoadFloat4(&src0[TRACK_QW]);
+        const XMVECTOR qx1 = XMLoadFloat4(&src1[TRACK_QX]);
+        const XMVECTOR qy1 = XMLoadFloat4(&src1[TRACK_QY]);
+        const XMVECTOR qz1 = XMLoadFloat4(&src1[TRACK_QZ]);
+        const XMVECTOR qw1 = XMLoadFloat4(&src1[TRACK_QW]);
+
+        XMVECTOR cosOmega = XMVectorMultiply(qx0, qx1);
+        cosOmega = XMVectorMultiplyAdd(qy0, qy1, cosOmega);
+        cosOmega = XMVectorMultiplyAdd(qz0, qz1, cosOmega);
+        cosOmega = XMVectorMultiplyAdd(qw0, qw1, cosOmega);
+
+        // Take the shortest arc
+        const XMVECTOR sign = XMVectorSelect(g_XMOne, g_XMNegativeOne, XMVectorLess(cosOmega, g_XMZero));
+        cosOmega = XMVectorMultiply(cosOmega, sign);
+
+        const XMVECTOR invT = XMVectorSubtract(g_XMOne, t);
+        XMVECTOR scale0 = invT;
+        XMVECTOR scale1 = t;
+
+        if (mode == Interpolation::Spherical)
+        {
+            const XMVECTOR omega = XMVectorACos(cosOmega);
+            const XMVECTOR invSinOmega = XMVectorReciprocal(XMVectorSin(omega));
+            const XMVECTOR linear = XMVectorGreater(cosOmega, XMVectorReplicate(c_SlerpThreshold));
+
+            scale0 = XMVectorSelect(XMVectorMultiply(XMVectorSin(XMVectorMultiply(invT, omega)), invSinOmega), invT, linear);
+            scale1 = XMVectorSelect(XMVectorMultiply(XMVectorSin(XMVectorMultiply(t, omega)), invSinOmega), t, linear);
+        }
+
+        scale1 = XMVectorMultiply(scale1, sign);
+
+        XMVECTOR qx = XMVectorMultiplyAdd(qx1, scale1, XMVectorMultiply(qx0, scale0));
+        XMVECTOR qy = XMVectorMultiplyAdd(qy1, scale1, XMVectorMultiply(qy0, scale0));
+        XMVECTOR qz = XMVectorMultiplyAdd(qz1, scale1, XMVectorMultiply(qz0, scale0));
+        XMVECTOR qw = XMVectorMultiplyAdd(qw1, scale1, XMVectorMultiply(qw0, scale0));
+
+        XMVECTOR lengthSq = XMVectorMultiply(qx, qx);
+        lengthSq = XMVectorMultiplyAdd(qy, qy, lengthSq);
+        lengthSq = XMVectorMultiplyAdd(qz, qz, lengthSq);
+        lengthSq = XMVectorMultiplyAdd(qw, qw, lengthSq);
+
+        const XMVECTOR invLength = XMVectorReciprocalSqrt(lengthSq);
+        keys[TRACK_QX] = XMVectorMultiply(qx, invLength);
+        keys[TRACK_QY] = XMVectorMultiply(qy, invLength);
+        keys[TRACK_QZ] = XMVectorMultiply(qz, invLength);
+        keys[TRACK_QW] = XMVectorMultiply(qw, invLength);
+    }
+
+    // Computes rotation * scale * translation for a group of four bones
+    void ComputeBoneGroup(_In_reads_(TRACK_STRIDE) const XMVECTOR* keys, _Out_writes_(c_BonesPerGroup) XMMATRIX* transforms) noexcept
+    {
+        const XMVECTOR qx = keys[TRACK_QX];
+        const XMVECTOR qy = keys[TRACK_QY];
+        const XMVECTOR qz = keys[TRACK_QZ];
+        const XMVECTOR qw = keys[TRACK_QW];
+
+        const XMVECTOR x2 = XMVectorAdd(qx, qx);
+        const XMVECTOR y2 = XMVectorAdd(qy, qy);
+        const XMVECTOR z2 = XMVectorAdd(qz, qz);
+
+        const XMVECTOR xx = XMVectorMultiply(qx, x2);
+        const XMVECTOR yy = XMVectorMultiply(qy, y2);
+        const XMVECTOR zz = XMVectorMultiply(qz, z2);
+        const XMVECTOR xy = XMVectorMultiply(qx, y2);
+        const XMVECTOR xz = XMVectorMultiply(qx, z2);
+        const XMVECTOR yz = XMVectorMultiply(qy, z2);
+        const XMVECTOR wx = XMVectorMultiply(qw, x2);
+        const XMVECTOR wy = XMVectorMultiply(qw, y2);
+        const XMVECTOR wz = XMVectorMultiply(qw, z2);
+
+        const XMVECTOR one = g_XMOne;
+        const XMVECTOR sx = keys[TRACK_SX];
+        const XMVECTOR sy = keys[TRACK_SY];
+        const XMVECTOR sz = keys[TRACK_SZ];
+
+        // Row i of the local transform for lane n is (m[i].x[n], m[i].y[n], m[i].z[n], m[i].w[n])
+        const XMMATRIX row0 = XMMatrixTranspose(XMMATRIX(
+            XMVectorMultiply(XMVectorSubtract(one, XMVectorAdd(yy, zz)), sx),
+            XMVectorMultiply(XMVectorAdd(xy, wz), sy),
+            XMVectorMultiply(XMVectorSubtract(xz, wy), sz),
+            g_XMZero));
+
+        const XMMATRIX row1 = XMMatrixTranspose(XMMATRIX(
+            XMVectorMultiply(XMVectorSubtract(xy, wz), sx),
+            XMVectorMultiply(XMVectorSubtract(one, XMVectorAdd(xx, zz)), sy),
+            XMVectorMultiply(XMVectorAdd(yz, wx), sz),
+            g_XMZero));
+
+        const XMMATRIX row2 = XMMatrixTranspose(XMMATRIX(
+            XMVectorMultiply(XMVectorAdd(xz, wy), sx),
+            XMVectorMultiply(XMVectorSubtract(yz, wx), sy),
+            XMVectorMultiply(XMVectorSubtract(one, XMVectorAdd(xx, yy)), sz),
+            g_XMZero));
+
+        const XMMATRIX row3 = XMMatrixTranspose(XMMATRIX(
+            keys[TRACK_TX],
+            keys[TRACK_TY],
+            keys[TRACK_TZ],
+            one));
+
+        for (size_t n = 0; n < c_BonesPerGroup; ++n)
+        {
+            transforms[n] = XMMATRIX(row0.r[n], row1.r[n], row2.r[n], row3.r[n]);
+        }
+    }
+
+    // Returns the keys for a frame, or nullptr if they are outside the file
+    const SDKANIMATION_DATA* GetTrack(_In_reads_bytes_(animSize) const uint8_t* animData, size_t animSize, size_t frame) noexcept
+    {
+        auto header = reinterpret_cast<const SDKANIMATION_FILE_HEADER*>(animData);
+        auto frameData = reinterpret_cast<const SDKANIMATION_FRAME_DATA*>(animData + header->AnimationDataOffset);
+
+        if (frameData[frame].DataOffset > UINT32_MAX)
+            return nullptr;
+
+        uint64_t offset = sizeof(SDKANIMATION_FILE_HEADER) + frameData[frame].DataOffset;
+        uint64_t end = offset + sizeof(SDKANIMATION_DATA) * uint64_t(header->NumAnimationKeys);
+        if (end > UINT32_MAX
+            || end > animSize)
+            return nullptr;
+
+        return reinterpret_cast<const SDKANIMATION_DATA*>(animData + offset);
+    }
+
+    XMVECTOR LoadOrientation(const SDKANIMATION_DATA& data) noexcept
+    {
+        XMVECTOR quat = XMLoadFloat4(&data.Orientation);
+        if (XMVector4Equal(quat, g_XMZero))
+            return XMQuaternionIdentity();
+
+        return XMQuaternionNormalize(quat);
+    }
+
+    // Samples a looping track at a fractional key position, matching interpolated playback
+    SDKANIMATION_DATA SampleTrack(
+        _In_reads_(keyCount) const SDKANIMATION_DATA* track,
+        uint32_t keyCount,
+        double position,
+        Interpolation mode) noexcept
+    {
+        const auto tick = static_cast<uint32_t>(position) % keyCount;
+        const auto& key0 = track[tick];
+        const auto& key1 = track[(tick + 1) % keyCount];
+        const auto t = static_cast<float>(position - std::floor(position));
+
+        const XMVECTOR q0 = LoadOrientation(key0);
+        XMVECTOR q1 = LoadOrientation(key1);
+
+        XMVECTOR quat;
+        if (mode == Interpolation::Spherical)
+        {
+            quat = XMQuaternionSlerp(q0, q1, t);
+        }
+        else
+        {
+            if (XMVectorGetX(XMVector4Dot(q0, q1)) < 0.f)
+                q1 = XMVectorNegate(q1);
+
+            quat = XMVectorLerp(q0, q1, t);
+        }
+
+        SDKANIMATION_DATA result;
+        XMStoreFloat3(&result.Translation, XMVectorLerp(XMLoadFloat3(&key0.Translation), XMLoadFloat3(&key1.Translation), t));
+        XMStoreFloat4(&result.Orientation, XMQuaternionNormalize(quat));
+        XMStoreFloat3(&result.Scaling, XMVectorLerp(XMLoadFloat3(&key0.Scaling), XMLoadFloat3(&key1.Scaling), t));
+        return result;
+    }
 }
 
 AnimationSDKMESH::AnimationSDKMESH() noexcept :
     m_animTime(0.0),
-    m_animSize(0)
+    m_interpolation(Interpolation::None),
+    m_animSize(0),
+    m_boneGroups(0)
 {
 }
 
@@ -126,6 +475,27 @@ HRESULT AnimationSDKMESH::Load(_In_z_ const wchar_t* fileName)
     return S_OK;
 }
 
+HRESULT AnimationSDKMESH::Save(_In_z_ const wchar_t* fileName) const
+{
+    if (!fileName)
+        return E_INVALIDARG;
+
+    if (!m_animData || !m_animSize)
+        return E_UNEXPECTED;
+
+    std::ofstream outFile(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outFile)
+        return E_FAIL;
+
+    outFile.write(reinterpret_cast<const char*>(m_animData.get()), static_cast<std::streamsize>(m_animSize));
+    if (!outFile)
+        return E_FAIL;
+
+    outFile.close();
+
+    return S_OK;
+}
+
 bool AnimationSDKMESH::Bind(const Model& model)
 {
     assert(m_animData && m_animSize > 0);
@@ -135,7 +505,7 @@ bool AnimationSDKMESH::Bind(const Model& model)
 
     auto header = reinterpret_cast<const SDKANIMATION_FILE_HEADER*>(m_animData.get());
     assert(header->Version == SDKMESH_FILE_VERSION);
-    auto frameData = reinterpret_cast<SDKANIMATION_FRAME_DATA*>(m_animData.get() + header->AnimationDataOffset);
+    auto frameData = reinterpret_cast<const SDKANIMATION_FRAME_DATA*>(m_animData.get() + header->AnimationDataOffset);
 
     m_boneToTrack.resize(model.bones.size());
     for (auto& it : m_boneToTrack)
@@ -147,14 +517,6 @@ bool AnimationSDKMESH::Bind(const Model& model)
 
     for (size_t j = 0; j < header->NumFrames; ++j)
     {
-        uint64_t offset = sizeof(SDKANIMATION_FILE_HEADER) + frameData[j].DataOffset;
-        uint64_t end = offset + sizeof(SDKANIMATION_DATA) * uint64_t(header->NumAnimationKeys);
-        if (end > UINT32_MAX
-            || end > m_animSize)
-            throw std::runtime_error("Animation file invalid");
-
-        frameData[j].pAnimationData = reinterpret_cast<SDKANIMATION_DATA*>(m_animData.get() + offset);
-
         wchar_t frameName[MAX_FRAME_NAME] = {};
         MultiByteToWideChar(CP_UTF8, 0, frameData[j].FrameName, -1, frameName, MAX_FRAME_NAME);
 
@@ -172,11 +534,75 @@ bool AnimationSDKMESH::Bind(const Model& model)
         }
     }
 
+    TranscodeTracks();
+
     m_animBones = ModelBone::MakeArray(model.bones.size());
 
     return result;
 }
 
+// Transcodes the bound tracks into SoA groups with pre-normalized orientations. The file image
+// is left unmodified so it can be saved or resampled later.
+void AnimationSDKMESH::TranscodeTracks()
+{
+    auto header = reinterpret_cast<const SDKANIMATION_FILE_HEADER*>(m_animData.get());
+    assert(header->Version == SDKMESH_FILE_VERSION);
+
+    std::vector<const SDKANIMATION_DATA*> tracks(header->NumFrames);
+    for (size_t j = 0; j < header->NumFrames; ++j)
+    {
+        tracks[j] = GetTrack(m_animData.get(), m_animSize, j);
+        if (!tracks[j])
+            throw std::runtime_error("Animation file invalid");
+    }
+
+    const size_t nbones = m_boneToTrack.size();
+    m_boneGroups = (nbones + c_BonesPerGroup - 1) / c_BonesPerGroup;
+    m_animTracks.resize(size_t(header->NumAnimationKeys) * m_boneGroups * TRACK_STRIDE);
+
+    for (size_t tick = 0; tick < header->NumAnimationKeys; ++tick)
+    {
+        for (size_t group = 0; group < m_boneGroups; ++group)
+        {
+            float values[TRACK_STRIDE][c_BonesPerGroup];
+
+            for (size_t n = 0; n < c_BonesPerGroup; ++n)
+            {
+                XMFLOAT3 translation(0.f, 0.f, 0.f);
+                XMFLOAT4 orientation(0.f, 0.f, 0.f, 1.f);
+                XMFLOAT3 scaling(1.f, 1.f, 1.f);
+
+                const size_t j = group * c_BonesPerGroup + n;
+                if (j < nbones && m_boneToTrack[j] != ModelBone::c_Invalid)
+                {
+                    auto data = &tracks[m_boneToTrack[j]][tick];
+
+                    translation = data->Translation;
+                    XMStoreFloat4(&orientation, LoadOrientation(*data));
+                    scaling = data->Scaling;
+                }
+
+                values[TRACK_TX][n] = translation.x;
+                values[TRACK_TY][n] = translation.y;
+                values[TRACK_TZ][n] = translation.z;
+                values[TRACK_QX][n] = orientation.x;
+                values[TRACK_QY][n] = orientation.y;
+                values[TRACK_QZ][n] = orientation.z;
+                values[TRACK_QW][n] = orientation.w;
+                values[TRACK_SX][n] = scaling.x;
+                values[TRACK_SY][n] = scaling.y;
+                values[TRACK_SZ][n] = scaling.z;
+            }
+
+            auto keys = &m_animTracks[(tick * m_boneGroups + group) * TRACK_STRIDE];
+            for (size_t k = 0; k < TRACK_STRIDE; ++k)
+            {
+                keys[k] = XMFLOAT4(values[k]);
+            }
+        }
+    }
+}
+
 void AnimationSDKMESH::Update(float delta)
 {
     m_animTime += static_cast<double>(delta);
@@ -190,6 +616,11 @@ void AnimationSDKMESH::Apply(
 {
     assert(m_animData && m_animSize > 0);
 
+    if (m_animTracks.empty())
+    {
+        throw std::runtime_error("Animation is not bound");
+    }
+
     if (!nbones || !boneTransforms)
     {
         throw std::invalid_argument("Bone transforms array required");
@@ -205,49 +636,203 @@ void AnimationSDKMESH::Apply(
         throw std::runtime_error("Model is missing bones");
     }
 
+    // Compute local bone transforms
+    GetLocalTransforms(model, m_animTime, m_animBones.get());
+
+    // Compute absolute locations
+    model.CopyAbsoluteBoneTransforms(nbones, m_animBones.get(), boneTransforms);
+
+    // Adjust for model's bind pose.
+    for (size_t j = 0; j < nbones; ++j)
+    {
+        boneTransforms[j] = XMMatrixMultiply(model.invBindPoseMatrices[j], boneTransforms[j]);
+    }
+}
+
+_Use_decl_annotations_
+void AnimationSDKMESH::ApplyBatch(
+    const Model& model,
+    size_t instanceCount,
+    const double* animTimes,
+    size_t nbones,
+    XMMATRIX* boneTransforms,
+    AnimationThreadPool* threadPool) const
+{
+    assert(m_animData && m_animSize > 0);
+
+    if (m_animTracks.empty())
+    {
+        throw std::runtime_error("Animation is not bound");
+    }
+
+    if (!animTimes)
+    {
+        throw std::invalid_argument("Animation times array required");
+    }
+
+    if (!instanceCount)
+        return;
+
+    EvaluateBatch(model, instanceCount, nbones, boneTransforms, threadPool,
+        [&](size_t instance, XMMATRIX* localTransforms)
+        {
+            GetLocalTransforms(model, animTimes[instance], localTransforms);
+        });
+}
+
+_Use_decl_annotations_
+void AnimationSDKMESH::GetLocalTransforms(
+    const Model& model,
+    double animTime,
+    XMMATRIX* localTransforms) const
+{
     auto header = reinterpret_cast<const SDKANIMATION_FILE_HEADER*>(m_animData.get());
     assert(header->Version == SDKMESH_FILE_VERSION);
 
     // Determine animation time
-    auto tick = static_cast<uint32_t>(static_cast<double>(header->AnimationFPS) * m_animTime);
+    const double frame = static_cast<double>(header->AnimationFPS) * animTime;
+    auto tick = static_cast<uint32_t>(frame);
     tick %= header->NumAnimationKeys;
 
-    // Compute local bone transforms
-    auto frameData = reinterpret_cast<SDKANIMATION_FRAME_DATA*>(m_animData.get() + header->AnimationDataOffset);
+    const uint32_t next = (m_interpolation == Interpolation::None) ? tick : ((tick + 1) % header->NumAnimationKeys);
+    const XMVECTOR t = XMVectorReplicate(static_cast<float>(frame - std::floor(frame)));
 
-    for (size_t j = 0; j < nbones; ++j)
+    // Compute local bone transforms, four bones at a time
+    const size_t count = std::min(model.bones.size(), m_boneToTrack.size());
+    auto keys0 = &m_animTracks[size_t(tick) * m_boneGroups * TRACK_STRIDE];
+    auto keys1 = &m_animTracks[size_t(next) * m_boneGroups * TRACK_STRIDE];
+
+    XMVECTOR keys[TRACK_STRIDE];
+    XMMATRIX local[c_BonesPerGroup];
+    for (size_t j = 0; j < count; keys0 += TRACK_STRIDE, keys1 += TRACK_STRIDE)
     {
-        if (m_boneToTrack[j] == ModelBone::c_Invalid)
+        if (m_interpolation == Interpolation::None)
+            LoadBoneGroup(keys0, keys);
+        else
+            InterpolateBoneGroup(t, keys0, keys1, m_interpolation, keys);
+
+        ComputeBoneGroup(keys, local);
+
+        for (size_t n = 0; n < c_BonesPerGroup && j < count; ++n, ++j)
         {
-            m_animBones[j] = model.boneMatrices[j];
+            localTransforms[j] = (m_boneToTrack[j] == ModelBone::c_Invalid) ? model.boneMatrices[j] : local[n];
         }
-        else
+    }
+}
+
+_Use_decl_annotations_
+HRESULT AnimationSDKMESH::Resample(uint32_t animationFPS, ResampleReport* report)
+{
+    if (report)
+    {
+        *report = {};
+    }
+
+    if (!m_animData || m_interpolation == Interpolation::None)
+        return E_UNEXPECTED;
+
+    auto header = reinterpret_cast<const SDKANIMATION_FILE_HEADER*>(m_animData.get());
+    assert(header->Version == SDKMESH_FILE_VERSION);
+
+    const uint64_t scaledKeys = uint64_t(header->NumAnimationKeys) * animationFPS;
+    if (!animationFPS
+        || animationFPS >= header->AnimationFPS
+        || (scaledKeys % header->AnimationFPS) != 0)
+        return E_INVALIDARG;
+
+    const auto keyCount = static_cast<uint32_t>(scaledKeys / header->AnimationFPS);
+
+    std::vector<const SDKANIMATION_DATA*> tracks(header->NumFrames);
+    for (size_t j = 0; j < header->NumFrames; ++j)
+    {
+        tracks[j] = GetTrack(m_animData.get(), m_animSize, j);
+        if (!tracks[j])
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+    }
+
+    // Frames immediately follow the header, then the keys for each track
+    const uint64_t framesSize = sizeof(SDKANIMATION_FRAME_DATA) * uint64_t(header->NumFrames);
+    const uint64_t trackSize = sizeof(SDKANIMATION_DATA) * uint64_t(keyCount);
+    const uint64_t dataSize = framesSize + trackSize * header->NumFrames;
+    const auto blobSize = static_cast<size_t>(sizeof(SDKANIMATION_FILE_HEADER) + dataSize);
+
+    std::unique_ptr<uint8_t[]> blob(new (std::nothrow) uint8_t[blobSize]);
+    if (!blob)
+        return E_OUTOFMEMORY;
+
+    memset(blob.get(), 0, blobSize);
+
+    auto newHeader = reinterpret_cast<SDKANIMATION_FILE_HEADER*>(blob.get());
+    *newHeader = *header;
+    newHeader->NumAnimationKeys = keyCount;
+    newHeader->AnimationFPS = animationFPS;
+    newHeader->AnimationDataSize = dataSize;
+    newHeader->AnimationDataOffset = sizeof(SDKANIMATION_FILE_HEADER);
+
+    auto frameData = reinterpret_cast<const SDKANIMATION_FRAME_DATA*>(m_animData.get() + header->AnimationDataOffset);
+    auto newFrameData = reinterpret_cast<SDKANIMATION_FRAME_DATA*>(blob.get() + sizeof(SDKANIMATION_FILE_HEADER));
+    auto newKeys = reinterpret_cast<SDKANIMATION_DATA*>(blob.get() + sizeof(SDKANIMATION_FILE_HEADER) + framesSize);
+
+    // Original keys per resampled key
+    const double step = double(header->AnimationFPS) / double(animationFPS);
+
+    float maxTranslationError = 0.f;
+    float maxRotationError = 0.f;
+    float maxScaleError = 0.f;
+
+    for (size_t j = 0; j < header->NumFrames; ++j)
+    {
+        memcpy(newFrameData[j].FrameName, frameData[j].FrameName, MAX_FRAME_NAME);
+        newFrameData[j].DataOffset = framesSize + trackSize * j;
+
+        auto track = &newKeys[size_t(keyCount) * j];
+        for (uint32_t k = 0; k < keyCount; ++k)
         {
-            auto frame = &frameData[m_boneToTrack[j]];
-            auto data = &frame->pAnimationData[tick];
+            track[k] = SampleTrack(tracks[j], header->NumAnimationKeys, double(k) * step, m_interpolation);
+        }
 
-            XMVECTOR quat = XMVectorSet(data->Orientation.x, data->Orientation.y, data->Orientation.z, data->Orientation.w);
-            if (XMVector4Equal(quat, g_XMZero))
-                quat = XMQuaternionIdentity();
-            else
-                quat = XMQuaternionNormalize(quat);
+        // Measure playback of the new track at each of the original keys
+        for (uint32_t k = 0; k < header->NumAnimationKeys; ++k)
+        {
+            const auto& original = tracks[j][k];
+            const auto sample = SampleTrack(track, keyCount, double(k) / step, m_interpolation);
 
-            XMMATRIX trans = XMMatrixTranslation(data->Translation.x, data->Translation.y, data->Translation.z);
-            XMMATRIX rotation = XMMatrixRotationQuaternion(quat);
-            XMMATRIX scale = XMMatrixScaling(data->Scaling.x, data->Scaling.y, data->Scaling.z);
+            const float translationError = XMVectorGetX(XMVector3Length(
+                XMVectorSubtract(XMLoadFloat3(&sample.Translation), XMLoadFloat3(&original.Translation))));
+            const float scaleError = XMVectorGetX(XMVector3Length(
+                XMVectorSubtract(XMLoadFloat3(&sample.Scaling), XMLoadFloat3(&original.Scaling))));
 
-            m_animBones[j] = XMMatrixMultiply(XMMatrixMultiply(rotation, scale), trans);
+            const float cosHalfAngle = std::min(1.f, std::abs(XMVectorGetX(XMVector4Dot(XMLoadFloat4(&sample.Orientation), LoadOrientation(original)))));
+            const float rotationError = 2.f * std::acos(cosHalfAngle);
+
+            maxTranslationError = std::max(maxTranslationError, translationError);
+            maxRotationError = std::max(maxRotationError, rotationError);
+            maxScaleError = std::max(maxScaleError, scaleError);
         }
     }
 
-    // Compute absolute locations
-    model.CopyAbsoluteBoneTransforms(nbones, m_animBones.get(), boneTransforms);
+    if (report)
+    {
+        report->originalKeys = header->NumAnimationKeys;
+        report->resampledKeys = keyCount;
+        report->originalSize = m_animSize;
+        report->resampledSize = blobSize;
+        report->maxTranslationError = maxTranslationError;
+        report->maxRotationError = maxRotationError;
+        report->maxScaleError = maxScaleError;
+    }
 
-    // Adjust for model's bind pose.
-    for (size_t j = 0; j < nbones; ++j)
+    m_animData.swap(blob);
+    m_animSize = blobSize;
+
+    // Frames keep their order, so an existing binding still maps the same tracks; only the
+    // transcoded keys are stale
+    if (!m_boneToTrack.empty())
     {
-        boneTransforms[j] = XMMatrixMultiply(model.invBindPoseMatrices[j], boneTransforms[j]);
+        TranscodeTracks();
     }
+
+    return S_OK;
 }
 
 
@@ -363,14 +948,43 @@ HRESULT AnimationCMO::Load(const wchar_t* fileName, size_t offset, const wchar_t
             m_startTime = clip->StartTime;
             m_endTime = clip->EndTime;
 
-            m_keys.resize(clip->keys);
+            // Split the keys into per-bone tracks, preserving file order within each track
+            uint32_t boneCount = 0;
+            for (size_t k = 0; k < clip->keys; ++k)
+            {
+                // Track offsets are indexed by bone
+                if (keys[k].BoneIndex > UINT16_MAX)
+                    return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+                boneCount = std::max(boneCount, keys[k].BoneIndex + 1);
+            }
+
+            m_trackOffsets.assign(size_t(boneCount) + 1, 0);
+            for (size_t k = 0; k < clip->keys; ++k)
+            {
+                ++m_trackOffsets[size_t(keys[k].BoneIndex) + 1];
+            }
+
+            for (size_t bone = 0; bone < boneCount; ++bone)
+            {
+                m_trackOffsets[bone + 1] += m_trackOffsets[bone];
+            }
+
+            m_keyTimes.resize(clip->keys);
+            m_trackKeys.resize(clip->keys);
             m_transforms = ModelBone::MakeArray(clip->keys);
 
+            std::vector<uint32_t> cursor(m_trackOffsets.cbegin(), m_trackOffsets.cend() - 1);
+
+            float maxTime = keys[0].Time;
             for (size_t k = 0; k < clip->keys; ++k)
             {
-                m_keys[k].first = keys[k].BoneIndex;
-                m_keys[k].second = keys[k].Time;
-                m_transforms[k] = XMLoadFloat4x4(&keys[k].Transform);
+                maxTime = std::max(maxTime, keys[k].Time);
+                m_keyTimes[k] = maxTime;
+
+                const uint32_t index = cursor[keys[k].BoneIndex]++;
+                m_trackKeys[index] = static_cast<uint32_t>(k);
+                m_transforms[index] = XMLoadFloat4x4(&keys[k].Transform);
             }
 
             return S_OK;
@@ -382,7 +996,7 @@ HRESULT AnimationCMO::Load(const wchar_t* fileName, size_t offset, const wchar_t
 
 void AnimationCMO::Bind(const Model& model)
 {
-    assert(!m_keys.empty());
+    assert(!m_keyTimes.empty());
 
     m_animBones = ModelBone::MakeArray(model.bones.size());
 }
@@ -402,7 +1016,7 @@ void AnimationCMO::Apply(
     size_t nbones,
     XMMATRIX* boneTransforms) const
 {
-    assert(!m_keys.empty());
+    assert(!m_keyTimes.empty());
 
     if (!nbones || !boneTransforms)
     {
@@ -420,31 +1034,217 @@ void AnimationCMO::Apply(
     }
 
     // Compute local bone transforms
-    model.CopyBoneTransformsTo(nbones, m_animBones.get());
+    GetLocalTransforms(model, m_animTime, m_animBones.get());
+
+    // Compute absolute locations
+    model.CopyAbsoluteBoneTransforms(nbones, m_animBones.get(), boneTransforms);
+
+    // Adjust for model's bind pose.
+    for (size_t j = 0; j < nbones; ++j)
+    {
+        boneTransforms[j] = XMMatrixMultiply(model.invBindPoseMatrices[j], boneTransforms[j]);
+    }
+}
+
+_Use_decl_annotations_
+void AnimationCMO::ApplyBatch(
+    const Model& model,
+    size_t instanceCount,
+    const float* animTimes,
+    size_t nbones,
+    XMMATRIX* boneTransforms,
+    AnimationThreadPool* threadPool) const
+{
+    assert(!m_keyTimes.empty());
+
+    if (!animTimes)
+    {
+        throw std::invalid_argument("Animation times array required");
+    }
+
+    if (!instanceCount)
+        return;
+
+    EvaluateBatch(model, instanceCount, nbones, boneTransforms, threadPool,
+        [&](size_t instance, XMMATRIX* localTransforms)
+        {
+            GetLocalTransforms(model, animTimes[instance], localTransforms);
+        });
+}
 
+_Use_decl_annotations_
+void AnimationCMO::GetLocalTransforms(
+    const Model& model,
+    float animTime,
+    XMMATRIX* localTransforms) const
+{
+    // Compute local bone transforms
+    model.CopyBoneTransformsTo(model.bones.size(), localTransforms);
 
-    // Apply keyframes
-    if (m_animTime >= m_startTime)
+    // Apply keyframes: keys are applied in file order up to the first one past the current time,
+    // so each bone takes the last key from its track that precedes that point
+    if (animTime >= m_startTime)
     {
-        size_t k = 0;
-        for (auto kit : m_keys)
+        const auto end = static_cast<uint32_t>(
+            std::upper_bound(m_keyTimes.cbegin(), m_keyTimes.cend(), animTime) - m_keyTimes.cbegin());
+
+        const size_t count = std::min(m_trackOffsets.size() - 1, model.bones.size());
+        for (size_t bone = 0; bone < count; ++bone)
         {
-            if (kit.second > m_animTime)
+            auto first = m_trackKeys.cbegin() + m_trackOffsets[bone];
+            auto last = m_trackKeys.cbegin() + m_trackOffsets[bone + 1];
+
+            auto it = std::lower_bound(first, last, end);
+            if (it != first)
             {
-                break;
+                localTransforms[bone] = m_transforms[static_cast<size_t>(it - m_trackKeys.cbegin()) - 1];
             }
+        }
+    }
+}
+
 
-            m_animBones[kit.first] = m_transforms[k];
-            ++k;
+//--------------------------------------------------------------------------------------
+// Thread pool for batched evaluation
+//--------------------------------------------------------------------------------------
+AnimationThreadPool::AnimationThreadPool(size_t threadCount) :
+    m_func(nullptr),
+    m_count(0),
+    m_grain(1),
+    m_next(0),
+    m_busy(0),
+    m_generation(0),
+    m_shutdown(false)
+{
+    if (!threadCount)
+    {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    // The thread calling ParallelFor does its share of the work
+    m_workers.reserve(threadCount - 1);
+    try
+    {
+        for (size_t j = 1; j < threadCount; ++j)
+        {
+            m_workers.emplace_back(&AnimationThreadPool::WorkerThread, this);
         }
     }
+    catch (...)
+    {
+        // The destructor won't run, so stop and join the workers already started here
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_shutdown = true;
+        }
+        m_wake.notify_all();
 
-    // Compute absolute locations
-    model.CopyAbsoluteBoneTransforms(nbones, m_animBones.get(), boneTransforms);
+        for (auto& it : m_workers)
+        {
+            it.join();
+        }
+        throw;
+    }
+}
 
-    // Adjust for model's bind pose.
-    for (size_t j = 0; j < nbones; ++j)
+AnimationThreadPool::~AnimationThreadPool()
+{
     {
-        boneTransforms[j] = XMMatrixMultiply(model.invBindPoseMatrices[j], boneTransforms[j]);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& it : m_workers)
+    {
+        it.join();
+    }
+}
+
+void AnimationThreadPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& func)
+{
+    if (!count)
+        return;
+
+    grain = std::max<size_t>(1, grain);
+
+    if (m_workers.empty() || count <= grain)
+    {
+        func(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_func = &func;
+        m_count = count;
+        m_grain = grain;
+        m_next = 0;
+        m_busy = m_workers.size();
+        m_error = nullptr;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    RunChunks();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busy == 0; });
+        m_func = nullptr;
+        std::swap(error, m_error);
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void AnimationThreadPool::WorkerThread()
+{
+    uint64_t generation = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_shutdown || m_generation != generation; });
+            if (m_shutdown)
+                return;
+
+            generation = m_generation;
+        }
+
+        RunChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busy;
+        }
+        m_done.notify_one();
+    }
+}
+
+void AnimationThreadPool::RunChunks() noexcept
+{
+    for (;;)
+    {
+        const size_t begin = m_next.fetch_add(m_grain);
+        if (begin >= m_count)
+            break;
+
+        try
+        {
+            (*m_func)(begin, std::min(begin + m_grain, m_count));
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error)
+            {
+                m_error = std::current_exception();
+            }
+        }
     }
 }
@@ -11,16 +11,79 @@
 #include <DirectXMath.h>
 #include <Model.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
 
 
 namespace DX
 {
+    // Persistent worker threads for evaluating batches of animation instances
+    class AnimationThreadPool
+    {
+    public:
+        // A threadCount of 0 uses one thread per hardware thread. The calling thread counts as one.
+        explicit AnimationThreadPool(size_t threadCount = 0);
+        ~AnimationThreadPool();
+
+        AnimationThreadPool(AnimationThreadPool&&) = delete;
+        AnimationThreadPool& operator= (AnimationThreadPool&&) = delete;
+
+        AnimationThreadPool(AnimationThreadPool const&) = delete;
+        AnimationThreadPool& operator= (AnimationThreadPool const&) = delete;
+
+        size_t GetThreadCount() const noexcept { return m_workers.size() + 1; }
+
+        // Calls func(begin, end) for chunks of up to 'grain' items covering [0, count), and returns once
+        // all chunks are done. The first exception thrown by func is rethrown. Not reentrant.
+        void ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& func);
+
+    private:
+        void WorkerThread();
+        void RunChunks() noexcept;
+
+        std::vector<std::thread>                        m_workers;
+        std::mutex                                      m_mutex;
+        std::condition_variable                         m_wake;
+        std::condition_variable                         m_done;
+        const std::function<void(size_t, size_t)>*      m_func;
+        size_t                                          m_count;
+        size_t                                          m_grain;
+        std::atomic<size_t>                             m_next;
+        size_t                                          m_busy;
+        uint64_t                                        m_generation;
+        bool                                            m_shutdown;
+        std::exception_ptr                              m_error;
+    };
+
     class AnimationSDKMESH
     {
     public:
+        enum class Interpolation : uint32_t
+        {
+            None = 0,       // Snap to the nearest preceding key
+            Linear,         // Lerp translation/scale, nlerp orientation
+            Spherical,      // Lerp translation/scale, slerp orientation
+        };
+
+        struct ResampleReport
+        {
+            uint32_t    originalKeys;
+            uint32_t    resampledKeys;
+            size_t      originalSize;
+            size_t      resampledSize;
+            float       maxTranslationError;
+            float       maxRotationError;       // radians
+            float       maxScaleError;
+        };
+
         AnimationSDKMESH() noexcept;
         ~AnimationSDKMESH() = default;
 
@@ -31,6 +94,7 @@ namespace DX
         AnimationSDKMESH& operator= (AnimationSDKMESH const&) = delete;
 
         HRESULT Load(_In_z_ const wchar_t* fileName);
+        HRESULT Save(_In_z_ const wchar_t* fileName) const;
 
         void Release()
         {
@@ -38,23 +102,57 @@ namespace DX
             m_animSize = 0;
             m_animData.reset();
             m_boneToTrack.clear();
+            m_animTracks.clear();
+            m_boneGroups = 0;
             m_animBones.reset();
         }
 
+        // Maps the animation tracks to the model's bones, and transcodes the keys into the
+        // structure-of-arrays layout used by Apply.
         bool Bind(const DirectX::Model& model);
 
         void Update(float delta);
 
+        void SetInterpolation(Interpolation mode) noexcept { m_interpolation = mode; }
+        Interpolation GetInterpolation() const noexcept { return m_interpolation; }
+
+        // Rebakes every track at a lower AnimationFPS using the current interpolation mode, and
+        // reports the playback error against the original keys. The clip duration must be
+        // preserved exactly, so NumAnimationKeys * animationFPS must be a multiple of the original
+        // AnimationFPS. An existing binding is kept and its keys are transcoded again.
+        HRESULT Resample(uint32_t animationFPS, _Out_opt_ ResampleReport* report = nullptr);
+
         void Apply(
             const DirectX::Model& model,
             size_t nbones,
             _Out_writes_(nbones) DirectX::XMMATRIX* boneTransforms) const;
 
+        // Evaluates many instances of the clip in one call, each at its own time as accumulated
+        // by Update, writing instance i to boneTransforms[i * nbones]. Does not use or change the
+        // object's own playback time.
+        void ApplyBatch(
+            const DirectX::Model& model,
+            size_t instanceCount,
+            _In_reads_(instanceCount) const double* animTimes,
+            size_t nbones,
+            _Out_writes_(instanceCount * nbones) DirectX::XMMATRIX* boneTransforms,
+            _In_opt_ AnimationThreadPool* threadPool = nullptr) const;
+
     private:
+        void TranscodeTracks();
+
+        void GetLocalTransforms(
+            const DirectX::Model& model,
+            double animTime,
+            _Out_writes_(model.bones.size()) DirectX::XMMATRIX* localTransforms) const;
+
         double                              m_animTime;
+        Interpolation                       m_interpolation;
         std::unique_ptr<uint8_t[]>          m_animData;
         size_t                              m_animSize;
         std::vector<uint32_t>               m_boneToTrack;
+        std::vector<DirectX::XMFLOAT4>      m_animTracks;
+        size_t                              m_boneGroups;
         DirectX::ModelBone::TransformArray  m_animBones;
     };
 
@@ -75,7 +173,9 @@ namespace DX
         void Release()
         {
             m_animTime = m_startTime = m_endTime = 0.f;
-            m_keys.clear();
+            m_keyTimes.clear();
+            m_trackOffsets.clear();
+            m_trackKeys.clear();
             m_transforms.reset();
             m_animBones.reset();
         }
@@ -89,14 +189,30 @@ namespace DX
             size_t nbones,
             _Out_writes_(nbones) DirectX::XMMATRIX* boneTransforms) const;
 
+        // Evaluates many instances of the clip in one call, each at its own time in [0, end time]
+        // as maintained by Update, writing instance i to boneTransforms[i * nbones]. Does not use
+        // or change the object's own playback time.
+        void ApplyBatch(
+            const DirectX::Model& model,
+            size_t instanceCount,
+            _In_reads_(instanceCount) const float* animTimes,
+            size_t nbones,
+            _Out_writes_(instanceCount * nbones) DirectX::XMMATRIX* boneTransforms,
+            _In_opt_ AnimationThreadPool* threadPool = nullptr) const;
+
     private:
-        using Key = std::pair<uint32_t, float>;
+        void GetLocalTransforms(
+            const DirectX::Model& model,
+            float animTime,
+            _Out_writes_(model.bones.size()) DirectX::XMMATRIX* localTransforms) const;
 
         float                               m_animTime;
         float                               m_startTime;
         float                               m_endTime;
-        std::vector<Key>                    m_keys;
-        DirectX::ModelBone::TransformArray  m_transforms;
+        std::vector<float>                  m_keyTimes;         // Running maximum of key times in file order
+        std::vector<uint32_t>               m_trackOffsets;     // Start of each bone's track in m_trackKeys
+        std::vector<uint32_t>               m_trackKeys;        // File order key indices, grouped by bone
+        DirectX::ModelBone::TransformArray  m_transforms;       // Key transforms, in m_trackKeys order
         DirectX::ModelBone::TransformArray  m_animBones;
     };
 }
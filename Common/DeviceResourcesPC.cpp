@@ -65,6 +65,7 @@ namespace
 bool DeviceResources::s_debugForceWarp = false;
 bool DeviceResources::s_debugPreferMinPower = false;
 int DeviceResources::s_debugAdapterOrdinal = -1;
+bool DeviceResources::s_debugSkipPresent = false;
 
 // Constructor for DeviceResources.
 DeviceResources::DeviceResources(
@@ -491,6 +492,13 @@ void DeviceResources::HandleDeviceLost()
 void DeviceResources::Present()
 {
     HRESULT hr = E_FAIL;
+    if (s_debugSkipPresent)
+    {
+        // Submit the frame's work without waiting on the display, for CPU benchmarking.
+        m_d3dContext->Flush();
+        hr = S_OK;
+    }
+    else
 #ifdef __dxgi1_5_h__
     if (m_options & c_AllowTearing)
     {
@@ -104,6 +104,11 @@ namespace DX
             s_debugAdapterOrdinal = adapter;
         }
 
+        static void DebugSkipPresent(bool enable) noexcept
+        {
+            s_debugSkipPresent = enable;
+        }
+
     private:
         void CreateFactory();
         void GetHardwareAdapter(IDXGIAdapter1** ppAdapter);
@@ -148,5 +153,6 @@ namespace DX
         static bool s_debugForceWarp;
         static bool s_debugPreferMinPower;
         static int s_debugAdapterOrdinal;
+        static bool s_debugSkipPresent;
     };
 }
@@ -0,0 +1,172 @@
+//
+// FrameBenchmark.h - Per-phase frame timing for the -benchmark test mode
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+#include "FrameStatistics.h"
+
+
+namespace DX
+{
+    // Collects the time spent in each phase of a fixed number of frames, after discarding a
+    // warm-up window. Times are in the caller's clock counts, converted to milliseconds for
+    // the report.
+    class FrameBenchmark
+    {
+    public:
+        enum Phase : unsigned int
+        {
+            PHASE_UPDATE = 0,
+            PHASE_RENDER,
+            PHASE_FRAME,
+            PHASE_COUNT
+        };
+
+        FrameBenchmark(uint32_t warmupFrames, uint32_t frames, uint64_t countsPerSecond) noexcept :
+            m_warmupFrames(warmupFrames),
+            m_frames(frames),
+            m_countsPerSecond(countsPerSecond ? countsPerSecond : 1),
+            m_seenFrames(0),
+            m_recordedFrames(0),
+            m_cpuStart(0.0),
+            m_cpuTime(0.0)
+        {
+            if (!warmupFrames)
+            {
+                m_cpuStart = ThreadCPUSeconds();
+            }
+        }
+
+        FrameBenchmark(FrameBenchmark&&) = default;
+        FrameBenchmark& operator= (FrameBenchmark&&) = default;
+
+        FrameBenchmark(FrameBenchmark const&) = delete;
+        FrameBenchmark& operator= (FrameBenchmark const&) = delete;
+
+        // Returns true once the last frame has been recorded.
+        bool RecordFrame(uint64_t updateCounts, uint64_t renderCounts) noexcept
+        {
+            if (IsComplete())
+                return true;
+
+            if (m_seenFrames++ < m_warmupFrames)
+            {
+                if (m_seenFrames == m_warmupFrames)
+                {
+                    m_cpuStart = ThreadCPUSeconds();
+                }
+                return false;
+            }
+
+            m_phases[PHASE_UPDATE].Record(updateCounts);
+            m_phases[PHASE_RENDER].Record(renderCounts);
+            m_phases[PHASE_FRAME].Record(updateCounts + renderCounts);
+
+            if (++m_recordedFrames >= m_frames)
+            {
+                m_cpuTime = ThreadCPUSeconds() - m_cpuStart;
+                return true;
+            }
+
+            return false;
+        }
+
+        bool IsComplete() const noexcept { return m_recordedFrames >= m_frames; }
+        uint32_t GetRecordedFrames() const noexcept { return m_recordedFrames; }
+
+        const FrameHistogram& GetPhase(Phase phase) const noexcept { return m_phases[phase]; }
+
+        // CPU time used by the recording thread over the measured frames, in seconds.
+        double GetThreadCPUTime() const noexcept { return m_cpuTime; }
+
+        double ToMilliseconds(uint64_t counts) const noexcept { return double(counts) * 1000.0 / double(m_countsPerSecond); }
+
+        // Writes the report as JSON. 'name' and 'stepMS' describe the run.
+        bool WriteJson(FILE* file, const char* name, double stepMS) const noexcept
+        {
+            if (!file)
+                return false;
+
+            fprintf(file, "{\n  \"name\": \"");
+            for (const char* ch = name ? name : ""; *ch; ++ch)
+            {
+                if (*ch == '"' || *ch == '\\')
+                {
+                    fputc('\\', file);
+                    fputc(*ch, file);
+                }
+                else if (static_cast<unsigned char>(*ch) < 0x20)
+                {
+                    fprintf(file, "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(*ch)));
+                }
+                else
+                {
+                    fputc(*ch, file);
+                }
+            }
+            fprintf(file, "\",\n");
+
+            fprintf(file, "  \"warmup_frames\": %u,\n  \"frames\": %u,\n  \"step_ms\": %.4f,\n  \"thread_cpu_ms\": %.4f,\n  \"phases\": {\n",
+                m_warmupFrames, m_recordedFrames, stepMS, m_cpuTime * 1000.0);
+
+            static const char* const s_names[PHASE_COUNT] = { "update", "render", "frame" };
+            for (unsigned int j = 0; j < PHASE_COUNT; ++j)
+            {
+                const auto& it = m_phases[j];
+                fprintf(file, "    \"%s\": { \"total_ms\": %.4f, \"mean_ms\": %.4f, \"min_ms\": %.4f, \"p50_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f }%s\n",
+                    s_names[j],
+                    ToMilliseconds(it.GetTotal()),
+                    it.GetMean() * 1000.0 / double(m_countsPerSecond),
+                    ToMilliseconds(it.GetMin()),
+                    ToMilliseconds(it.GetPercentile(50.0)),
+                    ToMilliseconds(it.GetPercentile(95.0)),
+                    ToMilliseconds(it.GetPercentile(99.0)),
+                    ToMilliseconds(it.GetMax()),
+                    (j + 1 < PHASE_COUNT) ? "," : "");
+            }
+
+            fprintf(file, "  }\n}\n");
+
+            return !ferror(file);
+        }
+
+        static double ThreadCPUSeconds() noexcept
+        {
+        #ifdef _WIN32
+            FILETIME creation, exitTime, kernel, user;
+            if (!GetThreadTimes(GetCurrentThread(), &creation, &exitTime, &kernel, &user))
+                return 0.0;
+
+            const uint64_t k = (uint64_t(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+            const uint64_t u = (uint64_t(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+            return double(k + u) / 10000000.0;
+        #else
+            timespec ts = {};
+            if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+                return 0.0;
+
+            return double(ts.tv_sec) + double(ts.tv_nsec) / 1000000000.0;
+        #endif
+        }
+
+    private:
+        uint32_t m_warmupFrames;
+        uint32_t m_frames;
+        uint64_t m_countsPerSecond;
+        uint32_t m_seenFrames;
+        uint32_t m_recordedFrames;
+        double m_cpuStart;
+        double m_cpuTime;
+
+        FrameHistogram m_phases[PHASE_COUNT];
+    };
+}
@@ -0,0 +1,185 @@
+//
+// FrameStatistics.h - Frame time distribution recorded by StepTimer
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#endif
+
+
+namespace DX
+{
+    // Log-linear histogram of tick counts in fixed memory. Each power of two is split into
+    // SubBuckets linear buckets, so a reported value is within 1/SubBuckets of the true one.
+    class FrameHistogram
+    {
+    public:
+        static constexpr unsigned int SubBucketBits = 4;
+        static constexpr unsigned int SubBuckets = 1u << SubBucketBits;
+        static constexpr size_t BucketCount = (64 - SubBucketBits + 1) * SubBuckets;
+
+        FrameHistogram() noexcept { Reset(); }
+
+        void Reset() noexcept
+        {
+            for (auto& it : m_counts)
+            {
+                it = 0;
+            }
+
+            m_count = 0;
+            m_total = 0;
+            m_min = UINT64_MAX;
+            m_max = 0;
+        }
+
+        void Record(uint64_t value) noexcept
+        {
+            ++m_counts[BucketIndex(value)];
+            ++m_count;
+            m_total += value;
+
+            if (value < m_min)
+                m_min = value;
+            if (value > m_max)
+                m_max = value;
+        }
+
+        uint64_t GetCount() const noexcept { return m_count; }
+        uint64_t GetTotal() const noexcept { return m_total; }
+        uint64_t GetMin() const noexcept { return m_count ? m_min : 0; }
+        uint64_t GetMax() const noexcept { return m_max; }
+        double GetMean() const noexcept { return m_count ? double(m_total) / double(m_count) : 0.0; }
+
+        // Smallest recorded value that at least 'percentile' percent of the values are at or
+        // below, rounded up to the top of its bucket.
+        uint64_t GetPercentile(double percentile) const noexcept
+        {
+            if (!m_count)
+                return 0;
+
+            if (percentile <= 0.0)
+                return GetMin();
+
+            auto rank = static_cast<uint64_t>(std::ceil(percentile * double(m_count) / 100.0));
+            if (rank < 1)
+                rank = 1;
+            if (rank >= m_count)
+                return m_max;
+
+            uint64_t seen = 0;
+            for (size_t j = 0; j < BucketCount; ++j)
+            {
+                seen += m_counts[j];
+                if (seen >= rank)
+                {
+                    const uint64_t value = BucketUpperBound(j);
+                    return (value > m_max) ? m_max : ((value < m_min) ? m_min : value);
+                }
+            }
+
+            return m_max;
+        }
+
+        static size_t BucketIndex(uint64_t value) noexcept
+        {
+            if (value < SubBuckets)
+                return static_cast<size_t>(value);
+
+            const unsigned int shift = HighestBit(value) - SubBucketBits;
+            return static_cast<size_t>(shift + 1) * SubBuckets + static_cast<size_t>((value >> shift) - SubBuckets);
+        }
+
+        static uint64_t BucketLowerBound(size_t index) noexcept
+        {
+            if (index < SubBuckets)
+                return index;
+
+            const auto shift = static_cast<unsigned int>(index / SubBuckets - 1);
+            return (uint64_t(SubBuckets) + uint64_t(index % SubBuckets)) << shift;
+        }
+
+        static uint64_t BucketUpperBound(size_t index) noexcept
+        {
+            if (index < SubBuckets)
+                return index;
+
+            const auto shift = static_cast<unsigned int>(index / SubBuckets - 1);
+            return BucketLowerBound(index) + ((uint64_t(1) << shift) - 1);
+        }
+
+    private:
+        static unsigned int HighestBit(uint64_t value) noexcept
+        {
+        #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+            unsigned long index = 0;
+            _BitScanReverse64(&index, value);
+            return static_cast<unsigned int>(index);
+        #elif defined(__GNUC__) || defined(__clang__)
+            return 63u - static_cast<unsigned int>(__builtin_clzll(value));
+        #else
+            unsigned int index = 0;
+            while (value >>= 1)
+            {
+                ++index;
+            }
+            return index;
+        #endif
+        }
+
+        uint32_t m_counts[BucketCount];
+        uint64_t m_count;
+        uint64_t m_total;
+        uint64_t m_min;
+        uint64_t m_max;
+    };
+
+    // What StepTimer records per Tick when statistics are enabled, in its canonical ticks.
+    struct FrameStatistics
+    {
+        // Time between Ticks, before StepTimer clamps large deltas
+        FrameHistogram frameTimes;
+
+        // Fixed timestep updates run after the first one in a Tick, to catch up with the clock
+        uint64_t catchUpUpdates;
+
+        // Fixed timestep updates never run, because the delta was clamped
+        uint64_t droppedUpdates;
+
+        // Ticks with a delta large enough to be clamped
+        uint64_t clampedFrames;
+
+        FrameStatistics() noexcept : catchUpUpdates(0), droppedUpdates(0), clampedFrames(0) {}
+
+        void Reset() noexcept
+        {
+            frameTimes.Reset();
+            catchUpUpdates = droppedUpdates = clampedFrames = 0;
+        }
+
+        // One line summary with times in milliseconds
+        int Format(char* buffer, size_t count, uint64_t ticksPerSecond) const noexcept
+        {
+            const double toMS = 1000.0 / double(ticksPerSecond);
+            return snprintf(buffer, count,
+                "%llu frames, mean %.2f ms, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms;"
+                " %llu catch-up updates, %llu dropped updates, %llu clamped frames",
+                static_cast<unsigned long long>(frameTimes.GetCount()),
+                frameTimes.GetMean() * toMS,
+                double(frameTimes.GetPercentile(50.0)) * toMS,
+                double(frameTimes.GetPercentile(95.0)) * toMS,
+                double(frameTimes.GetPercentile(99.0)) * toMS,
+                double(frameTimes.GetMax()) * toMS,
+                static_cast<unsigned long long>(catchUpUpdates),
+                static_cast<unsigned long long>(droppedUpdates),
+                static_cast<unsigned long long>(clampedFrames));
+        }
+    };
+}
@@ -5,6 +5,8 @@
 #include "pch.h"
 #include "Game.h"
 
+#include "FrameBenchmark.h"
+
 #pragma warning(push)
 #pragma warning(disable : 4265)
 #include <wrl/wrappers/corewrappers.h>
@@ -30,6 +32,11 @@ namespace
     std::unique_ptr<Game> g_game;
     bool g_testTimer = false;
 
+    // -benchmark:<frames> [-warmup:<frames>] [-report:<file>]
+    uint32_t g_benchmarkFrames = 0;
+    uint32_t g_benchmarkWarmup = 60;
+    wchar_t g_benchmarkReport[MAX_PATH] = L"benchmark.json";
+
 #ifdef WM_DEVICECHANGE
     HDEVNOTIFY g_hNewAudio;
 #endif
@@ -38,6 +45,7 @@ namespace
 LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 void ExitGame() noexcept;
 void ParseCommandLine(_In_ LPWSTR lpCmdLine);
+void BenchmarkFrame(DX::FrameBenchmark& benchmark);
 
 // Indicates to hybrid graphics systems to prefer the discrete part by default
 extern "C"
@@ -115,7 +123,7 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         if (!hwnd)
             return 1;
 
-        ShowWindow(hwnd, nCmdShow);
+        ShowWindow(hwnd, g_benchmarkFrames ? SW_HIDE : nCmdShow);
 
         GetClientRect(hwnd, &rc);
 
@@ -136,6 +144,12 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 #endif
     }
 
+    std::unique_ptr<DX::FrameBenchmark> benchmark;
+    if (g_benchmarkFrames > 0)
+    {
+        benchmark = std::make_unique<DX::FrameBenchmark>(g_benchmarkWarmup, g_benchmarkFrames, DX::QPCClock::GetFrequency());
+    }
+
     // Main message loop
     MSG msg = {};
     while (WM_QUIT != msg.message)
@@ -145,6 +159,13 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
             TranslateMessage(&msg);
             DispatchMessage(&msg);
         }
+        else if (benchmark)
+        {
+            if (!benchmark->IsComplete())
+            {
+                BenchmarkFrame(*benchmark);
+            }
+        }
         else
         {
             g_game->Tick();
@@ -436,6 +457,25 @@ void ParseCommandLine(_In_ LPWSTR lpCmdLine)
             if (_wcsicmp(pArg, L"ctest") == 0)
             {
                 g_testTimer = true;
+                DX::StepTimer::SetStatisticsReport(true);
+            }
+            else if (_wcsicmp(pArg, L"benchmark") == 0)
+            {
+                g_benchmarkFrames = (pValue && *pValue != 0) ? static_cast<uint32_t>(_wtoi(pValue)) : 600;
+            }
+            else if (_wcsicmp(pArg, L"warmup") == 0)
+            {
+                if (pValue && *pValue != 0)
+                {
+                    g_benchmarkWarmup = static_cast<uint32_t>(_wtoi(pValue));
+                }
+            }
+            else if (_wcsicmp(pArg, L"report") == 0)
+            {
+                if (pValue && *pValue != 0)
+                {
+                    wcscpy_s(g_benchmarkReport, pValue);
+                }
             }
             else if (_wcsicmp(pArg, L"forcewarp") == 0)
             {
@@ -456,6 +496,58 @@ void ParseCommandLine(_In_ LPWSTR lpCmdLine)
     }
 
     LocalFree(argv);
+
+    if (g_benchmarkFrames > 0)
+    {
+        // Every frame is one fixed 60 Hz step and skips the display, so runs are repeatable
+        DX::StepTimer::SetBenchmarkStep(DX::StepTimer::TicksPerSecond / 60);
+        DX::DeviceResources::DebugSkipPresent(true);
+    }
+}
+
+// Runs and times one frame, writing the report and exiting after the last one
+void BenchmarkFrame(DX::FrameBenchmark& benchmark)
+{
+    const uint64_t updateTime = DX::StepTimer::GetBenchmarkUpdateTime();
+    const uint64_t start = DX::QPCClock::GetCounter();
+
+    g_game->Tick();
+
+    const uint64_t frameTime = DX::QPCClock::GetCounter() - start;
+    const uint64_t updated = std::min(DX::StepTimer::GetBenchmarkUpdateTime() - updateTime, frameTime);
+
+    if (!benchmark.RecordFrame(updated, frameTime - updated))
+        return;
+
+    char name[256] = {};
+    std::ignore = WideCharToMultiByte(CP_UTF8, 0, g_game->GetAppName(), -1, name, static_cast<int>(sizeof(name) - 1), nullptr, nullptr);
+
+    const double stepMS = double(DX::StepTimer::GetBenchmarkStep()) * 1000.0 / double(DX::StepTimer::TicksPerSecond);
+
+    bool success = false;
+    FILE* file = nullptr;
+    if (!_wfopen_s(&file, g_benchmarkReport, L"wt") && file)
+    {
+        success = benchmark.WriteJson(file, name, stepMS);
+        success = (fclose(file) == 0) && success;
+    }
+
+    const auto& frame = benchmark.GetPhase(DX::FrameBenchmark::PHASE_FRAME);
+    printf("%s: %u frames, update %.3f ms, render %.3f ms, frame p50 %.3f ms p99 %.3f ms\n",
+        name, benchmark.GetRecordedFrames(),
+        benchmark.ToMilliseconds(benchmark.GetPhase(DX::FrameBenchmark::PHASE_UPDATE).GetTotal()) / benchmark.GetRecordedFrames(),
+        benchmark.ToMilliseconds(benchmark.GetPhase(DX::FrameBenchmark::PHASE_RENDER).GetTotal()) / benchmark.GetRecordedFrames(),
+        benchmark.ToMilliseconds(frame.GetPercentile(50.0)),
+        benchmark.ToMilliseconds(frame.GetPercentile(99.0)));
+
+    if (!success)
+    {
+        printf("ERROR: Failed writing benchmark report:\n%ls\n", g_benchmarkReport);
+    }
+
+    fflush(stdout);
+
+    PostQuitMessage(success ? 0 : 1);
 }
 
 // Exit helper
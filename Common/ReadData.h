@@ -12,12 +12,20 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <fstream>
+#include <future>
+#include <memory>
 #include <stdexcept>
+#include <string>
 #include <system_error>
+#include <thread>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 
@@ -70,4 +78,258 @@ namespace DX
 
         return blob;
     }
+
+
+    //----------------------------------------------------------------------------------
+    // Variants for loading many blobs at startup, which skip the zero-fill and copy ReadData
+    // does. These use the same CWD-then-EXE-folder search.
+
+    namespace Internal
+    {
+        struct handle_closer { void operator()(HANDLE h) noexcept { if (h && h != INVALID_HANDLE_VALUE) CloseHandle(h); } };
+
+        using ScopedHandle = std::unique_ptr<void, handle_closer>;
+
+        inline HANDLE OpenDataFileW(_In_z_ const wchar_t* name) noexcept
+        {
+        #if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+            CREATEFILE2_EXTENDED_PARAMETERS params = { sizeof(CREATEFILE2_EXTENDED_PARAMETERS), 0, 0, 0, {} };
+            params.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+            params.dwFileFlags = FILE_FLAG_SEQUENTIAL_SCAN;
+            return CreateFile2(name, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, &params);
+        #else
+            return CreateFileW(name, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        #endif
+        }
+
+        inline ScopedHandle OpenDataFile(_In_z_ const wchar_t* name, _Out_ size_t& size)
+        {
+            HANDLE hFile = OpenDataFileW(name);
+
+        #if !defined(WINAPI_FAMILY) || (WINAPI_FAMILY == WINAPI_FAMILY_DESKTOP_APP)
+            if (hFile == INVALID_HANDLE_VALUE)
+            {
+                wchar_t moduleName[_MAX_PATH] = {};
+                if (!GetModuleFileNameW(nullptr, moduleName, _MAX_PATH))
+                    throw std::system_error(std::error_code(static_cast<int>(GetLastError()), std::system_category()), "GetModuleFileNameW");
+
+                wchar_t drive[_MAX_DRIVE];
+                wchar_t path[_MAX_PATH];
+
+                if (_wsplitpath_s(moduleName, drive, _MAX_DRIVE, path, _MAX_PATH, nullptr, 0, nullptr, 0))
+                    throw std::runtime_error("_wsplitpath_s");
+
+                wchar_t filename[_MAX_PATH];
+                if (_wmakepath_s(filename, _MAX_PATH, drive, path, name, nullptr))
+                    throw std::runtime_error("_wmakepath_s");
+
+                hFile = OpenDataFileW(filename);
+            }
+        #endif
+
+            if (hFile == INVALID_HANDLE_VALUE)
+                throw std::system_error(std::error_code(static_cast<int>(GetLastError()), std::system_category()), "ReadData");
+
+            ScopedHandle file(hFile);
+
+            LARGE_INTEGER fileSize = {};
+            if (!GetFileSizeEx(hFile, &fileSize))
+                throw std::system_error(std::error_code(static_cast<int>(GetLastError()), std::system_category()), "GetFileSizeEx");
+
+        #if defined(_WIN64)
+            size = static_cast<size_t>(fileSize.QuadPart);
+        #else
+            if (fileSize.HighPart > 0)
+                throw std::runtime_error("ReadData");
+            size = fileSize.LowPart;
+        #endif
+
+            return file;
+        }
+    }
+
+    // Contents of a file in a heap buffer that isn't zeroed before the read
+    struct DataBlob
+    {
+        std::unique_ptr<uint8_t[]>  data;
+        size_t                      size;
+    };
+
+    inline DataBlob ReadDataUninitialized(_In_z_ const wchar_t* name)
+    {
+        DataBlob blob = {};
+        auto file = Internal::OpenDataFile(name, blob.size);
+
+        // Default-initialized, unlike std::make_unique<uint8_t[]> or std::vector::resize
+        blob.data.reset(new uint8_t[std::max<size_t>(blob.size, 1)]);
+
+        size_t offset = 0;
+        while (offset < blob.size)
+        {
+            const DWORD request = static_cast<DWORD>(std::min<size_t>(blob.size - offset, 0x40000000));
+            DWORD bytesRead = 0;
+            if (!ReadFile(file.get(), blob.data.get() + offset, request, &bytesRead, nullptr))
+                throw std::system_error(std::error_code(static_cast<int>(GetLastError()), std::system_category()), "ReadFile");
+
+            if (!bytesRead)
+                throw std::runtime_error("ReadData");
+
+            offset += bytesRead;
+        }
+
+        return blob;
+    }
+
+    // Read-only view of a whole file, valid for the lifetime of the object
+    class MappedData
+    {
+    public:
+        MappedData() noexcept : m_data(nullptr), m_size(0) {}
+
+        // Takes ownership of a view returned by MapViewOfFile
+        MappedData(_In_opt_ const void* view, size_t size) noexcept :
+            m_data(static_cast<const uint8_t*>(view)),
+            m_size(view ? size : 0)
+        {
+        }
+
+        MappedData(MappedData&& other) noexcept :
+            m_data(std::exchange(other.m_data, nullptr)),
+            m_size(std::exchange(other.m_size, 0))
+        {
+        }
+
+        MappedData& operator= (MappedData&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            }
+            return *this;
+        }
+
+        MappedData(MappedData const&) = delete;
+        MappedData& operator= (MappedData const&) = delete;
+
+        ~MappedData() { Reset(); }
+
+        const uint8_t* data() const noexcept { return m_data; }
+        size_t size() const noexcept { return m_size; }
+
+    private:
+        void Reset() noexcept
+        {
+            if (m_data)
+            {
+                std::ignore = UnmapViewOfFile(m_data);
+                m_data = nullptr;
+                m_size = 0;
+            }
+        }
+
+        const uint8_t*  m_data;
+        size_t          m_size;
+    };
+
+    inline MappedData MapData(_In_z_ const wchar_t* name)
+    {
+        size_t size = 0;
+        auto file = Internal::OpenDataFile(name, size);
+
+        // Empty files can't be mapped, but are still valid data
+        if (!size)
+            return MappedData();
+
+        // The view keeps the file mapping alive after both handles are closed
+    #if !defined(WINAPI_FAMILY) || (WINAPI_FAMILY == WINAPI_FAMILY_DESKTOP_APP)
+        Internal::ScopedHandle mapping(CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+    #else
+        Internal::ScopedHandle mapping(CreateFileMappingFromApp(file.get(), nullptr, PAGE_READONLY, 0, nullptr));
+    #endif
+        if (!mapping)
+            throw std::system_error(std::error_code(static_cast<int>(GetLastError()), std::system_category()), "CreateFileMapping");
+
+    #if !defined(WINAPI_FAMILY) || (WINAPI_FAMILY == WINAPI_FAMILY_DESKTOP_APP)
+        const void* view = MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0);
+    #else
+        const void* view = MapViewOfFileFromApp(mapping.get(), FILE_MAP_READ, 0, 0);
+    #endif
+        if (!view)
+            throw std::system_error(std::error_code(static_cast<int>(GetLastError()), std::system_category()), "MapViewOfFile");
+
+        return MappedData(view, size);
+    }
+
+    // Starts reading the files on a few threads and returns at once, so the caller can do other
+    // setup while they load. Results are in the order of 'names', and get() rethrows the first
+    // failure.
+    inline std::future<std::vector<DataBlob>> ReadDataAsync(std::vector<std::wstring> names, size_t maxThreads = 0)
+    {
+        if (!maxThreads)
+        {
+            maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        return std::async(std::launch::async, [names = std::move(names), maxThreads]()
+            {
+                std::vector<DataBlob> blobs(names.size());
+
+                std::atomic<size_t> next(0);
+                std::exception_ptr error;
+                std::atomic<bool> failed(false);
+
+                auto worker = [&]()
+                    {
+                        for (size_t j = next++; j < names.size() && !failed; j = next++)
+                        {
+                            try
+                            {
+                                blobs[j] = ReadDataUninitialized(names[j].c_str());
+                            }
+                            catch (...)
+                            {
+                                if (!failed.exchange(true))
+                                {
+                                    error = std::current_exception();
+                                }
+                            }
+                        }
+                    };
+
+                // This thread is one of the readers. A helper's future waits for it when destroyed, so
+                // the helpers are joined before 'blobs' goes away even if starting another one throws.
+                const size_t threadCount = std::min(maxThreads, names.size());
+
+                std::vector<std::future<void>> helpers;
+                helpers.reserve(threadCount);
+                try
+                {
+                    for (size_t j = 1; j < threadCount; ++j)
+                    {
+                        helpers.emplace_back(std::async(std::launch::async, worker));
+                    }
+                }
+                catch (...)
+                {
+                    // Helpers already started stop at their next file
+                    failed = true;
+                    throw;
+                }
+
+                worker();
+
+                for (auto& it : helpers)
+                {
+                    it.get();
+                }
+
+                if (error)
+                    std::rethrow_exception(error);
+
+                return blobs;
+            });
+    }
 }
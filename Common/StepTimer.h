@@ -6,16 +6,23 @@
 
 #include <cmath>
 #include <cstdint>
+#include <cstdio>
 #include <exception>
+#include <memory>
+#include <tuple>
+
+#include "FrameStatistics.h"
 
 
 namespace DX
 {
-    // Helper class for animation and simulation timing.
-    class StepTimer
+    // Helper class for animation and simulation timing. Clock provides static GetFrequency()
+    // and GetCounter() methods, which throw on failure.
+    template<typename Clock>
+    class BasicStepTimer
     {
     public:
-        StepTimer() noexcept(false) :
+        BasicStepTimer() noexcept(false) :
             m_elapsedTicks(0),
             m_totalTicks(0),
             m_leftOverTicks(0),
@@ -24,20 +31,42 @@ namespace DX
             m_framesThisSecond(0),
             m_qpcSecondCounter(0),
             m_isFixedTimeStep(false),
-            m_targetElapsedTicks(TicksPerSecond / 60)
+            m_targetElapsedTicks(TicksPerSecond / 60),
+            m_skipStatisticsFrame(true)
         {
-            if (!QueryPerformanceFrequency(&m_qpcFrequency))
+            m_qpcFrequency = Clock::GetFrequency();
+            m_qpcLastTime = Clock::GetCounter();
+
+            // Initialize max delta to 1/10 of a second.
+            m_qpcMaxDelta = m_qpcFrequency / 10;
+
+            if (StatisticsReport())
             {
-                throw std::exception();
+                EnableStatistics(true);
             }
+        }
+
+        BasicStepTimer(BasicStepTimer&&) = default;
+        BasicStepTimer& operator= (BasicStepTimer&&) = default;
+
+        BasicStepTimer(BasicStepTimer const&) = delete;
+        BasicStepTimer& operator= (BasicStepTimer const&) = delete;
 
-            if (!QueryPerformanceCounter(&m_qpcLastTime))
+        ~BasicStepTimer()
+        {
+            if (m_statistics && StatisticsReport())
             {
-                throw std::exception();
+                char summary[256] = {};
+                std::ignore = m_statistics->Format(summary, sizeof(summary), TicksPerSecond);
+                printf("StepTimer: %s\n", summary);
+                fflush(stdout);
+
+            #ifdef _WIN32
+                OutputDebugStringA("StepTimer: ");
+                OutputDebugStringA(summary);
+                OutputDebugStringA("\n");
+            #endif
             }
-
-            // Initialize max delta to 1/10 of a second.
-            m_qpcMaxDelta = static_cast<uint64_t>(m_qpcFrequency.QuadPart / 10);
         }
 
         // Get elapsed time since the previous Update call.
@@ -67,49 +96,101 @@ namespace DX
         static constexpr double TicksToSeconds(uint64_t ticks) noexcept { return static_cast<double>(ticks) / TicksPerSecond; }
         static constexpr uint64_t SecondsToTicks(double seconds) noexcept { return static_cast<uint64_t>(seconds * TicksPerSecond); }
 
+        // Optional frame time instrumentation, off by default. The first Tick after enabling or
+        // after ResetElapsedTime isn't recorded.
+        void EnableStatistics(bool enable)
+        {
+            if (!enable)
+            {
+                m_statistics.reset();
+            }
+            else if (!m_statistics)
+            {
+                m_statistics = std::make_unique<FrameStatistics>();
+                m_skipStatisticsFrame = true;
+            }
+        }
+
+        // Returns nullptr unless statistics are enabled.
+        const FrameStatistics* GetStatistics() const noexcept { return m_statistics.get(); }
+
+        void ResetStatistics() noexcept
+        {
+            if (m_statistics)
+            {
+                m_statistics->Reset();
+                m_skipStatisticsFrame = true;
+            }
+        }
+
+        // Timers created after this is set record statistics, and print a summary when destroyed.
+        static void SetStatisticsReport(bool report) noexcept { StatisticsReport() = report; }
+
+        // Benchmark mode, for repeatable runs: while the step is non-zero, every Tick advances
+        // by exactly that many ticks and calls Update once, whatever the clock says. The time
+        // spent in Update callbacks accumulates in Clock units.
+        static void SetBenchmarkStep(uint64_t ticks) noexcept { BenchmarkStep() = ticks; }
+        static uint64_t GetBenchmarkStep() noexcept { return BenchmarkStep(); }
+        static uint64_t GetBenchmarkUpdateTime() noexcept { return BenchmarkUpdateTime(); }
+
         // After an intentional timing discontinuity (for instance a blocking IO operation)
         // call this to avoid having the fixed timestep logic attempt a set of catch-up
         // Update calls.
 
         void ResetElapsedTime()
         {
-            if (!QueryPerformanceCounter(&m_qpcLastTime))
-            {
-                throw std::exception();
-            }
+            m_qpcLastTime = Clock::GetCounter();
 
             m_leftOverTicks = 0;
             m_framesPerSecond = 0;
             m_framesThisSecond = 0;
             m_qpcSecondCounter = 0;
+            m_skipStatisticsFrame = true;
         }
 
         // Update timer state, calling the specified Update function the appropriate number of times.
         template<typename TUpdate>
         void Tick(const TUpdate& update)
         {
-            // Query the current time.
-            LARGE_INTEGER currentTime;
-
-            if (!QueryPerformanceCounter(&currentTime))
+            if (BenchmarkStep() > 0)
             {
-                throw std::exception();
+                m_elapsedTicks = BenchmarkStep();
+                m_totalTicks += m_elapsedTicks;
+                m_leftOverTicks = 0;
+                m_frameCount++;
+
+                const uint64_t start = Clock::GetCounter();
+                update();
+                BenchmarkUpdateTime() += Clock::GetCounter() - start;
+                return;
             }
 
-            uint64_t timeDelta = static_cast<uint64_t>(currentTime.QuadPart - m_qpcLastTime.QuadPart);
+            // Query the current time.
+            const uint64_t currentTime = Clock::GetCounter();
+
+            uint64_t timeDelta = currentTime - m_qpcLastTime;
 
             m_qpcLastTime = currentTime;
             m_qpcSecondCounter += timeDelta;
 
+            // Statistics see the delta before it is clamped, since hitches are what they are for.
+            uint64_t rawTicks = 0;
+            if (m_statistics)
+            {
+                rawTicks = (timeDelta / m_qpcFrequency) * TicksPerSecond
+                    + (timeDelta % m_qpcFrequency) * TicksPerSecond / m_qpcFrequency;
+            }
+
             // Clamp excessively large time deltas (e.g. after paused in the debugger).
-            if (timeDelta > m_qpcMaxDelta)
+            const bool clamped = (timeDelta > m_qpcMaxDelta);
+            if (clamped)
             {
                 timeDelta = m_qpcMaxDelta;
             }
 
             // Convert QPC units into a canonical tick format. This cannot overflow due to the previous clamp.
             timeDelta *= TicksPerSecond;
-            timeDelta /= static_cast<uint64_t>(m_qpcFrequency.QuadPart);
+            timeDelta /= m_qpcFrequency;
 
             const uint32_t lastFrameCount = m_frameCount;
 
@@ -158,18 +239,64 @@ namespace DX
                 m_framesThisSecond++;
             }
 
-            if (m_qpcSecondCounter >= static_cast<uint64_t>(m_qpcFrequency.QuadPart))
+            if (m_qpcSecondCounter >= m_qpcFrequency)
             {
                 m_framesPerSecond = m_framesThisSecond;
                 m_framesThisSecond = 0;
-                m_qpcSecondCounter %= static_cast<uint64_t>(m_qpcFrequency.QuadPart);
+                m_qpcSecondCounter %= m_qpcFrequency;
+            }
+
+            if (m_statistics)
+            {
+                if (m_skipStatisticsFrame)
+                {
+                    m_skipStatisticsFrame = false;
+                }
+                else
+                {
+                    m_statistics->frameTimes.Record(rawTicks);
+
+                    const uint32_t updates = m_frameCount - lastFrameCount;
+                    if (updates > 1)
+                    {
+                        m_statistics->catchUpUpdates += updates - 1;
+                    }
+
+                    if (clamped)
+                    {
+                        m_statistics->clampedFrames++;
+
+                        if (m_isFixedTimeStep && m_targetElapsedTicks > 0)
+                        {
+                            m_statistics->droppedUpdates += (rawTicks - timeDelta) / m_targetElapsedTicks;
+                        }
+                    }
+                }
             }
         }
 
     private:
-        // Source timing data uses QPC units.
-        LARGE_INTEGER m_qpcFrequency;
-        LARGE_INTEGER m_qpcLastTime;
+        static bool& StatisticsReport() noexcept
+        {
+            static bool s_report = false;
+            return s_report;
+        }
+
+        static uint64_t& BenchmarkStep() noexcept
+        {
+            static uint64_t s_step = 0;
+            return s_step;
+        }
+
+        static uint64_t& BenchmarkUpdateTime() noexcept
+        {
+            static uint64_t s_time = 0;
+            return s_time;
+        }
+
+        // Source timing data uses Clock units.
+        uint64_t m_qpcFrequency;
+        uint64_t m_qpcLastTime;
         uint64_t m_qpcMaxDelta;
 
         // Derived timing data uses a canonical tick format.
@@ -186,5 +313,39 @@ namespace DX
         // Members for configuring fixed timestep mode.
         bool m_isFixedTimeStep;
         uint64_t m_targetElapsedTicks;
+
+        // Optional frame time instrumentation.
+        std::unique_ptr<FrameStatistics> m_statistics;
+        bool m_skipStatisticsFrame;
     };
+
+#ifdef _WIN32
+    // QueryPerformanceCounter based clock used by the test apps.
+    struct QPCClock
+    {
+        static uint64_t GetFrequency()
+        {
+            LARGE_INTEGER frequency;
+            if (!QueryPerformanceFrequency(&frequency))
+            {
+                throw std::exception();
+            }
+
+            return static_cast<uint64_t>(frequency.QuadPart);
+        }
+
+        static uint64_t GetCounter()
+        {
+            LARGE_INTEGER counter;
+            if (!QueryPerformanceCounter(&counter))
+            {
+                throw std::exception();
+            }
+
+            return static_cast<uint64_t>(counter.QuadPart);
+        }
+    };
+
+    using StepTimer = BasicStepTimer<QPCClock>;
+#endif
 }
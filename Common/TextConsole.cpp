@@ -16,6 +16,7 @@
 #include <cassert>
 #include <cstdarg>
 #include <cwchar>
+#include <tuple>
 #include <utility>
 
 using Microsoft::WRL::ComPtr;
@@ -50,11 +51,13 @@ TextConsole::TextConsole(ID3D11DeviceContext* context, const wchar_t* fontName)
 
 void TextConsole::Render()
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ProcessPending();
+
     if (!m_lines)
         return;
 
-    std::lock_guard<std::mutex> lock(m_mutex);
-
     const float lineSpacing = m_font->GetLineSpacing();
 
     const float x = float(m_layout.left);
@@ -86,6 +89,10 @@ void TextConsole::Clear() noexcept
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    // Discard anything written before the clear that hasn't been rendered yet
+    m_queue.Drain([](const wchar_t*, bool) {});
+    std::ignore = m_queue.TakeDropped();
+
     if (m_buffer)
     {
         memset(m_buffer.get(), 0, sizeof(wchar_t) * (m_columns + 1) * m_rows);
@@ -98,9 +105,7 @@ void TextConsole::Clear() noexcept
 _Use_decl_annotations_
 void TextConsole::Write(const wchar_t* str)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-
-    ProcessString(str);
+    Enqueue(str, wcslen(str), false);
 
 #ifndef NDEBUG
     if (m_debugOutput)
@@ -114,10 +119,7 @@ void TextConsole::Write(const wchar_t* str)
 _Use_decl_annotations_
 void TextConsole::WriteLine(const wchar_t* str)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-
-    ProcessString(str);
-    IncrementLine();
+    Enqueue(str, wcslen(str), true);
 
 #ifndef NDEBUG
     if (m_debugOutput)
@@ -132,28 +134,50 @@ void TextConsole::WriteLine(const wchar_t* str)
 _Use_decl_annotations_
 void TextConsole::Format(const wchar_t* strFormat, ...)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-
     va_list argList;
     va_start(argList, strFormat);
 
-    auto const len = size_t(_vscwprintf(strFormat, argList) + 1);
+    va_list argCount;
+    va_copy(argCount, argList);
 
-    if (m_tempBuffer.size() < len)
-        m_tempBuffer.resize(len);
+    va_list argFormat;
+    va_copy(argFormat, argList);
 
-    memset(m_tempBuffer.data(), 0, sizeof(wchar_t) * len);
+    // Typical lines fit on the stack, so nothing is allocated
+    wchar_t text[1024];
+    const int len = _vsnwprintf_s(text, _TRUNCATE, strFormat, argList);
 
-    vswprintf_s(m_tempBuffer.data(), m_tempBuffer.size(), strFormat, argList);
+    const wchar_t* str = text;
+    std::unique_ptr<wchar_t[]> longText;
+    if (len >= 0)
+    {
+        Enqueue(text, size_t(len), false);
+    }
+    else
+    {
+        const int count = _vscwprintf(strFormat, argCount);
+        if (count > 0)
+        {
+            longText.reset(new wchar_t[size_t(count) + 1]);
+            vswprintf_s(longText.get(), size_t(count) + 1, strFormat, argFormat);
 
-    va_end(argList);
+            str = longText.get();
+            Enqueue(str, size_t(count), false);
+        }
+        else
+        {
+            *text = L'\0';
+        }
+    }
 
-    ProcessString(m_tempBuffer.data());
+    va_end(argFormat);
+    va_end(argCount);
+    va_end(argList);
 
 #ifndef NDEBUG
     if (m_debugOutput)
     {
-        OutputDebugStringW(m_tempBuffer.data());
+        OutputDebugStringW(str);
     }
 #endif
 }
@@ -246,6 +270,47 @@ void TextConsole::SetRotation(DXGI_MODE_ROTATION rotation)
 }
 
 
+_Use_decl_annotations_
+void TextConsole::Enqueue(const wchar_t* str, size_t length, bool newLine) noexcept
+{
+    if (!length && !newLine)
+        return;
+
+    // Longer text takes several entries, so it can interleave with other threads' writes
+    do
+    {
+        const size_t chunk = (length > LineQueue::MaxLength) ? LineQueue::MaxLength : length;
+        length -= chunk;
+
+        std::ignore = m_queue.Push(str, chunk, newLine && !length);
+        str += chunk;
+    }
+    while (length > 0);
+}
+
+
+void TextConsole::ProcessPending()
+{
+    m_queue.Drain([this](const wchar_t* text, bool newLine)
+        {
+            ProcessString(text);
+            if (newLine)
+            {
+                IncrementLine();
+            }
+        });
+
+    const uint64_t dropped = m_queue.TakeDropped();
+    if (dropped > 0)
+    {
+        wchar_t text[64] = {};
+        swprintf_s(text, L"[%llu console writes dropped]", static_cast<unsigned long long>(dropped));
+        ProcessString(text);
+        IncrementLine();
+    }
+}
+
+
 void TextConsole::ProcessString(_In_z_ const wchar_t* str)
 {
     if (!m_lines)
@@ -15,15 +15,120 @@
 #include "SpriteBatch.h"
 #include "SpriteFont.h"
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <mutex>
-#include <vector>
 
 #include <wrl/client.h>
 
 
 namespace DX
 {
+    // Bounded multi-producer, single-consumer ring of preformatted text. Producers never lock or
+    // allocate; when the ring is full the text is dropped and counted instead.
+    template<size_t Capacity, size_t LineLength>
+    class TextLineQueue
+    {
+    public:
+        static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        static_assert(LineLength > 1, "LineLength must leave room for text");
+
+        static constexpr size_t MaxLength = LineLength - 1;
+
+        TextLineQueue() noexcept : m_enqueuePos(0), m_dropped(0), m_dequeuePos(0)
+        {
+            for (size_t j = 0; j < Capacity; ++j)
+            {
+                m_slots[j].sequence.store(j, std::memory_order_relaxed);
+            }
+        }
+
+        TextLineQueue(TextLineQueue&&) = delete;
+        TextLineQueue& operator= (TextLineQueue&&) = delete;
+
+        TextLineQueue(TextLineQueue const&) = delete;
+        TextLineQueue& operator= (TextLineQueue const&) = delete;
+
+        // Safe to call from any thread. 'length' must be no more than MaxLength.
+        bool Push(_In_reads_(length) const wchar_t* str, size_t length, bool newLine) noexcept
+        {
+            Slot* slot = nullptr;
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                slot = &m_slots[pos & (Capacity - 1)];
+                const size_t seq = slot->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else
+                {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            if (length > MaxLength)
+                length = MaxLength;
+
+            memcpy(slot->text, str, length * sizeof(wchar_t));
+            slot->text[length] = L'\0';
+            slot->newLine = newLine;
+
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only. Calls func(const wchar_t* text, bool newLine) for each published entry
+        // in order, and stops at the first one a producer is still writing.
+        template<typename Func>
+        size_t Drain(Func&& func)
+        {
+            size_t count = 0;
+            for (;;)
+            {
+                Slot& slot = m_slots[m_dequeuePos & (Capacity - 1)];
+                if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1)
+                    break;
+
+                func(static_cast<const wchar_t*>(slot.text), slot.newLine);
+
+                slot.sequence.store(m_dequeuePos + Capacity, std::memory_order_release);
+                ++m_dequeuePos;
+                ++count;
+            }
+            return count;
+        }
+
+        // Entries dropped because the ring was full since the last call
+        uint64_t TakeDropped() noexcept { return m_dropped.exchange(0, std::memory_order_relaxed); }
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> sequence;
+            bool                newLine;
+            wchar_t             text[LineLength];
+        };
+
+        // Producer and consumer positions live on separate cache lines
+        alignas(64) std::atomic<size_t>     m_enqueuePos;
+        std::atomic<uint64_t>               m_dropped;
+        alignas(64) size_t                  m_dequeuePos;
+        std::array<Slot, Capacity>          m_slots;
+    };
+
     class TextConsole
     {
     public:
@@ -58,6 +163,11 @@ namespace DX
         void SetRotation(DXGI_MODE_ROTATION rotation);
 
     private:
+        // Format and Write only queue text; Render does the layout on the render thread
+        using LineQueue = TextLineQueue<512, 128>;
+
+        void Enqueue(_In_reads_(length) const wchar_t* str, size_t length, bool newLine) noexcept;
+        void ProcessPending();
         void ProcessString(_In_z_ const wchar_t* str);
         void IncrementLine();
 
@@ -73,7 +183,8 @@ namespace DX
 
         std::unique_ptr<wchar_t[]>                      m_buffer;
         std::unique_ptr<wchar_t*[]>                     m_lines;
-        std::vector<wchar_t>                            m_tempBuffer;
+
+        LineQueue                                       m_queue;
 
         std::unique_ptr<DirectX::SpriteBatch>           m_batch;
         std::unique_ptr<DirectX::SpriteFont>            m_font;
@@ -39,7 +39,8 @@ extern std::unique_ptr<Model> CreateModelFromOBJ(
     _In_z_ const wchar_t* szFileName,
     _In_ IEffectFactory& fxFactory,
     bool enableInstacing,
-    ModelLoaderFlags flags);
+    ModelLoaderFlags flags,
+    bool optimizeMesh = false);
 
 
 //--------------------------------------------------------------------------------------
@@ -0,0 +1,599 @@
+//--------------------------------------------------------------------------------------
+// File: MeshOptimizer.h
+//
+// Post-processing for indexed triangle meshes such as those produced by WaveFrontReader:
+// single-pass bounds, vertex cache face reordering, vertex fetch reordering, and
+// post-transform cache statistics.
+//
+// Face reordering uses Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+// https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#ifdef _WIN32
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#endif
+#define WIN32_LEAN_AND_MEAN
+#ifndef NOMINMAX
+#define NOMINMAX 1
+#endif
+#define NODRAWTEXT
+#define NOGDI
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <Windows.h>
+#else // !WIN32
+#include <wsl/winadapter.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+namespace MeshOptimizer
+{
+    // LRU cache size modeled by OptimizeFaces
+    constexpr size_t c_OptimizeCacheSize = 32;
+
+    // FIFO cache size used when reporting ACMR/ATVR, typical of post-transform caches
+    constexpr size_t c_MetricCacheSize = 16;
+
+    //----------------------------------------------------------------------------------
+    // Computes the axis-aligned box in one SIMD min/max pass over the positions, with four
+    // independent accumulators. The box matches BoundingBox::CreateFromPoints, and the sphere
+    // comes from BoundingSphere::CreateFromPoints, which fits the points far tighter than a
+    // sphere around the box for elongated or diagonal meshes.
+    inline void ComputeBounds(
+        _In_reads_bytes_(count * stride) const DirectX::XMFLOAT3* positions, size_t count, size_t stride,
+        DirectX::BoundingBox& box, DirectX::BoundingSphere& sphere) noexcept
+    {
+        using namespace DirectX;
+
+        if (!count)
+        {
+            box.Center = sphere.Center = XMFLOAT3(0.f, 0.f, 0.f);
+            box.Extents = XMFLOAT3(0.f, 0.f, 0.f);
+            sphere.Radius = 0.f;
+            return;
+        }
+
+        auto ptr = reinterpret_cast<const uint8_t*>(positions);
+
+        // Four independent accumulators hide the latency of the min/max chains
+        XMVECTOR vMin0 = XMLoadFloat3(positions);
+        XMVECTOR vMax0 = vMin0;
+        XMVECTOR vMin1 = vMin0;
+        XMVECTOR vMax1 = vMin0;
+        XMVECTOR vMin2 = vMin0;
+        XMVECTOR vMax2 = vMin0;
+        XMVECTOR vMin3 = vMin0;
+        XMVECTOR vMax3 = vMin0;
+
+        size_t i = 1;
+        for (; i + 4 <= count; i += 4)
+        {
+            const XMVECTOR p0 = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(ptr + i * stride));
+            const XMVECTOR p1 = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(ptr + (i + 1) * stride));
+            const XMVECTOR p2 = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(ptr + (i + 2) * stride));
+            const XMVECTOR p3 = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(ptr + (i + 3) * stride));
+
+            vMin0 = XMVectorMin(vMin0, p0);
+            vMax0 = XMVectorMax(vMax0, p0);
+            vMin1 = XMVectorMin(vMin1, p1);
+            vMax1 = XMVectorMax(vMax1, p1);
+            vMin2 = XMVectorMin(vMin2, p2);
+            vMax2 = XMVectorMax(vMax2, p2);
+            vMin3 = XMVectorMin(vMin3, p3);
+            vMax3 = XMVectorMax(vMax3, p3);
+        }
+
+        for (; i < count; ++i)
+        {
+            const XMVECTOR p = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(ptr + i * stride));
+            vMin0 = XMVectorMin(vMin0, p);
+            vMax0 = XMVectorMax(vMax0, p);
+        }
+
+        const XMVECTOR vMin = XMVectorMin(XMVectorMin(vMin0, vMin1), XMVectorMin(vMin2, vMin3));
+        const XMVECTOR vMax = XMVectorMax(XMVectorMax(vMax0, vMax1), XMVectorMax(vMax2, vMax3));
+
+        XMFLOAT3 extremes[2];
+        XMStoreFloat3(&extremes[0], vMin);
+        XMStoreFloat3(&extremes[1], vMax);
+        BoundingBox::CreateFromPoints(box, 2, extremes, sizeof(XMFLOAT3));
+
+        BoundingSphere::CreateFromPoints(sphere, count, positions, stride);
+    }
+
+    //----------------------------------------------------------------------------------
+    // Average cache miss ratio (misses per triangle) and average transform to vertex ratio
+    // (misses per referenced vertex) for a FIFO post-transform cache of the given size.
+    template<class index_t>
+    HRESULT ComputeVertexCacheMissRate(
+        _In_reads_(nFaces * 3) const index_t* indices, size_t nFaces, size_t nVerts, size_t cacheSize,
+        float& acmr, float& atvr)
+    {
+        acmr = atvr = 0.f;
+
+        if (!indices || !nFaces || !nVerts || !cacheSize)
+            return E_INVALIDARG;
+
+        // A vertex is resident if it entered the cache less than cacheSize misses ago
+        std::unique_ptr<size_t[]> timestamps(new (std::nothrow) size_t[nVerts]);
+        if (!timestamps)
+            return E_OUTOFMEMORY;
+
+        std::fill(timestamps.get(), timestamps.get() + nVerts, size_t(0));
+
+        size_t misses = 0;
+        size_t used = 0;
+        for (size_t j = 0; j < nFaces * 3; ++j)
+        {
+            const size_t v = indices[j];
+            if (v >= nVerts)
+                return E_UNEXPECTED;
+
+            if (!timestamps[v])
+            {
+                ++used;
+            }
+
+            if (!timestamps[v] || (misses + 1 - timestamps[v]) > cacheSize)
+            {
+                ++misses;
+                timestamps[v] = misses;
+            }
+        }
+
+        acmr = float(misses) / float(nFaces);
+        atvr = float(misses) / float(used);
+
+        return S_OK;
+    }
+
+    //----------------------------------------------------------------------------------
+    // Reorders faces for the post-transform vertex cache. Faces are only reordered within
+    // runs of equal attributes (if provided), so attribute-sorted subsets stay contiguous.
+    // On return faceRemap[newFace] = oldFace.
+    template<class index_t>
+    HRESULT OptimizeFaces(
+        _In_reads_(nFaces * 3) const index_t* indices, size_t nFaces, size_t nVerts,
+        _In_reads_opt_(nFaces) const uint32_t* attributes,
+        _Out_writes_(nFaces) uint32_t* faceRemap,
+        size_t cacheSize = c_OptimizeCacheSize)
+    {
+        if (!indices || !nFaces || !nVerts || !faceRemap || cacheSize < 4)
+            return E_INVALIDARG;
+
+        if (nFaces >= UINT32_MAX || nVerts >= UINT32_MAX || cacheSize > 256)
+            return E_INVALIDARG;
+
+        constexpr float c_CacheDecayPower = 1.5f;
+        constexpr float c_LastTriScore = 0.75f;
+        constexpr float c_ValenceBoostScale = 2.0f;
+        constexpr float c_ValenceBoostPower = 0.5f;
+        constexpr uint32_t c_MaxValence = 64;
+        constexpr uint32_t c_None = UINT32_MAX;
+
+        float cacheScores[256] = {};
+        for (size_t j = 0; j < cacheSize; ++j)
+        {
+            if (j < 3)
+            {
+                // The last triangle's vertices score the same regardless of order
+                cacheScores[j] = c_LastTriScore;
+            }
+            else
+            {
+                const float scaler = 1.f - float(j - 3) / float(cacheSize - 3);
+                cacheScores[j] = std::pow(scaler, c_CacheDecayPower);
+            }
+        }
+
+        float valenceScores[c_MaxValence + 1] = {};
+        for (uint32_t j = 1; j <= c_MaxValence; ++j)
+        {
+            valenceScores[j] = c_ValenceBoostScale * std::pow(float(j), -c_ValenceBoostPower);
+        }
+
+        struct VertexData
+        {
+            uint32_t    adjStart;
+            uint32_t    adjCount;
+            uint32_t    active;     // Faces of the current run not yet emitted
+            int32_t     cachePos;
+            float       score;
+        };
+
+        std::vector<VertexData> verts;
+        std::vector<uint32_t> adjacency;
+        std::vector<float> faceScores;
+        std::vector<uint8_t> emitted;
+        try
+        {
+            verts.resize(nVerts);
+            adjacency.resize(nFaces * 3);
+            faceScores.resize(nFaces);
+            emitted.resize(nFaces);
+        }
+        catch (const std::bad_alloc&)
+        {
+            return E_OUTOFMEMORY;
+        }
+
+        // Face adjacency for each vertex in compressed rows
+        for (size_t j = 0; j < nFaces * 3; ++j)
+        {
+            const size_t v = indices[j];
+            if (v >= nVerts)
+                return E_UNEXPECTED;
+
+            ++verts[v].adjCount;
+        }
+
+        uint32_t offset = 0;
+        for (auto& it : verts)
+        {
+            it.adjStart = offset;
+            offset += it.adjCount;
+            it.adjCount = 0;
+            it.cachePos = -1;
+        }
+
+        for (size_t face = 0; face < nFaces; ++face)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                auto& vert = verts[indices[face * 3 + k]];
+                adjacency[vert.adjStart + vert.adjCount++] = static_cast<uint32_t>(face);
+            }
+        }
+
+        auto vertexScore = [&](const VertexData& vert) noexcept -> float
+            {
+                if (!vert.active)
+                    return -1.f;
+
+                float score = (vert.cachePos >= 0) ? cacheScores[vert.cachePos] : 0.f;
+                score += (vert.active <= c_MaxValence)
+                    ? valenceScores[vert.active]
+                    : c_ValenceBoostScale * std::pow(float(vert.active), -c_ValenceBoostPower);
+                return score;
+            };
+
+        auto faceScore = [&](size_t face) noexcept -> float
+            {
+                return verts[indices[face * 3]].score
+                    + verts[indices[face * 3 + 1]].score
+                    + verts[indices[face * 3 + 2]].score;
+            };
+
+        uint32_t cache[256 + 3];
+        uint32_t newCache[256 + 3];
+
+        size_t outFace = 0;
+        size_t runStart = 0;
+        while (runStart < nFaces)
+        {
+            size_t runEnd = runStart + 1;
+            if (attributes)
+            {
+                while (runEnd < nFaces && attributes[runEnd] == attributes[runStart])
+                {
+                    ++runEnd;
+                }
+            }
+            else
+            {
+                runEnd = nFaces;
+            }
+
+            for (size_t j = runStart * 3; j < runEnd * 3; ++j)
+            {
+                ++verts[indices[j]].active;
+            }
+
+            for (size_t j = runStart * 3; j < runEnd * 3; ++j)
+            {
+                auto& vert = verts[indices[j]];
+                vert.score = vertexScore(vert);
+            }
+
+            uint32_t bestFace = c_None;
+            float bestScore = -1.f;
+            for (size_t face = runStart; face < runEnd; ++face)
+            {
+                faceScores[face] = faceScore(face);
+                if (faceScores[face] > bestScore)
+                {
+                    bestScore = faceScores[face];
+                    bestFace = static_cast<uint32_t>(face);
+                }
+            }
+
+            size_t cacheCount = 0;
+            size_t scanCursor = runStart;
+
+            for (size_t count = runEnd - runStart; count > 0; --count)
+            {
+                if (bestFace == c_None)
+                {
+                    // Nothing adjacent to the cache remains; resume from the next unused face
+                    while (emitted[scanCursor])
+                    {
+                        ++scanCursor;
+                    }
+                    bestFace = static_cast<uint32_t>(scanCursor);
+                }
+
+                emitted[bestFace] = 1;
+                faceRemap[outFace++] = bestFace;
+
+                // New cache contents: the emitted face's vertices, then the previous entries
+                size_t newCount = 0;
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    const uint32_t v = static_cast<uint32_t>(indices[bestFace * 3 + k]);
+                    --verts[v].active;
+
+                    if (std::find(newCache, newCache + newCount, v) == newCache + newCount)
+                    {
+                        newCache[newCount++] = v;
+                    }
+                }
+
+                const size_t faceCount = newCount;
+                for (size_t j = 0; j < cacheCount; ++j)
+                {
+                    const uint32_t v = cache[j];
+                    if (std::find(newCache, newCache + faceCount, v) == newCache + faceCount)
+                    {
+                        newCache[newCount++] = v;
+                    }
+                }
+
+                // Entries beyond the cache size are evicted
+                for (size_t j = cacheSize; j < newCount; ++j)
+                {
+                    auto& vert = verts[newCache[j]];
+                    vert.cachePos = -1;
+                    vert.score = vertexScore(vert);
+                }
+
+                cacheCount = std::min(newCount, cacheSize);
+                for (size_t j = 0; j < cacheCount; ++j)
+                {
+                    auto& vert = verts[newCache[j]];
+                    vert.cachePos = static_cast<int32_t>(j);
+                    vert.score = vertexScore(vert);
+                }
+
+                // Rescore the remaining faces touching any vertex whose score changed
+                bestFace = c_None;
+                bestScore = -1.f;
+                for (size_t j = 0; j < newCount; ++j)
+                {
+                    const auto& vert = verts[newCache[j]];
+                    for (uint32_t a = 0; a < vert.adjCount; ++a)
+                    {
+                        const uint32_t face = adjacency[vert.adjStart + a];
+                        if (face < runStart || face >= runEnd || emitted[face])
+                            continue;
+
+                        faceScores[face] = faceScore(face);
+                        if (faceScores[face] > bestScore)
+                        {
+                            bestScore = faceScores[face];
+                            bestFace = face;
+                        }
+                    }
+                }
+
+                std::copy(newCache, newCache + cacheCount, cache);
+            }
+
+            // The next run starts with a cold cache
+            for (size_t j = 0; j < cacheCount; ++j)
+            {
+                verts[cache[j]].cachePos = -1;
+            }
+
+            runStart = runEnd;
+        }
+
+        return S_OK;
+    }
+
+    //----------------------------------------------------------------------------------
+    // Orders vertices by first use in the index buffer so vertex fetches walk memory
+    // linearly. Unreferenced vertices are moved to the end. On return
+    // vertexRemap[newVertex] = oldVertex.
+    template<class index_t>
+    HRESULT OptimizeVertices(
+        _In_reads_(nFaces * 3) const index_t* indices, size_t nFaces, size_t nVerts,
+        _Out_writes_(nVerts) uint32_t* vertexRemap)
+    {
+        if (!indices || !nFaces || !nVerts || !vertexRemap)
+            return E_INVALIDARG;
+
+        if (nVerts >= UINT32_MAX)
+            return E_INVALIDARG;
+
+        constexpr uint32_t c_Unused = UINT32_MAX;
+
+        std::unique_ptr<uint32_t[]> newIndex(new (std::nothrow) uint32_t[nVerts]);
+        if (!newIndex)
+            return E_OUTOFMEMORY;
+
+        std::fill(newIndex.get(), newIndex.get() + nVerts, c_Unused);
+
+        uint32_t next = 0;
+        for (size_t j = 0; j < nFaces * 3; ++j)
+        {
+            const size_t v = indices[j];
+            if (v >= nVerts)
+                return E_UNEXPECTED;
+
+            if (newIndex[v] == c_Unused)
+            {
+                newIndex[v] = next;
+                vertexRemap[next++] = static_cast<uint32_t>(v);
+            }
+        }
+
+        for (size_t v = 0; v < nVerts; ++v)
+        {
+            if (newIndex[v] == c_Unused)
+            {
+                vertexRemap[next++] = static_cast<uint32_t>(v);
+            }
+        }
+
+        return S_OK;
+    }
+
+    //----------------------------------------------------------------------------------
+    // Applies a face remap from OptimizeFaces to the index and attribute buffers
+    template<class index_t>
+    HRESULT ReorderFaces(
+        std::vector<index_t>& indices, std::vector<uint32_t>& attributes,
+        _In_reads_(attributes.size()) const uint32_t* faceRemap)
+    {
+        const size_t nFaces = attributes.size();
+        if (!faceRemap || (nFaces * 3) != indices.size())
+            return E_INVALIDARG;
+
+        std::vector<index_t> newIndices(indices.size());
+        std::vector<uint32_t> newAttributes(nFaces);
+        for (size_t j = 0; j < nFaces; ++j)
+        {
+            const size_t face = faceRemap[j];
+            if (face >= nFaces)
+                return E_UNEXPECTED;
+
+            newIndices[j * 3] = indices[face * 3];
+            newIndices[j * 3 + 1] = indices[face * 3 + 1];
+            newIndices[j * 3 + 2] = indices[face * 3 + 2];
+            newAttributes[j] = attributes[face];
+        }
+
+        indices.swap(newIndices);
+        attributes.swap(newAttributes);
+        return S_OK;
+    }
+
+    // Applies a vertex remap from OptimizeVertices to the vertex and index buffers
+    template<class index_t, class vertex_t>
+    HRESULT ReorderVertices(
+        std::vector<vertex_t>& vertices, std::vector<index_t>& indices,
+        _In_reads_(vertices.size()) const uint32_t* vertexRemap)
+    {
+        const size_t nVerts = vertices.size();
+        if (!vertexRemap)
+            return E_INVALIDARG;
+
+        std::vector<vertex_t> newVertices(nVerts);
+        std::vector<uint32_t> newIndex(nVerts);
+        for (size_t j = 0; j < nVerts; ++j)
+        {
+            const size_t v = vertexRemap[j];
+            if (v >= nVerts)
+                return E_UNEXPECTED;
+
+            newVertices[j] = vertices[v];
+            newIndex[v] = static_cast<uint32_t>(j);
+        }
+
+        for (auto& it : indices)
+        {
+            if (size_t(it) >= nVerts)
+                return E_UNEXPECTED;
+
+            it = static_cast<index_t>(newIndex[it]);
+        }
+
+        vertices.swap(newVertices);
+        return S_OK;
+    }
+
+    //----------------------------------------------------------------------------------
+    struct Statistics
+    {
+        float   acmrBefore;
+        float   atvrBefore;
+        float   acmrAfter;
+        float   atvrAfter;
+    };
+
+    // Runs face reordering then vertex fetch reordering, optionally reporting the
+    // post-transform cache statistics before and after
+    template<class index_t, class vertex_t>
+    HRESULT Optimize(
+        std::vector<vertex_t>& vertices, std::vector<index_t>& indices, std::vector<uint32_t>& attributes,
+        _Out_opt_ Statistics* stats = nullptr)
+    {
+        if (vertices.empty() || attributes.empty() || (attributes.size() * 3) != indices.size())
+            return E_INVALIDARG;
+
+        const size_t nFaces = attributes.size();
+        const size_t nVerts = vertices.size();
+
+        HRESULT hr = S_OK;
+        if (stats)
+        {
+            hr = ComputeVertexCacheMissRate(indices.data(), nFaces, nVerts, c_MetricCacheSize, stats->acmrBefore, stats->atvrBefore);
+            if (FAILED(hr))
+                return hr;
+        }
+
+        try
+        {
+            std::vector<uint32_t> remap(std::max(nFaces, nVerts));
+
+            hr = OptimizeFaces(indices.data(), nFaces, nVerts, attributes.data(), remap.data());
+            if (FAILED(hr))
+                return hr;
+
+            hr = ReorderFaces(indices, attributes, remap.data());
+            if (FAILED(hr))
+                return hr;
+
+            hr = OptimizeVertices(indices.data(), nFaces, nVerts, remap.data());
+            if (FAILED(hr))
+                return hr;
+
+            hr = ReorderVertices(vertices, indices, remap.data());
+            if (FAILED(hr))
+                return hr;
+        }
+        catch (const std::bad_alloc&)
+        {
+            return E_OUTOFMEMORY;
+        }
+
+        if (stats)
+        {
+            hr = ComputeVertexCacheMissRate(indices.data(), nFaces, nVerts, c_MetricCacheSize, stats->acmrAfter, stats->atvrAfter);
+        }
+
+        return hr;
+    }
+}
@@ -15,6 +15,7 @@
 
 #include <map>
 
+#include "MeshOptimizer.h"
 #include "WaveFrontReader.h"
 
 using namespace DirectX;
@@ -80,7 +81,8 @@ std::unique_ptr<Model> CreateModelFromOBJ(
     _In_z_ const wchar_t* szFileName,
     _In_ IEffectFactory& fxFactory,
     bool enableInstacing,
-    ModelLoaderFlags flags)
+    ModelLoaderFlags flags,
+    bool optimizeMesh)
 {
     if (!InitOnceExecuteOnce(&g_InitOnce, InitializeDecl, nullptr, nullptr))
         throw std::system_error(std::error_code(static_cast<int>(GetLastError()), std::system_category()), "InitOnceExecuteOnce");
@@ -140,6 +142,20 @@ std::unique_ptr<Model> CreateModelFromOBJ(
         }
     }
 
+    // Optional reordering for the post-transform vertex cache and vertex fetch
+    if (optimizeMesh)
+    {
+        MeshOptimizer::Statistics stats = {};
+        DX::ThrowIfFailed(
+            MeshOptimizer::Optimize(obj->vertices, obj->indices, obj->attributes, &stats)
+        );
+
+        char buff[256] = {};
+        sprintf_s(buff, "INFO: %ls ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", szFileName,
+            double(stats.acmrBefore), double(stats.acmrAfter), double(stats.atvrBefore), double(stats.atvrAfter));
+        OutputDebugStringA(buff);
+    }
+
     // Create Vertex Buffer
     Microsoft::WRL::ComPtr<ID3D11Buffer> vb;
     DX::ThrowIfFailed(
@@ -158,8 +174,15 @@ std::unique_ptr<Model> CreateModelFromOBJ(
     mesh->ccw = (flags & ModelLoader_CounterClockwise) != 0;
     mesh->pmalpha = (flags & ModelLoader_PremultipledAlpha) != 0;
 
-    BoundingSphere::CreateFromPoints(mesh->boundingSphere, obj->vertices.size(), &obj->vertices[0].position, sizeof(VertexPositionNormalTexture));
-    BoundingBox::CreateFromPoints(mesh->boundingBox, obj->vertices.size(), &obj->vertices[0].position, sizeof(VertexPositionNormalTexture));
+    if (optimizeMesh)
+    {
+        MeshOptimizer::ComputeBounds(&obj->vertices[0].position, obj->vertices.size(), sizeof(VertexPositionNormalTexture), mesh->boundingBox, mesh->boundingSphere);
+    }
+    else
+    {
+        BoundingSphere::CreateFromPoints(mesh->boundingSphere, obj->vertices.size(), &obj->vertices[0].position, sizeof(VertexPositionNormalTexture));
+        BoundingBox::CreateFromPoints(mesh->boundingBox, obj->vertices.size(), &obj->vertices[0].position, sizeof(VertexPositionNormalTexture));
+    }
 
     // Create a subset for each attribute/material
     uint32_t curmaterial = static_cast<uint32_t>(-1);
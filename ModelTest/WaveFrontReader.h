@@ -45,15 +45,35 @@
 #endif
 
 #include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cfloat>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
 #include <fstream>
+#include <functional>
+#include <iterator>
 #include <locale>
+#include <memory>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
 #include <vector>
-#include <unordered_map>
+
+#if (__cplusplus >= 201703L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L))
+#include <charconv>
+#endif
 
 #ifndef _WIN32
 #include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include <DirectXMath.h>
@@ -70,30 +90,25 @@ public:
         DirectX::XMFLOAT2 textureCoordinate;
     };
 
-    WaveFrontReader() noexcept : hasNormals(false), hasTexcoords(false) {}
+    WaveFrontReader() noexcept : hasNormals(false), hasTexcoords(false), materialLibraryTime(0) {}
 
     HRESULT Load(_In_z_ const wchar_t* szFileName, bool ccw = true)
     {
         Clear();
 
-        constexpr size_t MAX_POLY = 64;
-
         using namespace DirectX;
 
+#ifdef _WIN32
         std::wifstream InFile(szFileName);
+#else
+        std::wifstream InFile(std::filesystem::path(szFileName).c_str());
+#endif
         if (!InFile)
             return /* HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) */ static_cast<HRESULT>(0x80070002L);
 
         InFile.imbue(std::locale::classic());
 
-#ifdef _WIN32
-        wchar_t fname[_MAX_FNAME] = {};
-        _wsplitpath_s(szFileName, nullptr, 0, nullptr, 0, fname, _MAX_FNAME, nullptr, 0);
-        name = fname;
-#else
-        auto path = std::filesystem::path(szFileName);
-        name = path.filename().c_str();
-#endif
+        SetName(szFileName);
 
         std::vector<XMFLOAT3>   positions;
         std::vector<XMFLOAT3>   normals;
@@ -161,6 +176,11 @@ public:
             else if (0 == wcscmp(strCommand.c_str(), L"f"))
             {
                 // Face
+                if (vertexCache.empty())
+                {
+                    ReserveVertices(vertexCache, positions.size(), SIZE_MAX);
+                }
+
                 INT iPosition, iTexCoord, iNormal;
                 Vertex vertex;
 
@@ -308,31 +328,7 @@ public:
                     return E_FAIL;
                 }
 
-                // Convert polygons to triangles
-                const uint32_t i0 = faceIndex[0];
-                uint32_t i1 = faceIndex[1];
-
-                for (size_t j = 2; j < iFace; ++j)
-                {
-                    const uint32_t index = faceIndex[j];
-                    indices.emplace_back(static_cast<index_t>(i0));
-                    if (ccw)
-                    {
-                        indices.emplace_back(static_cast<index_t>(i1));
-                        indices.emplace_back(static_cast<index_t>(index));
-                    }
-                    else
-                    {
-                        indices.emplace_back(static_cast<index_t>(index));
-                        indices.emplace_back(static_cast<index_t>(i1));
-                    }
-
-                    attributes.emplace_back(curSubset);
-
-                    i1 = index;
-                }
-
-                assert(attributes.size() * 3 == indices.size());
+                AddFace(faceIndex, iFace, ccw, curSubset);
             }
             else if (0 == wcscmp(strCommand.c_str(), L"mtllib"))
             {
@@ -347,25 +343,7 @@ public:
                 InFile.width(MAX_PATH);
                 InFile >> strName;
 
-                bool bFound = false;
-                uint32_t count = 0;
-                for (auto it = materials.cbegin(); it != materials.cend(); ++it, ++count)
-                {
-                    if (0 == wcscmp(it->strName, strName))
-                    {
-                        bFound = true;
-                        curSubset = count;
-                        break;
-                    }
-                }
-
-                if (!bFound)
-                {
-                    Material mat;
-                    curSubset = static_cast<uint32_t>(materials.size());
-                    wcscpy_s(mat.strName, MAX_PATH - 1, strName);
-                    materials.emplace_back(mat);
-                }
+                curSubset = FindOrAddMaterial(strName);
             }
             else
             {
@@ -387,34 +365,289 @@ public:
         BoundingBox::CreateFromPoints(bounds, positions.size(), positions.data(), sizeof(XMFLOAT3));
 
         // If an associated material file was found, read that in as well.
-        if (*strMaterialFilename)
+        return LoadMaterialLibrary(szFileName, strMaterialFilename);
+    }
+
+    // Alternative to Load which memory-maps the file and tokenizes the narrow bytes directly,
+    // avoiding the per-token cost of std::wifstream. Produces the same results as Load.
+    HRESULT LoadMapped(_In_z_ const wchar_t* szFileName, bool ccw = true)
+    {
+        Clear();
+
+        using namespace DirectX;
+
+        MappedFile file;
+        HRESULT hr = file.Open(szFileName);
+        if (FAILED(hr))
+            return hr;
+
+        SetName(szFileName);
+
+        std::vector<XMFLOAT3>   positions;
+        std::vector<XMFLOAT3>   normals;
+        std::vector<XMFLOAT2>   texCoords;
+
+        Material defmat;
+
+        wcscpy_s(defmat.strName, L"default");
+        materials.emplace_back(defmat);
+
+        wchar_t strMaterialFilename[MAX_PATH] = {};
+        hr = ParseMapped(file.data(), file.data() + file.size(), ccw, positions, normals, texCoords, strMaterialFilename);
+        if (FAILED(hr))
+            return hr;
+
+        if (positions.empty())
+            return E_FAIL;
+
+        file.Close();
+
+        BoundingBox::CreateFromPoints(bounds, positions.size(), positions.data(), sizeof(XMFLOAT3));
+
+        // If an associated material file was found, read that in as well.
+        return LoadMaterialLibrary(szFileName, strMaterialFilename);
+    }
+
+    // Multi-threaded variant of LoadMapped. The file is split at line boundaries and each chunk's
+    // v/vt/vn/f records are parsed concurrently; the chunks are then merged in file order so the
+    // results are identical to Load. A threadCount of 0 uses all available hardware threads.
+    HRESULT LoadParallel(_In_z_ const wchar_t* szFileName, bool ccw = true, size_t threadCount = 0)
+    {
+        Clear();
+
+        using namespace DirectX;
+
+        MappedFile file;
+        HRESULT hr = file.Open(szFileName);
+        if (FAILED(hr))
+            return hr;
+
+        SetName(szFileName);
+
+        Material defmat;
+
+        wcscpy_s(defmat.strName, L"default");
+        materials.emplace_back(defmat);
+
+        if (!threadCount)
         {
-#ifdef _WIN32
-            wchar_t ext[_MAX_EXT] = {};
-            _wsplitpath_s(strMaterialFilename, nullptr, 0, nullptr, 0, fname, _MAX_FNAME, ext, _MAX_EXT);
+            threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
 
-            wchar_t drive[_MAX_DRIVE] = {};
-            wchar_t dir[_MAX_DIR] = {};
-            _wsplitpath_s(szFileName, drive, _MAX_DRIVE, dir, _MAX_DIR, nullptr, 0, nullptr, 0);
+        // Split on line boundaries
+        const char* ptr = file.data();
+        const char* end = ptr + file.size();
 
-            wchar_t szPath[MAX_PATH] = {};
-            _wmakepath_s(szPath, MAX_PATH, drive, dir, fname, ext);
-            HRESULT hr = LoadMTL(szPath);
-            if (FAILED(hr))
-                return hr;
-#else
-            auto path = std::filesystem::path(szFileName);
-            auto mtlpath = std::filesystem::path(strMaterialFilename);
-            path.replace_filename(mtlpath.filename());
-            path.replace_extension(mtlpath.extension());
+        const size_t chunkCount = std::max<size_t>(1, std::min(threadCount, file.size() / c_MinChunkSize));
+        std::vector<ParseChunk> chunks(chunkCount);
 
-            HRESULT hr = LoadMTL(path.c_str());
-            if (FAILED(hr))
-                return hr;
-#endif
+        const size_t chunkSize = file.size() / chunkCount;
+        for (size_t j = 0; j < chunkCount; ++j)
+        {
+            chunks[j].begin = ptr;
+            if (j + 1 == chunkCount)
+            {
+                ptr = end;
+            }
+            else
+            {
+                ptr = std::max(ptr, file.data() + chunkSize * (j + 1));
+                SkipLine(ptr, end);
+            }
+            chunks[j].end = ptr;
         }
 
-        return S_OK;
+        // Parse chunks concurrently
+        if (chunkCount > 1)
+        {
+            std::vector<std::thread> workers;
+            workers.reserve(chunkCount - 1);
+
+            // Chunks whose worker couldn't be started are parsed on this thread instead
+            size_t started = 1;
+            try
+            {
+                for (; started < chunkCount; ++started)
+                {
+                    workers.emplace_back(ParseChunkRecords, &chunks[started]);
+                }
+            }
+            catch (const std::system_error&)
+            {
+            }
+
+            ParseChunkRecords(&chunks[0]);
+
+            for (size_t j = started; j < chunkCount; ++j)
+            {
+                ParseChunkRecords(&chunks[j]);
+            }
+
+            for (auto& it : workers)
+            {
+                it.join();
+            }
+        }
+        else
+        {
+            ParseChunkRecords(&chunks[0]);
+        }
+
+        // Parsing stops at the first chunk that hit malformed data or a face error
+        size_t validChunks = 0;
+        size_t totalPositions = 0;
+        size_t totalNormals = 0;
+        size_t totalTexCoords = 0;
+        for (const auto& chunk : chunks)
+        {
+            ++validChunks;
+            totalPositions += chunk.positions.size();
+            totalNormals += chunk.normals.size();
+            totalTexCoords += chunk.texCoords.size();
+            if (chunk.stop)
+                break;
+        }
+
+        std::vector<XMFLOAT3>   positions;
+        std::vector<XMFLOAT3>   normals;
+        std::vector<XMFLOAT2>   texCoords;
+
+        positions.reserve(totalPositions);
+        normals.reserve(totalNormals);
+        texCoords.reserve(totalTexCoords);
+
+        // Merge in file order
+        VertexCache  vertexCache;
+
+        {
+            size_t totalCorners = 0;
+            for (size_t j = 0; j < validChunks; ++j)
+            {
+                totalCorners += chunks[j].corners.size() / 3;
+            }
+
+            ReserveVertices(vertexCache, totalPositions, totalCorners);
+        }
+
+        uint32_t curSubset = 0;
+
+        wchar_t strMaterialFilename[MAX_PATH] = {};
+        for (size_t j = 0; j < validChunks; ++j)
+        {
+            auto& chunk = chunks[j];
+
+            const size_t basePosition = positions.size();
+            const size_t baseNormal = normals.size();
+            const size_t baseTexCoord = texCoords.size();
+
+            positions.insert(positions.end(), chunk.positions.cbegin(), chunk.positions.cend());
+            normals.insert(normals.end(), chunk.normals.cbegin(), chunk.normals.cend());
+            texCoords.insert(texCoords.end(), chunk.texCoords.cbegin(), chunk.texCoords.cend());
+
+            ParseChunk::ReleaseAttributes(chunk);
+
+            hasNormals |= chunk.hasNormals;
+            hasTexcoords |= chunk.hasTexcoords;
+
+            if (chunk.mtllib)
+            {
+                const char* token = chunk.mtllib;
+                ReadToken(token, chunk.end, strMaterialFilename, MAX_PATH);
+            }
+
+            auto mit = chunk.materialRecords.cbegin();
+            const int32_t* corner = chunk.corners.data();
+            for (size_t face = 0; face < chunk.faces.size(); ++face)
+            {
+                for (; mit != chunk.materialRecords.cend() && mit->face <= face; ++mit)
+                {
+                    const char* token = mit->token;
+                    wchar_t strName[MAX_PATH] = {};
+                    ReadToken(token, chunk.end, strName, MAX_PATH);
+                    curSubset = FindOrAddMaterial(strName);
+                }
+
+                const auto& rec = chunk.faces[face];
+
+                // Sizes of the attribute arrays at the point the face statement was read
+                const size_t posCount = basePosition + rec.positionCount;
+                const size_t normCount = baseNormal + rec.normalCount;
+                const size_t coordCount = baseTexCoord + rec.texCoordCount;
+
+                uint32_t faceIndex[MAX_POLY];
+                for (size_t k = 0; k < rec.cornerCount; ++k, corner += 3)
+                {
+                    Vertex vertex;
+                    memset(&vertex, 0, sizeof(vertex));
+
+                    uint32_t vertexIndex = 0;
+                    if (!ResolveIndex(corner[0], posCount, vertexIndex))
+                        return E_FAIL;
+
+                    vertex.position = positions[vertexIndex];
+
+                    if (corner[1])
+                    {
+                        uint32_t coordIndex = 0;
+                        if (!ResolveIndex(corner[1], coordCount, coordIndex))
+                            return E_FAIL;
+
+                        vertex.textureCoordinate = texCoords[coordIndex];
+                    }
+
+                    if (corner[2])
+                    {
+                        uint32_t normIndex = 0;
+                        if (!ResolveIndex(corner[2], normCount, normIndex))
+                            return E_FAIL;
+
+                        vertex.normal = normals[normIndex];
+                    }
+
+                    const uint32_t index = AddVertex(vertexIndex, &vertex, vertexCache);
+                    if (index == uint32_t(-1))
+                        return E_OUTOFMEMORY;
+
+                    constexpr uint32_t maxIndex = (sizeof(index_t) == 2) ? UINT16_MAX : UINT32_MAX;
+                    if (index >= maxIndex)
+                    {
+                        // Too many indices for IB!
+                        return E_FAIL;
+                    }
+
+                    faceIndex[k] = index;
+                }
+
+                if (rec.error)
+                {
+                    // Face statement that failed parsing
+                    return chunk.hr;
+                }
+
+                AddFace(faceIndex, rec.cornerCount, ccw, curSubset);
+            }
+
+            for (; mit != chunk.materialRecords.cend(); ++mit)
+            {
+                const char* token = mit->token;
+                wchar_t strName[MAX_PATH] = {};
+                ReadToken(token, chunk.end, strName, MAX_PATH);
+                curSubset = FindOrAddMaterial(strName);
+            }
+
+            if (FAILED(chunk.hr))
+                return chunk.hr;
+        }
+
+        if (positions.empty())
+            return E_FAIL;
+
+        file.Close();
+
+        BoundingBox::CreateFromPoints(bounds, positions.size(), positions.data(), sizeof(XMFLOAT3));
+
+        // If an associated material file was found, read that in as well.
+        return LoadMaterialLibrary(szFileName, strMaterialFilename);
     }
 
     HRESULT LoadMTL(_In_z_ const wchar_t* szFileName)
@@ -422,7 +655,11 @@ public:
         using namespace DirectX;
 
         // Assumes MTL is in CWD along with OBJ
+#ifdef _WIN32
         std::wifstream InFile(szFileName);
+#else
+        std::wifstream InFile(std::filesystem::path(szFileName).c_str());
+#endif
         if (!InFile)
             return /* HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) */ static_cast<HRESULT>(0x80070002L);
 
@@ -572,6 +809,8 @@ public:
         attributes.clear();
         materials.clear();
         name.clear();
+        materialLibrary.clear();
+        materialLibraryTime = 0;
         hasNormals = false;
         hasTexcoords = false;
 
@@ -585,20 +824,17 @@ public:
 
         Clear();
 
-#ifdef _WIN32
-        wchar_t fname[_MAX_FNAME] = {};
-        _wsplitpath_s(szFileName, nullptr, 0, nullptr, 0, fname, _MAX_FNAME, nullptr, 0);
-        name = fname;
-#else
-        auto path = std::filesystem::path(szFileName);
-        name = path.filename().c_str();
-#endif
+        SetName(szFileName);
 
         Material defmat;
         wcscpy_s(defmat.strName, L"default");
         materials.emplace_back(defmat);
 
+#ifdef _WIN32
         std::ifstream vboFile(szFileName, std::ifstream::in | std::ifstream::binary);
+#else
+        std::ifstream vboFile(std::filesystem::path(szFileName).c_str(), std::ifstream::in | std::ifstream::binary);
+#endif
         if (!vboFile.is_open())
             return /* HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) */ static_cast<HRESULT>(0x80070002L);
 
@@ -648,78 +884,2075 @@ public:
         return S_OK;
     }
 
-    struct Material
+    class CacheView;
+
+    // Writes the parsed results, including materials and attributes, to a binary cache file
+    // that LoadCache or CacheView can map back in. ccw is the winding the mesh was loaded with.
+    HRESULT SaveCache(_In_z_ const wchar_t* szCacheFile, bool ccw = true) const
     {
-        DirectX::XMFLOAT3 vAmbient;
-        DirectX::XMFLOAT3 vDiffuse;
-        DirectX::XMFLOAT3 vSpecular;
-        DirectX::XMFLOAT3 vEmissive;
-        uint32_t nShininess;
-        float fAlpha;
+        if (vertices.empty() || indices.empty() || materials.empty() || (attributes.size() * 3) != indices.size())
+            return E_UNEXPECTED;
+
+        CacheHeader header = {};
+        header.magic = c_CacheMagic;
+        header.version = c_CacheVersion;
+        header.indexSize = sizeof(index_t);
+        header.vertexSize = sizeof(Vertex);
+        header.materialSize = sizeof(Material);
+        header.charSize = sizeof(wchar_t);
+        header.flags = (hasNormals ? CACHE_NORMALS : 0u) | (hasTexcoords ? CACHE_TEXCOORDS : 0u) | (ccw ? CACHE_CCW : 0u);
+        header.nameLength = name.size();
+        header.materialLibraryLength = materialLibrary.size();
+        header.vertexCount = vertices.size();
+        header.indexCount = indices.size();
+        header.attributeCount = attributes.size();
+        header.materialCount = materials.size();
+        header.materialLibraryTime = materialLibraryTime;
+        header.center = bounds.Center;
+        header.extents = bounds.Extents;
+
+        uint64_t offset = sizeof(CacheHeader);
+        header.nameOffset = AlignCache(offset);
+        offset = header.nameOffset + header.nameLength * sizeof(wchar_t);
+        header.materialLibraryOffset = AlignCache(offset);
+        offset = header.materialLibraryOffset + header.materialLibraryLength * sizeof(wchar_t);
+        header.vertexOffset = AlignCache(offset);
+        offset = header.vertexOffset + header.vertexCount * sizeof(Vertex);
+        header.indexOffset = AlignCache(offset);
+        offset = header.indexOffset + header.indexCount * sizeof(index_t);
+        header.attributeOffset = AlignCache(offset);
+        offset = header.attributeOffset + header.attributeCount * sizeof(uint32_t);
+        header.materialOffset = AlignCache(offset);
+        header.fileSize = header.materialOffset + header.materialCount * sizeof(Material);
+
+        // Write to a temporary file and rename it into place, so a cache that is concurrently
+        // mapped by another reader is never truncated underneath it.
+        std::wstring tempFile(szCacheFile);
+        tempFile += L".tmp";
 
-        bool bSpecular;
-        bool bEmissive;
+        {
+#ifdef _WIN32
+            std::ofstream outFile(tempFile.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+#else
+            std::ofstream outFile(std::filesystem::path(tempFile).c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+#endif
+            if (!outFile.is_open())
+                return E_FAIL;
 
-        wchar_t strName[MAX_PATH];
-        wchar_t strTexture[MAX_PATH];
-        wchar_t strNormalTexture[MAX_PATH];
-        wchar_t strSpecularTexture[MAX_PATH];
-        wchar_t strEmissiveTexture[MAX_PATH];
-        wchar_t strRMATexture[MAX_PATH];
+            static const char s_padding[c_CacheAlignment] = {};
 
-        Material() noexcept :
-        vAmbient(0.2f, 0.2f, 0.2f),
-            vDiffuse(0.8f, 0.8f, 0.8f),
-            vSpecular(1.0f, 1.0f, 1.0f),
-            vEmissive(0.f, 0.f, 0.f),
-            nShininess(0),
-            fAlpha(1.f),
-            bSpecular(false),
-            bEmissive(false),
-            strName{},
-            strTexture{},
-            strNormalTexture{},
-            strSpecularTexture{},
-            strEmissiveTexture{},
-            strRMATexture{}
+            uint64_t pos = 0;
+            auto writeSection = [&](uint64_t sectionOffset, const void* data, uint64_t bytes)
+                {
+                    assert(sectionOffset >= pos && (sectionOffset - pos) <= sizeof(s_padding));
+                    outFile.write(s_padding, static_cast<std::streamsize>(sectionOffset - pos));
+                    outFile.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+                    pos = sectionOffset + bytes;
+                };
+
+            writeSection(0, &header, sizeof(CacheHeader));
+            writeSection(header.nameOffset, name.c_str(), header.nameLength * sizeof(wchar_t));
+            writeSection(header.materialLibraryOffset, materialLibrary.c_str(), header.materialLibraryLength * sizeof(wchar_t));
+            writeSection(header.vertexOffset, vertices.data(), header.vertexCount * sizeof(Vertex));
+            writeSection(header.indexOffset, indices.data(), header.indexCount * sizeof(index_t));
+            writeSection(header.attributeOffset, attributes.data(), header.attributeCount * sizeof(uint32_t));
+            writeSection(header.materialOffset, materials.data(), header.materialCount * sizeof(Material));
+
+            outFile.close();
+            if (outFile.fail())
+            {
+                std::ignore = RemoveCacheFile(tempFile.c_str());
+                return E_FAIL;
+            }
+        }
+
+#ifdef _WIN32
+        if (!MoveFileExW(tempFile.c_str(), szCacheFile, MOVEFILE_REPLACE_EXISTING))
         {
+            const HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            std::ignore = RemoveCacheFile(tempFile.c_str());
+            return hr;
         }
-    };
+#else
+        if (rename(std::filesystem::path(tempFile).c_str(), std::filesystem::path(szCacheFile).c_str()) != 0)
+        {
+            std::ignore = RemoveCacheFile(tempFile.c_str());
+            return E_FAIL;
+        }
+#endif
 
-    std::vector<Vertex>     vertices;
+        return S_OK;
+    }
+
+    // Reads a cache written by SaveCache. The sections are bulk-copied out of the mapping; use
+    // CacheView instead to consume the mapped data in place.
+    HRESULT LoadCache(_In_z_ const wchar_t* szCacheFile, bool ccw = true)
+    {
+        Clear();
+
+        CacheView view;
+        HRESULT hr = view.Open(szCacheFile);
+        if (FAILED(hr))
+            return hr;
+
+        CopyCache(view, ccw);
+
+        return S_OK;
+    }
+
+    // Loads from the binary cache alongside szFileName when it is newer than the source and
+    // its material library is unchanged, otherwise parses the OBJ and writes a new cache.
+    // Cached results are copied into the members like LoadCache. Returns S_FALSE when the
+    // results came from the cache. Failing to write the cache is not an error.
+    HRESULT LoadCached(_In_z_ const wchar_t* szFileName, bool ccw = true, size_t threadCount = 0)
+    {
+        std::wstring cacheFile(szFileName);
+        cacheFile += c_CacheExtension;
+
+        {
+            CacheView view;
+            if (SUCCEEDED(view.Open(cacheFile.c_str())) && IsCacheCurrent(szFileName, cacheFile.c_str(), view))
+            {
+                Clear();
+                CopyCache(view, ccw);
+                return S_FALSE;
+            }
+        }
+
+        HRESULT hr = LoadParallel(szFileName, ccw, threadCount);
+        if (FAILED(hr))
+            return hr;
+
+        std::ignore = SaveCache(cacheFile.c_str(), ccw);
+
+        return S_OK;
+    }
+
+    // Zero-copy variant of LoadCached: on success the view maps a current cache for
+    // szFileName with the requested winding, and the members are left cleared. A missing or
+    // stale cache is re-parsed and rewritten first, so here failing to write it is an error.
+    // Returns S_FALSE when the existing cache was used.
+    HRESULT LoadCached(_In_z_ const wchar_t* szFileName, CacheView& view, bool ccw = true, size_t threadCount = 0)
+    {
+        Clear();
+
+        std::wstring cacheFile(szFileName);
+        cacheFile += c_CacheExtension;
+
+        if (SUCCEEDED(view.Open(cacheFile.c_str()))
+            && view.ccw == ccw
+            && IsCacheCurrent(szFileName, cacheFile.c_str(), view))
+            return S_FALSE;
+
+        view.Close();
+
+        HRESULT hr = LoadParallel(szFileName, ccw, threadCount);
+        if (SUCCEEDED(hr))
+        {
+            hr = SaveCache(cacheFile.c_str(), ccw);
+        }
+
+        Clear();
+
+        if (FAILED(hr))
+            return hr;
+
+        return view.Open(cacheFile.c_str());
+    }
+
+    // Triangles emitted by LoadStreaming. Indices address the batch's own vertices, and the
+    // pointers are only valid for the duration of the callback.
+    struct StreamBatch
+    {
+        const Vertex*       vertices;
+        size_t              vertexCount;
+        const index_t*      indices;
+        size_t              indexCount;
+        const uint32_t*     attributes;     // Material index for each triangle
+        size_t              baseFace;       // Index of the batch's first triangle within the mesh
+    };
+
+    struct StreamOptions
+    {
+        size_t  maxBatchVertices;   // Vertex limit for each batch (at least MAX_POLY)
+        size_t  maxBatchFaces;      // Triangle limit for each batch (at least MAX_POLY - 2)
+        size_t  memoryLimit;        // Bytes of working memory before spilling to a temporary file; 0 is unlimited
+        bool    ccw;
+
+        StreamOptions() noexcept :
+            maxBatchVertices((sizeof(index_t) == 2) ? UINT16_MAX : 131072),
+            maxBatchFaces(131072),
+            memoryLimit(0),
+            ccw(true)
+        {
+        }
+    };
+
+    struct StreamStats
+    {
+        size_t  batches;
+        size_t  faces;
+        size_t  peakMemory;         // Peak bytes of batch buffers and in-memory attribute arrays
+        size_t  spilledBytes;       // Bytes of attribute arrays placed in the temporary file
+    };
+
+    using StreamCallback = std::function<HRESULT(const StreamBatch&)>;
+
+    // Out-of-core variant of LoadMapped for meshes that do not fit in memory. Triangles are
+    // welded and emitted in file order through the callback, in batches bounded by the options,
+    // and the vertices/indices/attributes members are left empty. Positions, normals and texture
+    // coordinates must stay addressable for later faces, so once the memory limit is reached
+    // they are stored in a memory-mapped temporary file which the OS can page out. The source
+    // file is memory-mapped read-only and is not counted against the limit. A failed callback
+    // result stops the load and is returned.
+    HRESULT LoadStreaming(
+        _In_z_ const wchar_t* szFileName,
+        const StreamCallback& callback,
+        const StreamOptions& options = StreamOptions(),
+        _Out_opt_ StreamStats* stats = nullptr)
+    {
+        Clear();
+
+        if (stats)
+        {
+            memset(stats, 0, sizeof(StreamStats));
+        }
+
+        constexpr size_t maxVertices = (sizeof(index_t) == 2) ? UINT16_MAX : UINT32_MAX;
+        if (!callback
+            || (options.maxBatchVertices < MAX_POLY)
+            || (options.maxBatchVertices > maxVertices)
+            || (options.maxBatchFaces < (MAX_POLY - 2))
+            || (options.maxBatchFaces > (UINT32_MAX / 3)))
+            return E_INVALIDARG;
+
+        using namespace DirectX;
+
+        MappedFile file;
+        HRESULT hr = file.Open(szFileName);
+        if (FAILED(hr))
+            return hr;
+
+        SetName(szFileName);
+
+        Material defmat;
+
+        wcscpy_s(defmat.strName, L"default");
+        materials.emplace_back(defmat);
+
+        std::vector<Vertex> batchVertices;
+        std::vector<index_t> batchIndices;
+        std::vector<uint32_t> batchAttributes;
+        StreamWeldTable weldTable;
+        try
+        {
+            batchVertices.reserve(options.maxBatchVertices);
+            batchIndices.reserve(options.maxBatchFaces * 3);
+            batchAttributes.reserve(options.maxBatchFaces);
+            weldTable.Reserve(options.maxBatchVertices);
+        }
+        catch (const std::bad_alloc&)
+        {
+            return E_OUTOFMEMORY;
+        }
+
+        const size_t batchBytes = batchVertices.capacity() * sizeof(Vertex)
+            + batchIndices.capacity() * sizeof(index_t)
+            + batchAttributes.capacity() * sizeof(uint32_t)
+            + weldTable.bytes();
+
+        size_t ramLimit = SIZE_MAX;
+        if (options.memoryLimit)
+        {
+            ramLimit = (options.memoryLimit > batchBytes) ? (options.memoryLimit - batchBytes) : 0;
+        }
+
+        StreamMemory memory(ramLimit);
+        SpillArray<XMFLOAT3> positions;
+        SpillArray<XMFLOAT3> normals;
+        SpillArray<XMFLOAT2> texCoords;
+
+        XMFLOAT3 vMin(0.f, 0.f, 0.f);
+        XMFLOAT3 vMax(0.f, 0.f, 0.f);
+
+        size_t batchCount = 0;
+        size_t faceCount = 0;
+
+        auto flush = [&]() -> HRESULT
+            {
+                if (batchAttributes.empty())
+                    return S_OK;
+
+                StreamBatch batch = {};
+                batch.vertices = batchVertices.data();
+                batch.vertexCount = batchVertices.size();
+                batch.indices = batchIndices.data();
+                batch.indexCount = batchIndices.size();
+                batch.attributes = batchAttributes.data();
+                batch.baseFace = faceCount;
+
+                const HRESULT hrCallback = callback(batch);
+
+                ++batchCount;
+                faceCount += batchAttributes.size();
+
+                batchVertices.clear();
+                batchIndices.clear();
+                batchAttributes.clear();
+                weldTable.Clear();
+
+                return hrCallback;
+            };
+
+        wchar_t strMaterialFilename[MAX_PATH] = {};
+        uint32_t curSubset = 0;
+
+        const char* ptr = file.data();
+        const char* end = ptr + file.size();
+        while (ptr < end)
+        {
+            const char* cmd = nullptr;
+            const size_t cmdLen = ReadToken(ptr, end, cmd);
+            if (!cmdLen)
+                break;
+
+            bool valid = true;
+
+            if (*cmd == '#')
+            {
+                // Comment
+            }
+            else if (IsCommand(cmd, cmdLen, "v"))
+            {
+                // Vertex Position
+                float x = 0.f, y = 0.f, z = 0.f;
+                valid = ParseFloat(ptr, end, x) && ParseFloat(ptr, end, y) && ParseFloat(ptr, end, z);
+                if (!positions.size())
+                {
+                    vMin = vMax = XMFLOAT3(x, y, z);
+                }
+                vMin = XMFLOAT3(std::min(vMin.x, x), std::min(vMin.y, y), std::min(vMin.z, z));
+                vMax = XMFLOAT3(std::max(vMax.x, x), std::max(vMax.y, y), std::max(vMax.z, z));
+
+                hr = positions.push_back(XMFLOAT3(x, y, z), memory);
+            }
+            else if (IsCommand(cmd, cmdLen, "vt"))
+            {
+                // Vertex TexCoord
+                float u = 0.f, v = 0.f;
+                valid = ParseFloat(ptr, end, u) && ParseFloat(ptr, end, v);
+                hr = texCoords.push_back(XMFLOAT2(u, v), memory);
+
+                hasTexcoords = true;
+            }
+            else if (IsCommand(cmd, cmdLen, "vn"))
+            {
+                // Vertex Normal
+                float x = 0.f, y = 0.f, z = 0.f;
+                valid = ParseFloat(ptr, end, x) && ParseFloat(ptr, end, y) && ParseFloat(ptr, end, z);
+                hr = normals.push_back(XMFLOAT3(x, y, z), memory);
+
+                hasNormals = true;
+            }
+            else if (IsCommand(cmd, cmdLen, "f"))
+            {
+                // Face
+                uint32_t corners[MAX_POLY][3];
+                size_t iFace = 0;
+                for (;;)
+                {
+                    if (iFace >= MAX_POLY)
+                    {
+                        // Too many polygon verts for the reader
+                        return E_FAIL;
+                    }
+
+                    int iPosition = 0;
+                    std::ignore = ParseInt(ptr, end, iPosition);
+
+                    uint32_t* corner = corners[iFace];
+                    corner[1] = corner[2] = StreamWeldTable::c_Absent;
+
+                    if (!iPosition)
+                    {
+                        // 0 is not allowed for index
+                        return E_UNEXPECTED;
+                    }
+                    else if (!ResolveIndex(iPosition, positions.size(), corner[0]))
+                        return E_FAIL;
+
+                    if (ptr < end && *ptr == '/')
+                    {
+                        ++ptr;
+
+                        if (ptr < end && *ptr != '/')
+                        {
+                            // Optional texture coordinate
+                            int iTexCoord = 0;
+                            std::ignore = ParseInt(ptr, end, iTexCoord);
+
+                            if (!iTexCoord)
+                            {
+                                // 0 is not allowed for index
+                                return E_UNEXPECTED;
+                            }
+                            else if (!ResolveIndex(iTexCoord, texCoords.size(), corner[1]))
+                                return E_FAIL;
+                        }
+
+                        if (ptr < end && *ptr == '/')
+                        {
+                            ++ptr;
+
+                            // Optional vertex normal
+                            int iNormal = 0;
+                            std::ignore = ParseInt(ptr, end, iNormal);
+
+                            if (!iNormal)
+                            {
+                                // 0 is not allowed for index
+                                return E_UNEXPECTED;
+                            }
+                            else if (!ResolveIndex(iNormal, normals.size(), corner[2]))
+                                return E_FAIL;
+                        }
+                    }
+
+                    ++iFace;
+
+                    // Check for more face data or end of the face statement
+                    bool faceEnd = false;
+                    for (;;)
+                    {
+                        if (ptr >= end || *ptr == '\n')
+                        {
+                            faceEnd = true;
+                            break;
+                        }
+                        else if (IsDigit(*ptr) || *ptr == '-' || *ptr == '+')
+                            break;
+
+                        ++ptr;
+                    }
+
+                    if (faceEnd)
+                        break;
+                }
+
+                if (iFace < 3)
+                {
+                    // Need at least 3 points to form a triangle
+                    return E_FAIL;
+                }
+
+                // Polygons are never split across batches
+                if ((batchVertices.size() + iFace) > options.maxBatchVertices
+                    || (batchAttributes.size() + iFace - 2) > options.maxBatchFaces)
+                {
+                    hr = flush();
+                    if (FAILED(hr))
+                        return hr;
+                }
+
+                uint32_t faceIndex[MAX_POLY];
+                for (size_t j = 0; j < iFace; ++j)
+                {
+                    const uint32_t* corner = corners[j];
+                    faceIndex[j] = weldTable.Find(corner, static_cast<uint32_t>(batchVertices.size()));
+                    if (faceIndex[j] == batchVertices.size())
+                    {
+                        Vertex vertex;
+                        memset(&vertex, 0, sizeof(vertex));
+
+                        vertex.position = positions[corner[0]];
+                        if (corner[1] != StreamWeldTable::c_Absent)
+                        {
+                            vertex.textureCoordinate = texCoords[corner[1]];
+                        }
+                        if (corner[2] != StreamWeldTable::c_Absent)
+                        {
+                            vertex.normal = normals[corner[2]];
+                        }
+
+                        batchVertices.emplace_back(vertex);
+                    }
+                }
+
+                TriangulateFace(faceIndex, iFace, options.ccw, curSubset, batchIndices, batchAttributes);
+            }
+            else if (IsCommand(cmd, cmdLen, "mtllib"))
+            {
+                // Material library
+                ReadToken(ptr, end, strMaterialFilename, MAX_PATH);
+            }
+            else if (IsCommand(cmd, cmdLen, "usemtl"))
+            {
+                // Material
+                wchar_t strName[MAX_PATH] = {};
+                ReadToken(ptr, end, strName, MAX_PATH);
+
+                curSubset = FindOrAddMaterial(strName);
+            }
+
+            if (FAILED(hr))
+                return hr;
+
+            // Malformed numeric data ends parsing, matching the stream reader's fail state
+            if (!valid)
+                break;
+
+            SkipLine(ptr, end);
+        }
+
+        hr = flush();
+        if (FAILED(hr))
+            return hr;
+
+        if (!positions.size())
+            return E_FAIL;
+
+        file.Close();
+
+        const XMFLOAT3 extremes[2] = { vMin, vMax };
+        BoundingBox::CreateFromPoints(bounds, 2, extremes, sizeof(XMFLOAT3));
+
+        if (stats)
+        {
+            stats->batches = batchCount;
+            stats->faces = faceCount;
+            stats->peakMemory = batchBytes + memory.ramBytes();
+            stats->spilledBytes = memory.spilledBytes();
+        }
+
+        // If an associated material file was found, read that in as well.
+        return LoadMaterialLibrary(szFileName, strMaterialFilename);
+    }
+
+    struct Material
+    {
+        DirectX::XMFLOAT3 vAmbient;
+        DirectX::XMFLOAT3 vDiffuse;
+        DirectX::XMFLOAT3 vSpecular;
+        DirectX::XMFLOAT3 vEmissive;
+        uint32_t nShininess;
+        float fAlpha;
+
+        bool bSpecular;
+        bool bEmissive;
+
+        wchar_t strName[MAX_PATH];
+        wchar_t strTexture[MAX_PATH];
+        wchar_t strNormalTexture[MAX_PATH];
+        wchar_t strSpecularTexture[MAX_PATH];
+        wchar_t strEmissiveTexture[MAX_PATH];
+        wchar_t strRMATexture[MAX_PATH];
+
+        Material() noexcept :
+        vAmbient(0.2f, 0.2f, 0.2f),
+            vDiffuse(0.8f, 0.8f, 0.8f),
+            vSpecular(1.0f, 1.0f, 1.0f),
+            vEmissive(0.f, 0.f, 0.f),
+            nShininess(0),
+            fAlpha(1.f),
+            bSpecular(false),
+            bEmissive(false),
+            strName{},
+            strTexture{},
+            strNormalTexture{},
+            strSpecularTexture{},
+            strEmissiveTexture{},
+            strRMATexture{}
+        {
+        }
+    };
+
+    std::vector<Vertex>     vertices;
     std::vector<index_t>    indices;
     std::vector<uint32_t>   attributes;
     std::vector<Material>   materials;
 
-    std::wstring            name;
-    bool                    hasNormals;
-    bool                    hasTexcoords;
+    std::wstring            name;
+    bool                    hasNormals;
+    bool                    hasTexcoords;
+
+    DirectX::BoundingBox    bounds;
+
+private:
+    // MTL file the materials were read from and its write time at that point, recorded in
+    // the binary cache so LoadCached notices when it changes
+    std::wstring            materialLibrary;
+    uint64_t                materialLibraryTime;
+
+    // Flat vertex welding table. OBJ position indices are dense, so they directly address the
+    // head of a chain of welded vertices sharing that position; chain links are kept in a
+    // parallel array instead of per-entry allocations. Keying on the position index keeps the
+    // spatial locality of the face data, which measured faster than hashing the whole vertex.
+    class VertexCache
+    {
+    public:
+        VertexCache() = default;
+
+        VertexCache(const VertexCache&) = delete;
+        VertexCache& operator=(const VertexCache&) = delete;
+
+        VertexCache(VertexCache&&) = default;
+        VertexCache& operator=(VertexCache&&) = default;
+
+        void Reserve(size_t positionCount, size_t vertexCount)
+        {
+            if (positionCount > m_head.size())
+            {
+                m_head.resize(positionCount, c_Empty);
+            }
+            m_next.reserve(vertexCount);
+        }
+
+        // Returns the index of an identical vertex, or appends the vertex and returns the new index
+        uint32_t Add(const Vertex& vertex, uint32_t positionIndex, std::vector<Vertex>& vertices)
+        {
+            if (positionIndex >= m_head.size())
+            {
+                m_head.resize(std::max<size_t>(size_t(positionIndex) + 1, m_head.size() * 2), c_Empty);
+            }
+
+            for (uint32_t index = m_head[positionIndex]; index != c_Empty; index = m_next[index])
+            {
+                if (0 == memcmp(&vertex, &vertices[index], sizeof(Vertex)))
+                    return index;
+            }
+
+            assert(m_next.size() == vertices.size());
+
+            const auto index = static_cast<uint32_t>(vertices.size());
+            vertices.emplace_back(vertex);
+
+            m_next.push_back(m_head[positionIndex]);
+            m_head[positionIndex] = index;
+
+            return index;
+        }
+
+        void Clear() noexcept
+        {
+            m_head.clear();
+            m_next.clear();
+        }
+
+        bool empty() const noexcept { return m_next.empty(); }
+        size_t size() const noexcept { return m_next.size(); }
+
+    private:
+        static constexpr uint32_t c_Empty = UINT32_MAX;
+
+        std::vector<uint32_t>   m_head;     // First vertex for each position index
+        std::vector<uint32_t>   m_next;     // Next vertex with the same position
+    };
+
+    uint32_t AddVertex(uint32_t positionIndex, const Vertex* pVertex, VertexCache& cache)
+    {
+        return cache.Add(*pVertex, positionIndex, vertices);
+    }
+
+    void ReserveVertices(VertexCache& cache, size_t positionCount, size_t cornerCount)
+    {
+        // Most meshes weld to slightly more vertices than positions (UV and normal seams),
+        // and never more than one per face corner or than the index format can address.
+        constexpr size_t maxVertices = (sizeof(index_t) == 2) ? UINT16_MAX : UINT32_MAX;
+
+        size_t estimate = positionCount + positionCount / 4;
+        estimate = std::min(estimate, cornerCount);
+        estimate = std::min(estimate, maxVertices);
+
+        cache.Reserve(positionCount, estimate);
+        vertices.reserve(estimate);
+    }
+
+    void SetName(_In_z_ const wchar_t* szFileName)
+    {
+#ifdef _WIN32
+        wchar_t fname[_MAX_FNAME] = {};
+        _wsplitpath_s(szFileName, nullptr, 0, nullptr, 0, fname, _MAX_FNAME, nullptr, 0);
+        name = fname;
+#else
+        auto path = std::filesystem::path(szFileName);
+        name = path.stem().wstring();
+#endif
+    }
+
+    uint32_t FindOrAddMaterial(_In_z_ const wchar_t* strName)
+    {
+        uint32_t count = 0;
+        for (auto it = materials.cbegin(); it != materials.cend(); ++it, ++count)
+        {
+            if (0 == wcscmp(it->strName, strName))
+            {
+                return count;
+            }
+        }
+
+        Material mat;
+        wcscpy_s(mat.strName, MAX_PATH - 1, strName);
+        materials.emplace_back(mat);
+        return count;
+    }
+
+    HRESULT LoadMaterialLibrary(_In_z_ const wchar_t* szFileName, _In_z_ const wchar_t* strMaterialFilename)
+    {
+        if (!*strMaterialFilename)
+            return S_OK;
+
+#ifdef _WIN32
+        wchar_t fname[_MAX_FNAME] = {};
+        wchar_t ext[_MAX_EXT] = {};
+        _wsplitpath_s(strMaterialFilename, nullptr, 0, nullptr, 0, fname, _MAX_FNAME, ext, _MAX_EXT);
+
+        wchar_t drive[_MAX_DRIVE] = {};
+        wchar_t dir[_MAX_DIR] = {};
+        _wsplitpath_s(szFileName, drive, _MAX_DRIVE, dir, _MAX_DIR, nullptr, 0, nullptr, 0);
+
+        wchar_t szPath[MAX_PATH] = {};
+        _wmakepath_s(szPath, MAX_PATH, drive, dir, fname, ext);
+        materialLibrary = szPath;
+#else
+        auto path = std::filesystem::path(szFileName);
+        auto mtlpath = std::filesystem::path(strMaterialFilename);
+        path.replace_filename(mtlpath.filename());
+        path.replace_extension(mtlpath.extension());
+        materialLibrary = path.wstring();
+#endif
+
+        // Taken before reading, so an edit made during the load leaves the cache stale
+        std::ignore = GetWriteTime(materialLibrary.c_str(), materialLibraryTime);
+        return LoadMTL(materialLibrary.c_str());
+    }
+
+    void CopyCache(const CacheView& view, bool ccw)
+    {
+        name.assign(view.name, view.nameLength);
+        materialLibrary.assign(view.materialLibrary, view.materialLibraryLength);
+        materialLibraryTime = view.materialLibraryTime;
+        vertices.assign(view.vertices, view.vertices + view.vertexCount);
+        indices.assign(view.indices, view.indices + view.indexCount);
+        attributes.assign(view.attributes, view.attributes + view.attributeCount);
+        materials.assign(view.materials, view.materials + view.materialCount);
+        hasNormals = view.hasNormals;
+        hasTexcoords = view.hasTexcoords;
+        bounds = view.bounds;
+
+        if (view.ccw != ccw)
+        {
+            // Triangulation emits the same fans for either winding, so flipping is exact
+            for (size_t j = 0; j < indices.size(); j += 3)
+            {
+                std::swap(indices[j + 1], indices[j + 2]);
+            }
+        }
+    }
+
+    //----------------------------------------------------------------------------------
+    // Read-only memory mapping of a whole file
+    class MappedFile
+    {
+    public:
+        MappedFile() noexcept : m_data(nullptr), m_size(0)
+#ifdef _WIN32
+            , m_hFile(INVALID_HANDLE_VALUE), m_hMapping(nullptr)
+#endif
+        {}
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile() { Close(); }
+
+        HRESULT Open(_In_z_ const wchar_t* szFileName) noexcept
+        {
+            Close();
+
+#ifdef _WIN32
+            m_hFile = CreateFileW(szFileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (m_hFile == INVALID_HANDLE_VALUE)
+                return HRESULT_FROM_WIN32(GetLastError());
+
+            LARGE_INTEGER fileSize = {};
+            if (!GetFileSizeEx(m_hFile, &fileSize))
+                return HRESULT_FROM_WIN32(GetLastError());
+
+            if (!fileSize.QuadPart)
+                return E_FAIL;
+
+#if defined(_WIN64)
+            m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+            if (fileSize.HighPart > 0)
+                return HRESULT_FROM_WIN32(ERROR_FILE_TOO_LARGE);
+            m_size = fileSize.LowPart;
+#endif
+
+            m_hMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!m_hMapping)
+                return HRESULT_FROM_WIN32(GetLastError());
+
+            m_data = static_cast<const char*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+            if (!m_data)
+                return HRESULT_FROM_WIN32(GetLastError());
+#else
+            const int fd = open(std::filesystem::path(szFileName).c_str(), O_RDONLY);
+            if (fd == -1)
+                return /* HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) */ static_cast<HRESULT>(0x80070002L);
+
+            struct stat st = {};
+            if (fstat(fd, &st) == -1 || st.st_size <= 0)
+            {
+                close(fd);
+                return E_FAIL;
+            }
+
+            m_size = static_cast<size_t>(st.st_size);
+
+            void* ptr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (ptr == MAP_FAILED)
+                return E_FAIL;
+
+            std::ignore = madvise(ptr, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(ptr);
+#endif
+
+            return S_OK;
+        }
+
+        void Close() noexcept
+        {
+#ifdef _WIN32
+            if (m_data)
+                std::ignore = UnmapViewOfFile(m_data);
+            if (m_hMapping)
+                std::ignore = CloseHandle(m_hMapping);
+            if (m_hFile != INVALID_HANDLE_VALUE)
+                std::ignore = CloseHandle(m_hFile);
+            m_hMapping = nullptr;
+            m_hFile = INVALID_HANDLE_VALUE;
+#else
+            if (m_data)
+                std::ignore = munmap(const_cast<char*>(m_data), m_size);
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        const char* data() const noexcept { return m_data; }
+        size_t size() const noexcept { return m_size; }
+
+    private:
+        const char* m_data;
+        size_t      m_size;
+#ifdef _WIN32
+        HANDLE      m_hFile;
+        HANDLE      m_hMapping;
+#endif
+    };
+
+    //----------------------------------------------------------------------------------
+    // Binary cache file layout: a CacheHeader followed by the name, material library path,
+    // vertex, index, attribute and material arrays, each starting on a c_CacheAlignment
+    // boundary. A cache is only valid for builds with the same index format, Vertex/Material
+    // layout and wchar_t size.
+    static constexpr uint32_t c_CacheMagic = 0x43524657; // "WFRC"
+    static constexpr uint32_t c_CacheVersion = 2;
+    static constexpr size_t c_CacheAlignment = 64;
+    static constexpr const wchar_t* c_CacheExtension = L".wfrcache";
+
+    enum CacheFlags : uint32_t
+    {
+        CACHE_NORMALS = 0x1,
+        CACHE_TEXCOORDS = 0x2,
+        CACHE_CCW = 0x4,
+    };
+
+    struct CacheHeader
+    {
+        uint32_t            magic;
+        uint32_t            version;
+        uint32_t            indexSize;
+        uint32_t            vertexSize;
+        uint32_t            materialSize;
+        uint32_t            charSize;
+        uint32_t            flags;
+        uint32_t            reserved;
+        uint64_t            nameLength;
+        uint64_t            materialLibraryLength;
+        uint64_t            vertexCount;
+        uint64_t            indexCount;
+        uint64_t            attributeCount;
+        uint64_t            materialCount;
+        uint64_t            nameOffset;
+        uint64_t            materialLibraryOffset;
+        uint64_t            vertexOffset;
+        uint64_t            indexOffset;
+        uint64_t            attributeOffset;
+        uint64_t            materialOffset;
+        uint64_t            fileSize;
+        uint64_t            materialLibraryTime;    // Write time of the MTL file when it was read
+        DirectX::XMFLOAT3   center;
+        DirectX::XMFLOAT3   extents;
+    };
+
+    static_assert(sizeof(CacheHeader) == 168, "CacheHeader layout mismatch");
+
+    static uint64_t AlignCache(uint64_t offset) noexcept
+    {
+        return (offset + c_CacheAlignment - 1) & ~uint64_t(c_CacheAlignment - 1);
+    }
+
+    static bool RemoveCacheFile(_In_z_ const wchar_t* szFileName) noexcept
+    {
+#ifdef _WIN32
+        return DeleteFileW(szFileName) != 0;
+#else
+        return unlink(std::filesystem::path(szFileName).c_str()) == 0;
+#endif
+    }
+
+    // File system write time, only meaningful for comparisons on the same machine
+    static bool GetWriteTime(_In_z_ const wchar_t* szFileName, uint64_t& time) noexcept
+    {
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA data = {};
+        if (!GetFileAttributesExW(szFileName, GetFileExInfoStandard, &data))
+            return false;
+
+        time = (uint64_t(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+#else
+        struct stat data = {};
+        if (stat(std::filesystem::path(szFileName).c_str(), &data) != 0)
+            return false;
+
+        time = uint64_t(data.st_mtim.tv_sec) * 1000000000ull + uint64_t(data.st_mtim.tv_nsec);
+#endif
+        return true;
+    }
+
+public:
+    // Read-only view of a binary cache written by SaveCache. The pointers reference the
+    // file mapping directly and remain valid until the view is closed or destroyed. Open
+    // checks every index and attribute against the vertex and material counts, and that
+    // the material strings are terminated, so the data can be used without further checks.
+    class CacheView
+    {
+    public:
+        CacheView() noexcept { Reset(); }
+
+        CacheView(const CacheView&) = delete;
+        CacheView& operator=(const CacheView&) = delete;
+
+        HRESULT Open(_In_z_ const wchar_t* szCacheFile) noexcept
+        {
+            Close();
+
+            HRESULT hr = m_file.Open(szCacheFile);
+            if (FAILED(hr))
+                return hr;
+
+            if (m_file.size() < sizeof(CacheHeader))
+            {
+                Close();
+                return E_FAIL;
+            }
+
+            CacheHeader header;
+            memcpy(&header, m_file.data(), sizeof(CacheHeader));
+
+            if (header.magic != c_CacheMagic
+                || header.version != c_CacheVersion
+                || header.indexSize != sizeof(index_t)
+                || header.vertexSize != sizeof(Vertex)
+                || header.materialSize != sizeof(Material)
+                || header.charSize != sizeof(wchar_t)
+                || header.fileSize != m_file.size()
+                || !header.vertexCount
+                || !header.materialCount
+                || (header.attributeCount * 3) != header.indexCount
+                || !IsValidSection(header, header.nameOffset, header.nameLength, sizeof(wchar_t))
+                || !IsValidSection(header, header.materialLibraryOffset, header.materialLibraryLength, sizeof(wchar_t))
+                || !IsValidSection(header, header.vertexOffset, header.vertexCount, sizeof(Vertex))
+                || !IsValidSection(header, header.indexOffset, header.indexCount, sizeof(index_t))
+                || !IsValidSection(header, header.attributeOffset, header.attributeCount, sizeof(uint32_t))
+                || !IsValidSection(header, header.materialOffset, header.materialCount, sizeof(Material)))
+            {
+                Close();
+                return E_FAIL;
+            }
+
+            const char* base = m_file.data();
+            if (!IsValidData(header,
+                reinterpret_cast<const index_t*>(base + header.indexOffset),
+                reinterpret_cast<const uint32_t*>(base + header.attributeOffset),
+                reinterpret_cast<const Material*>(base + header.materialOffset)))
+            {
+                Close();
+                return E_FAIL;
+            }
+
+            name = reinterpret_cast<const wchar_t*>(base + header.nameOffset);
+            materialLibrary = reinterpret_cast<const wchar_t*>(base + header.materialLibraryOffset);
+            vertices = reinterpret_cast<const Vertex*>(base + header.vertexOffset);
+            indices = reinterpret_cast<const index_t*>(base + header.indexOffset);
+            attributes = reinterpret_cast<const uint32_t*>(base + header.attributeOffset);
+            materials = reinterpret_cast<const Material*>(base + header.materialOffset);
+            nameLength = static_cast<size_t>(header.nameLength);
+            materialLibraryLength = static_cast<size_t>(header.materialLibraryLength);
+            materialLibraryTime = header.materialLibraryTime;
+            vertexCount = static_cast<size_t>(header.vertexCount);
+            indexCount = static_cast<size_t>(header.indexCount);
+            attributeCount = static_cast<size_t>(header.attributeCount);
+            materialCount = static_cast<size_t>(header.materialCount);
+            hasNormals = (header.flags & CACHE_NORMALS) != 0;
+            hasTexcoords = (header.flags & CACHE_TEXCOORDS) != 0;
+            ccw = (header.flags & CACHE_CCW) != 0;
+            bounds.Center = header.center;
+            bounds.Extents = header.extents;
+
+            return S_OK;
+        }
+
+        void Close() noexcept
+        {
+            m_file.Close();
+            Reset();
+        }
+
+        const wchar_t*          name;
+        const wchar_t*          materialLibrary;        // Path of the MTL file, not terminated
+        const Vertex*           vertices;
+        const index_t*          indices;
+        const uint32_t*         attributes;
+        const Material*         materials;
+        size_t                  nameLength;
+        size_t                  materialLibraryLength;
+        uint64_t                materialLibraryTime;
+        size_t                  vertexCount;
+        size_t                  indexCount;
+        size_t                  attributeCount;
+        size_t                  materialCount;
+        bool                    hasNormals;
+        bool                    hasTexcoords;
+        bool                    ccw;
+        DirectX::BoundingBox    bounds;
+
+    private:
+        static bool IsValidSection(const CacheHeader& header, uint64_t offset, uint64_t count, size_t stride) noexcept
+        {
+            return (offset % c_CacheAlignment) == 0
+                && offset >= sizeof(CacheHeader)
+                && offset <= header.fileSize
+                && count <= (header.fileSize - offset) / stride;
+        }
+
+        static bool IsValidData(const CacheHeader& header, const index_t* pIndices, const uint32_t* pAttributes, const Material* pMaterials) noexcept
+        {
+            for (uint64_t j = 0; j < header.indexCount; ++j)
+            {
+                if (pIndices[j] >= header.vertexCount)
+                    return false;
+            }
+
+            for (uint64_t j = 0; j < header.attributeCount; ++j)
+            {
+                if (pAttributes[j] >= header.materialCount)
+                    return false;
+            }
+
+            for (uint64_t j = 0; j < header.materialCount; ++j)
+            {
+                const Material& mat = pMaterials[j];
+                if (!wmemchr(mat.strName, 0, MAX_PATH)
+                    || !wmemchr(mat.strTexture, 0, MAX_PATH)
+                    || !wmemchr(mat.strNormalTexture, 0, MAX_PATH)
+                    || !wmemchr(mat.strSpecularTexture, 0, MAX_PATH)
+                    || !wmemchr(mat.strEmissiveTexture, 0, MAX_PATH)
+                    || !wmemchr(mat.strRMATexture, 0, MAX_PATH))
+                    return false;
+            }
+
+            return true;
+        }
+
+        void Reset() noexcept
+        {
+            name = nullptr;
+            materialLibrary = nullptr;
+            vertices = nullptr;
+            indices = nullptr;
+            attributes = nullptr;
+            materials = nullptr;
+            nameLength = materialLibraryLength = vertexCount = indexCount = attributeCount = materialCount = 0;
+            materialLibraryTime = 0;
+            hasNormals = hasTexcoords = ccw = false;
+            bounds.Center = bounds.Extents = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
+        }
+
+        MappedFile  m_file;
+    };
+
+private:
+    // Returns true if the cache was written after the source was last modified, and the
+    // material library it was built from has not been modified since it was read
+    static bool IsCacheCurrent(_In_z_ const wchar_t* szSourceFile, _In_z_ const wchar_t* szCacheFile, const CacheView& view)
+    {
+        uint64_t sourceTime = 0;
+        uint64_t cacheTime = 0;
+        if (!GetWriteTime(szSourceFile, sourceTime)
+            || !GetWriteTime(szCacheFile, cacheTime)
+            || cacheTime <= sourceTime)
+            return false;
+
+        if (!view.materialLibraryLength)
+            return true;
+
+        const std::wstring materialLibraryPath(view.materialLibrary, view.materialLibraryLength);
+
+        uint64_t materialLibraryTime = 0;
+        return GetWriteTime(materialLibraryPath.c_str(), materialLibraryTime)
+            && materialLibraryTime == view.materialLibraryTime;
+    }
+
+    //----------------------------------------------------------------------------------
+    // Segment allocator for LoadStreaming. Segments come from the heap until the RAM limit
+    // is reached, then from a read/write mapping of a temporary file deleted on close.
+    class StreamMemory
+    {
+    public:
+        explicit StreamMemory(size_t ramLimit) noexcept :
+            m_ramLimit(ramLimit), m_ramBytes(0), m_fileSize(0)
+#ifdef _WIN32
+            , m_hFile(INVALID_HANDLE_VALUE)
+#else
+            , m_fd(-1)
+#endif
+        {}
+
+        StreamMemory(const StreamMemory&) = delete;
+        StreamMemory& operator=(const StreamMemory&) = delete;
+
+        ~StreamMemory()
+        {
+            for (const auto& it : m_views)
+            {
+#ifdef _WIN32
+                std::ignore = UnmapViewOfFile(it.first);
+#else
+                std::ignore = munmap(it.first, it.second);
+#endif
+            }
+
+#ifdef _WIN32
+            if (m_hFile != INVALID_HANDLE_VALUE)
+                std::ignore = CloseHandle(m_hFile);
+#else
+            if (m_fd != -1)
+                std::ignore = close(m_fd);
+#endif
+        }
+
+        void* Allocate(size_t bytes) noexcept
+        {
+            if (bytes <= m_ramLimit && m_ramBytes <= (m_ramLimit - bytes))
+            {
+                std::unique_ptr<char[]> block(new (std::nothrow) char[bytes]);
+                if (block)
+                {
+                    try
+                    {
+                        m_blocks.emplace_back(std::move(block));
+                    }
+                    catch (const std::bad_alloc&)
+                    {
+                        return nullptr;
+                    }
+
+                    m_ramBytes += bytes;
+                    return m_blocks.back().get();
+                }
+            }
+
+            return Spill(bytes);
+        }
+
+        size_t ramBytes() const noexcept { return m_ramBytes; }
+        size_t spilledBytes() const noexcept { return static_cast<size_t>(m_fileSize); }
+
+    private:
+        void* Spill(size_t bytes) noexcept
+        {
+            try
+            {
+                m_views.reserve(m_views.size() + 1);
+            }
+            catch (const std::bad_alloc&)
+            {
+                return nullptr;
+            }
+
+            const uint64_t fileEnd = m_fileSize + bytes;
+            void* ptr = nullptr;
+
+#ifdef _WIN32
+            if (m_hFile == INVALID_HANDLE_VALUE)
+            {
+                wchar_t tempPath[MAX_PATH] = {};
+                wchar_t tempFile[MAX_PATH] = {};
+                if (!GetTempPathW(MAX_PATH, tempPath) || !GetTempFileNameW(tempPath, L"wfr", 0, tempFile))
+                    return nullptr;
+
+                m_hFile = CreateFileW(tempFile, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                    FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+                if (m_hFile == INVALID_HANDLE_VALUE)
+                    return nullptr;
+            }
+
+            // Each segment gets its own view; the mapping object grows the file as needed
+            HANDLE hMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_READWRITE,
+                static_cast<DWORD>(fileEnd >> 32), static_cast<DWORD>(fileEnd), nullptr);
+            if (!hMapping)
+                return nullptr;
+
+            ptr = MapViewOfFile(hMapping, FILE_MAP_WRITE,
+                static_cast<DWORD>(m_fileSize >> 32), static_cast<DWORD>(m_fileSize), bytes);
+            std::ignore = CloseHandle(hMapping);
+            if (!ptr)
+                return nullptr;
+#else
+            if (m_fd == -1)
+            {
+                std::error_code ec;
+                std::string tempFile = (std::filesystem::temp_directory_path(ec) / "wfrspillXXXXXX").string();
+                if (ec)
+                    return nullptr;
+
+                m_fd = mkstemp(&tempFile[0]);
+                if (m_fd == -1)
+                    return nullptr;
+
+                std::ignore = unlink(tempFile.c_str());
+            }
+
+            if (ftruncate(m_fd, static_cast<off_t>(fileEnd)) != 0)
+                return nullptr;
+
+            ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, static_cast<off_t>(m_fileSize));
+            if (ptr == MAP_FAILED)
+                return nullptr;
+#endif
+
+            m_views.emplace_back(ptr, bytes);
+            m_fileSize = fileEnd;
+            return ptr;
+        }
+
+        size_t                                  m_ramLimit;
+        size_t                                  m_ramBytes;
+        uint64_t                                m_fileSize;
+        std::vector<std::unique_ptr<char[]>>    m_blocks;
+        std::vector<std::pair<void*, size_t>>   m_views;
+#ifdef _WIN32
+        HANDLE                                  m_hFile;
+#else
+        int                                     m_fd;
+#endif
+    };
+
+    // Append-only array stored in fixed-size segments from StreamMemory. Segment sizes are a
+    // multiple of 64K for 4-byte aligned types, which satisfies the Windows view granularity.
+    template<class T>
+    class SpillArray
+    {
+    public:
+        static constexpr size_t c_SegmentElements = 16384;
+
+        static_assert((sizeof(T) % 4) == 0, "Segment size must be a multiple of 64K");
+
+        SpillArray() noexcept : m_size(0) {}
+
+        HRESULT push_back(const T& value, StreamMemory& memory)
+        {
+            const size_t offset = m_size % c_SegmentElements;
+            if (!offset)
+            {
+                void* segment = memory.Allocate(sizeof(T) * c_SegmentElements);
+                if (!segment)
+                    return E_OUTOFMEMORY;
+
+                m_segments.push_back(static_cast<T*>(segment));
+            }
+
+            m_segments.back()[offset] = value;
+            ++m_size;
+            return S_OK;
+        }
+
+        const T& operator[](size_t index) const noexcept
+        {
+            assert(index < m_size);
+            return m_segments[index / c_SegmentElements][index % c_SegmentElements];
+        }
+
+        size_t size() const noexcept { return m_size; }
+
+    private:
+        std::vector<T*> m_segments;
+        size_t          m_size;
+    };
+
+    // Welds the corners of one LoadStreaming batch by their position/texcoord/normal indices
+    class StreamWeldTable
+    {
+    public:
+        static constexpr uint32_t c_Absent = UINT32_MAX;
+
+        void Reserve(size_t maxVertices)
+        {
+            size_t capacity = 16;
+            while (capacity < maxVertices * 2)
+            {
+                capacity <<= 1;
+            }
+
+            m_slots.resize(capacity);
+            for (auto& it : m_slots)
+            {
+                it.index = c_Absent;
+            }
+            m_used.reserve(maxVertices);
+        }
+
+        // Returns the vertex index for the corner, inserting newIndex if it is not yet present
+        uint32_t Find(_In_reads_(3) const uint32_t* corner, uint32_t newIndex) noexcept
+        {
+            const size_t mask = m_slots.size() - 1;
+            size_t slot = (size_t(corner[0]) * 0x9E3779B1u ^ size_t(corner[1]) * 0x85EBCA77u ^ size_t(corner[2]) * 0xC2B2AE3Du) & mask;
+            for (;;)
+            {
+                Slot& entry = m_slots[slot];
+                if (entry.index == c_Absent)
+                {
+                    assert(m_used.size() < m_used.capacity());
+                    entry.position = corner[0];
+                    entry.texcoord = corner[1];
+                    entry.normal = corner[2];
+                    entry.index = newIndex;
+                    m_used.push_back(static_cast<uint32_t>(slot));
+                    return newIndex;
+                }
+
+                if (entry.position == corner[0] && entry.texcoord == corner[1] && entry.normal == corner[2])
+                    return entry.index;
+
+                slot = (slot + 1) & mask;
+            }
+        }
+
+        void Clear() noexcept
+        {
+            for (const auto it : m_used)
+            {
+                m_slots[it].index = c_Absent;
+            }
+            m_used.clear();
+        }
+
+        size_t bytes() const noexcept
+        {
+            return m_slots.capacity() * sizeof(Slot) + m_used.capacity() * sizeof(uint32_t);
+        }
+
+    private:
+        struct Slot
+        {
+            uint32_t position;
+            uint32_t texcoord;
+            uint32_t normal;
+            uint32_t index;
+        };
+
+        std::vector<Slot>       m_slots;
+        std::vector<uint32_t>   m_used;     // Occupied slots, reset when the batch is emitted
+    };
+
+    //----------------------------------------------------------------------------------
+    // Locale-free tokenizer helpers for the mapped path. These mirror the behavior of
+    // std::wistream operator>> with the classic locale for well-formed OBJ content.
+    static bool IsSpace(char c) noexcept
+    {
+        return (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f');
+    }
+
+    static bool IsDigit(char c) noexcept
+    {
+        return (c >= '0' && c <= '9');
+    }
+
+    static void SkipWhitespace(const char*& ptr, const char* end) noexcept
+    {
+        while (ptr < end && IsSpace(*ptr))
+            ++ptr;
+    }
+
+    static void SkipLine(const char*& ptr, const char* end) noexcept
+    {
+        auto eol = static_cast<const char*>(memchr(ptr, '\n', static_cast<size_t>(end - ptr)));
+        ptr = (eol) ? (eol + 1) : end;
+    }
+
+    static size_t ReadToken(const char*& ptr, const char* end, const char*& token) noexcept
+    {
+        SkipWhitespace(ptr, end);
+        token = ptr;
+        while (ptr < end && !IsSpace(*ptr))
+            ++ptr;
+        return static_cast<size_t>(ptr - token);
+    }
+
+    static void ReadToken(const char*& ptr, const char* end, _Out_writes_(maxChar) wchar_t* str, size_t maxChar) noexcept
+    {
+        const char* token = nullptr;
+        size_t len = ReadToken(ptr, end, token);
+        len = std::min(len, maxChar - 1);
+        for (size_t j = 0; j < len; ++j)
+        {
+            str[j] = static_cast<wchar_t>(static_cast<unsigned char>(token[j]));
+        }
+        str[len] = 0;
+    }
+
+    template<size_t N>
+    static bool IsCommand(const char* token, size_t len, const char(&cmd)[N]) noexcept
+    {
+        return (len == N - 1) && (0 == memcmp(token, cmd, N - 1));
+    }
+
+    static bool ParseInt(const char*& ptr, const char* end, int& value) noexcept
+    {
+        value = 0;
+
+        SkipWhitespace(ptr, end);
+
+        const char* p = ptr;
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negative = (*p == '-');
+            ++p;
+        }
+
+        if (p >= end || !IsDigit(*p))
+            return false;
+
+        int64_t result = 0;
+        for (; p < end && IsDigit(*p); ++p)
+        {
+            result = result * 10 + (*p - '0');
+            if (result > INT32_MAX)
+                return false;
+        }
+
+        value = static_cast<int>(negative ? -result : result);
+        ptr = p;
+        return true;
+    }
+
+    static bool ParseFloat(const char*& ptr, const char* end, float& value) noexcept
+    {
+        value = 0.f;
+
+        SkipWhitespace(ptr, end);
+
+        const char* p = ptr;
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negative = (*p == '-');
+            ++p;
+        }
+
+        const char* numStart = p;
+
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool truncated = false;
+        bool any = false;
+
+        for (; p < end && IsDigit(*p); ++p)
+        {
+            any = true;
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + uint64_t(*p - '0');
+                if (mantissa)
+                    ++digits;
+            }
+            else
+            {
+                truncated |= (*p != '0');
+                ++exponent;
+            }
+        }
+
+        if (p < end && *p == '.')
+        {
+            ++p;
+            for (; p < end && IsDigit(*p); ++p)
+            {
+                any = true;
+                if (digits < 19)
+                {
+                    mantissa = mantissa * 10 + uint64_t(*p - '0');
+                    if (mantissa)
+                        ++digits;
+                    --exponent;
+                }
+                else
+                {
+                    truncated |= (*p != '0');
+                }
+            }
+        }
+
+        if (!any)
+            return false;
+
+        if (p < end && (*p == 'e' || *p == 'E'))
+        {
+            const char* e = p + 1;
+            bool negExp = false;
+            if (e < end && (*e == '-' || *e == '+'))
+            {
+                negExp = (*e == '-');
+                ++e;
+            }
+
+            if (e < end && IsDigit(*e))
+            {
+                int exp10 = 0;
+                for (; e < end && IsDigit(*e); ++e)
+                {
+                    if (exp10 < 10000)
+                        exp10 = exp10 * 10 + (*e - '0');
+                }
+                exponent += (negExp) ? -exp10 : exp10;
+                p = e;
+            }
+        }
+
+        ptr = p;
+
+        // Fast path: the mantissa and power of ten are both exact in a float, so a single
+        // multiply or divide is correctly rounded (Clinger's algorithm).
+        static constexpr float s_pow10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+        if (!truncated && mantissa <= (uint64_t(1) << 24) && exponent >= -10 && exponent <= 10)
+        {
+            float result = static_cast<float>(mantissa);
+            result = (exponent < 0) ? (result / s_pow10[-exponent]) : (result * s_pow10[exponent]);
+            value = (negative) ? -result : result;
+            return true;
+        }
+
+        // Slow path for everything else (denormals, long mantissas, large exponents).
+        // Like the stream extraction in Load, a value too large for a float is a parse
+        // failure that stores +/-FLT_MAX, while one too small rounds to zero.
+        float result = 0.f;
+#ifdef __cpp_lib_to_chars
+        auto r = std::from_chars(numStart, p, result);
+        if (r.ec == std::errc::result_out_of_range)
+        {
+            if (exponent + digits > 0)
+            {
+                value = (negative) ? -FLT_MAX : FLT_MAX;
+                return false;
+            }
+
+            result = 0.f;
+        }
+        else if (r.ec != std::errc())
+            return false;
+#else
+        char buff[128] = {};
+        const size_t len = std::min(static_cast<size_t>(p - numStart), std::size(buff) - 1);
+        memcpy(buff, numStart, len);
+        errno = 0;
+        result = strtof(buff, nullptr);
+        if (errno == ERANGE && std::isinf(result))
+        {
+            value = (negative) ? -FLT_MAX : FLT_MAX;
+            return false;
+        }
+#endif
+        value = (negative) ? -result : result;
+        return true;
+    }
+
+    static bool ResolveIndex(int index, size_t count, uint32_t& result) noexcept
+    {
+        if (index < 0)
+        {
+            // Negative values are relative indices
+            result = uint32_t(ptrdiff_t(count) + index);
+        }
+        else
+        {
+            // OBJ format uses 1-based arrays
+            result = uint32_t(index - 1);
+        }
+
+        return (result < count);
+    }
 
-    DirectX::BoundingBox    bounds;
+    static constexpr size_t MAX_POLY = 64;
+    static constexpr size_t c_MinChunkSize = 4096;
 
-private:
-    using VertexCache = std::unordered_multimap<uint32_t, uint32_t>;
+    // Per-thread parse results for LoadParallel
+    struct ParseChunk
+    {
+        struct FaceRecord
+        {
+            uint32_t cornerCount;
+            uint32_t positionCount;
+            uint32_t texCoordCount;
+            uint32_t normalCount;
+            bool     error;
+        };
+
+        struct MaterialRecord
+        {
+            size_t      face;
+            const char* token;
+        };
+
+        const char*                     begin = nullptr;
+        const char*                     end = nullptr;
+        std::vector<DirectX::XMFLOAT3>  positions;
+        std::vector<DirectX::XMFLOAT3>  normals;
+        std::vector<DirectX::XMFLOAT2>  texCoords;
+        std::vector<int32_t>            corners;    // position, texcoord, normal (0 if not present)
+        std::vector<FaceRecord>         faces;
+        std::vector<MaterialRecord>     materialRecords;
+        const char*                     mtllib = nullptr;
+        bool                            hasNormals = false;
+        bool                            hasTexcoords = false;
+        bool                            stop = false;
+        HRESULT                         hr = S_OK;
+
+        static void ReleaseAttributes(ParseChunk& chunk) noexcept
+        {
+            std::vector<DirectX::XMFLOAT3>().swap(chunk.positions);
+            std::vector<DirectX::XMFLOAT3>().swap(chunk.normals);
+            std::vector<DirectX::XMFLOAT2>().swap(chunk.texCoords);
+        }
+    };
+
+    static void ParseChunkRecords(ParseChunk* chunk) noexcept
+    {
+        try
+        {
+            ParseChunkRecordsImpl(*chunk);
+        }
+        catch (const std::bad_alloc&)
+        {
+            chunk->hr = E_OUTOFMEMORY;
+            chunk->stop = true;
+        }
+    }
 
-    uint32_t AddVertex(uint32_t hash, const Vertex* pVertex, VertexCache& cache)
+    static void ParseChunkRecordsImpl(ParseChunk& chunk)
     {
-        auto f = cache.equal_range(hash);
+        using namespace DirectX;
 
-        for (auto it = f.first; it != f.second; ++it)
+        const char* ptr = chunk.begin;
+        const char* end = chunk.end;
+
+        // Rough reservation based on typical record sizes
+        chunk.corners.reserve(static_cast<size_t>(end - ptr) / 8);
+
+        while (ptr < end)
         {
-            auto& tv = vertices[it->second];
+            const char* cmd = nullptr;
+            const size_t cmdLen = ReadToken(ptr, end, cmd);
+            if (!cmdLen)
+                break;
+
+            bool valid = true;
+
+            if (*cmd == '#')
+            {
+                // Comment
+            }
+            else if (IsCommand(cmd, cmdLen, "v"))
+            {
+                float x = 0.f, y = 0.f, z = 0.f;
+                valid = ParseFloat(ptr, end, x) && ParseFloat(ptr, end, y) && ParseFloat(ptr, end, z);
+                chunk.positions.emplace_back(XMFLOAT3(x, y, z));
+            }
+            else if (IsCommand(cmd, cmdLen, "vt"))
+            {
+                float u = 0.f, v = 0.f;
+                valid = ParseFloat(ptr, end, u) && ParseFloat(ptr, end, v);
+                chunk.texCoords.emplace_back(XMFLOAT2(u, v));
+                chunk.hasTexcoords = true;
+            }
+            else if (IsCommand(cmd, cmdLen, "vn"))
+            {
+                float x = 0.f, y = 0.f, z = 0.f;
+                valid = ParseFloat(ptr, end, x) && ParseFloat(ptr, end, y) && ParseFloat(ptr, end, z);
+                chunk.normals.emplace_back(XMFLOAT3(x, y, z));
+                chunk.hasNormals = true;
+            }
+            else if (IsCommand(cmd, cmdLen, "f"))
+            {
+                // Index range checks are deferred to the merge where the global counts are known
+                typename ParseChunk::FaceRecord rec = {};
+                rec.positionCount = static_cast<uint32_t>(chunk.positions.size());
+                rec.texCoordCount = static_cast<uint32_t>(chunk.texCoords.size());
+                rec.normalCount = static_cast<uint32_t>(chunk.normals.size());
+
+                HRESULT hr = S_OK;
+                for (;;)
+                {
+                    if (rec.cornerCount >= MAX_POLY)
+                    {
+                        // Too many polygon verts for the reader
+                        hr = E_FAIL;
+                        break;
+                    }
+
+                    int iPosition = 0;
+                    int iTexCoord = 0;
+                    int iNormal = 0;
+
+                    std::ignore = ParseInt(ptr, end, iPosition);
+                    if (!iPosition)
+                    {
+                        // 0 is not allowed for index
+                        hr = E_UNEXPECTED;
+                        break;
+                    }
+
+                    if (ptr < end && *ptr == '/')
+                    {
+                        ++ptr;
+
+                        if (ptr < end && *ptr != '/')
+                        {
+                            std::ignore = ParseInt(ptr, end, iTexCoord);
+                            if (!iTexCoord)
+                            {
+                                hr = E_UNEXPECTED;
+                                break;
+                            }
+                        }
+
+                        if (ptr < end && *ptr == '/')
+                        {
+                            ++ptr;
+
+                            std::ignore = ParseInt(ptr, end, iNormal);
+                            if (!iNormal)
+                            {
+                                hr = E_UNEXPECTED;
+                                break;
+                            }
+                        }
+                    }
+
+                    chunk.corners.push_back(iPosition);
+                    chunk.corners.push_back(iTexCoord);
+                    chunk.corners.push_back(iNormal);
+                    ++rec.cornerCount;
+
+                    // Check for more face data or end of the face statement
+                    bool faceEnd = false;
+                    for (;;)
+                    {
+                        if (ptr >= end || *ptr == '\n')
+                        {
+                            faceEnd = true;
+                            break;
+                        }
+                        else if (IsDigit(*ptr) || *ptr == '-' || *ptr == '+')
+                            break;
+
+                        ++ptr;
+                    }
+
+                    if (faceEnd)
+                        break;
+                }
+
+                if (SUCCEEDED(hr) && rec.cornerCount < 3)
+                {
+                    // Need at least 3 points to form a triangle
+                    hr = E_FAIL;
+                }
+
+                if (FAILED(hr))
+                {
+                    rec.error = true;
+                    chunk.faces.push_back(rec);
+                    chunk.hr = hr;
+                    chunk.stop = true;
+                    return;
+                }
+
+                chunk.faces.push_back(rec);
+            }
+            else if (IsCommand(cmd, cmdLen, "mtllib"))
+            {
+                SkipWhitespace(ptr, end);
+                chunk.mtllib = ptr;
+            }
+            else if (IsCommand(cmd, cmdLen, "usemtl"))
+            {
+                SkipWhitespace(ptr, end);
+                chunk.materialRecords.push_back({ chunk.faces.size(), ptr });
+            }
+
+            if (!valid)
+            {
+                chunk.stop = true;
+                return;
+            }
+
+            SkipLine(ptr, end);
+        }
+    }
+
+    void AddFace(_In_reads_(iFace) const uint32_t* faceIndex, size_t iFace, bool ccw, uint32_t curSubset)
+    {
+        TriangulateFace(faceIndex, iFace, ccw, curSubset, indices, attributes);
+    }
 
-            if (0 == memcmp(pVertex, &tv, sizeof(Vertex)))
+    static void TriangulateFace(
+        _In_reads_(iFace) const uint32_t* faceIndex, size_t iFace, bool ccw, uint32_t curSubset,
+        std::vector<index_t>& outIndices, std::vector<uint32_t>& outAttributes)
+    {
+        // Convert polygons to triangles
+        const uint32_t i0 = faceIndex[0];
+        uint32_t i1 = faceIndex[1];
+
+        for (size_t j = 2; j < iFace; ++j)
+        {
+            const uint32_t index = faceIndex[j];
+            outIndices.emplace_back(static_cast<index_t>(i0));
+            if (ccw)
+            {
+                outIndices.emplace_back(static_cast<index_t>(i1));
+                outIndices.emplace_back(static_cast<index_t>(index));
+            }
+            else
             {
-                return it->second;
+                outIndices.emplace_back(static_cast<index_t>(index));
+                outIndices.emplace_back(static_cast<index_t>(i1));
             }
+
+            outAttributes.emplace_back(curSubset);
+
+            i1 = index;
         }
 
-        auto index = static_cast<uint32_t>(vertices.size());
-        vertices.emplace_back(*pVertex);
+        assert(outAttributes.size() * 3 == outIndices.size());
+    }
+
+    HRESULT ParseMapped(
+        const char* ptr, const char* end, bool ccw,
+        std::vector<DirectX::XMFLOAT3>& positions,
+        std::vector<DirectX::XMFLOAT3>& normals,
+        std::vector<DirectX::XMFLOAT2>& texCoords,
+        _Out_writes_(MAX_PATH) wchar_t* strMaterialFilename)
+    {
+        using namespace DirectX;
+
+        VertexCache  vertexCache;
+
+        uint32_t curSubset = 0;
+
+        while (ptr < end)
+        {
+            const char* cmd = nullptr;
+            const size_t cmdLen = ReadToken(ptr, end, cmd);
+            if (!cmdLen)
+                break;
+
+            bool valid = true;
+
+            if (*cmd == '#')
+            {
+                // Comment
+            }
+            else if (IsCommand(cmd, cmdLen, "v"))
+            {
+                // Vertex Position
+                float x = 0.f, y = 0.f, z = 0.f;
+                valid = ParseFloat(ptr, end, x) && ParseFloat(ptr, end, y) && ParseFloat(ptr, end, z);
+                positions.emplace_back(XMFLOAT3(x, y, z));
+            }
+            else if (IsCommand(cmd, cmdLen, "vt"))
+            {
+                // Vertex TexCoord
+                float u = 0.f, v = 0.f;
+                valid = ParseFloat(ptr, end, u) && ParseFloat(ptr, end, v);
+                texCoords.emplace_back(XMFLOAT2(u, v));
+
+                hasTexcoords = true;
+            }
+            else if (IsCommand(cmd, cmdLen, "vn"))
+            {
+                // Vertex Normal
+                float x = 0.f, y = 0.f, z = 0.f;
+                valid = ParseFloat(ptr, end, x) && ParseFloat(ptr, end, y) && ParseFloat(ptr, end, z);
+                normals.emplace_back(XMFLOAT3(x, y, z));
+
+                hasNormals = true;
+            }
+            else if (IsCommand(cmd, cmdLen, "f"))
+            {
+                // Face
+                if (vertexCache.empty())
+                {
+                    ReserveVertices(vertexCache, positions.size(), SIZE_MAX);
+                }
+
+                int iPosition, iTexCoord, iNormal;
+                Vertex vertex;
+
+                uint32_t faceIndex[MAX_POLY];
+                size_t iFace = 0;
+                for (;;)
+                {
+                    if (iFace >= MAX_POLY)
+                    {
+                        // Too many polygon verts for the reader
+                        return E_FAIL;
+                    }
+
+                    memset(&vertex, 0, sizeof(vertex));
+
+                    std::ignore = ParseInt(ptr, end, iPosition);
+
+                    uint32_t vertexIndex = 0;
+                    if (!iPosition)
+                    {
+                        // 0 is not allowed for index
+                        return E_UNEXPECTED;
+                    }
+                    else if (!ResolveIndex(iPosition, positions.size(), vertexIndex))
+                        return E_FAIL;
+
+                    vertex.position = positions[vertexIndex];
+
+                    if (ptr < end && *ptr == '/')
+                    {
+                        ++ptr;
+
+                        if (ptr < end && *ptr != '/')
+                        {
+                            // Optional texture coordinate
+                            std::ignore = ParseInt(ptr, end, iTexCoord);
+
+                            uint32_t coordIndex = 0;
+                            if (!iTexCoord)
+                            {
+                                // 0 is not allowed for index
+                                return E_UNEXPECTED;
+                            }
+                            else if (!ResolveIndex(iTexCoord, texCoords.size(), coordIndex))
+                                return E_FAIL;
+
+                            vertex.textureCoordinate = texCoords[coordIndex];
+                        }
+
+                        if (ptr < end && *ptr == '/')
+                        {
+                            ++ptr;
+
+                            // Optional vertex normal
+                            std::ignore = ParseInt(ptr, end, iNormal);
+
+                            uint32_t normIndex = 0;
+                            if (!iNormal)
+                            {
+                                // 0 is not allowed for index
+                                return E_UNEXPECTED;
+                            }
+                            else if (!ResolveIndex(iNormal, normals.size(), normIndex))
+                                return E_FAIL;
+
+                            vertex.normal = normals[normIndex];
+                        }
+                    }
+
+                    const uint32_t index = AddVertex(vertexIndex, &vertex, vertexCache);
+                    if (index == uint32_t(-1))
+                        return E_OUTOFMEMORY;
+
+                    constexpr uint32_t maxIndex = (sizeof(index_t) == 2) ? UINT16_MAX : UINT32_MAX;
+                    if (index >= maxIndex)
+                    {
+                        // Too many indices for IB!
+                        return E_FAIL;
+                    }
+
+                    faceIndex[iFace] = index;
+                    ++iFace;
+
+                    // Check for more face data or end of the face statement
+                    bool faceEnd = false;
+                    for (;;)
+                    {
+                        if (ptr >= end || *ptr == '\n')
+                        {
+                            faceEnd = true;
+                            break;
+                        }
+                        else if (IsDigit(*ptr) || *ptr == '-' || *ptr == '+')
+                            break;
+
+                        ++ptr;
+                    }
+
+                    if (faceEnd)
+                        break;
+                }
+
+                if (iFace < 3)
+                {
+                    // Need at least 3 points to form a triangle
+                    return E_FAIL;
+                }
+
+                AddFace(faceIndex, iFace, ccw, curSubset);
+            }
+            else if (IsCommand(cmd, cmdLen, "mtllib"))
+            {
+                // Material library
+                ReadToken(ptr, end, strMaterialFilename, MAX_PATH);
+            }
+            else if (IsCommand(cmd, cmdLen, "usemtl"))
+            {
+                // Material
+                wchar_t strName[MAX_PATH] = {};
+                ReadToken(ptr, end, strName, MAX_PATH);
+
+                curSubset = FindOrAddMaterial(strName);
+            }
+
+            // Malformed numeric data ends parsing, matching the stream reader's fail state
+            if (!valid)
+                break;
+
+            SkipLine(ptr, end);
+        }
 
-        VertexCache::value_type entry(hash, index);
-        cache.insert(entry);
-        return index;
+        return S_OK;
     }
 
     void LoadTexturePath(std::wifstream& InFile, _Out_writes_(maxChar) wchar_t* texture, size_t maxChar)
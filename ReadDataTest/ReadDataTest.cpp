@@ -0,0 +1,91 @@
+//-------------------------------------------------------------------------------------
+// ReadDataTest.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cwchar>
+#include <iterator>
+
+//-------------------------------------------------------------------------------------
+// Types and globals
+
+using TestFN = bool (*)();
+
+struct TestInfo
+{
+    const char *name;
+    TestFN func;
+};
+
+extern bool Test01();
+extern bool Test02();
+extern bool Benchmark01();
+
+TestInfo g_Tests[] =
+{
+    { "ReadData variants", Test01 },
+    { "ReadDataAsync", Test02 },
+};
+
+TestInfo g_Benchmarks[] =
+{
+    { "ReadData startup asset load", Benchmark01 },
+};
+
+
+//-------------------------------------------------------------------------------------
+bool RunTests(const TestInfo* tests, size_t count)
+{
+    size_t nPass = 0;
+    size_t nFail = 0;
+
+    for(size_t i=0; i < count; ++i)
+    {
+        printf("%s: ", tests[i].name );
+
+        if ( tests[i].func() )
+        {
+            ++nPass;
+            printf("PASS\n");
+        }
+        else
+        {
+            ++nFail;
+            printf("FAIL\n");
+        }
+    }
+
+    printf("Ran %zu tests, %zu pass, %zu fail\n", nPass+nFail, nPass, nFail);
+
+    return (nFail == 0);
+}
+
+
+//-------------------------------------------------------------------------------------
+int __cdecl wmain(int argc, wchar_t* argv[])
+{
+    printf("**************************************************************\n");
+    printf("*** ReadDataTest\n" );
+    printf("**************************************************************\n");
+
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!_wcsicmp(argv[i], L"-bench"))
+        {
+            benchmark = true;
+        }
+    }
+
+    if (benchmark)
+    {
+        if ( !RunTests(g_Benchmarks, std::size(g_Benchmarks)) )
+            return -1;
+    }
+    else if ( !RunTests(g_Tests, std::size(g_Tests)) )
+        return -1;
+
+    return 0;
+}
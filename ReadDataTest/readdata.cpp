@@ -0,0 +1,322 @@
+//-------------------------------------------------------------------------------------
+// readdata.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX 1
+#define NODRAWTEXT
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+#pragma warning(pop)
+
+#include <Windows.h>
+
+#include "ReadData.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cwctype>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    // Binary assets the test apps load at startup
+    const wchar_t* const c_AssetExtensions[] =
+    {
+        L".cso", L".dds", L".cmo", L".sdkmesh", L".sdkmesh_anim", L".vbo", L".spritefont",
+    };
+
+    constexpr size_t c_WarmRuns = 5;
+
+    // Keeps the benchmark loops from being optimized away
+    volatile size_t g_Sink = 0;
+
+    // Assets directly inside each test app's folder, in a stable order
+    std::vector<std::wstring> FindAssets(uint64_t& totalBytes)
+    {
+        namespace fs = std::filesystem;
+
+        std::vector<std::wstring> assets;
+        totalBytes = 0;
+
+        std::error_code ec;
+        for (const auto& dir : fs::directory_iterator(fs::current_path(), ec))
+        {
+            const auto dirName = dir.path().filename().wstring();
+            if (!dir.is_directory(ec) || dirName.empty() || dirName[0] == L'.' || dirName[0] == L'_')
+                continue;
+
+            for (const auto& file : fs::directory_iterator(dir.path(), ec))
+            {
+                if (!file.is_regular_file(ec))
+                    continue;
+
+                auto ext = file.path().extension().wstring();
+                std::transform(ext.begin(), ext.end(), ext.begin(), [](wchar_t c) { return static_cast<wchar_t>(towlower(c)); });
+
+                if (std::find_if(std::begin(c_AssetExtensions), std::end(c_AssetExtensions),
+                    [&](const wchar_t* it) { return ext == it; }) == std::end(c_AssetExtensions))
+                    continue;
+
+                assets.emplace_back(file.path().wstring());
+                totalBytes += file.file_size(ec);
+            }
+        }
+
+        std::sort(assets.begin(), assets.end());
+        return assets;
+    }
+
+    const wchar_t c_MissingFile[] = L"ReadDataTest\\missing-file.bin";
+
+    template<typename Func>
+    bool Throws(Func func)
+    {
+        try
+        {
+            func();
+        }
+        catch (const std::exception&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    // Median time of c_WarmRuns calls, in milliseconds
+    double TimeWarm(const std::function<void()>& func)
+    {
+        double times[c_WarmRuns] = {};
+        for (auto& it : times)
+        {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            it = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        std::sort(std::begin(times), std::end(times));
+        return times[c_WarmRuns / 2];
+    }
+}
+
+//-------------------------------------------------------------------------------------
+// ReadDataUninitialized and MapData return the same bytes as ReadData
+bool Test01()
+{
+    uint64_t totalBytes = 0;
+    const auto assets = FindAssets(totalBytes);
+    if (assets.empty())
+    {
+        printf("ERROR: No assets found under the current directory\n");
+        return false;
+    }
+
+    bool success = true;
+
+    for (const auto& it : assets)
+    {
+        try
+        {
+            const auto expected = DX::ReadData(it.c_str());
+
+            const auto blob = DX::ReadDataUninitialized(it.c_str());
+            if (blob.size != expected.size()
+                || (blob.size > 0 && memcmp(blob.data.get(), expected.data(), blob.size) != 0))
+            {
+                printf("ERROR: ReadDataUninitialized mismatch (%zu bytes, expected %zu):\n%ls\n", blob.size, expected.size(), it.c_str());
+                success = false;
+            }
+
+            auto mapped = DX::MapData(it.c_str());
+            if (mapped.size() != expected.size()
+                || (mapped.size() > 0 && memcmp(mapped.data(), expected.data(), mapped.size()) != 0))
+            {
+                printf("ERROR: MapData mismatch (%zu bytes, expected %zu):\n%ls\n", mapped.size(), expected.size(), it.c_str());
+                success = false;
+            }
+
+            // Moving hands the view over without unmapping it
+            auto moved = std::move(mapped);
+            if (mapped.data() || (moved.size() > 0 && memcmp(moved.data(), expected.data(), moved.size()) != 0))
+            {
+                printf("ERROR: MappedData move failed:\n%ls\n", it.c_str());
+                success = false;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            printf("ERROR: Failed reading asset (%s):\n%ls\n", e.what(), it.c_str());
+            success = false;
+        }
+    }
+
+    if (!Throws([]() { std::ignore = DX::ReadDataUninitialized(c_MissingFile); })
+        || !Throws([]() { std::ignore = DX::MapData(c_MissingFile); }))
+    {
+        printf("ERROR: Expected failure for missing file\n");
+        success = false;
+    }
+
+    printf("%zu files tested ", assets.size());
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Batched reads keep the request order and report failures through get()
+bool Test02()
+{
+    uint64_t totalBytes = 0;
+    const auto assets = FindAssets(totalBytes);
+    if (assets.empty())
+    {
+        printf("ERROR: No assets found under the current directory\n");
+        return false;
+    }
+
+    bool success = true;
+
+    const size_t threadCounts[] = { 1, 4, 0 };
+    for (const size_t threads : threadCounts)
+    {
+        try
+        {
+            auto pending = DX::ReadDataAsync(assets, threads);
+            const auto blobs = pending.get();
+
+            if (blobs.size() != assets.size())
+            {
+                printf("ERROR: ReadDataAsync returned %zu blobs for %zu files (%zu threads)\n", blobs.size(), assets.size(), threads);
+                success = false;
+                continue;
+            }
+
+            for (size_t j = 0; j < assets.size(); ++j)
+            {
+                const auto expected = DX::ReadData(assets[j].c_str());
+                if (blobs[j].size != expected.size()
+                    || (blobs[j].size > 0 && memcmp(blobs[j].data.get(), expected.data(), blobs[j].size) != 0))
+                {
+                    printf("ERROR: ReadDataAsync mismatch (%zu threads):\n%ls\n", threads, assets[j].c_str());
+                    success = false;
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            printf("ERROR: ReadDataAsync failed (%s, %zu threads)\n", e.what(), threads);
+            success = false;
+        }
+    }
+
+    {
+        auto names = assets;
+        names.insert(names.begin() + ptrdiff_t(names.size() / 2), c_MissingFile);
+
+        auto pending = DX::ReadDataAsync(std::move(names), 4);
+        if (!Throws([&]() { std::ignore = pending.get(); }))
+        {
+            printf("ERROR: Expected ReadDataAsync failure for missing file\n");
+            success = false;
+        }
+    }
+
+    {
+        auto pending = DX::ReadDataAsync({});
+        if (!pending.get().empty())
+        {
+            printf("ERROR: Expected no results for an empty batch\n");
+            success = false;
+        }
+    }
+
+    printf("%zu files tested ", assets.size());
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Loads every asset the way app startup would, with each of the ReadData variants
+bool Benchmark01()
+{
+    uint64_t totalBytes = 0;
+    const auto assets = FindAssets(totalBytes);
+    if (assets.empty())
+    {
+        printf("ERROR: No assets found under the current directory\n");
+        return false;
+    }
+
+    const double sizeMB = double(totalBytes) / (1024.0 * 1024.0);
+
+    size_t sink = 0;
+
+    // Warm the file cache, so every variant is timed against cached data
+    for (const auto& it : assets)
+    {
+        sink += DX::ReadData(it.c_str()).size();
+    }
+
+    const double readTime = TimeWarm([&]()
+        {
+            for (const auto& it : assets)
+            {
+                sink += DX::ReadData(it.c_str()).size();
+            }
+        });
+
+    const double uninitTime = TimeWarm([&]()
+        {
+            for (const auto& it : assets)
+            {
+                sink += DX::ReadDataUninitialized(it.c_str()).size;
+            }
+        });
+
+    // Touch a byte per page, since a mapping costs nothing until it is used
+    const double mappedTime = TimeWarm([&]()
+        {
+            for (const auto& it : assets)
+            {
+                const auto mapped = DX::MapData(it.c_str());
+                for (size_t j = 0; j < mapped.size(); j += 4096)
+                {
+                    sink += mapped.data()[j];
+                }
+            }
+        });
+
+    const double asyncTime = TimeWarm([&]()
+        {
+            for (const auto& it : DX::ReadDataAsync(assets).get())
+            {
+                sink += it.size;
+            }
+        });
+
+    g_Sink = sink;
+
+    printf("\n\t%zu files, %.1f MB\n", assets.size(), sizeMB);
+    printf("\tReadData:              %10.2f ms  %8.2f MB/s\n", readTime, sizeMB * 1000.0 / readTime);
+    printf("\tReadDataUninitialized: %10.2f ms  %8.2f MB/s  (%.2fx)\n", uninitTime, sizeMB * 1000.0 / uninitTime, readTime / uninitTime);
+    printf("\tMapData (touched):     %10.2f ms  %8.2f MB/s  (%.2fx)\n", mappedTime, sizeMB * 1000.0 / mappedTime, readTime / mappedTime);
+    printf("\tReadDataAsync (%2u):    %10.2f ms  %8.2f MB/s  (%.2fx)\n", std::max(1u, std::thread::hardware_concurrency()), asyncTime, sizeMB * 1000.0 / asyncTime, readTime / asyncTime);
+
+    return true;
+}
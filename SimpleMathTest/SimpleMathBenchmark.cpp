@@ -0,0 +1,453 @@
+//-------------------------------------------------------------------------------------
+// SimpleMathBenchmark.cpp
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//-------------------------------------------------------------------------------------
+
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX 1
+#define NODRAWTEXT
+#define NOGDI
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+#pragma warning(pop)
+
+#ifndef _WIN32
+#include "pch.h"
+#endif
+
+#include "SimpleMath.h"
+#include "SimpleMathStream.h"
+#include "SimpleMathRayPacket.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace DirectX;
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+    // Elements per pass; small enough to stay in L1 so the math, not memory, is measured
+    constexpr size_t c_Elements = 1024;
+
+    // Points for the batched projection cases that are big enough to split across threads
+    constexpr size_t c_LargeElements = 1024 * 1024;
+
+    // Each case is repeated until at least this long has been spent on it
+    constexpr double c_MinSeconds = 0.25;
+
+    const char* GetISAName() noexcept
+    {
+    #if defined(_XM_NO_INTRINSICS_)
+        return "No intrinsics";
+    #elif defined(_XM_AVX2_INTRINSICS_) || defined(__AVX2__)
+        return "AVX2";
+    #elif defined(_XM_AVX_INTRINSICS_) || defined(__AVX__)
+        return "AVX";
+    #elif defined(_XM_SSE_INTRINSICS_)
+        return "SSE2";
+    #elif defined(_XM_ARM_NEON_INTRINSICS_)
+        return "ARM-NEON";
+    #else
+        return "Unknown";
+    #endif
+    }
+
+    struct TestData
+    {
+        std::vector<Vector3> points;
+        std::vector<Vector3> results;
+        std::vector<Matrix> matrices;
+        std::vector<Matrix> products;
+        std::vector<Quaternion> rotations;
+        std::vector<Quaternion> blended;
+        std::vector<float> weights;
+
+        Vector3Stream pointStream;
+        Vector3Stream resultStream;
+
+        std::vector<Vector3> largePoints;
+        std::vector<Vector3> largeResults;
+        Vector3Stream largeStream;
+        Vector3Stream largeResultStream;
+
+        std::vector<Ray> rays;
+        std::vector<BoundingSphere> spheres;
+        std::vector<BoundingBox> boxes;
+        std::vector<uint32_t> hits;
+        std::vector<float> distances;
+        RayStream rayStream;
+        BoundingSphereStream sphereStream;
+        BoundingBoxStream boxStream;
+
+        Matrix world;
+        Matrix view;
+        Matrix proj;
+        Viewport viewport;
+
+        TestData() :
+            points(c_Elements),
+            results(c_Elements),
+            matrices(c_Elements),
+            products(c_Elements),
+            rotations(c_Elements),
+            blended(c_Elements),
+            weights(c_Elements),
+            largePoints(c_LargeElements),
+            largeResults(c_LargeElements),
+            rays(c_Elements),
+            spheres(c_Elements),
+            boxes(c_Elements),
+            hits(c_Elements / 32),
+            distances(c_Elements),
+            viewport(0.f, 0.f, 1920.f, 1080.f)
+        {
+            std::mt19937 rng(12345);
+            std::uniform_real_distribution<float> position(-100.f, 100.f);
+            std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+            std::uniform_real_distribution<float> scale(0.5f, 2.f);
+            std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+            for (size_t j = 0; j < c_Elements; ++j)
+            {
+                points[j] = Vector3(position(rng), position(rng), position(rng));
+
+                rotations[j] = Quaternion::CreateFromYawPitchRoll(angle(rng), angle(rng), angle(rng));
+
+                // Scale, rotate, translate: what an entity's world matrix looks like
+                matrices[j] = Matrix::CreateScale(scale(rng))
+                    * Matrix::CreateFromQuaternion(rotations[j])
+                    * Matrix::CreateTranslation(points[j]);
+
+                weights[j] = unit(rng);
+            }
+
+            for (auto& it : largePoints)
+            {
+                it = Vector3(position(rng), position(rng), position(rng));
+            }
+
+            for (size_t j = 0; j < c_Elements; ++j)
+            {
+                // Roughly half of the rays and bounds overlap, so neither branch of a scalar test is free
+                const Vector3 target(position(rng), position(rng), position(rng));
+                Vector3 direction = target - points[j];
+                direction.Normalize();
+                rays[j] = Ray(points[j], direction);
+
+                spheres[j] = BoundingSphere(target, 10.f * scale(rng));
+                boxes[j] = BoundingBox(target, XMFLOAT3(10.f * scale(rng), 10.f * scale(rng), 10.f * scale(rng)));
+            }
+
+            rayStream.Load(rays.data(), c_Elements);
+            sphereStream.Load(spheres.data(), c_Elements);
+            boxStream.Load(boxes.data(), c_Elements);
+
+            pointStream.Load(points.data(), c_Elements);
+            resultStream.Resize(c_Elements);
+            largeStream.Load(largePoints.data(), c_LargeElements);
+            largeResultStream.Resize(c_LargeElements);
+
+            world = matrices[0];
+            view = Matrix::CreateLookAt(Vector3(0.f, 50.f, 200.f), Vector3::Zero, Vector3::UnitY);
+            proj = Matrix::CreatePerspectiveFieldOfView(XM_PIDIV4, 16.f / 9.f, 0.1f, 1000.f);
+        }
+    };
+
+    // Keeps results alive so the optimizer can't discard the loop bodies
+    volatile float g_sink = 0.f;
+
+    typedef size_t (*BenchFN)(TestData&);
+
+    //---------------------------------------------------------------------------------
+    size_t BenchTransform(TestData& data)
+    {
+        const Matrix m = data.matrices[1];
+        for (size_t j = 0; j < c_Elements; ++j)
+        {
+            data.results[j] = Vector3::Transform(data.points[j], m);
+        }
+        return c_Elements;
+    }
+
+    size_t BenchTransformArray(TestData& data)
+    {
+        Vector3::Transform(data.points.data(), c_Elements, data.matrices[1], data.results.data());
+        return c_Elements;
+    }
+
+    size_t BenchTransformStream(TestData& data)
+    {
+        Vector3Stream::Transform(data.pointStream, data.matrices[1], data.resultStream);
+        return c_Elements;
+    }
+
+    size_t BenchNormalize(TestData& data)
+    {
+        for (size_t j = 0; j < c_Elements; ++j)
+        {
+            data.points[j].Normalize(data.results[j]);
+        }
+        return c_Elements;
+    }
+
+    size_t BenchNormalizeStream(TestData& data)
+    {
+        Vector3Stream::Normalize(data.pointStream, data.resultStream);
+        return c_Elements;
+    }
+
+    size_t BenchMultiply(TestData& data)
+    {
+        const Matrix viewProj = data.view * data.proj;
+        for (size_t j = 0; j < c_Elements; ++j)
+        {
+            data.products[j] = data.matrices[j] * viewProj;
+        }
+        return c_Elements;
+    }
+
+    size_t BenchInvert(TestData& data)
+    {
+        for (size_t j = 0; j < c_Elements; ++j)
+        {
+            data.products[j] = data.matrices[j].Invert();
+        }
+        return c_Elements;
+    }
+
+    size_t BenchSlerp(TestData& data)
+    {
+        for (size_t j = 0; j < c_Elements; ++j)
+        {
+            data.blended[j] = Quaternion::Slerp(data.rotations[j], data.rotations[c_Elements - 1 - j], data.weights[j]);
+        }
+        return c_Elements;
+    }
+
+    size_t BenchDecompose(TestData& data)
+    {
+        for (size_t j = 0; j < c_Elements; ++j)
+        {
+            Vector3 scale, translation;
+            if (data.matrices[j].Decompose(scale, data.blended[j], translation))
+            {
+                data.results[j] = translation;
+            }
+        }
+        return c_Elements;
+    }
+
+    size_t BenchProject(TestData& data)
+    {
+        for (size_t j = 0; j < c_Elements; ++j)
+        {
+            data.results[j] = data.viewport.Project(data.points[j], data.proj, data.view, data.world);
+        }
+        return c_Elements;
+    }
+
+    size_t BenchProjectArray(TestData& data)
+    {
+        ViewportProject(data.viewport, data.points.data(), c_Elements, data.proj, data.view, data.world, data.results.data());
+        return c_Elements;
+    }
+
+    size_t BenchProjectStream(TestData& data)
+    {
+        ViewportProject(data.viewport, data.pointStream, data.proj, data.view, data.world, data.resultStream);
+        return c_Elements;
+    }
+
+    size_t BenchProjectLarge(TestData& data)
+    {
+        ViewportProject(data.viewport, data.largePoints.data(), c_LargeElements, data.proj, data.view, data.world, data.largeResults.data());
+        return c_LargeElements;
+    }
+
+    size_t BenchProjectLargeStream(TestData& data)
+    {
+        ViewportProject(data.viewport, data.largeStream, data.proj, data.view, data.world, data.largeResultStream);
+        return c_LargeElements;
+    }
+
+    size_t BenchProjectLargeStreamThreaded(TestData& data)
+    {
+        ViewportProject(data.viewport, data.largeStream, data.proj, data.view, data.world, data.largeResultStream, 0);
+        return c_LargeElements;
+    }
+
+    size_t BenchRaySpheres(TestData& data)
+    {
+        const Ray& ray = data.rays[0];
+        for (size_t j = 0; j < c_Elements; ++j)
+        {
+            float dist = 0.f;
+            std::ignore = ray.Intersects(data.spheres[j], dist);
+            data.distances[j] = dist;
+        }
+        return c_Elements;
+    }
+
+    size_t BenchRaySphereStream(TestData& data)
+    {
+        float nearest;
+        std::ignore = data.sphereStream.Intersects(data.rays[0], data.hits.data(), data.distances.data(), nearest);
+        return c_Elements;
+    }
+
+    size_t BenchRayBoxes(TestData& data)
+    {
+        const Ray& ray = data.rays[0];
+        for (size_t j = 0; j < c_Elements; ++j)
+        {
+            float dist = 0.f;
+            std::ignore = ray.Intersects(data.boxes[j], dist);
+            data.distances[j] = dist;
+        }
+        return c_Elements;
+    }
+
+    size_t BenchRayBoxStream(TestData& data)
+    {
+        float nearest;
+        std::ignore = data.boxStream.Intersects(data.rays[0], data.hits.data(), data.distances.data(), nearest);
+        return c_Elements;
+    }
+
+    size_t BenchRaysBox(TestData& data)
+    {
+        const BoundingBox& box = data.boxes[0];
+        for (size_t j = 0; j < c_Elements; ++j)
+        {
+            float dist = 0.f;
+            std::ignore = data.rays[j].Intersects(box, dist);
+            data.distances[j] = dist;
+        }
+        return c_Elements;
+    }
+
+    size_t BenchRayStreamBox(TestData& data)
+    {
+        std::ignore = data.rayStream.Intersects(data.boxes[0], data.hits.data(), data.distances.data());
+        return c_Elements;
+    }
+
+    struct Bench
+    {
+        const char *    name;
+        BenchFN         func;
+    };
+
+    const Bench g_Benchmarks[] =
+    {
+        { "Vector3::Transform", BenchTransform },
+        { "Vector3::Transform (array)", BenchTransformArray },
+        { "Vector3Stream::Transform", BenchTransformStream },
+        { "Vector3::Normalize", BenchNormalize },
+        { "Vector3Stream::Normalize", BenchNormalizeStream },
+        { "Matrix multiply", BenchMultiply },
+        { "Matrix::Invert", BenchInvert },
+        { "Quaternion::Slerp", BenchSlerp },
+        { "Matrix::Decompose", BenchDecompose },
+        { "Viewport::Project", BenchProject },
+        { "ViewportProject (array)", BenchProjectArray },
+        { "ViewportProject (stream)", BenchProjectStream },
+        { "ViewportProject 1M (array)", BenchProjectLarge },
+        { "ViewportProject 1M (stream)", BenchProjectLargeStream },
+        { "ViewportProject 1M (stream, threads)", BenchProjectLargeStreamThreaded },
+        { "Ray::Intersects (spheres)", BenchRaySpheres },
+        { "BoundingSphereStream::Intersects", BenchRaySphereStream },
+        { "Ray::Intersects (boxes)", BenchRayBoxes },
+        { "BoundingBoxStream::Intersects", BenchRayBoxStream },
+        { "Ray::Intersects (rays vs box)", BenchRaysBox },
+        { "RayStream::Intersects (box)", BenchRayStreamBox },
+    };
+
+    // Runs one case until c_MinSeconds have passed and returns the seconds per operation
+    double Run(const Bench& bench, TestData& data)
+    {
+        using clock = std::chrono::steady_clock;
+
+        // Warm up caches and branch predictors
+        std::ignore = bench.func(data);
+
+        size_t operations = 0;
+        double elapsed = 0.0;
+        size_t passes = 1;
+        while (elapsed < c_MinSeconds)
+        {
+            const auto start = clock::now();
+            for (size_t j = 0; j < passes; ++j)
+            {
+                operations += bench.func(data);
+            }
+            elapsed += std::chrono::duration<double>(clock::now() - start).count();
+
+            passes *= 2;
+        }
+
+        g_sink = g_sink + data.results[0].x + data.products[0]._11 + data.blended[0].w + data.resultStream.X()[0] + data.largeResultStream.X()[0] + data.distances[0];
+
+        return elapsed / double(operations);
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+#ifdef _WIN32
+int __cdecl wmain(int argc, wchar_t* argv[])
+#else
+int main(int argc, char* argv[])
+#endif
+{
+    const char* isa = GetISAName();
+
+    printf("*** SimpleMathBenchmark (using DirectXMath version %03d, %s)\n", DIRECTX_MATH_VERSION, isa);
+
+    if (!XMVerifyCPUSupport())
+    {
+        printf("FAILED: XMVerifyCPUSupport reports a failure on this platform\n");
+        return 1;
+    }
+
+    // Optional substring filter on the case names
+    char filter[64] = {};
+    if (argc > 1)
+    {
+    #ifdef _WIN32
+        size_t converted = 0;
+        wcstombs_s(&converted, filter, argv[1], _TRUNCATE);
+    #else
+        strncpy(filter, argv[1], sizeof(filter) - 1);
+    #endif
+    }
+
+    auto data = std::make_unique<TestData>();
+
+    printf("\n\t%-38s %-14s %10s %14s\n", "Operation", "ISA", "ns/op", "ops/s");
+
+    for (const auto& it : g_Benchmarks)
+    {
+        if (*filter && !strstr(it.name, filter))
+            continue;
+
+        const double seconds = Run(it, *data);
+
+        printf("\t%-38s %-14s %10.2f %14.0f\n", it.name, isa, seconds * 1e9, 1.0 / seconds);
+    }
+
+    return 0;
+}
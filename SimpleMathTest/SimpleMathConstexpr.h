@@ -0,0 +1,523 @@
+//-------------------------------------------------------------------------------------
+// SimpleMathConstexpr.h -- Compile-time evaluable subset of SimpleMath
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//-------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "SimpleMath.h"
+
+
+//
+// The SimpleMath operators load into XMVECTOR registers, so none of them can be used in a
+// constant expression. These functions take and return the same SimpleMath types, work on
+// the float members when evaluated by the compiler, and call the SimpleMath operators when
+// evaluated at runtime. Tables such as projection presets, basis matrices or color palettes
+// can then be declared constexpr and end up in read-only data.
+//
+// The SimpleMath static constants (Vector3::Up, Matrix::Identity, ...) are defined in
+// SimpleMath.cpp, so the ones needed for compile-time work are repeated here.
+//
+// Only the literal-type constructors are usable in a constant expression: the default
+// constructors are not constexpr, so always pass every component.
+//
+
+namespace DirectX
+{
+    namespace SimpleMath
+    {
+        namespace Internal
+        {
+            // True while the compiler is evaluating a constant expression. Without the builtin
+            // every call takes the scalar path, which is still correct, just not vectorized.
+            constexpr bool IsConstantEvaluated() noexcept
+            {
+            #if defined(__cpp_lib_is_constant_evaluated)
+                return std::is_constant_evaluated();
+            #elif defined(__clang__)
+            #if __has_builtin(__builtin_is_constant_evaluated)
+                return __builtin_is_constant_evaluated();
+            #else
+                return true;
+            #endif
+            #elif (defined(_MSC_VER) && (_MSC_VER >= 1925)) || (defined(__GNUC__) && (__GNUC__ >= 9))
+                return __builtin_is_constant_evaluated();
+            #else
+                return true;
+            #endif
+            }
+
+            // Row vector times matrix, for the compile-time path of Constexpr::Multiply
+            constexpr Vector4 MultiplyRow(const Vector4& row, const Matrix& m) noexcept
+            {
+                return Vector4(
+                    row.x * m._11 + row.y * m._21 + row.z * m._31 + row.w * m._41,
+                    row.x * m._12 + row.y * m._22 + row.z * m._32 + row.w * m._42,
+                    row.x * m._13 + row.y * m._23 + row.z * m._33 + row.w * m._43,
+                    row.x * m._14 + row.y * m._24 + row.z * m._34 + row.w * m._44);
+            }
+        }
+
+        namespace Constexpr
+        {
+            //---------------------------------------------------------------------------------
+            // Constants
+
+            constexpr Vector2 Vector2Zero(0.f, 0.f);
+            constexpr Vector2 Vector2One(1.f, 1.f);
+            constexpr Vector2 Vector2UnitX(1.f, 0.f);
+            constexpr Vector2 Vector2UnitY(0.f, 1.f);
+
+            constexpr Vector3 Vector3Zero(0.f, 0.f, 0.f);
+            constexpr Vector3 Vector3One(1.f, 1.f, 1.f);
+            constexpr Vector3 Vector3UnitX(1.f, 0.f, 0.f);
+            constexpr Vector3 Vector3UnitY(0.f, 1.f, 0.f);
+            constexpr Vector3 Vector3UnitZ(0.f, 0.f, 1.f);
+            constexpr Vector3 Vector3Up(0.f, 1.f, 0.f);
+            constexpr Vector3 Vector3Down(0.f, -1.f, 0.f);
+            constexpr Vector3 Vector3Right(1.f, 0.f, 0.f);
+            constexpr Vector3 Vector3Left(-1.f, 0.f, 0.f);
+            constexpr Vector3 Vector3Forward(0.f, 0.f, -1.f);
+            constexpr Vector3 Vector3Backward(0.f, 0.f, 1.f);
+
+            constexpr Vector4 Vector4Zero(0.f, 0.f, 0.f, 0.f);
+            constexpr Vector4 Vector4One(1.f, 1.f, 1.f, 1.f);
+            constexpr Vector4 Vector4UnitX(1.f, 0.f, 0.f, 0.f);
+            constexpr Vector4 Vector4UnitY(0.f, 1.f, 0.f, 0.f);
+            constexpr Vector4 Vector4UnitZ(0.f, 0.f, 1.f, 0.f);
+            constexpr Vector4 Vector4UnitW(0.f, 0.f, 0.f, 1.f);
+
+            constexpr Matrix MatrixIdentity(
+                1.f, 0.f, 0.f, 0.f,
+                0.f, 1.f, 0.f, 0.f,
+                0.f, 0.f, 1.f, 0.f,
+                0.f, 0.f, 0.f, 1.f);
+
+            //---------------------------------------------------------------------------------
+            // Vector2
+
+            constexpr Vector2 Add(const Vector2& v1, const Vector2& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector2(v1.x + v2.x, v1.y + v2.y);
+                return v1 + v2;
+            }
+
+            constexpr Vector2 Subtract(const Vector2& v1, const Vector2& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector2(v1.x - v2.x, v1.y - v2.y);
+                return v1 - v2;
+            }
+
+            constexpr Vector2 Multiply(const Vector2& v1, const Vector2& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector2(v1.x * v2.x, v1.y * v2.y);
+                return v1 * v2;
+            }
+
+            constexpr Vector2 Scale(const Vector2& v, float s) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector2(v.x * s, v.y * s);
+                return v * s;
+            }
+
+            constexpr Vector2 Lerp(const Vector2& v1, const Vector2& v2, float t) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector2(v1.x + (v2.x - v1.x) * t, v1.y + (v2.y - v1.y) * t);
+                return Vector2::Lerp(v1, v2, t);
+            }
+
+            constexpr float Dot(const Vector2& v1, const Vector2& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return v1.x * v2.x + v1.y * v2.y;
+                return v1.Dot(v2);
+            }
+
+            //---------------------------------------------------------------------------------
+            // Vector3
+
+            constexpr Vector3 Add(const Vector3& v1, const Vector3& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector3(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z);
+                return v1 + v2;
+            }
+
+            constexpr Vector3 Subtract(const Vector3& v1, const Vector3& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector3(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z);
+                return v1 - v2;
+            }
+
+            constexpr Vector3 Multiply(const Vector3& v1, const Vector3& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector3(v1.x * v2.x, v1.y * v2.y, v1.z * v2.z);
+                return v1 * v2;
+            }
+
+            constexpr Vector3 Scale(const Vector3& v, float s) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector3(v.x * s, v.y * s, v.z * s);
+                return v * s;
+            }
+
+            constexpr Vector3 Lerp(const Vector3& v1, const Vector3& v2, float t) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector3(v1.x + (v2.x - v1.x) * t, v1.y + (v2.y - v1.y) * t, v1.z + (v2.z - v1.z) * t);
+                return Vector3::Lerp(v1, v2, t);
+            }
+
+            constexpr float Dot(const Vector3& v1, const Vector3& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+                return v1.Dot(v2);
+            }
+
+            constexpr Vector3 Cross(const Vector3& v1, const Vector3& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    return Vector3(
+                        v1.y * v2.z - v1.z * v2.y,
+                        v1.z * v2.x - v1.x * v2.z,
+                        v1.x * v2.y - v1.y * v2.x);
+                }
+                return v1.Cross(v2);
+            }
+
+            //---------------------------------------------------------------------------------
+            // Vector4
+
+            constexpr Vector4 Add(const Vector4& v1, const Vector4& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector4(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z, v1.w + v2.w);
+                return v1 + v2;
+            }
+
+            constexpr Vector4 Subtract(const Vector4& v1, const Vector4& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector4(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z, v1.w - v2.w);
+                return v1 - v2;
+            }
+
+            constexpr Vector4 Multiply(const Vector4& v1, const Vector4& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector4(v1.x * v2.x, v1.y * v2.y, v1.z * v2.z, v1.w * v2.w);
+                return v1 * v2;
+            }
+
+            constexpr Vector4 Scale(const Vector4& v, float s) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Vector4(v.x * s, v.y * s, v.z * s, v.w * s);
+                return v * s;
+            }
+
+            constexpr Vector4 Lerp(const Vector4& v1, const Vector4& v2, float t) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    return Vector4(
+                        v1.x + (v2.x - v1.x) * t,
+                        v1.y + (v2.y - v1.y) * t,
+                        v1.z + (v2.z - v1.z) * t,
+                        v1.w + (v2.w - v1.w) * t);
+                }
+                return Vector4::Lerp(v1, v2, t);
+            }
+
+            constexpr float Dot(const Vector4& v1, const Vector4& v2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+                return v1.Dot(v2);
+            }
+
+            //---------------------------------------------------------------------------------
+            // Color
+
+            constexpr Color Add(const Color& c1, const Color& c2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Color(c1.x + c2.x, c1.y + c2.y, c1.z + c2.z, c1.w + c2.w);
+                return c1 + c2;
+            }
+
+            constexpr Color Subtract(const Color& c1, const Color& c2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Color(c1.x - c2.x, c1.y - c2.y, c1.z - c2.z, c1.w - c2.w);
+                return c1 - c2;
+            }
+
+            // Modulate
+            constexpr Color Multiply(const Color& c1, const Color& c2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Color(c1.x * c2.x, c1.y * c2.y, c1.z * c2.z, c1.w * c2.w);
+                return c1 * c2;
+            }
+
+            constexpr Color Scale(const Color& c, float s) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                    return Color(c.x * s, c.y * s, c.z * s, c.w * s);
+                return c * s;
+            }
+
+            constexpr Color Lerp(const Color& c1, const Color& c2, float t) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    return Color(
+                        c1.x + (c2.x - c1.x) * t,
+                        c1.y + (c2.y - c1.y) * t,
+                        c1.z + (c2.z - c1.z) * t,
+                        c1.w + (c2.w - c1.w) * t);
+                }
+                return Color::Lerp(c1, c2, t);
+            }
+
+            //---------------------------------------------------------------------------------
+            // Matrix
+            //
+            // Only the named members are read: the XMFLOAT4X4 constexpr constructor initializes
+            // _11.._44, so the m[4][4] view of the union is not active in a constant expression.
+
+            constexpr Vector4 Row(const Matrix& m, size_t row) noexcept
+            {
+                return (row == 0) ? Vector4(m._11, m._12, m._13, m._14)
+                    : (row == 1) ? Vector4(m._21, m._22, m._23, m._24)
+                    : (row == 2) ? Vector4(m._31, m._32, m._33, m._34)
+                    : Vector4(m._41, m._42, m._43, m._44);
+            }
+
+            constexpr Matrix CreateFromRows(const Vector4& r0, const Vector4& r1, const Vector4& r2, const Vector4& r3) noexcept
+            {
+                return Matrix(
+                    r0.x, r0.y, r0.z, r0.w,
+                    r1.x, r1.y, r1.z, r1.w,
+                    r2.x, r2.y, r2.z, r2.w,
+                    r3.x, r3.y, r3.z, r3.w);
+            }
+
+            // Rows are the x, y and z axes followed by the origin, as in Matrix::CreateWorld
+            constexpr Matrix CreateFromAxes(const Vector3& xAxis, const Vector3& yAxis, const Vector3& zAxis, const Vector3& origin) noexcept
+            {
+                return Matrix(
+                    xAxis.x, xAxis.y, xAxis.z, 0.f,
+                    yAxis.x, yAxis.y, yAxis.z, 0.f,
+                    zAxis.x, zAxis.y, zAxis.z, 0.f,
+                    origin.x, origin.y, origin.z, 1.f);
+            }
+
+            constexpr Matrix Transpose(const Matrix& m) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    return Matrix(
+                        m._11, m._21, m._31, m._41,
+                        m._12, m._22, m._32, m._42,
+                        m._13, m._23, m._33, m._43,
+                        m._14, m._24, m._34, m._44);
+                }
+                return m.Transpose();
+            }
+
+            constexpr Matrix Multiply(const Matrix& m1, const Matrix& m2) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    return CreateFromRows(
+                        Internal::MultiplyRow(Row(m1, 0), m2),
+                        Internal::MultiplyRow(Row(m1, 1), m2),
+                        Internal::MultiplyRow(Row(m1, 2), m2),
+                        Internal::MultiplyRow(Row(m1, 3), m2));
+                }
+                return m1 * m2;
+            }
+
+            // Same as Vector3::Transform: the result is divided by w
+            constexpr Vector3 Transform(const Vector3& v, const Matrix& m) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    const float w = v.x * m._14 + v.y * m._24 + v.z * m._34 + m._44;
+                    return Vector3(
+                        (v.x * m._11 + v.y * m._21 + v.z * m._31 + m._41) / w,
+                        (v.x * m._12 + v.y * m._22 + v.z * m._32 + m._42) / w,
+                        (v.x * m._13 + v.y * m._23 + v.z * m._33 + m._43) / w);
+                }
+                return Vector3::Transform(v, m);
+            }
+
+            constexpr Vector3 TransformNormal(const Vector3& v, const Matrix& m) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    return Vector3(
+                        v.x * m._11 + v.y * m._21 + v.z * m._31,
+                        v.x * m._12 + v.y * m._22 + v.z * m._32,
+                        v.x * m._13 + v.y * m._23 + v.z * m._33);
+                }
+                return Vector3::TransformNormal(v, m);
+            }
+
+            constexpr Matrix CreateTranslation(float x, float y, float z) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    return Matrix(
+                        1.f, 0.f, 0.f, 0.f,
+                        0.f, 1.f, 0.f, 0.f,
+                        0.f, 0.f, 1.f, 0.f,
+                        x, y, z, 1.f);
+                }
+                return Matrix::CreateTranslation(x, y, z);
+            }
+
+            constexpr Matrix CreateTranslation(const Vector3& position) noexcept
+            {
+                return CreateTranslation(position.x, position.y, position.z);
+            }
+
+            constexpr Matrix CreateScale(float xs, float ys, float zs) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    return Matrix(
+                        xs, 0.f, 0.f, 0.f,
+                        0.f, ys, 0.f, 0.f,
+                        0.f, 0.f, zs, 0.f,
+                        0.f, 0.f, 0.f, 1.f);
+                }
+                return Matrix::CreateScale(xs, ys, zs);
+            }
+
+            constexpr Matrix CreateScale(const Vector3& scales) noexcept
+            {
+                return CreateScale(scales.x, scales.y, scales.z);
+            }
+
+            constexpr Matrix CreateScale(float scale) noexcept
+            {
+                return CreateScale(scale, scale, scale);
+            }
+
+            //---------------------------------------------------------------------------------
+            // Projections (right-handed, as in SimpleMath). CreatePerspectiveFieldOfView needs
+            // tan() and is not provided; CreatePerspective covers presets given as view sizes.
+
+            constexpr Matrix CreatePerspective(float width, float height, float nearPlane, float farPlane) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    const float twoNearZ = nearPlane + nearPlane;
+                    const float range = farPlane / (nearPlane - farPlane);
+                    return Matrix(
+                        twoNearZ / width, 0.f, 0.f, 0.f,
+                        0.f, twoNearZ / height, 0.f, 0.f,
+                        0.f, 0.f, range, -1.f,
+                        0.f, 0.f, range * nearPlane, 0.f);
+                }
+                return Matrix::CreatePerspective(width, height, nearPlane, farPlane);
+            }
+
+            constexpr Matrix CreatePerspectiveOffCenter(float left, float right, float bottom, float top, float nearPlane, float farPlane) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    const float twoNearZ = nearPlane + nearPlane;
+                    const float reciprocalWidth = 1.f / (right - left);
+                    const float reciprocalHeight = 1.f / (top - bottom);
+                    const float range = farPlane / (nearPlane - farPlane);
+                    return Matrix(
+                        twoNearZ * reciprocalWidth, 0.f, 0.f, 0.f,
+                        0.f, twoNearZ * reciprocalHeight, 0.f, 0.f,
+                        (left + right) * reciprocalWidth, (top + bottom) * reciprocalHeight, range, -1.f,
+                        0.f, 0.f, range * nearPlane, 0.f);
+                }
+                return Matrix::CreatePerspectiveOffCenter(left, right, bottom, top, nearPlane, farPlane);
+            }
+
+            constexpr Matrix CreateOrthographic(float width, float height, float zNearPlane, float zFarPlane) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    const float range = 1.f / (zNearPlane - zFarPlane);
+                    return Matrix(
+                        2.f / width, 0.f, 0.f, 0.f,
+                        0.f, 2.f / height, 0.f, 0.f,
+                        0.f, 0.f, range, 0.f,
+                        0.f, 0.f, range * zNearPlane, 1.f);
+                }
+                return Matrix::CreateOrthographic(width, height, zNearPlane, zFarPlane);
+            }
+
+            constexpr Matrix CreateOrthographicOffCenter(float left, float right, float bottom, float top, float zNearPlane, float zFarPlane) noexcept
+            {
+                if (Internal::IsConstantEvaluated())
+                {
+                    const float reciprocalWidth = 1.f / (right - left);
+                    const float reciprocalHeight = 1.f / (top - bottom);
+                    const float range = 1.f / (zNearPlane - zFarPlane);
+                    return Matrix(
+                        reciprocalWidth + reciprocalWidth, 0.f, 0.f, 0.f,
+                        0.f, reciprocalHeight + reciprocalHeight, 0.f, 0.f,
+                        0.f, 0.f, range, 0.f,
+                        -(left + right) * reciprocalWidth, -(top + bottom) * reciprocalHeight, range * zNearPlane, 1.f);
+                }
+                return Matrix::CreateOrthographicOffCenter(left, right, bottom, top, zNearPlane, zFarPlane);
+            }
+
+            //---------------------------------------------------------------------------------
+            // Comparisons usable in static_assert
+
+            constexpr bool Equal(const Vector2& v1, const Vector2& v2) noexcept
+            {
+                return v1.x == v2.x && v1.y == v2.y;
+            }
+
+            constexpr bool Equal(const Vector3& v1, const Vector3& v2) noexcept
+            {
+                return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z;
+            }
+
+            constexpr bool Equal(const Vector4& v1, const Vector4& v2) noexcept
+            {
+                return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z && v1.w == v2.w;
+            }
+
+            constexpr bool Equal(const Color& c1, const Color& c2) noexcept
+            {
+                return c1.x == c2.x && c1.y == c2.y && c1.z == c2.z && c1.w == c2.w;
+            }
+
+            constexpr bool Equal(const Matrix& m1, const Matrix& m2) noexcept
+            {
+                return Equal(Row(m1, 0), Row(m2, 0))
+                    && Equal(Row(m1, 1), Row(m2, 1))
+                    && Equal(Row(m1, 2), Row(m2, 2))
+                    && Equal(Row(m1, 3), Row(m2, 3));
+            }
+        }
+    }
+}
@@ -0,0 +1,514 @@
+//-------------------------------------------------------------------------------------
+// SimpleMathRayPacket.h -- Batched Ray intersection queries for SimpleMath
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//-------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cfloat>
+#include <cstdint>
+
+#include "SimpleMathStream.h"
+
+
+namespace DirectX
+{
+    namespace SimpleMath
+    {
+        namespace Internal
+        {
+            // Size() elements of N components, each in its own aligned, padded array
+            template<size_t N>
+            class ComponentStream
+            {
+            public:
+                ComponentStream() = default;
+                explicit ComponentStream(size_t count) : m_storage(N, count) {}
+
+                ComponentStream(ComponentStream&&) = default;
+                ComponentStream& operator= (ComponentStream&&) = default;
+
+                ComponentStream(ComponentStream const&) = delete;
+                ComponentStream& operator= (ComponentStream const&) = delete;
+
+                // Zeroes the contents
+                void Resize(size_t count) { m_storage.Resize(N, count); }
+
+                size_t Size() const noexcept { return m_storage.Count(); }
+
+                float* Component(size_t index) noexcept { assert(index < N); return m_storage.Component(index); }
+                const float* Component(size_t index) const noexcept { assert(index < N); return m_storage.Component(index); }
+
+            protected:
+                StreamStorage m_storage;
+            };
+        }
+
+        //------------------------------------------------------------------------------
+        // Packet intersection queries
+        //
+        // Bounds streams test one Ray against all of their elements; RayStream tests all of
+        // its rays against one bounding volume. Per element, each answers as the matching
+        // Ray::Intersects does, including the distance it reports.
+        //
+        // 'hits' receives one bit per element (bit j % 32 of word j / 32), so it needs
+        // (Size() + 31) / 32 words. 'distances' receives Size() floats, 0 for a miss. Either
+        // may be null. Ray directions are expected to be normalized, as for Ray::Intersects.
+
+        // Components: center x, y, z, radius
+        class BoundingSphereStream : public Internal::ComponentStream<4>
+        {
+        public:
+            BoundingSphereStream() = default;
+            explicit BoundingSphereStream(size_t count) : ComponentStream(count) {}
+            BoundingSphereStream(const BoundingSphere* spheres, size_t count) : ComponentStream(count) { Load(spheres, count); }
+
+            void Load(const BoundingSphere* spheres, size_t count)
+            {
+                Resize(count);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    Set(j, spheres[j]);
+                }
+            }
+
+            BoundingSphere Get(size_t index) const noexcept
+            {
+                assert(index < Size());
+                return BoundingSphere(XMFLOAT3(Component(0)[index], Component(1)[index], Component(2)[index]), Component(3)[index]);
+            }
+
+            void Set(size_t index, const BoundingSphere& sphere) noexcept
+            {
+                assert(index < Size());
+                Component(0)[index] = sphere.Center.x;
+                Component(1)[index] = sphere.Center.y;
+                Component(2)[index] = sphere.Center.z;
+                Component(3)[index] = sphere.Radius;
+            }
+
+            // Returns the index of the nearest hit with its distance in 'nearest', or SIZE_MAX
+            size_t Intersects(const Ray& ray, uint32_t* hits, float* distances, float& nearest) const noexcept;
+        };
+
+        // Components: center x, y, z, extents x, y, z
+        class BoundingBoxStream : public Internal::ComponentStream<6>
+        {
+        public:
+            BoundingBoxStream() = default;
+            explicit BoundingBoxStream(size_t count) : ComponentStream(count) {}
+            BoundingBoxStream(const BoundingBox* boxes, size_t count) : ComponentStream(count) { Load(boxes, count); }
+
+            void Load(const BoundingBox* boxes, size_t count)
+            {
+                Resize(count);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    Set(j, boxes[j]);
+                }
+            }
+
+            BoundingBox Get(size_t index) const noexcept
+            {
+                assert(index < Size());
+                return BoundingBox(
+                    XMFLOAT3(Component(0)[index], Component(1)[index], Component(2)[index]),
+                    XMFLOAT3(Component(3)[index], Component(4)[index], Component(5)[index]));
+            }
+
+            void Set(size_t index, const BoundingBox& box) noexcept
+            {
+                assert(index < Size());
+                Component(0)[index] = box.Center.x;
+                Component(1)[index] = box.Center.y;
+                Component(2)[index] = box.Center.z;
+                Component(3)[index] = box.Extents.x;
+                Component(4)[index] = box.Extents.y;
+                Component(5)[index] = box.Extents.z;
+            }
+
+            // Returns the index of the nearest hit with its distance in 'nearest', or SIZE_MAX.
+            // As BoundingBox::Intersects, a ray starting inside a box reports a negative distance.
+            size_t Intersects(const Ray& ray, uint32_t* hits, float* distances, float& nearest) const noexcept;
+        };
+
+        // Components: normal x, y, z, d
+        class PlaneStream : public Internal::ComponentStream<4>
+        {
+        public:
+            PlaneStream() = default;
+            explicit PlaneStream(size_t count) : ComponentStream(count) {}
+            PlaneStream(const Plane* planes, size_t count) : ComponentStream(count) { Load(planes, count); }
+
+            void Load(const Plane* planes, size_t count)
+            {
+                Resize(count);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    Set(j, planes[j]);
+                }
+            }
+
+            Plane Get(size_t index) const noexcept
+            {
+                assert(index < Size());
+                return Plane(Component(0)[index], Component(1)[index], Component(2)[index], Component(3)[index]);
+            }
+
+            void Set(size_t index, const Plane& plane) noexcept
+            {
+                assert(index < Size());
+                Component(0)[index] = plane.x;
+                Component(1)[index] = plane.y;
+                Component(2)[index] = plane.z;
+                Component(3)[index] = plane.w;
+            }
+
+            // Returns the index of the nearest hit with its distance in 'nearest', or SIZE_MAX
+            size_t Intersects(const Ray& ray, uint32_t* hits, float* distances, float& nearest) const noexcept;
+        };
+
+        // Components: position x, y, z, direction x, y, z
+        class RayStream : public Internal::ComponentStream<6>
+        {
+        public:
+            RayStream() = default;
+            explicit RayStream(size_t count) : ComponentStream(count) {}
+            RayStream(const Ray* rays, size_t count) : ComponentStream(count) { Load(rays, count); }
+
+            void Load(const Ray* rays, size_t count)
+            {
+                Resize(count);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    Set(j, rays[j]);
+                }
+            }
+
+            Ray Get(size_t index) const noexcept
+            {
+                assert(index < Size());
+                return Ray(
+                    Vector3(Component(0)[index], Component(1)[index], Component(2)[index]),
+                    Vector3(Component(3)[index], Component(4)[index], Component(5)[index]));
+            }
+
+            void Set(size_t index, const Ray& ray) noexcept
+            {
+                assert(index < Size());
+                Component(0)[index] = ray.position.x;
+                Component(1)[index] = ray.position.y;
+                Component(2)[index] = ray.position.z;
+                Component(3)[index] = ray.direction.x;
+                Component(4)[index] = ray.direction.y;
+                Component(5)[index] = ray.direction.z;
+            }
+
+            // Each return the number of rays that hit
+            size_t Intersects(const BoundingSphere& sphere, uint32_t* hits, float* distances) const noexcept;
+            size_t Intersects(const BoundingBox& box, uint32_t* hits, float* distances) const noexcept;
+            size_t Intersects(const Plane& plane, uint32_t* hits, float* distances) const noexcept;
+        };
+
+
+        //------------------------------------------------------------------------------
+        // Implementation
+        //------------------------------------------------------------------------------
+
+        namespace Internal
+        {
+            namespace RayPacket
+            {
+                using L = StreamLanes;
+
+                // Rays closer than this to parallel with a slab or plane never hit it
+                constexpr float c_RayEpsilon = 1e-20f;
+
+                struct LaneRay
+                {
+                    L::V ox, oy, oz;
+                    L::V dx, dy, dz;
+
+                    // 1 / direction, and which axes the ray is parallel to, for the slab test
+                    L::V ix, iy, iz;
+                    L::V px, py, pz;
+
+                    void PrepareSlabs() noexcept
+                    {
+                        const L::V one = L::Splat(1.f);
+                        const L::V epsilon = L::Splat(c_RayEpsilon);
+                        ix = L::Divide(one, dx);
+                        iy = L::Divide(one, dy);
+                        iz = L::Divide(one, dz);
+                        px = L::LessOrEqual(L::Abs(dx), epsilon);
+                        py = L::LessOrEqual(L::Abs(dy), epsilon);
+                        pz = L::LessOrEqual(L::Abs(dz), epsilon);
+                    }
+                };
+
+                inline LaneRay SplatRay(const Ray& ray) noexcept
+                {
+                    LaneRay result = {};
+                    result.ox = L::Splat(ray.position.x);
+                    result.oy = L::Splat(ray.position.y);
+                    result.oz = L::Splat(ray.position.z);
+                    result.dx = L::Splat(ray.direction.x);
+                    result.dy = L::Splat(ray.direction.y);
+                    result.dz = L::Splat(ray.direction.z);
+                    return result;
+                }
+
+                inline LaneRay LoadRays(const RayStream& rays, size_t offset) noexcept
+                {
+                    LaneRay result = {};
+                    result.ox = L::Load(rays.Component(0) + offset);
+                    result.oy = L::Load(rays.Component(1) + offset);
+                    result.oz = L::Load(rays.Component(2) + offset);
+                    result.dx = L::Load(rays.Component(3) + offset);
+                    result.dy = L::Load(rays.Component(4) + offset);
+                    result.dz = L::Load(rays.Component(5) + offset);
+                    return result;
+                }
+
+                inline L::V XM_CALLCONV Dot3(L::V ax, L::V ay, L::V az, L::V bx, L::V by, L::V bz) noexcept
+                {
+                    return L::Add(L::Add(L::Multiply(ax, bx), L::Multiply(ay, by)), L::Multiply(az, bz));
+                }
+
+                // As BoundingSphere::Intersects: distance to entry, or to exit if the ray starts inside
+                inline L::V XM_CALLCONV SphereLanes(const LaneRay& ray, L::V cx, L::V cy, L::V cz, L::V radius, L::V& noHit) noexcept
+                {
+                    const L::V zero = L::Splat(0.f);
+
+                    const L::V lx = L::Subtract(cx, ray.ox);
+                    const L::V ly = L::Subtract(cy, ray.oy);
+                    const L::V lz = L::Subtract(cz, ray.oz);
+
+                    const L::V s = Dot3(lx, ly, lz, ray.dx, ray.dy, ray.dz);
+                    const L::V l2 = Dot3(lx, ly, lz, lx, ly, lz);
+                    const L::V r2 = L::Multiply(radius, radius);
+                    const L::V m2 = L::Subtract(l2, L::Multiply(s, s));
+
+                    noHit = L::Or(L::And(L::Less(s, zero), L::Greater(l2, r2)), L::Greater(m2, r2));
+
+                    const L::V q = L::Sqrt(L::Subtract(r2, m2));
+                    const L::V t = L::Select(L::Subtract(s, q), L::Add(s, q), L::LessOrEqual(l2, r2));
+
+                    return L::Select(t, zero, noHit);
+                }
+
+                // One slab of the box test
+                inline void XM_CALLCONV SlabLanes(L::V center, L::V extent, L::V origin, L::V inverse, L::V parallel,
+                    L::V& tmin, L::V& tmax, L::V& outside) noexcept
+                {
+                    const L::V offset = L::Subtract(center, origin);
+                    const L::V t1 = L::Multiply(L::Subtract(offset, extent), inverse);
+                    const L::V t2 = L::Multiply(L::Add(offset, extent), inverse);
+
+                    tmin = L::Select(L::Min(t1, t2), L::Splat(-FLT_MAX), parallel);
+                    tmax = L::Select(L::Max(t1, t2), L::Splat(FLT_MAX), parallel);
+
+                    // A parallel ray misses unless its origin is between the slab's planes
+                    const L::V inside = L::And(L::LessOrEqual(offset, extent), L::LessOrEqual(L::Subtract(L::Splat(0.f), extent), offset));
+                    outside = L::AndNot(parallel, inside);
+                }
+
+                // As BoundingBox::Intersects: distance to entry, negative if the ray starts inside
+                inline L::V XM_CALLCONV BoxLanes(const LaneRay& ray, L::V cx, L::V cy, L::V cz, L::V ex, L::V ey, L::V ez, L::V& noHit) noexcept
+                {
+                    L::V minX, maxX, outX;
+                    L::V minY, maxY, outY;
+                    L::V minZ, maxZ, outZ;
+                    SlabLanes(cx, ex, ray.ox, ray.ix, ray.px, minX, maxX, outX);
+                    SlabLanes(cy, ey, ray.oy, ray.iy, ray.py, minY, maxY, outY);
+                    SlabLanes(cz, ez, ray.oz, ray.iz, ray.pz, minZ, maxZ, outZ);
+
+                    const L::V tmin = L::Max(L::Max(minX, minY), minZ);
+                    const L::V tmax = L::Min(L::Min(maxX, maxY), maxZ);
+
+                    noHit = L::Or(L::Greater(tmin, tmax), L::Less(tmax, L::Splat(0.f)));
+                    noHit = L::Or(noHit, L::Or(outX, L::Or(outY, outZ)));
+
+                    return L::Select(tmin, L::Splat(0.f), noHit);
+                }
+
+                // As Ray::Intersects(const Plane&): only hits in front of the origin count
+                inline L::V XM_CALLCONV PlaneLanes(const LaneRay& ray, L::V nx, L::V ny, L::V nz, L::V d, L::V& noHit) noexcept
+                {
+                    const L::V zero = L::Splat(0.f);
+
+                    const L::V nd = Dot3(nx, ny, nz, ray.dx, ray.dy, ray.dz);
+                    const L::V no = L::Add(Dot3(nx, ny, nz, ray.ox, ray.oy, ray.oz), d);
+                    const L::V t = L::Subtract(zero, L::Divide(no, nd));
+
+                    noHit = L::Or(L::LessOrEqual(L::Abs(nd), L::Splat(c_RayEpsilon)), L::Less(t, zero));
+
+                    return L::Select(t, zero, noHit);
+                }
+
+                // Writes one register of results; returns the hit bits for the valid lanes
+                inline unsigned int XM_CALLCONV StoreHits(size_t offset, size_t count, L::V dist, L::V noHit, uint32_t* hits, float* distances) noexcept
+                {
+                    const size_t lanes = (count - offset < L::Count) ? count - offset : L::Count;
+                    const unsigned int bits = ~L::MoveMask(noHit) & ((1u << lanes) - 1u);
+
+                    if (hits)
+                    {
+                        uint32_t& word = hits[offset / 32];
+                        if (!(offset % 32))
+                        {
+                            word = 0;
+                        }
+                        word |= uint32_t(bits) << (offset % 32);
+                    }
+
+                    if (distances)
+                    {
+                        StoreLanes(distances + offset, dist, lanes);
+                    }
+
+                    return bits;
+                }
+
+                // Runs kernel(offset, noHit) -> distances over every element of a bounds stream
+                template<typename TKernel>
+                size_t IntersectBounds(size_t count, TKernel&& kernel, uint32_t* hits, float* distances, float& nearest) noexcept
+                {
+                    size_t nearestIndex = SIZE_MAX;
+                    nearest = 0.f;
+
+                    for (size_t j = 0; j < count; j += L::Count)
+                    {
+                        L::V noHit;
+                        const L::V dist = kernel(j, noHit);
+
+                        unsigned int bits = StoreHits(j, count, dist, noHit, hits, distances);
+                        if (bits)
+                        {
+                            alignas(c_StreamAlignment) float temp[L::Count];
+                            L::Store(temp, dist);
+                            for (size_t k = 0; bits; ++k, bits >>= 1)
+                            {
+                                if ((bits & 1) && (nearestIndex == SIZE_MAX || temp[k] < nearest))
+                                {
+                                    nearestIndex = j + k;
+                                    nearest = temp[k];
+                                }
+                            }
+                        }
+                    }
+
+                    return nearestIndex;
+                }
+
+                // Runs kernel(offset, noHit) -> distances over every ray of a RayStream
+                template<typename TKernel>
+                size_t IntersectRays(size_t count, TKernel&& kernel, uint32_t* hits, float* distances) noexcept
+                {
+                    size_t hitCount = 0;
+
+                    for (size_t j = 0; j < count; j += L::Count)
+                    {
+                        L::V noHit;
+                        const L::V dist = kernel(j, noHit);
+
+                        for (unsigned int bits = StoreHits(j, count, dist, noHit, hits, distances); bits; bits &= bits - 1)
+                        {
+                            ++hitCount;
+                        }
+                    }
+
+                    return hitCount;
+                }
+            }
+        }
+
+        inline size_t BoundingSphereStream::Intersects(const Ray& ray, uint32_t* hits, float* distances, float& nearest) const noexcept
+        {
+            const Internal::RayPacket::LaneRay r = Internal::RayPacket::SplatRay(ray);
+            return Internal::RayPacket::IntersectBounds(Size(), [&](size_t j, Internal::RayPacket::L::V& noHit)
+                {
+                    using L = Internal::RayPacket::L;
+                    return Internal::RayPacket::SphereLanes(r,
+                        L::Load(Component(0) + j), L::Load(Component(1) + j), L::Load(Component(2) + j),
+                        L::Load(Component(3) + j), noHit);
+                }, hits, distances, nearest);
+        }
+
+        inline size_t BoundingBoxStream::Intersects(const Ray& ray, uint32_t* hits, float* distances, float& nearest) const noexcept
+        {
+            Internal::RayPacket::LaneRay r = Internal::RayPacket::SplatRay(ray);
+            r.PrepareSlabs();
+            return Internal::RayPacket::IntersectBounds(Size(), [&](size_t j, Internal::RayPacket::L::V& noHit)
+                {
+                    using L = Internal::RayPacket::L;
+                    return Internal::RayPacket::BoxLanes(r,
+                        L::Load(Component(0) + j), L::Load(Component(1) + j), L::Load(Component(2) + j),
+                        L::Load(Component(3) + j), L::Load(Component(4) + j), L::Load(Component(5) + j), noHit);
+                }, hits, distances, nearest);
+        }
+
+        inline size_t PlaneStream::Intersects(const Ray& ray, uint32_t* hits, float* distances, float& nearest) const noexcept
+        {
+            const Internal::RayPacket::LaneRay r = Internal::RayPacket::SplatRay(ray);
+            return Internal::RayPacket::IntersectBounds(Size(), [&](size_t j, Internal::RayPacket::L::V& noHit)
+                {
+                    using L = Internal::RayPacket::L;
+                    return Internal::RayPacket::PlaneLanes(r,
+                        L::Load(Component(0) + j), L::Load(Component(1) + j), L::Load(Component(2) + j),
+                        L::Load(Component(3) + j), noHit);
+                }, hits, distances, nearest);
+        }
+
+        inline size_t RayStream::Intersects(const BoundingSphere& sphere, uint32_t* hits, float* distances) const noexcept
+        {
+            using L = Internal::StreamLanes;
+
+            const L::V cx = L::Splat(sphere.Center.x);
+            const L::V cy = L::Splat(sphere.Center.y);
+            const L::V cz = L::Splat(sphere.Center.z);
+            const L::V radius = L::Splat(sphere.Radius);
+
+            return Internal::RayPacket::IntersectRays(Size(), [&](size_t j, L::V& noHit)
+                {
+                    return Internal::RayPacket::SphereLanes(Internal::RayPacket::LoadRays(*this, j), cx, cy, cz, radius, noHit);
+                }, hits, distances);
+        }
+
+        inline size_t RayStream::Intersects(const BoundingBox& box, uint32_t* hits, float* distances) const noexcept
+        {
+            using L = Internal::StreamLanes;
+
+            const L::V cx = L::Splat(box.Center.x);
+            const L::V cy = L::Splat(box.Center.y);
+            const L::V cz = L::Splat(box.Center.z);
+            const L::V ex = L::Splat(box.Extents.x);
+            const L::V ey = L::Splat(box.Extents.y);
+            const L::V ez = L::Splat(box.Extents.z);
+
+            return Internal::RayPacket::IntersectRays(Size(), [&](size_t j, L::V& noHit)
+                {
+                    Internal::RayPacket::LaneRay r = Internal::RayPacket::LoadRays(*this, j);
+                    r.PrepareSlabs();
+                    return Internal::RayPacket::BoxLanes(r, cx, cy, cz, ex, ey, ez, noHit);
+                }, hits, distances);
+        }
+
+        inline size_t RayStream::Intersects(const Plane& plane, uint32_t* hits, float* distances) const noexcept
+        {
+            using L = Internal::StreamLanes;
+
+            const L::V nx = L::Splat(plane.x);
+            const L::V ny = L::Splat(plane.y);
+            const L::V nz = L::Splat(plane.z);
+            const L::V d = L::Splat(plane.w);
+
+            return Internal::RayPacket::IntersectRays(Size(), [&](size_t j, L::V& noHit)
+                {
+                    return Internal::RayPacket::PlaneLanes(Internal::RayPacket::LoadRays(*this, j), nx, ny, nz, d, noHit);
+                }, hits, distances);
+        }
+    }
+}
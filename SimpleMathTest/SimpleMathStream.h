@@ -0,0 +1,821 @@
+//-------------------------------------------------------------------------------------
+// SimpleMathStream.h -- Structure-of-arrays batch types for SimpleMath
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//-------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#if defined(_XM_AVX_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+#include <immintrin.h>
+#endif
+
+#include "SimpleMath.h"
+
+
+namespace DirectX
+{
+    namespace SimpleMath
+    {
+        namespace Internal
+        {
+            // Each component array is aligned and padded to this many floats, so the kernels
+            // always work on whole registers and never need a scalar tail.
+            constexpr size_t c_StreamLanes = 8;
+            constexpr size_t c_StreamAlignment = c_StreamLanes * sizeof(float);
+
+            inline size_t StreamPadded(size_t count) noexcept
+            {
+                return (count + c_StreamLanes - 1) & ~(c_StreamLanes - 1);
+            }
+
+            // 'components' arrays of 'stride' floats in one aligned allocation
+            class StreamStorage
+            {
+            public:
+                StreamStorage() noexcept : m_data(nullptr), m_count(0), m_stride(0) {}
+
+                StreamStorage(size_t components, size_t count) : StreamStorage()
+                {
+                    Resize(components, count);
+                }
+
+                StreamStorage(StreamStorage&& other) noexcept :
+                    m_data(other.m_data),
+                    m_count(other.m_count),
+                    m_stride(other.m_stride)
+                {
+                    other.m_data = nullptr;
+                    other.m_count = other.m_stride = 0;
+                }
+
+                StreamStorage& operator= (StreamStorage&& other) noexcept
+                {
+                    if (this != &other)
+                    {
+                        Free();
+                        m_data = other.m_data;
+                        m_count = other.m_count;
+                        m_stride = other.m_stride;
+                        other.m_data = nullptr;
+                        other.m_count = other.m_stride = 0;
+                    }
+                    return *this;
+                }
+
+                StreamStorage(StreamStorage const&) = delete;
+                StreamStorage& operator= (StreamStorage const&) = delete;
+
+                ~StreamStorage() { Free(); }
+
+                // Contents are zeroed, including the padding lanes
+                void Resize(size_t components, size_t count)
+                {
+                    const size_t stride = StreamPadded(count);
+                    if (stride != m_stride || !m_data)
+                    {
+                        const size_t bytes = (stride ? stride : c_StreamLanes) * components * sizeof(float);
+                    #ifdef _WIN32
+                        auto data = static_cast<float*>(_aligned_malloc(bytes, c_StreamAlignment));
+                    #else
+                        auto data = static_cast<float*>(aligned_alloc(c_StreamAlignment, bytes));
+                    #endif
+                        if (!data)
+                            throw std::bad_alloc();
+
+                        Free();
+                        m_data = data;
+                        m_stride = stride;
+                    }
+
+                    m_count = count;
+                    memset(m_data, 0, (m_stride ? m_stride : c_StreamLanes) * components * sizeof(float));
+                }
+
+                size_t Count() const noexcept { return m_count; }
+                size_t Stride() const noexcept { return m_stride; }
+
+                float* Component(size_t index) noexcept { return m_data + index * m_stride; }
+                const float* Component(size_t index) const noexcept { return m_data + index * m_stride; }
+
+            private:
+                void Free() noexcept
+                {
+                    if (m_data)
+                    {
+                    #ifdef _WIN32
+                        _aligned_free(m_data);
+                    #else
+                        free(m_data);
+                    #endif
+                        m_data = nullptr;
+                    }
+                }
+
+                float* m_data;
+                size_t m_count;
+                size_t m_stride;
+            };
+
+            // The register the kernels are written against: 8 lanes with AVX, otherwise the
+            // 4 lanes of an XMVECTOR (SSE, NEON, or the no-intrinsics fallback).
+        #if defined(_XM_AVX_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+            struct StreamLanes
+            {
+                using V = __m256;
+                static constexpr size_t Count = 8;
+
+                static V Load(const float* p) noexcept { return _mm256_load_ps(p); }
+                static void Store(float* p, V v) noexcept { _mm256_store_ps(p, v); }
+                static V Splat(float f) noexcept { return _mm256_set1_ps(f); }
+                static V Add(V a, V b) noexcept { return _mm256_add_ps(a, b); }
+                static V Subtract(V a, V b) noexcept { return _mm256_sub_ps(a, b); }
+                static V Multiply(V a, V b) noexcept { return _mm256_mul_ps(a, b); }
+                static V Divide(V a, V b) noexcept { return _mm256_div_ps(a, b); }
+                static V Sqrt(V a) noexcept { return _mm256_sqrt_ps(a); }
+
+                // a * b + c
+                static V MultiplyAdd(V a, V b, V c) noexcept
+                {
+                #ifdef _XM_FMA3_INTRINSICS_
+                    return _mm256_fmadd_ps(a, b, c);
+                #else
+                    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+                #endif
+                }
+
+                // a where test > 0, otherwise zero
+                static V SelectPositive(V test, V a) noexcept
+                {
+                    return _mm256_and_ps(_mm256_cmp_ps(test, _mm256_setzero_ps(), _CMP_GT_OQ), a);
+                }
+
+                static V Min(V a, V b) noexcept { return _mm256_min_ps(a, b); }
+                static V Max(V a, V b) noexcept { return _mm256_max_ps(a, b); }
+                static V Abs(V a) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+
+                // Comparisons return all-ones lanes where true
+                static V Greater(V a, V b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+                static V Less(V a, V b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+                static V LessOrEqual(V a, V b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+                static V And(V a, V b) noexcept { return _mm256_and_ps(a, b); }
+                static V Or(V a, V b) noexcept { return _mm256_or_ps(a, b); }
+
+                // a & ~b
+                static V AndNot(V a, V b) noexcept { return _mm256_andnot_ps(b, a); }
+
+                // b where mask is set, otherwise a
+                static V Select(V a, V b, V mask) noexcept { return _mm256_blendv_ps(a, b, mask); }
+
+                // One bit per lane of a comparison result
+                static unsigned int MoveMask(V mask) noexcept { return static_cast<unsigned int>(_mm256_movemask_ps(mask)); }
+            };
+        #else
+            struct StreamLanes
+            {
+                using V = XMVECTOR;
+                static constexpr size_t Count = 4;
+
+                static V XM_CALLCONV Load(const float* p) noexcept { return XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(p)); }
+                static void XM_CALLCONV Store(float* p, FXMVECTOR v) noexcept { XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(p), v); }
+                static V XM_CALLCONV Splat(float f) noexcept { return XMVectorReplicate(f); }
+                static V XM_CALLCONV Add(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorAdd(a, b); }
+                static V XM_CALLCONV Subtract(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorSubtract(a, b); }
+                static V XM_CALLCONV Multiply(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorMultiply(a, b); }
+                static V XM_CALLCONV Divide(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorDivide(a, b); }
+                static V XM_CALLCONV Sqrt(FXMVECTOR a) noexcept { return XMVectorSqrt(a); }
+                static V XM_CALLCONV MultiplyAdd(FXMVECTOR a, FXMVECTOR b, FXMVECTOR c) noexcept { return XMVectorMultiplyAdd(a, b, c); }
+
+                static V XM_CALLCONV SelectPositive(FXMVECTOR test, FXMVECTOR a) noexcept
+                {
+                    return XMVectorSelect(XMVectorZero(), a, XMVectorGreater(test, XMVectorZero()));
+                }
+
+                static V XM_CALLCONV Min(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorMin(a, b); }
+                static V XM_CALLCONV Max(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorMax(a, b); }
+                static V XM_CALLCONV Abs(FXMVECTOR a) noexcept { return XMVectorAbs(a); }
+
+                static V XM_CALLCONV Greater(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorGreater(a, b); }
+                static V XM_CALLCONV Less(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorLess(a, b); }
+                static V XM_CALLCONV LessOrEqual(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorLessOrEqual(a, b); }
+                static V XM_CALLCONV And(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorAndInt(a, b); }
+                static V XM_CALLCONV Or(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorOrInt(a, b); }
+                static V XM_CALLCONV AndNot(FXMVECTOR a, FXMVECTOR b) noexcept { return XMVectorAndCInt(a, b); }
+                static V XM_CALLCONV Select(FXMVECTOR a, FXMVECTOR b, FXMVECTOR mask) noexcept { return XMVectorSelect(a, b, mask); }
+
+                static unsigned int XM_CALLCONV MoveMask(FXMVECTOR mask) noexcept
+                {
+                #if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+                    return static_cast<unsigned int>(_mm_movemask_ps(mask));
+                #else
+                    uint32_t bits[4];
+                    XMStoreInt4(bits, mask);
+                    return (bits[0] >> 31) | ((bits[1] >> 31) << 1) | ((bits[2] >> 31) << 2) | ((bits[3] >> 31) << 3);
+                #endif
+                }
+            };
+        #endif
+
+            static_assert(c_StreamLanes % StreamLanes::Count == 0, "Stream padding must be a whole number of registers");
+        }
+
+        class MatrixStream;
+
+        //------------------------------------------------------------------------------
+        // Vector3Stream: x[], y[], z[] as separate aligned arrays
+        //
+        // The batch operations resize 'result' to match their input, and may be called
+        // in-place (result being one of the inputs).
+        class Vector3Stream
+        {
+        public:
+            Vector3Stream() = default;
+            explicit Vector3Stream(size_t count) : m_storage(3, count) {}
+            Vector3Stream(const Vector3* varray, size_t count) : m_storage(3, count) { Load(varray, count); }
+
+            Vector3Stream(Vector3Stream&&) = default;
+            Vector3Stream& operator= (Vector3Stream&&) = default;
+
+            Vector3Stream(Vector3Stream const&) = delete;
+            Vector3Stream& operator= (Vector3Stream const&) = delete;
+
+            // Zeroes the contents
+            void Resize(size_t count) { m_storage.Resize(3, count); }
+
+            size_t Size() const noexcept { return m_storage.Count(); }
+
+            float* X() noexcept { return m_storage.Component(0); }
+            float* Y() noexcept { return m_storage.Component(1); }
+            float* Z() noexcept { return m_storage.Component(2); }
+            const float* X() const noexcept { return m_storage.Component(0); }
+            const float* Y() const noexcept { return m_storage.Component(1); }
+            const float* Z() const noexcept { return m_storage.Component(2); }
+
+            Vector3 Get(size_t index) const noexcept
+            {
+                assert(index < Size());
+                return Vector3(X()[index], Y()[index], Z()[index]);
+            }
+
+            void Set(size_t index, const Vector3& v) noexcept
+            {
+                assert(index < Size());
+                X()[index] = v.x;
+                Y()[index] = v.y;
+                Z()[index] = v.z;
+            }
+
+            // Conversion from and to the AoS type
+            void Load(const Vector3* varray, size_t count)
+            {
+                Resize(count);
+
+                float* x = X();
+                float* y = Y();
+                float* z = Z();
+                for (size_t j = 0; j < count; ++j)
+                {
+                    x[j] = varray[j].x;
+                    y[j] = varray[j].y;
+                    z[j] = varray[j].z;
+                }
+            }
+
+            void Store(Vector3* resultArray) const noexcept
+            {
+                const float* x = X();
+                const float* y = Y();
+                const float* z = Z();
+                for (size_t j = 0; j < Size(); ++j)
+                {
+                    resultArray[j] = Vector3(x[j], y[j], z[j]);
+                }
+            }
+
+            // Batch operations; per element these match the Vector3 function of the same name
+            static void Transform(const Vector3Stream& v, const Matrix& m, Vector3Stream& result);
+            static void Transform(const Vector3Stream& v, const MatrixStream& m, Vector3Stream& result);
+
+            static void TransformNormal(const Vector3Stream& v, const Matrix& m, Vector3Stream& result);
+            static void TransformNormal(const Vector3Stream& v, const MatrixStream& m, Vector3Stream& result);
+
+            static void Normalize(const Vector3Stream& v, Vector3Stream& result);
+            static void Lerp(const Vector3Stream& v1, const Vector3Stream& v2, float t, Vector3Stream& result);
+
+            // 'resultArray' receives Size() floats
+            static void Dot(const Vector3Stream& v1, const Vector3Stream& v2, float* resultArray) noexcept;
+            static void Length(const Vector3Stream& v, float* resultArray) noexcept;
+
+        private:
+            // Lets 'result' alias an input: only reallocate when the size differs
+            void Prepare(size_t count)
+            {
+                if (Size() != count)
+                {
+                    Resize(count);
+                }
+            }
+
+            Internal::StreamStorage m_storage;
+        };
+
+        //------------------------------------------------------------------------------
+        // MatrixStream: one aligned array per matrix element (_11[], _12[], ... _44[])
+        class MatrixStream
+        {
+        public:
+            MatrixStream() = default;
+            explicit MatrixStream(size_t count) : m_storage(16, count) {}
+            MatrixStream(const Matrix* marray, size_t count) : m_storage(16, count) { Load(marray, count); }
+
+            MatrixStream(MatrixStream&&) = default;
+            MatrixStream& operator= (MatrixStream&&) = default;
+
+            MatrixStream(MatrixStream const&) = delete;
+            MatrixStream& operator= (MatrixStream const&) = delete;
+
+            // Zeroes the contents
+            void Resize(size_t count) { m_storage.Resize(16, count); }
+
+            size_t Size() const noexcept { return m_storage.Count(); }
+
+            // Array of element (row, column) across the stream, both 0-based
+            float* Element(size_t row, size_t column) noexcept { return m_storage.Component(row * 4 + column); }
+            const float* Element(size_t row, size_t column) const noexcept { return m_storage.Component(row * 4 + column); }
+
+            Matrix Get(size_t index) const noexcept
+            {
+                assert(index < Size());
+                Matrix m;
+                for (size_t j = 0; j < 16; ++j)
+                {
+                    m.m[j / 4][j % 4] = m_storage.Component(j)[index];
+                }
+                return m;
+            }
+
+            void Set(size_t index, const Matrix& m) noexcept
+            {
+                assert(index < Size());
+                for (size_t j = 0; j < 16; ++j)
+                {
+                    m_storage.Component(j)[index] = m.m[j / 4][j % 4];
+                }
+            }
+
+            // Conversion from and to the AoS type
+            void Load(const Matrix* marray, size_t count)
+            {
+                Resize(count);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    Set(j, marray[j]);
+                }
+            }
+
+            void Store(Matrix* resultArray) const noexcept
+            {
+                for (size_t j = 0; j < Size(); ++j)
+                {
+                    resultArray[j] = Get(j);
+                }
+            }
+
+            // result[i] = m1[i] * m2
+            static void Multiply(const MatrixStream& m1, const Matrix& m2, MatrixStream& result);
+
+        private:
+            Internal::StreamStorage m_storage;
+        };
+
+
+        //------------------------------------------------------------------------------
+        // Batched Viewport::Project / Viewport::Unproject
+        //
+        // world * view * proj and the viewport scale and offset are composed into one matrix
+        // up front, so each point costs a single transform. Large batches can be split into
+        // chunks across 'threads' threads (0 for one per hardware thread).
+        Matrix CreateViewportProject(const Viewport& viewport, const Matrix& proj, const Matrix& view, const Matrix& world) noexcept;
+        Matrix CreateViewportUnproject(const Viewport& viewport, const Matrix& proj, const Matrix& view, const Matrix& world) noexcept;
+
+        void ViewportProject(const Viewport& viewport, const Vector3* points, size_t count,
+            const Matrix& proj, const Matrix& view, const Matrix& world, Vector3* resultArray, unsigned int threads = 1);
+        void ViewportUnproject(const Viewport& viewport, const Vector3* points, size_t count,
+            const Matrix& proj, const Matrix& view, const Matrix& world, Vector3* resultArray, unsigned int threads = 1);
+
+        void ViewportProject(const Viewport& viewport, const Vector3Stream& points,
+            const Matrix& proj, const Matrix& view, const Matrix& world, Vector3Stream& result, unsigned int threads = 1);
+        void ViewportUnproject(const Viewport& viewport, const Vector3Stream& points,
+            const Matrix& proj, const Matrix& view, const Matrix& world, Vector3Stream& result, unsigned int threads = 1);
+
+
+        //------------------------------------------------------------------------------
+        // Implementation
+        //------------------------------------------------------------------------------
+
+        namespace Internal
+        {
+            // Rows of a matrix broadcast across the lanes, or the rows of a MatrixStream
+            // block. Either way element (r, c) for the current block is Get(r, c).
+            struct SplatMatrix
+            {
+                StreamLanes::V e[16];
+
+                explicit SplatMatrix(const Matrix& m) noexcept
+                {
+                    for (size_t j = 0; j < 16; ++j)
+                    {
+                        e[j] = StreamLanes::Splat(m.m[j / 4][j % 4]);
+                    }
+                }
+
+                void Next(size_t) noexcept {}
+                StreamLanes::V Get(size_t row, size_t column) const noexcept { return e[row * 4 + column]; }
+            };
+
+            struct StreamMatrix
+            {
+                const MatrixStream& source;
+                StreamLanes::V e[16];
+
+                explicit StreamMatrix(const MatrixStream& m) noexcept : source(m), e{} {}
+
+                void Next(size_t offset) noexcept
+                {
+                    for (size_t j = 0; j < 16; ++j)
+                    {
+                        e[j] = StreamLanes::Load(source.Element(j / 4, j % 4) + offset);
+                    }
+                }
+
+                StreamLanes::V Get(size_t row, size_t column) const noexcept { return e[row * 4 + column]; }
+            };
+
+            template<bool Coord, typename TMatrix>
+            void TransformStream(const Vector3Stream& v, TMatrix& m, Vector3Stream& result, size_t begin, size_t end) noexcept
+            {
+                using L = StreamLanes;
+
+                const float* vx = v.X();
+                const float* vy = v.Y();
+                const float* vz = v.Z();
+                float* rx = result.X();
+                float* ry = result.Y();
+                float* rz = result.Z();
+
+                assert((begin % c_StreamLanes) == 0);
+
+                const size_t padded = StreamPadded(end);
+                for (size_t j = begin; j < padded; j += L::Count)
+                {
+                    m.Next(j);
+
+                    const L::V x = L::Load(vx + j);
+                    const L::V y = L::Load(vy + j);
+                    const L::V z = L::Load(vz + j);
+
+                    L::V ox = L::Multiply(z, m.Get(2, 0));
+                    L::V oy = L::Multiply(z, m.Get(2, 1));
+                    L::V oz = L::Multiply(z, m.Get(2, 2));
+                    if (Coord)
+                    {
+                        ox = L::Add(ox, m.Get(3, 0));
+                        oy = L::Add(oy, m.Get(3, 1));
+                        oz = L::Add(oz, m.Get(3, 2));
+                    }
+                    ox = L::MultiplyAdd(y, m.Get(1, 0), ox);
+                    oy = L::MultiplyAdd(y, m.Get(1, 1), oy);
+                    oz = L::MultiplyAdd(y, m.Get(1, 2), oz);
+                    ox = L::MultiplyAdd(x, m.Get(0, 0), ox);
+                    oy = L::MultiplyAdd(x, m.Get(0, 1), oy);
+                    oz = L::MultiplyAdd(x, m.Get(0, 2), oz);
+
+                    if (Coord)
+                    {
+                        // As XMVector3TransformCoord, divide through by w
+                        L::V w = L::MultiplyAdd(z, m.Get(2, 3), m.Get(3, 3));
+                        w = L::MultiplyAdd(y, m.Get(1, 3), w);
+                        w = L::MultiplyAdd(x, m.Get(0, 3), w);
+
+                        ox = L::Divide(ox, w);
+                        oy = L::Divide(oy, w);
+                        oz = L::Divide(oz, w);
+                    }
+
+                    L::Store(rx + j, ox);
+                    L::Store(ry + j, oy);
+                    L::Store(rz + j, oz);
+                }
+            }
+
+            inline StreamLanes::V XM_CALLCONV StreamDot(const Vector3Stream& v1, const Vector3Stream& v2, size_t offset) noexcept
+            {
+                using L = StreamLanes;
+
+                L::V dot = L::Multiply(L::Load(v1.Z() + offset), L::Load(v2.Z() + offset));
+                dot = L::MultiplyAdd(L::Load(v1.Y() + offset), L::Load(v2.Y() + offset), dot);
+                return L::MultiplyAdd(L::Load(v1.X() + offset), L::Load(v2.X() + offset), dot);
+            }
+
+            // Stores a full register, or just the first 'count' lanes of it
+            inline void XM_CALLCONV StoreLanes(float* resultArray, StreamLanes::V value, size_t count) noexcept
+            {
+                if (count >= StreamLanes::Count)
+                {
+                    // resultArray has no alignment requirement
+                #if defined(_XM_AVX_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+                    _mm256_storeu_ps(resultArray, value);
+                #else
+                    XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(resultArray), value);
+                #endif
+                }
+                else
+                {
+                    alignas(c_StreamAlignment) float temp[StreamLanes::Count];
+                    StreamLanes::Store(temp, value);
+                    memcpy(resultArray, temp, count * sizeof(float));
+                }
+            }
+        }
+
+        inline void Vector3Stream::Transform(const Vector3Stream& v, const Matrix& m, Vector3Stream& result)
+        {
+            result.Prepare(v.Size());
+            Internal::SplatMatrix M(m);
+            Internal::TransformStream<true>(v, M, result, 0, v.Size());
+        }
+
+        inline void Vector3Stream::Transform(const Vector3Stream& v, const MatrixStream& m, Vector3Stream& result)
+        {
+            assert(m.Size() == v.Size());
+            result.Prepare(v.Size());
+            Internal::StreamMatrix M(m);
+            Internal::TransformStream<true>(v, M, result, 0, v.Size());
+        }
+
+        inline void Vector3Stream::TransformNormal(const Vector3Stream& v, const Matrix& m, Vector3Stream& result)
+        {
+            result.Prepare(v.Size());
+            Internal::SplatMatrix M(m);
+            Internal::TransformStream<false>(v, M, result, 0, v.Size());
+        }
+
+        inline void Vector3Stream::TransformNormal(const Vector3Stream& v, const MatrixStream& m, Vector3Stream& result)
+        {
+            assert(m.Size() == v.Size());
+            result.Prepare(v.Size());
+            Internal::StreamMatrix M(m);
+            Internal::TransformStream<false>(v, M, result, 0, v.Size());
+        }
+
+        inline void Vector3Stream::Normalize(const Vector3Stream& v, Vector3Stream& result)
+        {
+            using L = Internal::StreamLanes;
+
+            result.Prepare(v.Size());
+
+            const size_t padded = Internal::StreamPadded(v.Size());
+            for (size_t j = 0; j < padded; j += L::Count)
+            {
+                // Zero-length vectors (and the padding) normalize to zero, as XMVector3Normalize
+                const L::V length = L::Sqrt(Internal::StreamDot(v, v, j));
+                L::Store(result.X() + j, L::SelectPositive(length, L::Divide(L::Load(v.X() + j), length)));
+                L::Store(result.Y() + j, L::SelectPositive(length, L::Divide(L::Load(v.Y() + j), length)));
+                L::Store(result.Z() + j, L::SelectPositive(length, L::Divide(L::Load(v.Z() + j), length)));
+            }
+        }
+
+        inline void Vector3Stream::Lerp(const Vector3Stream& v1, const Vector3Stream& v2, float t, Vector3Stream& result)
+        {
+            using L = Internal::StreamLanes;
+
+            assert(v1.Size() == v2.Size());
+            result.Prepare(v1.Size());
+
+            const L::V T = L::Splat(t);
+            const size_t padded = Internal::StreamPadded(v1.Size());
+            for (size_t j = 0; j < padded; j += L::Count)
+            {
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    const L::V a = L::Load(v1.m_storage.Component(c) + j);
+                    const L::V b = L::Load(v2.m_storage.Component(c) + j);
+                    L::Store(result.m_storage.Component(c) + j, L::MultiplyAdd(T, L::Subtract(b, a), a));
+                }
+            }
+        }
+
+        inline void Vector3Stream::Dot(const Vector3Stream& v1, const Vector3Stream& v2, float* resultArray) noexcept
+        {
+            using L = Internal::StreamLanes;
+
+            assert(v1.Size() == v2.Size());
+
+            const size_t count = v1.Size();
+            for (size_t j = 0; j < count; j += L::Count)
+            {
+                Internal::StoreLanes(resultArray + j, Internal::StreamDot(v1, v2, j), count - j);
+            }
+        }
+
+        inline void Vector3Stream::Length(const Vector3Stream& v, float* resultArray) noexcept
+        {
+            using L = Internal::StreamLanes;
+
+            const size_t count = v.Size();
+            for (size_t j = 0; j < count; j += L::Count)
+            {
+                Internal::StoreLanes(resultArray + j, L::Sqrt(Internal::StreamDot(v, v, j)), count - j);
+            }
+        }
+
+        inline void MatrixStream::Multiply(const MatrixStream& m1, const Matrix& m2, MatrixStream& result)
+        {
+            using L = Internal::StreamLanes;
+
+            if (result.Size() != m1.Size())
+            {
+                result.Resize(m1.Size());
+            }
+
+            const Internal::SplatMatrix M(m2);
+
+            const size_t padded = Internal::StreamPadded(m1.Size());
+            for (size_t j = 0; j < padded; j += L::Count)
+            {
+                for (size_t row = 0; row < 4; ++row)
+                {
+                    // Load the whole row first, so result may alias m1
+                    const L::V a0 = L::Load(m1.Element(row, 0) + j);
+                    const L::V a1 = L::Load(m1.Element(row, 1) + j);
+                    const L::V a2 = L::Load(m1.Element(row, 2) + j);
+                    const L::V a3 = L::Load(m1.Element(row, 3) + j);
+
+                    for (size_t column = 0; column < 4; ++column)
+                    {
+                        L::V value = L::Multiply(a3, M.Get(3, column));
+                        value = L::MultiplyAdd(a2, M.Get(2, column), value);
+                        value = L::MultiplyAdd(a1, M.Get(1, column), value);
+                        value = L::MultiplyAdd(a0, M.Get(0, column), value);
+                        L::Store(result.Element(row, column) + j, value);
+                    }
+                }
+            }
+        }
+
+        namespace Internal
+        {
+            // Below this many points per thread, starting threads costs more than it saves
+            constexpr size_t c_MinParallelChunk = 16384;
+
+            // Calls func(begin, end) over [0, count) in chunks aligned to the stream padding
+            template<typename TFunc>
+            void ParallelChunks(size_t count, unsigned int threads, TFunc&& func)
+            {
+                if (!threads)
+                {
+                    threads = std::thread::hardware_concurrency();
+                }
+
+                const size_t maxChunks = (count + c_MinParallelChunk - 1) / c_MinParallelChunk;
+                const size_t chunks = (threads < maxChunks) ? threads : maxChunks;
+                if (chunks <= 1)
+                {
+                    func(size_t(0), count);
+                    return;
+                }
+
+                const size_t chunkSize = StreamPadded((count + chunks - 1) / chunks);
+
+                std::vector<std::thread> workers;
+                workers.reserve(chunks - 1);
+
+                size_t begin = chunkSize;
+                try
+                {
+                    for (; begin < count; begin += chunkSize)
+                    {
+                        const size_t end = (count - begin > chunkSize) ? begin + chunkSize : count;
+                        workers.emplace_back([&func, begin, end]() { func(begin, end); });
+                    }
+                }
+                catch (const std::system_error&)
+                {
+                }
+
+                // This thread takes the first chunk, and any whose thread couldn't be started
+                func(size_t(0), (count > chunkSize) ? chunkSize : count);
+
+                for (; begin < count; begin += chunkSize)
+                {
+                    func(begin, (count - begin > chunkSize) ? begin + chunkSize : count);
+                }
+
+                for (auto& it : workers)
+                {
+                    it.join();
+                }
+            }
+
+            inline void TransformArray(const Vector3* points, size_t count, const Matrix& m, Vector3* resultArray, unsigned int threads)
+            {
+                ParallelChunks(count, threads, [=, &m](size_t begin, size_t end)
+                    {
+                        Vector3::Transform(points + begin, end - begin, m, resultArray + begin);
+                    });
+            }
+
+            inline void TransformStreamParallel(const Vector3Stream& points, const Matrix& m, Vector3Stream& result, unsigned int threads)
+            {
+                if (result.Size() != points.Size())
+                {
+                    result.Resize(points.Size());
+                }
+
+                const SplatMatrix M(m);
+                ParallelChunks(points.Size(), threads, [&](size_t begin, size_t end)
+                    {
+                        SplatMatrix local(M);
+                        TransformStream<true>(points, local, result, begin, end);
+                    });
+            }
+        }
+
+        inline Matrix CreateViewportProject(const Viewport& viewport, const Matrix& proj, const Matrix& view, const Matrix& world) noexcept
+        {
+            // As XMVector3Project: the scale and offset are applied after the divide by w,
+            // which is the same as scaling x, y, z and adding offset * w before it.
+            const float halfWidth = viewport.width * 0.5f;
+            const float halfHeight = viewport.height * 0.5f;
+
+            Matrix screen(
+                halfWidth, 0.f, 0.f, 0.f,
+                0.f, -halfHeight, 0.f, 0.f,
+                0.f, 0.f, viewport.maxDepth - viewport.minDepth, 0.f,
+                viewport.x + halfWidth, viewport.y + halfHeight, viewport.minDepth, 1.f);
+
+            return world * view * proj * screen;
+        }
+
+        inline Matrix CreateViewportUnproject(const Viewport& viewport, const Matrix& proj, const Matrix& view, const Matrix& world) noexcept
+        {
+            // As XMVector3Unproject: back to normalized device coordinates, then through the
+            // inverse of world * view * proj
+            const float scaleX = 2.f / viewport.width;
+            const float scaleY = -2.f / viewport.height;
+            const float scaleZ = 1.f / (viewport.maxDepth - viewport.minDepth);
+
+            Matrix device(
+                scaleX, 0.f, 0.f, 0.f,
+                0.f, scaleY, 0.f, 0.f,
+                0.f, 0.f, scaleZ, 0.f,
+                -viewport.x * scaleX - 1.f, -viewport.y * scaleY + 1.f, -viewport.minDepth * scaleZ, 1.f);
+
+            return device * (world * view * proj).Invert();
+        }
+
+        inline void ViewportProject(const Viewport& viewport, const Vector3* points, size_t count,
+            const Matrix& proj, const Matrix& view, const Matrix& world, Vector3* resultArray, unsigned int threads)
+        {
+            const Matrix m = CreateViewportProject(viewport, proj, view, world);
+            Internal::TransformArray(points, count, m, resultArray, threads);
+        }
+
+        inline void ViewportUnproject(const Viewport& viewport, const Vector3* points, size_t count,
+            const Matrix& proj, const Matrix& view, const Matrix& world, Vector3* resultArray, unsigned int threads)
+        {
+            const Matrix m = CreateViewportUnproject(viewport, proj, view, world);
+            Internal::TransformArray(points, count, m, resultArray, threads);
+        }
+
+        inline void ViewportProject(const Viewport& viewport, const Vector3Stream& points,
+            const Matrix& proj, const Matrix& view, const Matrix& world, Vector3Stream& result, unsigned int threads)
+        {
+            const Matrix m = CreateViewportProject(viewport, proj, view, world);
+            Internal::TransformStreamParallel(points, m, result, threads);
+        }
+
+        inline void ViewportUnproject(const Viewport& viewport, const Vector3Stream& points,
+            const Matrix& proj, const Matrix& view, const Matrix& world, Vector3Stream& result, unsigned int threads)
+        {
+            const Matrix m = CreateViewportUnproject(viewport, proj, view, world);
+            Internal::TransformStreamParallel(points, m, result, threads);
+        }
+    }
+}
@@ -5740,6 +5740,10 @@ extern int TestD3D11();
 #endif
 
 extern int TestD3D12();
+extern int TestStream();
+extern int TestViewportBatch();
+extern int TestRayPacket();
+extern int TestConstexpr();
 
 typedef int (*TestFN)();
 
@@ -5759,6 +5763,10 @@ static struct Test
     { "Color", TestC },
     { "Ray", TestRay },
     { "Viewport", TestVP },
+    { "Streams", TestStream },
+    { "Viewport batch", TestViewportBatch },
+    { "Ray packet", TestRayPacket },
+    { "Constexpr", TestConstexpr },
 #ifdef TEST_D3D11
     { "D3D11", TestD3D11 },
 #endif
@@ -26,3 +26,75 @@
 #pragma warning(pop)
 
 #include "SimpleMath.h"
+#include "SimpleMathConstexpr.h"
+
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+    //---------------------------------------------------------------------------------
+    // Vectors and colors
+
+    static_assert(Constexpr::Equal(Constexpr::Add(Vector2(1.f, 2.f), Vector2(3.f, 4.f)), Vector2(4.f, 6.f)), "Vector2 add");
+    static_assert(Constexpr::Equal(Constexpr::Subtract(Vector2(1.f, 2.f), Vector2(3.f, 4.f)), Vector2(-2.f, -2.f)), "Vector2 subtract");
+    static_assert(Constexpr::Dot(Vector2(1.f, 2.f), Vector2(3.f, 4.f)) == 11.f, "Vector2 dot");
+
+    static_assert(Constexpr::Equal(Constexpr::Add(Vector3(1.f, 2.f, 3.f), Constexpr::Vector3One), Vector3(2.f, 3.f, 4.f)), "Vector3 add");
+    static_assert(Constexpr::Equal(Constexpr::Multiply(Vector3(1.f, 2.f, 3.f), Vector3(4.f, 5.f, 6.f)), Vector3(4.f, 10.f, 18.f)), "Vector3 multiply");
+    static_assert(Constexpr::Equal(Constexpr::Scale(Vector3(1.f, 2.f, 3.f), 0.5f), Vector3(0.5f, 1.f, 1.5f)), "Vector3 scale");
+    static_assert(Constexpr::Equal(Constexpr::Lerp(Constexpr::Vector3Zero, Vector3(2.f, 4.f, 8.f), 0.25f), Vector3(0.5f, 1.f, 2.f)), "Vector3 lerp");
+    static_assert(Constexpr::Dot(Vector3(1.f, 2.f, 3.f), Vector3(4.f, 5.f, 6.f)) == 32.f, "Vector3 dot");
+    static_assert(Constexpr::Equal(Constexpr::Cross(Vector3(1.f, 2.f, 3.f), Vector3(4.f, 5.f, 6.f)), Vector3(-3.f, 6.f, -3.f)), "Vector3 cross");
+    static_assert(Constexpr::Equal(Constexpr::Cross(Constexpr::Vector3UnitX, Constexpr::Vector3UnitY), Constexpr::Vector3UnitZ), "Vector3 cross");
+    static_assert(Constexpr::Equal(Constexpr::Cross(Constexpr::Vector3Up, Constexpr::Vector3Forward), Constexpr::Vector3Left), "Vector3 cross");
+
+    static_assert(Constexpr::Dot(Constexpr::Vector4One, Vector4(1.f, 2.f, 3.f, 4.f)) == 10.f, "Vector4 dot");
+    static_assert(Constexpr::Equal(Constexpr::Subtract(Constexpr::Vector4One, Constexpr::Vector4UnitW), Vector4(1.f, 1.f, 1.f, 0.f)), "Vector4 subtract");
+
+    // A palette baked at compile time
+    constexpr Color c_Black(0.f, 0.f, 0.f);
+    constexpr Color c_Orange(1.f, 0.5f, 0.f);
+    constexpr Color c_Ramp[] =
+    {
+        Constexpr::Lerp(c_Black, c_Orange, 0.f),
+        Constexpr::Lerp(c_Black, c_Orange, 0.5f),
+        Constexpr::Lerp(c_Black, c_Orange, 1.f),
+        Constexpr::Scale(Constexpr::Multiply(c_Orange, Color(0.5f, 0.5f, 1.f, 1.f)), 2.f),
+    };
+
+    static_assert(Constexpr::Equal(c_Ramp[0], c_Black), "Color lerp");
+    static_assert(Constexpr::Equal(c_Ramp[1], Color(0.5f, 0.25f, 0.f, 1.f)), "Color lerp");
+    static_assert(Constexpr::Equal(c_Ramp[2], c_Orange), "Color lerp");
+    static_assert(Constexpr::Equal(c_Ramp[3], Color(1.f, 0.5f, 0.f, 2.f)), "Color modulate");
+
+    //---------------------------------------------------------------------------------
+    // Matrices
+
+    constexpr Matrix c_World = Constexpr::Multiply(Constexpr::CreateScale(2.f), Constexpr::CreateTranslation(1.f, 2.f, 3.f));
+
+    static_assert(Constexpr::Equal(c_World, Matrix(
+        2.f, 0.f, 0.f, 0.f,
+        0.f, 2.f, 0.f, 0.f,
+        0.f, 0.f, 2.f, 0.f,
+        1.f, 2.f, 3.f, 1.f)), "Matrix multiply");
+    static_assert(Constexpr::Equal(Constexpr::Multiply(Constexpr::MatrixIdentity, c_World), c_World), "Matrix identity");
+    static_assert(Constexpr::Equal(Constexpr::Transpose(Constexpr::Transpose(c_World)), c_World), "Matrix transpose");
+    static_assert(Constexpr::Equal(Constexpr::Transform(Constexpr::Vector3One, c_World), Vector3(3.f, 4.f, 5.f)), "Vector3 transform");
+    static_assert(Constexpr::Equal(Constexpr::TransformNormal(Constexpr::Vector3One, c_World), Vector3(2.f, 2.f, 2.f)), "Vector3 transform normal");
+
+    // Quarter turn about y: +x goes to -z
+    constexpr Matrix c_TurnY = Constexpr::CreateFromAxes(
+        Constexpr::Vector3Forward,
+        Constexpr::Vector3Up,
+        Constexpr::Cross(Constexpr::Vector3Forward, Constexpr::Vector3Up),
+        Constexpr::Vector3Zero);
+
+    static_assert(Constexpr::Equal(Constexpr::Row(c_TurnY, 2), Vector4(1.f, 0.f, 0.f, 0.f)), "Matrix from axes");
+    static_assert(Constexpr::Equal(Constexpr::Multiply(c_TurnY, Constexpr::Transpose(c_TurnY)), Constexpr::MatrixIdentity), "Matrix orthonormal");
+
+    // Pixel coordinates to clip space for a 1024x512 target
+    constexpr Matrix c_Pixels = Constexpr::CreateOrthographicOffCenter(0.f, 1024.f, 512.f, 0.f, 0.f, 1.f);
+
+    static_assert(Constexpr::Equal(Constexpr::Transform(Constexpr::Vector3Zero, c_Pixels), Vector3(-1.f, 1.f, 0.f)), "Orthographic off-center");
+    static_assert(Constexpr::Equal(Constexpr::Transform(Vector3(1024.f, 512.f, 0.f), c_Pixels), Vector3(1.f, -1.f, 0.f)), "Orthographic off-center");
+}
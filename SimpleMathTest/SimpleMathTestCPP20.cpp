@@ -26,3 +26,89 @@
 #pragma warning(pop)
 
 #include "SimpleMath.h"
+#include "SimpleMathConstexpr.h"
+
+#include <array>
+
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+    static_assert(Internal::IsConstantEvaluated(), "std::is_constant_evaluated");
+
+    //---------------------------------------------------------------------------------
+    // Camera presets built by consteval functions
+
+    struct CameraPreset
+    {
+        Matrix view;
+        Matrix projection;
+    };
+
+    // A far plane of twice the near distance keeps the depth terms exact, so results compare equal
+    consteval CameraPreset MakePreset(const Vector3& position, float width, float height) noexcept
+    {
+        // Looking down -z from 'position'
+        return CameraPreset
+        {
+            Constexpr::CreateTranslation(Constexpr::Scale(position, -1.f)),
+            Constexpr::CreatePerspective(width, height, 1.f, 2.f),
+        };
+    }
+
+    constexpr std::array<CameraPreset, 3> c_Presets =
+    {
+        MakePreset(Vector3(0.f, 0.f, 10.f), 2.f, 2.f),
+        MakePreset(Vector3(0.f, 4.f, 20.f), 4.f, 2.f),
+        MakePreset(Vector3(8.f, 0.f, 40.f), 2.f, 4.f),
+    };
+
+    consteval Vector3 ToClip(const CameraPreset& preset, const Vector3& position) noexcept
+    {
+        return Constexpr::Transform(position, Constexpr::Multiply(preset.view, preset.projection));
+    }
+
+    // The point straight ahead on the near plane lands at the center, at depth 0
+    static_assert(Constexpr::Equal(ToClip(c_Presets[0], Vector3(0.f, 0.f, 9.f)), Vector3(0.f, 0.f, 0.f)));
+    static_assert(Constexpr::Equal(ToClip(c_Presets[1], Vector3(0.f, 4.f, 19.f)), Vector3(0.f, 0.f, 0.f)));
+
+    // The near plane corners land on the clip space corners
+    static_assert(Constexpr::Equal(ToClip(c_Presets[0], Vector3(1.f, 1.f, 9.f)), Vector3(1.f, 1.f, 0.f)));
+    static_assert(Constexpr::Equal(ToClip(c_Presets[1], Vector3(-2.f, 3.f, 19.f)), Vector3(-1.f, -1.f, 0.f)));
+    static_assert(Constexpr::Equal(ToClip(c_Presets[2], Vector3(9.f, 2.f, 39.f)), Vector3(1.f, 1.f, 0.f)));
+
+    static_assert(Constexpr::Row(c_Presets[0].projection, 2).w == -1.f);
+    static_assert(Constexpr::CreatePerspectiveOffCenter(-1.f, 1.f, -1.f, 1.f, 1.f, 2.f)._11 == c_Presets[0].projection._11);
+
+    //---------------------------------------------------------------------------------
+    // Cube map face bases, with the third axis from a cross product
+
+    consteval Matrix MakeFace(const Vector3& xAxis, const Vector3& yAxis) noexcept
+    {
+        return Constexpr::CreateFromAxes(xAxis, yAxis, Constexpr::Cross(xAxis, yAxis), Constexpr::Vector3Zero);
+    }
+
+    constexpr std::array<Matrix, 6> c_CubeFaces =
+    {
+        MakeFace(Constexpr::Vector3Forward, Constexpr::Vector3Up),
+        MakeFace(Constexpr::Vector3Backward, Constexpr::Vector3Up),
+        MakeFace(Constexpr::Vector3Right, Constexpr::Vector3Backward),
+        MakeFace(Constexpr::Vector3Right, Constexpr::Vector3Forward),
+        MakeFace(Constexpr::Vector3Right, Constexpr::Vector3Up),
+        MakeFace(Constexpr::Vector3Left, Constexpr::Vector3Up),
+    };
+
+    consteval bool AllOrthonormal() noexcept
+    {
+        for (const auto& face : c_CubeFaces)
+        {
+            if (!Constexpr::Equal(Constexpr::Multiply(face, Constexpr::Transpose(face)), Constexpr::MatrixIdentity))
+                return false;
+        }
+        return true;
+    }
+
+    static_assert(AllOrthonormal());
+    static_assert(Constexpr::Equal(Constexpr::TransformNormal(Constexpr::Vector3UnitZ, c_CubeFaces[0]), Constexpr::Vector3Right));
+    static_assert(Constexpr::Equal(Constexpr::TransformNormal(Constexpr::Vector3UnitZ, c_CubeFaces[2]), Constexpr::Vector3Down));
+}
@@ -0,0 +1,203 @@
+//-------------------------------------------------------------------------------------
+// SimpleMathTestConstexpr.cpp
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//-------------------------------------------------------------------------------------
+
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX 1
+#define NODRAWTEXT
+#define NOGDI
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+#pragma warning(pop)
+
+#ifndef _WIN32
+#include "pch.h"
+#endif
+
+#include "SimpleMath.h"
+#include "SimpleMathConstexpr.h"
+
+#include "SimpleMathTest.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+    // Each case is a constexpr function of an index. The tables below run them in the
+    // compiler; TestConstexpr runs them again at runtime, where they take the SimpleMath
+    // intrinsics path, and checks that both agree.
+
+    constexpr Vector3 c_Points[] =
+    {
+        Vector3(0.f, 0.f, 0.f),
+        Vector3(1.f, 2.f, 3.f),
+        Vector3(-4.5f, 0.25f, 7.f),
+        Vector3(100.f, -50.f, 0.125f),
+    };
+
+    constexpr Color c_Colors[] =
+    {
+        Color(1.f, 0.f, 0.f),
+        Color(0.f, 0.5f, 1.f, 0.5f),
+        Color(0.25f, 0.75f, 0.125f, 1.f),
+        Color(1.f, 1.f, 1.f, 0.f),
+    };
+
+    constexpr float c_Weights[] = { 0.f, 0.3f, 0.5f, 1.f };
+
+    constexpr size_t c_Count = 4;
+
+    constexpr size_t Next(size_t j) noexcept { return (j + 1) % c_Count; }
+
+    constexpr Matrix MakeMatrix(size_t j) noexcept
+    {
+        return (j == 0) ? Constexpr::Multiply(Constexpr::CreateScale(2.f, 3.f, 4.f), Constexpr::CreateTranslation(1.f, -2.f, 3.f))
+            : (j == 1) ? Constexpr::Multiply(Constexpr::CreateTranslation(0.f, 0.f, -10.f), Constexpr::CreatePerspective(1.6f, 0.9f, 0.1f, 100.f))
+            : (j == 2) ? Constexpr::CreatePerspectiveOffCenter(-0.8f, 0.6f, -0.5f, 0.4f, 0.1f, 100.f)
+            : (j == 3) ? Constexpr::CreateOrthographic(1280.f, 720.f, 0.f, 10.f)
+            : (j == 4) ? Constexpr::CreateOrthographicOffCenter(0.f, 1280.f, 720.f, 0.f, 0.f, 1.f)
+            : Constexpr::Transpose(Constexpr::CreateScale(Vector3(0.5f, 2.f, -1.f)));
+    }
+
+    constexpr size_t c_MatrixCount = 6;
+
+    constexpr Matrix c_Matrices[c_MatrixCount] = { MakeMatrix(0), MakeMatrix(1), MakeMatrix(2), MakeMatrix(3), MakeMatrix(4), MakeMatrix(5) };
+
+    constexpr Matrix ComposeMatrix(size_t j) noexcept { return Constexpr::Multiply(c_Matrices[j], c_Matrices[(j + 1) % c_MatrixCount]); }
+    constexpr Matrix TransposeMatrix(size_t j) noexcept { return Constexpr::Transpose(c_Matrices[j]); }
+
+    constexpr Vector3 AddPoints(size_t j) noexcept { return Constexpr::Add(c_Points[j], c_Points[Next(j)]); }
+    constexpr Vector3 SubtractPoints(size_t j) noexcept { return Constexpr::Subtract(c_Points[j], c_Points[Next(j)]); }
+    constexpr Vector3 MultiplyPoints(size_t j) noexcept { return Constexpr::Multiply(c_Points[j], c_Points[Next(j)]); }
+    constexpr Vector3 ScalePoint(size_t j) noexcept { return Constexpr::Scale(c_Points[j], c_Weights[j]); }
+    constexpr Vector3 LerpPoints(size_t j) noexcept { return Constexpr::Lerp(c_Points[j], c_Points[Next(j)], c_Weights[j]); }
+    constexpr Vector3 CrossPoints(size_t j) noexcept { return Constexpr::Cross(c_Points[j], c_Points[Next(j)]); }
+    constexpr Vector3 TransformPoint(size_t j) noexcept { return Constexpr::Transform(c_Points[j], c_Matrices[j % 2]); }
+    constexpr Vector3 TransformDirection(size_t j) noexcept { return Constexpr::TransformNormal(c_Points[j], c_Matrices[j + 1]); }
+    constexpr float DotPoints(size_t j) noexcept { return Constexpr::Dot(c_Points[j], c_Points[Next(j)]); }
+
+    constexpr Color AddColors(size_t j) noexcept { return Constexpr::Add(c_Colors[j], c_Colors[Next(j)]); }
+    constexpr Color ModulateColors(size_t j) noexcept { return Constexpr::Multiply(c_Colors[j], c_Colors[Next(j)]); }
+    constexpr Color ScaleColor(size_t j) noexcept { return Constexpr::Scale(c_Colors[j], c_Weights[j]); }
+    constexpr Color LerpColors(size_t j) noexcept { return Constexpr::Lerp(c_Colors[j], c_Colors[Next(j)], c_Weights[j]); }
+
+    // Relative, since the projected points are large
+    bool NearEqual(float a, float b)
+    {
+        const float scale = std::max(1.f, std::fabs(b));
+        return XMScalarNearEqual(a, b, EPSILON2 * scale);
+    }
+
+    bool NearEqual(const Vector3& a, const Vector3& b)
+    {
+        return NearEqual(a.x, b.x) && NearEqual(a.y, b.y) && NearEqual(a.z, b.z);
+    }
+
+    bool NearEqual(const Color& a, const Color& b)
+    {
+        return NearEqual(a.x, b.x) && NearEqual(a.y, b.y) && NearEqual(a.z, b.z) && NearEqual(a.w, b.w);
+    }
+
+    bool NearEqual(const Matrix& a, const Matrix& b)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            for (size_t k = 0; k < 4; ++k)
+            {
+                if (!NearEqual(a.m[j][k], b.m[j][k]))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    bool VerifyCase(const char* name, const T* expected, size_t count, T(*func)(size_t))
+    {
+        bool success = true;
+        for (size_t j = 0; j < count; ++j)
+        {
+            // Not a constant expression, so this takes the runtime path
+            const T result = func(j);
+            if (!NearEqual(result, expected[j]))
+            {
+                printf("ERROR: %s [%zu] differs between compile time and runtime\n", name, j);
+                success = false;
+            }
+        }
+        return success;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+int TestConstexpr()
+{
+    bool success = true;
+
+    {
+        constexpr Vector3 add[] = { AddPoints(0), AddPoints(1), AddPoints(2), AddPoints(3) };
+        constexpr Vector3 sub[] = { SubtractPoints(0), SubtractPoints(1), SubtractPoints(2), SubtractPoints(3) };
+        constexpr Vector3 mul[] = { MultiplyPoints(0), MultiplyPoints(1), MultiplyPoints(2), MultiplyPoints(3) };
+        constexpr Vector3 scale[] = { ScalePoint(0), ScalePoint(1), ScalePoint(2), ScalePoint(3) };
+        constexpr Vector3 lerp[] = { LerpPoints(0), LerpPoints(1), LerpPoints(2), LerpPoints(3) };
+        constexpr Vector3 cross[] = { CrossPoints(0), CrossPoints(1), CrossPoints(2), CrossPoints(3) };
+        constexpr Vector3 transform[] = { TransformPoint(0), TransformPoint(1), TransformPoint(2), TransformPoint(3) };
+        constexpr Vector3 transformNormal[] = { TransformDirection(0), TransformDirection(1), TransformDirection(2), TransformDirection(3) };
+        constexpr float dot[] = { DotPoints(0), DotPoints(1), DotPoints(2), DotPoints(3) };
+
+        success &= VerifyCase("Vector3 add", add, c_Count, AddPoints);
+        success &= VerifyCase("Vector3 subtract", sub, c_Count, SubtractPoints);
+        success &= VerifyCase("Vector3 multiply", mul, c_Count, MultiplyPoints);
+        success &= VerifyCase("Vector3 scale", scale, c_Count, ScalePoint);
+        success &= VerifyCase("Vector3 lerp", lerp, c_Count, LerpPoints);
+        success &= VerifyCase("Vector3 cross", cross, c_Count, CrossPoints);
+        success &= VerifyCase("Vector3 transform", transform, c_Count, TransformPoint);
+        success &= VerifyCase("Vector3 transform normal", transformNormal, c_Count, TransformDirection);
+        success &= VerifyCase("Vector3 dot", dot, c_Count, DotPoints);
+    }
+
+    {
+        constexpr Color add[] = { AddColors(0), AddColors(1), AddColors(2), AddColors(3) };
+        constexpr Color modulate[] = { ModulateColors(0), ModulateColors(1), ModulateColors(2), ModulateColors(3) };
+        constexpr Color scale[] = { ScaleColor(0), ScaleColor(1), ScaleColor(2), ScaleColor(3) };
+        constexpr Color lerp[] = { LerpColors(0), LerpColors(1), LerpColors(2), LerpColors(3) };
+
+        success &= VerifyCase("Color add", add, c_Count, AddColors);
+        success &= VerifyCase("Color modulate", modulate, c_Count, ModulateColors);
+        success &= VerifyCase("Color scale", scale, c_Count, ScaleColor);
+        success &= VerifyCase("Color lerp", lerp, c_Count, LerpColors);
+    }
+
+    {
+        constexpr Matrix compose[] = { ComposeMatrix(0), ComposeMatrix(1), ComposeMatrix(2), ComposeMatrix(3), ComposeMatrix(4), ComposeMatrix(5) };
+        constexpr Matrix transpose[] = { TransposeMatrix(0), TransposeMatrix(1), TransposeMatrix(2), TransposeMatrix(3), TransposeMatrix(4), TransposeMatrix(5) };
+
+        success &= VerifyCase("Matrix create", c_Matrices, c_MatrixCount, MakeMatrix);
+        success &= VerifyCase("Matrix multiply", compose, c_MatrixCount, ComposeMatrix);
+        success &= VerifyCase("Matrix transpose", transpose, c_MatrixCount, TransposeMatrix);
+    }
+
+    // The compile-time constants match the SimpleMath ones
+    if (Constexpr::MatrixIdentity != Matrix::Identity
+        || Constexpr::Vector3Up != Vector3::Up
+        || Constexpr::Vector3Forward != Vector3::Forward
+        || Constexpr::Vector4UnitW != Vector4::UnitW
+        || Constexpr::Vector2One != Vector2::One)
+    {
+        printf("ERROR: Constexpr constants differ from SimpleMath\n");
+        success = false;
+    }
+
+    return (success) ? 0 : 1;
+}
@@ -0,0 +1,715 @@
+//-------------------------------------------------------------------------------------
+// SimpleMathTestStream.cpp
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//-------------------------------------------------------------------------------------
+
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX 1
+#define NODRAWTEXT
+#define NOGDI
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+#pragma warning(pop)
+
+#ifndef _WIN32
+#include "pch.h"
+#endif
+
+#include "SimpleMath.h"
+#include "SimpleMathStream.h"
+#include "SimpleMathRayPacket.h"
+
+#include "SimpleMathTest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+using namespace DirectX;
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+    // Sizes around the register and padding boundaries
+    const size_t c_Counts[] = { 0, 1, 3, 4, 5, 7, 8, 9, 16, 17, 1000 };
+
+    std::vector<Vector3> RandomVectors(std::mt19937& rng, size_t count)
+    {
+        std::uniform_real_distribution<float> dist(-10.f, 10.f);
+
+        std::vector<Vector3> result(count);
+        for (auto& it : result)
+        {
+            it = Vector3(dist(rng), dist(rng), dist(rng));
+        }
+        return result;
+    }
+
+    std::vector<Matrix> RandomMatrices(std::mt19937& rng, size_t count)
+    {
+        std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+        std::uniform_real_distribution<float> scale(0.5f, 2.f);
+        std::uniform_real_distribution<float> offset(-10.f, 10.f);
+
+        std::vector<Matrix> result(count);
+        for (auto& it : result)
+        {
+            it = Matrix::CreateScale(scale(rng), scale(rng), scale(rng))
+                * Matrix::CreateFromYawPitchRoll(angle(rng), angle(rng), angle(rng))
+                * Matrix::CreateTranslation(offset(rng), offset(rng), offset(rng));
+        }
+        return result;
+    }
+
+    // Relative tolerance: the batch kernels may fuse multiply-adds the scalar path doesn't
+    bool StreamNearEqual(float a, float b)
+    {
+        const float tolerance = EPSILON3 * std::max(1.f, std::max(fabsf(a), fabsf(b)));
+        return fabsf(a - b) <= tolerance;
+    }
+
+    bool StreamNearEqual(const Vector3& a, const Vector3& b)
+    {
+        return StreamNearEqual(a.x, b.x) && StreamNearEqual(a.y, b.y) && StreamNearEqual(a.z, b.z);
+    }
+
+    // Checks a stream against the AoS results, one error line per operation
+    bool VerifyStream(const Vector3Stream& stream, const std::vector<Vector3>& expected, const char* name, size_t count)
+    {
+        if (stream.Size() != expected.size())
+        {
+            printf("ERROR: %s size %zu (expecting %zu)\n", name, stream.Size(), expected.size());
+            return false;
+        }
+
+        for (size_t j = 0; j < expected.size(); ++j)
+        {
+            const Vector3 v = stream.Get(j);
+            if (!StreamNearEqual(v, expected[j]))
+            {
+                printf("ERROR: %s [%zu of %zu] %f %f %f (expecting %f %f %f)\n", name, j, count,
+                    v.x, v.y, v.z, expected[j].x, expected[j].y, expected[j].z);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<Ray> RandomRays(std::mt19937& rng, size_t count)
+    {
+        std::uniform_real_distribution<float> dist(-10.f, 10.f);
+        std::uniform_int_distribution<int> axis(0, 7);
+
+        std::vector<Ray> result(count);
+        for (auto& it : result)
+        {
+            it.position = Vector3(dist(rng), dist(rng), dist(rng));
+
+            // Some directions lie in a plane or along an axis, to hit the parallel slab cases
+            Vector3 direction(dist(rng), dist(rng), dist(rng));
+            switch (axis(rng))
+            {
+            case 0: direction = Vector3(direction.x, 0.f, 0.f); break;
+            case 1: direction = Vector3(0.f, direction.y, direction.z); break;
+            default: break;
+            }
+
+            if (direction.LengthSquared() == 0.f)
+            {
+                direction = Vector3::UnitZ;
+            }
+
+            direction.Normalize();
+            it.direction = direction;
+        }
+        return result;
+    }
+
+    std::vector<BoundingSphere> RandomSpheres(std::mt19937& rng, size_t count)
+    {
+        std::uniform_real_distribution<float> dist(-10.f, 10.f);
+        std::uniform_real_distribution<float> radius(0.1f, 4.f);
+
+        std::vector<BoundingSphere> result(count);
+        for (auto& it : result)
+        {
+            it = BoundingSphere(XMFLOAT3(dist(rng), dist(rng), dist(rng)), radius(rng));
+        }
+        return result;
+    }
+
+    std::vector<BoundingBox> RandomBoxes(std::mt19937& rng, size_t count)
+    {
+        std::uniform_real_distribution<float> dist(-10.f, 10.f);
+        std::uniform_real_distribution<float> extent(0.1f, 4.f);
+
+        std::vector<BoundingBox> result(count);
+        for (auto& it : result)
+        {
+            it = BoundingBox(XMFLOAT3(dist(rng), dist(rng), dist(rng)), XMFLOAT3(extent(rng), extent(rng), extent(rng)));
+        }
+        return result;
+    }
+
+    std::vector<Plane> RandomPlanes(std::mt19937& rng, size_t count)
+    {
+        std::uniform_real_distribution<float> dist(-10.f, 10.f);
+
+        std::vector<Plane> result(count);
+        for (auto& it : result)
+        {
+            Vector3 normal(dist(rng), dist(rng), dist(rng));
+            normal.Normalize();
+            it = Plane(normal, dist(rng));
+        }
+        return result;
+    }
+
+    bool HitBit(const std::vector<uint32_t>& hits, size_t index)
+    {
+        return (hits[index / 32] & (1u << (index % 32))) != 0;
+    }
+
+    // Compares packet results against Ray::Intersects(query(j)) for each element
+    template<typename TQuery>
+    bool VerifyPacket(const char* name, size_t count, const std::vector<uint32_t>& hits, const std::vector<float>& distances, TQuery&& query)
+    {
+        for (size_t j = 0; j < count; ++j)
+        {
+            float expected = -1.f;
+            const bool hit = query(j, expected);
+
+            if (hit != HitBit(hits, j) || !StreamNearEqual(distances[j], expected))
+            {
+                printf("ERROR: %s [%zu of %zu] %s %f (expecting %s %f)\n", name, j, count,
+                    HitBit(hits, j) ? "hit" : "miss", distances[j], hit ? "hit" : "miss", expected);
+                return false;
+            }
+        }
+
+        // Bits past the end are clear
+        for (size_t j = count; j < hits.size() * 32; ++j)
+        {
+            if (HitBit(hits, j))
+            {
+                printf("ERROR: %s hit bit %zu set past the end (%zu)\n", name, j, count);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Checks the nearest hit reported for one ray against N bounds
+    template<typename TQuery>
+    bool VerifyNearest(const char* name, size_t count, size_t index, float nearest, TQuery&& query)
+    {
+        size_t expectedIndex = SIZE_MAX;
+        float expected = 0.f;
+        for (size_t j = 0; j < count; ++j)
+        {
+            float dist = 0.f;
+            if (query(j, dist) && (expectedIndex == SIZE_MAX || dist < expected))
+            {
+                expectedIndex = j;
+                expected = dist;
+            }
+        }
+
+        if (index != expectedIndex || !StreamNearEqual(nearest, expected))
+        {
+            printf("ERROR: %s nearest %zu %f (expecting %zu %f)\n", name, index, nearest, expectedIndex, expected);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool VerifyFloats(const std::vector<float>& values, const std::vector<float>& expected, const char* name, size_t count)
+    {
+        for (size_t j = 0; j < expected.size(); ++j)
+        {
+            if (!StreamNearEqual(values[j], expected[j]))
+            {
+                printf("ERROR: %s [%zu of %zu] %f (expecting %f)\n", name, j, count, values[j], expected[j]);
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+int TestStream()
+{
+    bool success = true;
+
+    std::mt19937 rng(2024);
+
+    // Conversion and element access
+    {
+        Vector3Stream empty;
+        if (empty.Size() != 0)
+        {
+            printf("ERROR: default Vector3Stream not empty\n");
+            success = false;
+        }
+
+        const auto points = RandomVectors(rng, 13);
+        Vector3Stream stream(points.data(), points.size());
+
+        if (stream.Size() != points.size()
+            || (reinterpret_cast<uintptr_t>(stream.X()) % Internal::c_StreamAlignment) != 0
+            || (reinterpret_cast<uintptr_t>(stream.Y()) % Internal::c_StreamAlignment) != 0
+            || (reinterpret_cast<uintptr_t>(stream.Z()) % Internal::c_StreamAlignment) != 0)
+        {
+            printf("ERROR: Vector3Stream layout\n");
+            success = false;
+        }
+
+        std::vector<Vector3> roundTrip(points.size());
+        stream.Store(roundTrip.data());
+        for (size_t j = 0; j < points.size(); ++j)
+        {
+            if (roundTrip[j] != points[j] || stream.Get(j) != points[j] || stream.X()[j] != points[j].x)
+            {
+                printf("ERROR: Vector3Stream round trip [%zu]\n", j);
+                success = false;
+            }
+        }
+
+        stream.Set(5, Vector3(1.f, 2.f, 3.f));
+        if (stream.Get(5) != Vector3(1.f, 2.f, 3.f) || stream.Get(4) != points[4])
+        {
+            printf("ERROR: Vector3Stream Set\n");
+            success = false;
+        }
+
+        Vector3Stream moved(std::move(stream));
+        if (moved.Size() != points.size() || moved.Get(0) != points[0] || stream.Size() != 0)
+        {
+            printf("ERROR: Vector3Stream move\n");
+            success = false;
+        }
+
+        const auto mats = RandomMatrices(rng, 13);
+        MatrixStream mstream(mats.data(), mats.size());
+
+        std::vector<Matrix> mroundTrip(mats.size());
+        mstream.Store(mroundTrip.data());
+        for (size_t j = 0; j < mats.size(); ++j)
+        {
+            if (mroundTrip[j] != mats[j] || mstream.Get(j) != mats[j] || mstream.Element(3, 0)[j] != mats[j]._41)
+            {
+                printf("ERROR: MatrixStream round trip [%zu]\n", j);
+                success = false;
+            }
+        }
+    }
+
+    for (const size_t count : c_Counts)
+    {
+        const auto a = RandomVectors(rng, count);
+        const auto b = RandomVectors(rng, count);
+        const auto mats = RandomMatrices(rng, count);
+        const Matrix m = RandomMatrices(rng, 1)[0];
+
+        const Vector3Stream sa(a.data(), count);
+        const Vector3Stream sb(b.data(), count);
+        const MatrixStream sm(mats.data(), count);
+
+        Vector3Stream result;
+        std::vector<Vector3> expected(count);
+
+        // Transform
+        Vector3::Transform(a.data(), count, m, expected.data());
+        Vector3Stream::Transform(sa, m, result);
+        success &= VerifyStream(result, expected, "Transform", count);
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            expected[j] = Vector3::Transform(a[j], mats[j]);
+        }
+        Vector3Stream::Transform(sa, sm, result);
+        success &= VerifyStream(result, expected, "Transform (MatrixStream)", count);
+
+        // Projection, where w is not 1
+        {
+            const Matrix proj = Matrix::CreatePerspectiveFieldOfView(XM_PIDIV4, 1.5f, 0.1f, 100.f);
+            for (size_t j = 0; j < count; ++j)
+            {
+                expected[j] = Vector3::Transform(a[j] + Vector3(0.f, 0.f, -25.f), proj);
+            }
+
+            Vector3Stream shifted(count);
+            for (size_t j = 0; j < count; ++j)
+            {
+                shifted.Set(j, a[j] + Vector3(0.f, 0.f, -25.f));
+            }
+            Vector3Stream::Transform(shifted, proj, result);
+            success &= VerifyStream(result, expected, "Transform (projection)", count);
+        }
+
+        // TransformNormal
+        Vector3::TransformNormal(a.data(), count, m, expected.data());
+        Vector3Stream::TransformNormal(sa, m, result);
+        success &= VerifyStream(result, expected, "TransformNormal", count);
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            expected[j] = Vector3::TransformNormal(a[j], mats[j]);
+        }
+        Vector3Stream::TransformNormal(sa, sm, result);
+        success &= VerifyStream(result, expected, "TransformNormal (MatrixStream)", count);
+
+        // Normalize
+        for (size_t j = 0; j < count; ++j)
+        {
+            a[j].Normalize(expected[j]);
+        }
+        Vector3Stream::Normalize(sa, result);
+        success &= VerifyStream(result, expected, "Normalize", count);
+
+        // Lerp
+        for (size_t j = 0; j < count; ++j)
+        {
+            expected[j] = Vector3::Lerp(a[j], b[j], 0.3f);
+        }
+        Vector3Stream::Lerp(sa, sb, 0.3f, result);
+        success &= VerifyStream(result, expected, "Lerp", count);
+
+        // Dot and Length, checking nothing is written past the end
+        std::vector<float> values(count + 1, -1.f);
+        std::vector<float> expectedValues(count);
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            expectedValues[j] = a[j].Dot(b[j]);
+        }
+        Vector3Stream::Dot(sa, sb, values.data());
+        success &= VerifyFloats(values, expectedValues, "Dot", count);
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            expectedValues[j] = a[j].Length();
+        }
+        Vector3Stream::Length(sa, values.data());
+        success &= VerifyFloats(values, expectedValues, "Length", count);
+
+        if (values[count] != -1.f)
+        {
+            printf("ERROR: Dot/Length wrote past the end [%zu]\n", count);
+            success = false;
+        }
+
+        // MatrixStream multiply
+        {
+            MatrixStream product;
+            MatrixStream::Multiply(sm, m, product);
+
+            for (size_t j = 0; j < count; ++j)
+            {
+                const Matrix actual = product.Get(j);
+                const Matrix check = mats[j] * m;
+                for (size_t k = 0; k < 16; ++k)
+                {
+                    if (!StreamNearEqual(actual.m[k / 4][k % 4], check.m[k / 4][k % 4]))
+                    {
+                        printf("ERROR: MatrixStream::Multiply [%zu of %zu] element %zu %f (expecting %f)\n",
+                            j, count, k, actual.m[k / 4][k % 4], check.m[k / 4][k % 4]);
+                        success = false;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Zero-length vectors normalize to zero
+    {
+        const Vector3 zeros[] = { Vector3::Zero, Vector3(3.f, 0.f, 4.f), Vector3::Zero };
+        Vector3Stream stream(zeros, std::size(zeros));
+        Vector3Stream::Normalize(stream, stream);
+
+        if (stream.Get(0) != Vector3::Zero
+            || !StreamNearEqual(stream.Get(1), Vector3(0.6f, 0.f, 0.8f))
+            || stream.Get(2) != Vector3::Zero)
+        {
+            printf("ERROR: Normalize of zero-length vector\n");
+            success = false;
+        }
+    }
+
+    // In-place operation
+    {
+        const auto a = RandomVectors(rng, 37);
+        const Matrix m = RandomMatrices(rng, 1)[0];
+
+        std::vector<Vector3> expected(a.size());
+        Vector3::Transform(a.data(), a.size(), m, expected.data());
+
+        Vector3Stream stream(a.data(), a.size());
+        Vector3Stream::Transform(stream, m, stream);
+        success &= VerifyStream(stream, expected, "Transform (in-place)", a.size());
+
+        const auto mats = RandomMatrices(rng, 37);
+        MatrixStream mstream(mats.data(), mats.size());
+        MatrixStream::Multiply(mstream, m, mstream);
+        for (size_t j = 0; j < mats.size(); ++j)
+        {
+            const Matrix check = mats[j] * m;
+            if (!StreamNearEqual(mstream.Get(j)._41, check._41) || !StreamNearEqual(mstream.Get(j)._12, check._12))
+            {
+                printf("ERROR: MatrixStream::Multiply (in-place) [%zu]\n", j);
+                success = false;
+                break;
+            }
+        }
+    }
+
+    return (success) ? 0 : 1;
+}
+
+
+//-------------------------------------------------------------------------------------
+int TestViewportBatch()
+{
+    bool success = true;
+
+    std::mt19937 rng(4096);
+
+    const Matrix world = Matrix::CreateScale(1.5f) * Matrix::CreateFromYawPitchRoll(0.3f, -0.2f, 0.1f) * Matrix::CreateTranslation(2.f, -1.f, 3.f);
+    const Matrix view = Matrix::CreateLookAt(Vector3(0.f, 10.f, 40.f), Vector3::Zero, Vector3::UnitY);
+    const Matrix proj = Matrix::CreatePerspectiveFieldOfView(XM_PIDIV4, 16.f / 9.f, 1.f, 200.f);
+
+    const Viewport viewports[] =
+    {
+        Viewport(0.f, 0.f, 1920.f, 1080.f),
+        Viewport(23.f, 42.f, 666.f, 1234.f, 0.25f, 0.75f),
+    };
+
+    // Enough points that the threaded path splits them, and an unaligned tail
+    const size_t counts[] = { 0, 1, 7, 33, Internal::c_MinParallelChunk * 3 + 5 };
+
+    for (const auto& vp : viewports)
+    {
+        for (const size_t count : counts)
+        {
+            const auto points = RandomVectors(rng, count);
+
+            std::vector<Vector3> expected(count);
+            for (size_t j = 0; j < count; ++j)
+            {
+                expected[j] = vp.Project(points[j], proj, view, world);
+            }
+
+            for (const unsigned int threads : { 1u, 4u, 0u })
+            {
+                std::vector<Vector3> projected(count);
+                ViewportProject(vp, points.data(), count, proj, view, world, projected.data(), threads);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    if (!StreamNearEqual(projected[j], expected[j]))
+                    {
+                        printf("ERROR: ViewportProject [%zu of %zu, %u threads] %f %f %f (expecting %f %f %f)\n", j, count, threads,
+                            projected[j].x, projected[j].y, projected[j].z, expected[j].x, expected[j].y, expected[j].z);
+                        success = false;
+                        break;
+                    }
+                }
+
+                const Vector3Stream stream(points.data(), count);
+                Vector3Stream result;
+                ViewportProject(vp, stream, proj, view, world, result, threads);
+                success &= VerifyStream(result, expected, "ViewportProject (stream)", count);
+
+                // Unproject the scalar results and compare with the scalar round trip
+                std::vector<Vector3> roundTrip(count);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    roundTrip[j] = vp.Unproject(expected[j], proj, view, world);
+                }
+
+                std::vector<Vector3> unprojected(count);
+                ViewportUnproject(vp, expected.data(), count, proj, view, world, unprojected.data(), threads);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    if (!StreamNearEqual(unprojected[j], roundTrip[j]))
+                    {
+                        printf("ERROR: ViewportUnproject [%zu of %zu, %u threads] %f %f %f (expecting %f %f %f)\n", j, count, threads,
+                            unprojected[j].x, unprojected[j].y, unprojected[j].z, roundTrip[j].x, roundTrip[j].y, roundTrip[j].z);
+                        success = false;
+                        break;
+                    }
+                }
+
+                const Vector3Stream screen(expected.data(), count);
+                ViewportUnproject(vp, screen, proj, view, world, result, threads);
+                success &= VerifyStream(result, roundTrip, "ViewportUnproject (stream)", count);
+            }
+        }
+    }
+
+    // In-place
+    {
+        const auto points = RandomVectors(rng, 100);
+        const Viewport& vp = viewports[1];
+
+        std::vector<Vector3> inplace(points);
+        ViewportProject(vp, inplace.data(), inplace.size(), proj, view, world, inplace.data());
+        ViewportUnproject(vp, inplace.data(), inplace.size(), proj, view, world, inplace.data());
+
+        for (size_t j = 0; j < points.size(); ++j)
+        {
+            if (!StreamNearEqual(inplace[j], points[j]))
+            {
+                printf("ERROR: ViewportProject/Unproject in-place round trip [%zu] %f %f %f (expecting %f %f %f)\n", j,
+                    inplace[j].x, inplace[j].y, inplace[j].z, points[j].x, points[j].y, points[j].z);
+                success = false;
+                break;
+            }
+        }
+    }
+
+    return (success) ? 0 : 1;
+}
+
+
+//-------------------------------------------------------------------------------------
+int TestRayPacket()
+{
+    bool success = true;
+
+    std::mt19937 rng(8192);
+
+    for (const size_t count : c_Counts)
+    {
+        const auto rays = RandomRays(rng, count);
+        const auto spheres = RandomSpheres(rng, count);
+        const auto boxes = RandomBoxes(rng, count);
+        const auto planes = RandomPlanes(rng, count);
+
+        const RayStream rayStream(rays.data(), count);
+        const BoundingSphereStream sphereStream(spheres.data(), count);
+        const BoundingBoxStream boxStream(boxes.data(), count);
+        const PlaneStream planeStream(planes.data(), count);
+
+        std::vector<uint32_t> hits((count + 31) / 32, 0xdeadbeef);
+        std::vector<float> distances(count, -1.f);
+
+        // One ray against N bounds, with a few rays per size
+        for (size_t k = 0; k < 4; ++k)
+        {
+            const Ray ray = RandomRays(rng, 1)[0];
+            float nearest = -1.f;
+
+            auto sphereQuery = [&](size_t j, float& dist) { return ray.Intersects(spheres[j], dist); };
+            size_t index = sphereStream.Intersects(ray, hits.data(), distances.data(), nearest);
+            success &= VerifyPacket("BoundingSphereStream::Intersects", count, hits, distances, sphereQuery);
+            success &= VerifyNearest("BoundingSphereStream::Intersects", count, index, nearest, sphereQuery);
+
+            auto boxQuery = [&](size_t j, float& dist) { return ray.Intersects(boxes[j], dist); };
+            index = boxStream.Intersects(ray, hits.data(), distances.data(), nearest);
+            success &= VerifyPacket("BoundingBoxStream::Intersects", count, hits, distances, boxQuery);
+            success &= VerifyNearest("BoundingBoxStream::Intersects", count, index, nearest, boxQuery);
+
+            auto planeQuery = [&](size_t j, float& dist) { return ray.Intersects(planes[j], dist); };
+            index = planeStream.Intersects(ray, hits.data(), distances.data(), nearest);
+            success &= VerifyPacket("PlaneStream::Intersects", count, hits, distances, planeQuery);
+            success &= VerifyNearest("PlaneStream::Intersects", count, index, nearest, planeQuery);
+        }
+
+        // N rays against one bound
+        {
+            const BoundingSphere sphere(XMFLOAT3(1.f, -2.f, 0.5f), 5.f);
+            size_t expected = 0;
+            auto query = [&](size_t j, float& dist) { return rays[j].Intersects(sphere, dist); };
+            for (size_t j = 0; j < count; ++j)
+            {
+                float dist;
+                expected += query(j, dist) ? 1 : 0;
+            }
+
+            const size_t hitCount = rayStream.Intersects(sphere, hits.data(), distances.data());
+            success &= VerifyPacket("RayStream::Intersects(BoundingSphere)", count, hits, distances, query);
+            if (hitCount != expected)
+            {
+                printf("ERROR: RayStream::Intersects(BoundingSphere) %zu hits (expecting %zu)\n", hitCount, expected);
+                success = false;
+            }
+        }
+
+        {
+            const BoundingBox box(XMFLOAT3(-1.f, 2.f, 0.f), XMFLOAT3(4.f, 3.f, 5.f));
+            auto query = [&](size_t j, float& dist) { return rays[j].Intersects(box, dist); };
+
+            std::ignore = rayStream.Intersects(box, hits.data(), distances.data());
+            success &= VerifyPacket("RayStream::Intersects(BoundingBox)", count, hits, distances, query);
+        }
+
+        {
+            const Plane plane(Vector3(0.f, 0.6f, 0.8f), -2.f);
+            auto query = [&](size_t j, float& dist) { return rays[j].Intersects(plane, dist); };
+
+            std::ignore = rayStream.Intersects(plane, hits.data(), distances.data());
+            success &= VerifyPacket("RayStream::Intersects(Plane)", count, hits, distances, query);
+        }
+
+        // Null outputs are allowed
+        {
+            float nearest = 0.f;
+            const Ray ray(Vector3::Zero, Vector3::UnitX);
+            float check = 0.f;
+            if (sphereStream.Intersects(ray, nullptr, nullptr, nearest) != sphereStream.Intersects(ray, hits.data(), nullptr, check)
+                || nearest != check)
+            {
+                printf("ERROR: BoundingSphereStream::Intersects with null outputs [%zu]\n", count);
+                success = false;
+            }
+        }
+    }
+
+    // Axis-aligned rays against a box, starting inside and outside its slabs
+    {
+        const BoundingBox box(XMFLOAT3(0.f, 0.f, 0.f), XMFLOAT3(1.f, 1.f, 1.f));
+        const Ray rays[] =
+        {
+            Ray(Vector3(0.f, 0.f, -5.f), Vector3::UnitZ),   // hit at 4
+            Ray(Vector3(2.f, 0.f, -5.f), Vector3::UnitZ),   // outside the x slab
+            Ray(Vector3(0.f, 0.f, 0.f), Vector3::UnitZ),    // inside, negative distance
+            Ray(Vector3(0.f, 0.f, 5.f), Vector3::UnitZ),    // behind
+            Ray(Vector3(0.5f, 0.5f, -3.f), Vector3::UnitZ), // hit at 2
+        };
+        const bool expectedHit[] = { true, false, true, false, true };
+        const float expectedDist[] = { 4.f, 0.f, -1.f, 0.f, 2.f };
+
+        const RayStream stream(rays, std::size(rays));
+        uint32_t hits = 0;
+        float distances[std::size(rays)] = {};
+        if (stream.Intersects(box, &hits, distances) != 3)
+        {
+            printf("ERROR: RayStream::Intersects(BoundingBox) axis-aligned hit count\n");
+            success = false;
+        }
+
+        for (size_t j = 0; j < std::size(rays); ++j)
+        {
+            if (((hits >> j) & 1) != (expectedHit[j] ? 1u : 0u) || !StreamNearEqual(distances[j], expectedDist[j]))
+            {
+                printf("ERROR: RayStream::Intersects(BoundingBox) axis-aligned [%zu] %f (expecting %f)\n", j, distances[j], expectedDist[j]);
+                success = false;
+            }
+        }
+    }
+
+    return (success) ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+//-------------------------------------------------------------------------------------
+// StepTimerTest.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <iterator>
+
+//-------------------------------------------------------------------------------------
+// Types and globals
+
+using TestFN = bool (*)();
+
+struct TestInfo
+{
+    const char *name;
+    TestFN func;
+};
+
+extern bool Test01();
+extern bool Test02();
+extern bool Test03();
+extern bool Test04();
+extern bool Test05();
+extern bool Test06();
+
+TestInfo g_Tests[] =
+{
+    { "FrameHistogram", Test01 },
+    { "StepTimer statistics (variable)", Test02 },
+    { "StepTimer statistics (fixed)", Test03 },
+    { "StepTimer statistics report", Test04 },
+    { "StepTimer benchmark step", Test05 },
+    { "FrameBenchmark", Test06 },
+};
+
+
+//-------------------------------------------------------------------------------------
+bool RunTests(const TestInfo* tests, size_t count)
+{
+    size_t nPass = 0;
+    size_t nFail = 0;
+
+    for(size_t i=0; i < count; ++i)
+    {
+        printf("%s: ", tests[i].name );
+
+        if ( tests[i].func() )
+        {
+            ++nPass;
+            printf("PASS\n");
+        }
+        else
+        {
+            ++nFail;
+            printf("FAIL\n");
+        }
+    }
+
+    printf("Ran %zu tests, %zu pass, %zu fail\n", nPass+nFail, nPass, nFail);
+
+    return (nFail == 0);
+}
+
+
+//-------------------------------------------------------------------------------------
+#ifdef _WIN32
+int __cdecl wmain()
+#else
+int main()
+#endif
+{
+    printf("**************************************************************\n");
+    printf("*** StepTimerTest\n" );
+    printf("**************************************************************\n");
+
+    if ( !RunTests(g_Tests, std::size(g_Tests)) )
+        return -1;
+
+    return 0;
+}
@@ -0,0 +1,515 @@
+//-------------------------------------------------------------------------------------
+// steptimer.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX 1
+#define NODRAWTEXT
+#define NOGDI
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+#pragma warning(pop)
+
+#include <Windows.h>
+#endif
+
+#include "StepTimer.h"
+#include "FrameBenchmark.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <tuple>
+
+namespace
+{
+    // Microsecond counter advanced by hand, so every Tick sees an exact delta
+    struct FakeClock
+    {
+        static uint64_t s_counter;
+
+        static uint64_t GetFrequency() noexcept { return 1000000; }
+        static uint64_t GetCounter() noexcept { return s_counter; }
+    };
+
+    uint64_t FakeClock::s_counter = 0;
+
+    using FakeTimer = DX::BasicStepTimer<FakeClock>;
+
+    constexpr uint64_t c_Frame60 = 16667;       // microseconds
+    constexpr uint64_t c_Hitch = 50000;
+
+    // Advances the clock and ticks, returning how many updates ran
+    uint32_t Advance(FakeTimer& timer, uint64_t microseconds)
+    {
+        FakeClock::s_counter += microseconds;
+
+        uint32_t updates = 0;
+        timer.Tick([&]() { ++updates; });
+        return updates;
+    }
+
+    uint64_t ToTicks(uint64_t microseconds)
+    {
+        return microseconds * FakeTimer::TicksPerSecond / FakeClock::GetFrequency();
+    }
+
+    // A percentile is reported as the top of its bucket, which is within 1/16 of the value
+    bool IsNear(uint64_t actual, uint64_t expected)
+    {
+        return actual >= expected && actual <= expected + expected / DX::FrameHistogram::SubBuckets;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+// Bucket layout and percentiles
+bool Test01()
+{
+    bool success = true;
+
+    DX::FrameHistogram histogram;
+
+    if (histogram.GetCount() != 0 || histogram.GetPercentile(50.0) != 0 || histogram.GetMax() != 0 || histogram.GetMin() != 0)
+    {
+        printf("ERROR: Expected an empty histogram\n");
+        success = false;
+    }
+
+    // Every value lands in a bucket that contains it, no wider than 1/16 of its lower bound
+    size_t lastIndex = 0;
+    for (uint64_t value = 0; value < 100000; ++value)
+    {
+        const size_t index = DX::FrameHistogram::BucketIndex(value);
+        const uint64_t lower = DX::FrameHistogram::BucketLowerBound(index);
+        const uint64_t upper = DX::FrameHistogram::BucketUpperBound(index);
+
+        if (index < lastIndex || value < lower || value > upper
+            || (upper - lower) > lower / DX::FrameHistogram::SubBuckets)
+        {
+            printf("ERROR: Value %llu in bucket %zu [%llu, %llu]\n",
+                static_cast<unsigned long long>(value), index,
+                static_cast<unsigned long long>(lower), static_cast<unsigned long long>(upper));
+            success = false;
+            break;
+        }
+
+        lastIndex = index;
+    }
+
+    for (unsigned int bit = 4; bit < 64; ++bit)
+    {
+        const uint64_t values[] = { (uint64_t(1) << bit) - 1, uint64_t(1) << bit, (uint64_t(1) << bit) + 1 };
+        for (const uint64_t value : values)
+        {
+            const size_t index = DX::FrameHistogram::BucketIndex(value);
+            if (index >= DX::FrameHistogram::BucketCount
+                || value < DX::FrameHistogram::BucketLowerBound(index)
+                || value > DX::FrameHistogram::BucketUpperBound(index))
+            {
+                printf("ERROR: Value 2^%u%+d out of its bucket\n", bit, int(value - (uint64_t(1) << bit)));
+                success = false;
+            }
+        }
+    }
+
+    if (DX::FrameHistogram::BucketIndex(UINT64_MAX) != DX::FrameHistogram::BucketCount - 1)
+    {
+        printf("ERROR: UINT64_MAX isn't in the last bucket\n");
+        success = false;
+    }
+
+    for (uint64_t value = 1; value <= 1000; ++value)
+    {
+        histogram.Record(value);
+    }
+
+    if (histogram.GetCount() != 1000
+        || histogram.GetMin() != 1
+        || histogram.GetMax() != 1000
+        || histogram.GetMean() != 500.5
+        || !IsNear(histogram.GetPercentile(50.0), 500)
+        || !IsNear(histogram.GetPercentile(95.0), 950)
+        || !IsNear(histogram.GetPercentile(99.0), 990)
+        || histogram.GetPercentile(100.0) != 1000
+        || histogram.GetPercentile(0.0) != 1)
+    {
+        printf("ERROR: Unexpected summary (p50 %llu, p95 %llu, p99 %llu)\n",
+            static_cast<unsigned long long>(histogram.GetPercentile(50.0)),
+            static_cast<unsigned long long>(histogram.GetPercentile(95.0)),
+            static_cast<unsigned long long>(histogram.GetPercentile(99.0)));
+        success = false;
+    }
+
+    histogram.Reset();
+    if (histogram.GetCount() != 0 || histogram.GetPercentile(99.0) != 0)
+    {
+        printf("ERROR: Reset didn't empty the histogram\n");
+        success = false;
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Variable timestep records every frame, including hitches the timer clamps
+bool Test02()
+{
+    bool success = true;
+
+    FakeClock::s_counter = 1000;
+    FakeTimer timer;
+
+    if (timer.GetStatistics())
+    {
+        printf("ERROR: Statistics should be off by default\n");
+        success = false;
+    }
+
+    timer.EnableStatistics(true);
+
+    // Time since construction isn't a frame
+    std::ignore = Advance(timer, 2000000);
+
+    for (int j = 0; j < 99; ++j)
+    {
+        std::ignore = Advance(timer, c_Frame60);
+    }
+    std::ignore = Advance(timer, c_Hitch);
+
+    const auto stats = timer.GetStatistics();
+    if (!stats
+        || stats->frameTimes.GetCount() != 100
+        || !IsNear(stats->frameTimes.GetPercentile(50.0), ToTicks(c_Frame60))
+        || !IsNear(stats->frameTimes.GetPercentile(99.0), ToTicks(c_Frame60))
+        || stats->frameTimes.GetMax() != ToTicks(c_Hitch)
+        || stats->catchUpUpdates != 0
+        || stats->clampedFrames != 0)
+    {
+        printf("ERROR: Unexpected variable timestep statistics\n");
+        success = false;
+    }
+
+    // The timer clamps to 1/10 of a second, but the statistics keep the real delta
+    std::ignore = Advance(timer, 300000);
+
+    if (!stats
+        || timer.GetElapsedTicks() != FakeTimer::TicksPerSecond / 10
+        || stats->frameTimes.GetMax() != ToTicks(300000)
+        || stats->clampedFrames != 1
+        || stats->droppedUpdates != 0)
+    {
+        printf("ERROR: Clamped frame not recorded\n");
+        success = false;
+    }
+
+    timer.ResetStatistics();
+    std::ignore = Advance(timer, c_Frame60);
+    std::ignore = Advance(timer, c_Frame60);
+
+    if (!stats || stats->frameTimes.GetCount() != 1 || stats->clampedFrames != 0)
+    {
+        printf("ERROR: ResetStatistics didn't start over\n");
+        success = false;
+    }
+
+    timer.EnableStatistics(false);
+    if (timer.GetStatistics())
+    {
+        printf("ERROR: Statistics should be off after disabling\n");
+        success = false;
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Fixed timestep counts catch-up updates, and updates lost to clamping
+bool Test03()
+{
+    bool success = true;
+
+    FakeClock::s_counter = 0;
+    FakeTimer timer;
+    timer.SetFixedTimeStep(true);
+    timer.SetTargetElapsedSeconds(1.0 / 60.0);
+    timer.EnableStatistics(true);
+
+    std::ignore = Advance(timer, c_Frame60);
+
+    uint32_t updates = 0;
+    for (int j = 0; j < 10; ++j)
+    {
+        updates += Advance(timer, c_Frame60);
+    }
+
+    const auto stats = timer.GetStatistics();
+    if (!stats || updates != 10 || stats->catchUpUpdates != 0 || stats->frameTimes.GetCount() != 10)
+    {
+        printf("ERROR: Expected one update per frame at the target rate (%u updates)\n", updates);
+        success = false;
+    }
+
+    // A 50 ms frame takes three updates to catch up
+    updates = Advance(timer, c_Hitch);
+    if (!stats || updates != 3 || stats->catchUpUpdates != 2)
+    {
+        printf("ERROR: Expected 2 catch-up updates for a 50 ms frame (%u updates)\n", updates);
+        success = false;
+    }
+
+    // 250 ms is clamped to 100 ms, so most of it never runs
+    const uint64_t catchUp = stats ? stats->catchUpUpdates : 0;
+    updates = Advance(timer, 250000);
+
+    const uint64_t target = FakeTimer::SecondsToTicks(1.0 / 60.0);
+    const uint64_t dropped = (ToTicks(250000) - FakeTimer::TicksPerSecond / 10) / target;
+
+    if (!stats
+        || updates < 6
+        || stats->catchUpUpdates != catchUp + updates - 1
+        || stats->clampedFrames != 1
+        || stats->droppedUpdates != dropped)
+    {
+        printf("ERROR: Unexpected clamp statistics (%u updates, %llu dropped, expected %llu)\n",
+            updates,
+            static_cast<unsigned long long>(stats ? stats->droppedUpdates : 0),
+            static_cast<unsigned long long>(dropped));
+        success = false;
+    }
+
+    // An intentional discontinuity isn't a hitch
+    const uint64_t frames = stats ? stats->frameTimes.GetCount() : 0;
+    FakeClock::s_counter += 5000000;
+    timer.ResetElapsedTime();
+    std::ignore = Advance(timer, c_Frame60);
+
+    if (!stats || stats->frameTimes.GetCount() != frames)
+    {
+        printf("ERROR: Frame after ResetElapsedTime was recorded\n");
+        success = false;
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Timers created while the report is on record statistics and print them when destroyed
+bool Test04()
+{
+    bool success = true;
+
+    FakeTimer::SetStatisticsReport(true);
+
+    {
+        FakeClock::s_counter = 0;
+        FakeTimer timer;
+
+        std::ignore = Advance(timer, c_Frame60);
+        for (int j = 0; j < 30; ++j)
+        {
+            std::ignore = Advance(timer, c_Frame60);
+        }
+
+        const auto stats = timer.GetStatistics();
+        if (!stats || stats->frameTimes.GetCount() != 30)
+        {
+            printf("ERROR: Statistics not enabled by the report\n");
+            success = false;
+        }
+        else
+        {
+            char summary[256] = {};
+            const int len = stats->Format(summary, sizeof(summary), FakeTimer::TicksPerSecond);
+            if (len <= 0 || size_t(len) >= sizeof(summary) || !strstr(summary, "30 frames") || !strstr(summary, "p99 16."))
+            {
+                printf("ERROR: Unexpected summary: %s\n", summary);
+                success = false;
+            }
+        }
+
+        printf("\n");
+    }
+
+    FakeTimer::SetStatisticsReport(false);
+
+    FakeTimer timer;
+    if (timer.GetStatistics())
+    {
+        printf("ERROR: Statistics enabled after the report was turned off\n");
+        success = false;
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Benchmark mode ignores the clock, runs one update per Tick, and times the updates
+bool Test05()
+{
+    bool success = true;
+
+    constexpr uint64_t c_Step = FakeTimer::TicksPerSecond / 60;
+    constexpr uint64_t c_UpdateCost = 250;      // microseconds
+
+    FakeClock::s_counter = 0;
+    FakeTimer timer;
+    timer.SetFixedTimeStep(true);
+
+    FakeTimer::SetBenchmarkStep(c_Step);
+
+    const uint64_t before = FakeTimer::GetBenchmarkUpdateTime();
+
+    uint32_t updates = 0;
+    for (int j = 0; j < 100; ++j)
+    {
+        // Wildly varying clock deltas make no difference
+        FakeClock::s_counter += (j % 3) ? 1 : 400000;
+
+        timer.Tick([&]()
+            {
+                ++updates;
+                FakeClock::s_counter += c_UpdateCost;
+            });
+    }
+
+    FakeTimer::SetBenchmarkStep(0);
+
+    if (updates != 100
+        || timer.GetFrameCount() != 100
+        || timer.GetElapsedTicks() != c_Step
+        || timer.GetTotalTicks() != c_Step * 100
+        || FakeTimer::GetBenchmarkUpdateTime() - before != c_UpdateCost * 100)
+    {
+        printf("ERROR: Unexpected benchmark timing (%u updates, %llu total ticks)\n",
+            updates, static_cast<unsigned long long>(timer.GetTotalTicks()));
+        success = false;
+    }
+
+    // Back to the clock once the step is cleared
+    timer.ResetElapsedTime();
+    updates = Advance(timer, c_Hitch);
+    if (updates != 3)
+    {
+        printf("ERROR: Expected the clock to drive updates after benchmark mode (%u updates)\n", updates);
+        success = false;
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Warm-up frames are discarded, and the report is JSON with per-phase times
+bool Test06()
+{
+    bool success = true;
+
+    // Counts are microseconds
+    DX::FrameBenchmark benchmark(10, 100, 1000000);
+
+    for (uint32_t j = 0; j < 10; ++j)
+    {
+        if (benchmark.RecordFrame(1000000, 1000000))
+        {
+            printf("ERROR: Completed during warm-up\n");
+            success = false;
+        }
+    }
+
+    bool complete = false;
+    for (uint32_t j = 0; j < 100; ++j)
+    {
+        complete = benchmark.RecordFrame(2000 + (j == 99 ? 8000 : 0), 5000);
+        if (complete != (j == 99))
+        {
+            printf("ERROR: Completed after %u frames\n", j + 1);
+            success = false;
+            break;
+        }
+    }
+
+    const auto& update = benchmark.GetPhase(DX::FrameBenchmark::PHASE_UPDATE);
+    const auto& render = benchmark.GetPhase(DX::FrameBenchmark::PHASE_RENDER);
+    const auto& frame = benchmark.GetPhase(DX::FrameBenchmark::PHASE_FRAME);
+
+    if (!benchmark.IsComplete()
+        || benchmark.GetRecordedFrames() != 100
+        || update.GetCount() != 100
+        || update.GetMax() != 10000
+        || !IsNear(update.GetPercentile(50.0), 2000)
+        || render.GetTotal() != 500000
+        || frame.GetMax() != 15000
+        || benchmark.ToMilliseconds(frame.GetMin()) != 7.0)
+    {
+        printf("ERROR: Unexpected phase times\n");
+        success = false;
+    }
+
+    // Frames after completion are ignored
+    if (!benchmark.RecordFrame(1, 1) || update.GetCount() != 100)
+    {
+        printf("ERROR: Recorded past the frame count\n");
+        success = false;
+    }
+
+    FILE* file = tmpfile();
+    if (!file || !benchmark.WriteJson(file, "Test \"App\"", 16.6667))
+    {
+        printf("ERROR: WriteJson failed\n");
+        success = false;
+    }
+    else
+    {
+        rewind(file);
+
+        std::string json;
+        char buffer[512];
+        size_t count = 0;
+        while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            json.append(buffer, count);
+        }
+
+        const char* expected[] =
+        {
+            "\"name\": \"Test \\\"App\\\"\"",
+            "\"warmup_frames\": 10",
+            "\"frames\": 100",
+            "\"step_ms\": 16.6667",
+            "\"update\": { \"total_ms\": 208.0000",
+            "\"render\": { \"total_ms\": 500.0000, \"mean_ms\": 5.0000",
+            "\"frame\": {",
+            "\"max_ms\": 15.0000 }\n  }\n}\n",
+        };
+
+        for (const auto it : expected)
+        {
+            if (json.find(it) == std::string::npos)
+            {
+                printf("ERROR: Report missing %s:\n%s\n", it, json.c_str());
+                success = false;
+                break;
+            }
+        }
+    }
+
+    if (file)
+    {
+        fclose(file);
+    }
+
+    return success;
+}
@@ -0,0 +1,47 @@
+//--------------------------------------------------------------------------------------
+// File: pch.h
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248929
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <winsdkver.h>
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0601
+#endif
+#include <sdkddkver.h>
+
+// Use the C++ standard templated min/max
+#define NOMINMAX
+
+#define WIN32_LEAN_AND_MEAN
+#define NODRAWTEXT
+#define NOGDI
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+
+#include <Windows.h>
+
+#include <wrl/client.h>
+
+#include <d3d11_1.h>
+
+#define _XM_NO_XMVECTOR_OVERLOADS_
+#include <DirectXMath.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <memory>
+#include <stdexcept>
+#include <vector>
@@ -0,0 +1,432 @@
+//-------------------------------------------------------------------------------------
+// textconsole.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include "pch.h"
+#include "TextConsole.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <string>
+#include <thread>
+#include <tuple>
+
+namespace
+{
+    // Heap allocations made by the current thread, to check the logging path doesn't allocate
+    thread_local size_t t_allocations = 0;
+
+    const unsigned int c_ThreadCounts[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+    constexpr size_t c_BenchmarkWrites = 1000000;
+
+    // Runs 'producers' threads of produce(index) against a consumer that calls consume() until
+    // they are all done, and returns the elapsed time in milliseconds
+    double RunContention(
+        unsigned int producers,
+        const std::function<void(unsigned int)>& produce,
+        const std::function<void()>& consume)
+    {
+        std::atomic<bool> go(false);
+        std::atomic<unsigned int> running(producers);
+
+        std::vector<std::thread> threads;
+        threads.reserve(producers);
+        for (unsigned int j = 0; j < producers; ++j)
+        {
+            threads.emplace_back([&, j]()
+                {
+                    while (!go.load(std::memory_order_acquire))
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    produce(j);
+
+                    running.fetch_sub(1, std::memory_order_release);
+                });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+
+        while (running.load(std::memory_order_acquire) > 0)
+        {
+            consume();
+        }
+
+        for (auto& it : threads)
+        {
+            it.join();
+        }
+
+        const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        consume();
+
+        return elapsed;
+    }
+}
+
+void* operator new(size_t size)
+{
+    ++t_allocations;
+
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+
+//-------------------------------------------------------------------------------------
+// Ordering, truncation, wrap-around, and overflow on one thread
+bool Test01()
+{
+    bool success = true;
+
+    auto queue = std::make_unique<DX::TextLineQueue<8, 8>>();
+
+    struct Entry
+    {
+        std::wstring text;
+        bool newLine;
+    };
+    std::vector<Entry> entries;
+    auto collect = [&](const wchar_t* text, bool newLine) { entries.push_back({ text, newLine }); };
+
+    // Text past MaxLength is cut off
+    if (!queue->Push(L"abc", 3, false) || !queue->Push(L"defghijkl", 9, true))
+    {
+        printf("ERROR: Push failed on an empty queue\n");
+        success = false;
+    }
+
+    if (queue->Drain(collect) != 2
+        || entries.size() != 2
+        || entries[0].text != L"abc" || entries[0].newLine
+        || entries[1].text != L"defghij" || !entries[1].newLine)
+    {
+        printf("ERROR: Unexpected entries after Drain\n");
+        success = false;
+    }
+
+    if (queue->Drain(collect) != 0)
+    {
+        printf("ERROR: Drain of an empty queue returned entries\n");
+        success = false;
+    }
+
+    // Overflow is dropped and counted, not blocked on
+    for (int j = 0; j < 8; ++j)
+    {
+        const wchar_t text = static_cast<wchar_t>(L'0' + j);
+        if (!queue->Push(&text, 1, false))
+        {
+            printf("ERROR: Push failed before the queue was full (%d)\n", j);
+            success = false;
+        }
+    }
+
+    if (queue->Push(L"x", 1, false) || queue->Push(L"y", 1, false))
+    {
+        printf("ERROR: Push succeeded on a full queue\n");
+        success = false;
+    }
+
+    if (queue->TakeDropped() != 2 || queue->TakeDropped() != 0)
+    {
+        printf("ERROR: Unexpected dropped count\n");
+        success = false;
+    }
+
+    entries.clear();
+    if (queue->Drain(collect) != 8)
+    {
+        printf("ERROR: Expected 8 entries from a full queue\n");
+        success = false;
+    }
+    else
+    {
+        for (size_t j = 0; j < 8; ++j)
+        {
+            if (entries[j].text.size() != 1 || entries[j].text[0] != static_cast<wchar_t>(L'0' + j))
+            {
+                printf("ERROR: Entry %zu out of order\n", j);
+                success = false;
+            }
+        }
+    }
+
+    // Several trips around the ring
+    unsigned int next = 0;
+    unsigned int expected = 0;
+    for (int cycle = 0; cycle < 10; ++cycle)
+    {
+        for (int j = 0; j < 5; ++j)
+        {
+            wchar_t text[8] = {};
+            swprintf_s(text, L"%u", next++);
+            std::ignore = queue->Push(text, wcslen(text), false);
+        }
+
+        entries.clear();
+        queue->Drain(collect);
+        for (const auto& it : entries)
+        {
+            if (wcstoul(it.text.c_str(), nullptr, 10) != expected++)
+            {
+                printf("ERROR: Entry out of order in cycle %d\n", cycle);
+                success = false;
+            }
+        }
+    }
+
+    if (expected != next)
+    {
+        printf("ERROR: Lost entries across wrap-around (%u of %u)\n", expected, next);
+        success = false;
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Concurrent producers keep their own order, and every entry is either received or dropped
+bool Test02()
+{
+    constexpr unsigned int c_Producers = 8;
+    constexpr unsigned int c_PerProducer = 20000;
+
+    bool success = true;
+
+    auto queue = std::make_unique<DX::TextLineQueue<256, 32>>();
+
+    unsigned int lastSeen[c_Producers] = {};
+    bool seen[c_Producers] = {};
+    uint64_t received = 0;
+    uint64_t dropped = 0;
+    bool ordered = true;
+
+    std::ignore = RunContention(c_Producers,
+        [&](unsigned int producer)
+        {
+            for (unsigned int j = 0; j < c_PerProducer; ++j)
+            {
+                wchar_t text[32] = {};
+                const int len = swprintf_s(text, L"%u %u", producer, j);
+                std::ignore = queue->Push(text, size_t(len), true);
+            }
+        },
+        [&]()
+        {
+            received += queue->Drain([&](const wchar_t* text, bool newLine)
+                {
+                    unsigned int producer = 0;
+                    unsigned int index = 0;
+                    if (swscanf_s(text, L"%u %u", &producer, &index) != 2 || producer >= c_Producers || !newLine)
+                    {
+                        ordered = false;
+                        return;
+                    }
+
+                    if (seen[producer] && index <= lastSeen[producer])
+                    {
+                        ordered = false;
+                    }
+
+                    seen[producer] = true;
+                    lastSeen[producer] = index;
+                });
+            dropped += queue->TakeDropped();
+        });
+
+    if (!ordered)
+    {
+        printf("ERROR: Entries out of order or corrupted\n");
+        success = false;
+    }
+
+    if (received + dropped != uint64_t(c_Producers) * c_PerProducer)
+    {
+        printf("ERROR: %llu received + %llu dropped, expected %u\n",
+            static_cast<unsigned long long>(received), static_cast<unsigned long long>(dropped), c_Producers * c_PerProducer);
+        success = false;
+    }
+
+    if (!received)
+    {
+        printf("ERROR: Nothing was received\n");
+        success = false;
+    }
+
+    printf("%llu received, %llu dropped ", static_cast<unsigned long long>(received), static_cast<unsigned long long>(dropped));
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Logging without allocating, and draining without a device
+bool Test03()
+{
+    bool success = true;
+
+    auto console = std::make_unique<DX::TextConsole>();
+
+    // Warm up anything the CRT allocates on first use
+    console->Format(L"%ls %d %.2f\n", L"warm", 1, 2.0);
+    console->Render();
+
+    size_t allocations = t_allocations;
+
+    for (int j = 0; j < 1000; ++j)
+    {
+        console->Write(L"frame ");
+        console->Format(L"%d: %.3f ms %ls\n", j, double(j) * 0.5, L"update");
+        console->WriteLine(L"done");
+    }
+
+    if (t_allocations != allocations)
+    {
+        printf("ERROR: Logging allocated %zu times\n", t_allocations - allocations);
+        success = false;
+    }
+
+    // Past the stack buffer, Format still produces the whole string
+    const std::wstring longText(3000, L'z');
+    console->Format(L"%ls\n", longText.c_str());
+    console->WriteLine(longText.c_str());
+    console->Write(L"");
+    console->WriteLine(L"");
+
+    console->Render();
+    console->Clear();
+
+    // Writes from other threads while this one renders
+    std::atomic<bool> allocationFree(true);
+    std::ignore = RunContention(4,
+        [&](unsigned int producer)
+        {
+            const size_t before = t_allocations;
+            for (int j = 0; j < 10000; ++j)
+            {
+                console->Format(L"thread %u line %d\n", producer, j);
+            }
+
+            if (t_allocations != before)
+            {
+                allocationFree = false;
+            }
+        },
+        [&]()
+        {
+            console->Render();
+        });
+
+    if (!allocationFree)
+    {
+        printf("ERROR: Logging from a worker thread allocated\n");
+        success = false;
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Raw ring throughput as the number of producers grows
+bool Benchmark01()
+{
+    auto queue = std::make_unique<DX::TextLineQueue<512, 128>>();
+
+    printf("\n\t%10s %12s %14s %12s %10s\n", "Producers", "Time (ms)", "Writes/ms", "ns/write", "Dropped");
+
+    for (const unsigned int producers : c_ThreadCounts)
+    {
+        const size_t perProducer = c_BenchmarkWrites / producers;
+
+        uint64_t received = 0;
+        uint64_t dropped = 0;
+
+        const double elapsed = RunContention(producers,
+            [&](unsigned int producer)
+            {
+                wchar_t text[64] = {};
+                const int len = swprintf_s(text, L"thread %u: the quick brown fox", producer);
+                for (size_t j = 0; j < perProducer; ++j)
+                {
+                    std::ignore = queue->Push(text, size_t(len), true);
+                }
+            },
+            [&]()
+            {
+                received += queue->Drain([](const wchar_t*, bool) {});
+                dropped += queue->TakeDropped();
+            });
+
+        const double writes = double(perProducer * producers);
+        printf("\t%10u %12.2f %14.0f %12.1f %9.1f%%\n",
+            producers, elapsed, writes / elapsed, elapsed * 1e6 * producers / writes,
+            100.0 * double(dropped) / writes);
+
+        if (received + dropped != perProducer * producers)
+        {
+            printf("ERROR: Lost entries with %u producers\n", producers);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Format from job threads while the render thread drains the console every "frame"
+bool Benchmark02()
+{
+    auto console = std::make_unique<DX::TextConsole>();
+
+    printf("\n\t%10s %12s %14s %12s\n", "Producers", "Time (ms)", "Formats/ms", "ns/Format");
+
+    for (const unsigned int producers : c_ThreadCounts)
+    {
+        const size_t perProducer = c_BenchmarkWrites / producers;
+
+        const double elapsed = RunContention(producers,
+            [&](unsigned int producer)
+            {
+                for (size_t j = 0; j < perProducer; ++j)
+                {
+                    console->Format(L"job %u frame %zu: %.3f ms\n", producer, j, double(j) * 0.016);
+                }
+            },
+            [&]()
+            {
+                console->Render();
+            });
+
+        const double writes = double(perProducer * producers);
+        printf("\t%10u %12.2f %14.0f %12.1f\n",
+            producers, elapsed, writes / elapsed, elapsed * 1e6 * producers / writes);
+    }
+
+    return true;
+}
@@ -1,6 +1,6 @@
 //-------------------------------------------------------------------------------------
 // WavTest.cpp
-//  
+//
 // Copyright (c) Microsoft Corporation.
 //-------------------------------------------------------------------------------------
 
@@ -17,10 +17,25 @@
 
 #include <Windows.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <exception>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 //-------------------------------------------------------------------------------------
 // Types and globals
@@ -35,25 +50,50 @@ struct TestInfo
 
 extern bool Test01();
 extern bool Test02();
+extern bool Test03();
+extern bool Test04();
+extern bool Test05();
+extern bool Benchmark01();
+extern bool Benchmark02();
 
 TestInfo g_Tests[] =
 {
     { "WAVFileReader", Test01 },
     { "WaveBankReader", Test02 },
+    { "MD5Checksum", Test03 },
+    { "WaveBankBatchReader", Test04 },
+    { "WaveBankMapping", Test05 },
 };
 
+TestInfo g_Benchmarks[] =
+{
+    { "LoadWAVAudioFromFileEx throughput", Benchmark01 },
+    { "WaveBankReader throughput", Benchmark02 },
+};
+
+extern bool WriteBenchmarkReport(const wchar_t* fileName);
+
+namespace
+{
+    // Number of threads used to validate media entries (-j N, 0 for one per hardware thread)
+    size_t g_Threads = 1;
+
+    // Report per-file parse time and throughput (-timing)
+    bool g_Timing = false;
+}
+
 
 //-------------------------------------------------------------------------------------
-bool RunTests()
+bool RunTests(const TestInfo* tests, size_t count)
 {
     size_t nPass = 0;
     size_t nFail = 0;
 
-    for(size_t i=0; i < std::size(g_Tests); ++i)
+    for(size_t i=0; i < count; ++i)
     {
-        printf("%s: ", g_Tests[i].name );
+        printf("%s: ", tests[i].name );
 
-        if ( g_Tests[i].func() )
+        if ( tests[i].func() )
         {
             ++nPass;
             printf("PASS\n");
@@ -72,13 +112,52 @@ bool RunTests()
 
 
 //-------------------------------------------------------------------------------------
-int __cdecl wmain()
+int __cdecl wmain(int argc, wchar_t* argv[])
 {
     printf("**************************************************************\n");
     printf("*** WavTest\n" );
     printf("**************************************************************\n");
 
-    if ( !RunTests() )
+    bool benchmark = false;
+    std::wstring reportFile;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!_wcsicmp(argv[i], L"-timing"))
+        {
+            g_Timing = true;
+        }
+        else if (!_wcsicmp(argv[i], L"-bench"))
+        {
+            benchmark = true;
+        }
+        else if (!_wcsicmp(argv[i], L"-j") && (i + 1 < argc))
+        {
+            g_Threads = wcstoul(argv[++i], nullptr, 10);
+        }
+        else if (!_wcsicmp(argv[i], L"-report") && (i + 1 < argc))
+        {
+            reportFile = argv[++i];
+        }
+    }
+
+    if (!g_Threads)
+    {
+        g_Threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    if (benchmark)
+    {
+        // -report <file> writes the results as JSON, or as CSV for a .csv file name
+        const bool success = RunTests(g_Benchmarks, std::size(g_Benchmarks));
+
+        if (!reportFile.empty() && !WriteBenchmarkReport(reportFile.c_str()))
+            return -1;
+
+        if (!success)
+            return -1;
+    }
+    else if ( !RunTests(g_Tests, std::size(g_Tests)) )
         return -1;
 
     return 0;
@@ -86,58 +165,297 @@ int __cdecl wmain()
 
 
 //-------------------------------------------------------------------------------------
-#include <bcrypt.h>
+// Calls func(index) for every index in [0, count) using up to g_Threads threads. Results
+// should be written per index and reported afterwards so output stays in media order.
+void ParallelForEach(size_t count, const std::function<void(size_t)>& func)
+{
+    const size_t nthreads = std::min(g_Threads, count);
+    if (nthreads <= 1)
+    {
+        for (size_t index = 0; index < count; ++index)
+        {
+            func(index);
+        }
+        return;
+    }
 
-#ifndef NT_SUCCESS
-#define NT_SUCCESS(Status)          ((Status) >= 0)
-#endif
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex errorLock;
 
-struct bcrypthandle_closer { void operator()(BCRYPT_HASH_HANDLE h) { BCryptDestroyHash(h); } };
+    auto worker = [&]()
+    {
+        for (size_t index = next++; index < count; index = next++)
+        {
+            try
+            {
+                func(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorLock);
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+    };
 
-using ScopedHashHandle = std::unique_ptr<void, bcrypthandle_closer>;
+    // If a thread can't be started, the ones that did and this one share the remaining indices
+    std::vector<std::thread> threads;
+    threads.reserve(nthreads - 1);
+    try
+    {
+        for (size_t j = 1; j < nthreads; ++j)
+        {
+            threads.emplace_back(worker);
+        }
+    }
+    catch (const std::system_error&)
+    {
+    }
 
-#define MD5_DIGEST_LENGTH 16
+    worker();
 
-HRESULT MD5Checksum( _In_reads_(dataSize) const uint8_t *data, size_t dataSize, _Out_bytecap_x_(16) uint8_t *digest )
+    for (auto& it : threads)
+    {
+        it.join();
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+
+//-------------------------------------------------------------------------------------
+// printf into a per-entry log, which is written out once all entries are done
+void AppendLog(std::string& log, _In_z_ _Printf_format_string_ const char* format, ...)
 {
-    if ( !data || !dataSize || !digest )
-        return E_INVALIDARG;
+    char buff[1024] = {};
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buff, sizeof(buff), format, args);
+    va_end(args);
+
+    log += buff;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Test media names are relative to the test suite root, using Windows path separators
+bool GetMediaPath(_In_z_ const wchar_t* fname, _Out_writes_(count) wchar_t* path, size_t count)
+{
+    const DWORD ret = ExpandEnvironmentStringsW(fname, path, static_cast<DWORD>(count));
+    return (ret > 0 && ret <= count);
+}
+
+
+//-------------------------------------------------------------------------------------
+uint64_t GetMediaFileSize(_In_z_ const wchar_t* path)
+{
+    WIN32_FILE_ATTRIBUTE_DATA data = {};
+    if (!GetFileAttributesExW(path, GetFileExInfoStandard, &data))
+        return 0;
+
+    return (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+}
+
 
-    memset( digest, 0, MD5_DIGEST_LENGTH );
+//-------------------------------------------------------------------------------------
+double ElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
 
-    NTSTATUS status;
 
-    // Ensure have the MD5 algorithm ready
-    static BCRYPT_ALG_HANDLE s_algid = nullptr;
-    if ( !s_algid )
+//-------------------------------------------------------------------------------------
+// Adds a parse time line to the entry log when -timing is given
+void LogTiming(std::string& log, _In_z_ const wchar_t* fname, uint64_t fileBytes, double parseTime)
+{
+    if (!g_Timing)
+        return;
+
+    const double mbPerSec = (parseTime > 0.0) ? (double(fileBytes) / (1024.0 * 1024.0)) / (parseTime / 1000.0) : 0.0;
+    AppendLog(log, "\t%10.3f ms %10.1f MB/s  %ls\n", parseTime, mbPerSec, fname);
+}
+
+
+//-------------------------------------------------------------------------------------
+// Writes the per-entry logs in media order, then the wall-clock time of the whole pass
+void FlushLogs(const std::vector<std::string>& logs, double wallTime)
+{
+    if (g_Timing)
+        printf("\n");
+
+    for (const auto& it : logs)
     {
-        status = BCryptOpenAlgorithmProvider( &s_algid, BCRYPT_MD5_ALGORITHM, MS_PRIMITIVE_PROVIDER,  0 );
-        if ( !NT_SUCCESS(status) )
-            return HRESULT_FROM_NT(status);
+        printf("%s", it.c_str());
+    }
+
+    if (g_Timing)
+        printf("\t%10.3f ms total, %zu thread(s)\n", wallTime, g_Threads);
+}
 
-        DWORD len = 0, res = 0;
-        status = BCryptGetProperty( s_algid, BCRYPT_HASH_LENGTH, (PBYTE)&len, sizeof(DWORD), &res, 0 );
-        if ( !NT_SUCCESS(status) || res != sizeof(DWORD) || len != MD5_DIGEST_LENGTH )
+
+//-------------------------------------------------------------------------------------
+// RFC 1321 MD5, so the checksums don't depend on a platform crypto provider
+namespace
+{
+    class MD5
+    {
+    public:
+        MD5() noexcept :
+            m_state{ 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 },
+            m_length(0),
+            m_buffer{}
         {
-            return E_FAIL;
         }
-    }
 
-    // Create hash object
-    BCRYPT_HASH_HANDLE hobj;
-    status = BCryptCreateHash( s_algid, &hobj, nullptr, 0, nullptr, 0, 0 ); 
-    if ( !NT_SUCCESS(status) )
-        return HRESULT_FROM_NT(status);
+        void Update(_In_reads_(dataSize) const uint8_t* data, size_t dataSize) noexcept
+        {
+            size_t used = static_cast<size_t>(m_length & 63);
+            m_length += dataSize;
+
+            if (used > 0)
+            {
+                const size_t count = std::min(dataSize, 64 - used);
+                memcpy(m_buffer + used, data, count);
+                data += count;
+                dataSize -= count;
+                used += count;
+
+                if (used < 64)
+                    return;
+
+                Transform(m_buffer);
+            }
+
+            for (; dataSize >= 64; data += 64, dataSize -= 64)
+            {
+                Transform(data);
+            }
+
+            if (dataSize > 0)
+            {
+                memcpy(m_buffer, data, dataSize);
+            }
+        }
+
+        void Finish(_Out_writes_bytes_(16) uint8_t* digest) noexcept
+        {
+            const uint64_t bits = m_length * 8;
+
+            static const uint8_t s_padding[64] = { 0x80 };
+            const size_t used = static_cast<size_t>(m_length & 63);
+            Update(s_padding, (used < 56) ? (56 - used) : (120 - used));
+
+            uint8_t length[8];
+            for (size_t j = 0; j < 8; ++j)
+            {
+                length[j] = static_cast<uint8_t>(bits >> (8 * j));
+            }
+            Update(length, sizeof(length));
+
+            for (size_t j = 0; j < 16; ++j)
+            {
+                digest[j] = static_cast<uint8_t>(m_state[j / 4] >> (8 * (j % 4)));
+            }
+        }
+
+    private:
+        static uint32_t Rotate(uint32_t x, uint32_t n) noexcept { return (x << n) | (x >> (32 - n)); }
+
+        void Transform(_In_reads_bytes_(64) const uint8_t* block) noexcept
+        {
+            static const uint32_t s_shift[64] =
+            {
+                7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+                5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+                4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+                6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+            };
+
+            // floor(abs(sin(i + 1)) * 2^32)
+            static const uint32_t s_table[64] =
+            {
+                0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+                0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+                0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+                0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+                0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+                0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+                0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+                0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+            };
+
+            uint32_t m[16];
+            for (size_t j = 0; j < 16; ++j)
+            {
+                m[j] = uint32_t(block[j * 4])
+                    | (uint32_t(block[j * 4 + 1]) << 8)
+                    | (uint32_t(block[j * 4 + 2]) << 16)
+                    | (uint32_t(block[j * 4 + 3]) << 24);
+            }
+
+            uint32_t a = m_state[0];
+            uint32_t b = m_state[1];
+            uint32_t c = m_state[2];
+            uint32_t d = m_state[3];
+
+            for (uint32_t j = 0; j < 64; ++j)
+            {
+                uint32_t f;
+                uint32_t g;
+                if (j < 16)
+                {
+                    f = (b & c) | (~b & d);
+                    g = j;
+                }
+                else if (j < 32)
+                {
+                    f = (d & b) | (~d & c);
+                    g = (5 * j + 1) & 15;
+                }
+                else if (j < 48)
+                {
+                    f = b ^ c ^ d;
+                    g = (3 * j + 5) & 15;
+                }
+                else
+                {
+                    f = c ^ (b | ~d);
+                    g = (7 * j) & 15;
+                }
+
+                const uint32_t temp = d;
+                d = c;
+                c = b;
+                b += Rotate(a + f + s_table[j] + m[g], s_shift[j]);
+                a = temp;
+            }
+
+            m_state[0] += a;
+            m_state[1] += b;
+            m_state[2] += c;
+            m_state[3] += d;
+        }
+
+        uint32_t    m_state[4];
+        uint64_t    m_length;
+        uint8_t     m_buffer[64];
+    };
+}
 
-    ScopedHashHandle hash( hobj );
+#define MD5_DIGEST_LENGTH 16
 
-    status = BCryptHashData( hash.get(), (PBYTE)data, (ULONG)dataSize, 0 );
-    if ( !NT_SUCCESS(status) )	
-        return HRESULT_FROM_NT(status);
+HRESULT MD5Checksum( _In_reads_(dataSize) const uint8_t *data, size_t dataSize, _Out_bytecap_x_(16) uint8_t *digest )
+{
+    if ( !data || !dataSize || !digest )
+        return E_INVALIDARG;
 
-    status = BCryptFinishHash( hash.get(), (PBYTE)digest, MD5_DIGEST_LENGTH, 0 );
-    if ( !NT_SUCCESS(status) )
-        return HRESULT_FROM_NT(status);
+    MD5 hash;
+    hash.Update( data, dataSize );
+    hash.Finish( digest );
 
 #ifdef _DEBUG
     char buff[1024] = ", { ";
@@ -155,3 +473,68 @@ HRESULT MD5Checksum( _In_reads_(dataSize) const uint8_t *data, size_t dataSize,
 
     return S_OK;
 }
+
+
+//-------------------------------------------------------------------------------------
+// RFC 1321 test suite, plus inputs that straddle the 64-byte block and padding boundaries
+bool Test03()
+{
+    struct TestVector
+    {
+        const char* input;
+        uint8_t md5[16];
+    };
+
+    static const TestVector s_vectors[] =
+    {
+        { "a", {0x0c,0xc1,0x75,0xb9,0xc0,0xf1,0xb6,0xa8,0x31,0xc3,0x99,0xe2,0x69,0x77,0x26,0x61} },
+        { "abc", {0x90,0x01,0x50,0x98,0x3c,0xd2,0x4f,0xb0,0xd6,0x96,0x3f,0x7d,0x28,0xe1,0x7f,0x72} },
+        { "message digest", {0xf9,0x6b,0x69,0x7d,0x7c,0xb7,0x93,0x8d,0x52,0x5a,0x2f,0x31,0xaa,0xf1,0x61,0xd0} },
+        { "abcdefghijklmnopqrstuvwxyz", {0xc3,0xfc,0xd3,0xd7,0x61,0x92,0xe4,0x00,0x7d,0xfb,0x49,0x6c,0xca,0x67,0xe1,0x3b} },
+        { "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", {0xd1,0x74,0xab,0x98,0xd2,0x77,0xd9,0xf5,0xa5,0x61,0x1c,0x2c,0x9f,0x41,0x9d,0x9f} },
+        { "12345678901234567890123456789012345678901234567890123456789012345678901234567890", {0x57,0xed,0xf4,0xa2,0x2b,0xe3,0xc9,0x55,0xac,0x49,0xda,0x2e,0x21,0x07,0xb6,0x7a} },
+    };
+
+    bool success = true;
+
+    for (const auto& it : s_vectors)
+    {
+        uint8_t digest[MD5_DIGEST_LENGTH];
+        HRESULT hr = MD5Checksum(reinterpret_cast<const uint8_t*>(it.input), strlen(it.input), digest);
+        if (FAILED(hr) || memcmp(digest, it.md5, MD5_DIGEST_LENGTH) != 0)
+        {
+            success = false;
+            printf("ERROR: MD5 mismatch for \"%s\"\n", it.input);
+        }
+    }
+
+    // Hashing in pieces must match hashing in one go
+    std::vector<uint8_t> data(1000);
+    for (size_t j = 0; j < data.size(); ++j)
+    {
+        data[j] = static_cast<uint8_t>(j * 7 + (j >> 8));
+    }
+
+    for (const size_t length : { 55u, 56u, 63u, 64u, 65u, 119u, 120u, 1000u })
+    {
+        uint8_t expected[MD5_DIGEST_LENGTH];
+        std::ignore = MD5Checksum(data.data(), length, expected);
+
+        MD5 hash;
+        for (size_t offset = 0; offset < length; offset += 13)
+        {
+            hash.Update(data.data() + offset, std::min<size_t>(13, length - offset));
+        }
+
+        uint8_t digest[MD5_DIGEST_LENGTH];
+        hash.Finish(digest);
+
+        if (memcmp(digest, expected, MD5_DIGEST_LENGTH) != 0)
+        {
+            success = false;
+            printf("ERROR: Incremental MD5 mismatch for %zu bytes\n", length);
+        }
+    }
+
+    return success;
+}
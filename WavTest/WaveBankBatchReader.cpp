@@ -0,0 +1,375 @@
+//--------------------------------------------------------------------------------------
+// File: WaveBankBatchReader.cpp
+//
+// Batched asynchronous reads of streaming wave bank entries
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//--------------------------------------------------------------------------------------
+
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX 1
+#define NODRAWTEXT
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+#pragma warning(pop)
+
+#include <Windows.h>
+
+#include "WaveBankBatchReader.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+    struct aligned_deleter
+    {
+        void operator()(void* p) noexcept
+        {
+            _aligned_free(p);
+        }
+    };
+
+    using ScopedAlignedArrayUInt8 = std::unique_ptr<uint8_t[], aligned_deleter>;
+
+    // 'size' must be a multiple of 'alignment'
+    ScopedAlignedArrayUInt8 AllocateAligned(size_t size, size_t alignment)
+    {
+        return ScopedAlignedArrayUInt8(static_cast<uint8_t*>(_aligned_malloc(size, alignment)));
+    }
+
+    constexpr uint64_t AlignDown(uint64_t value, uint64_t alignment) noexcept
+    {
+        return value & ~(alignment - 1);
+    }
+
+    constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment) noexcept
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // One requested entry
+    struct EntryRequest
+    {
+        uint32_t index;
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    // One file read covering entries [firstEntry, lastEntry) of the sorted requests
+    struct ReadRequest
+    {
+        uint64_t offset;
+        uint32_t length;
+        size_t   firstEntry;
+        size_t   lastEntry;
+    };
+}
+
+class WaveBankBatchReader::Impl
+{
+public:
+    Impl(WaveBankReader& reader, size_t queueDepth, uint32_t maxReadSize) :
+        mReader(reader),
+        mQueueDepth(std::min<size_t>(std::max<size_t>(1, queueDepth), MAXIMUM_WAIT_OBJECTS)),
+        mMaxReadSize(static_cast<uint32_t>(std::max<uint64_t>(c_ReadAlignment, AlignUp(maxReadSize, c_ReadAlignment)))),
+        mReadCount(0)
+    {
+    }
+
+    HRESULT ReadEntries(const uint32_t* indices, size_t count, const Callback& callback);
+
+    size_t GetReadCount() const noexcept { return mReadCount; }
+
+    size_t GetQueueDepth() const noexcept { return mQueueDepth; }
+
+private:
+    HRESULT Complete(const ReadRequest& read, const uint8_t* buffer, HRESULT hr, size_t bytesRead, const Callback& callback);
+
+    HRESULT Execute(size_t bufferSize, const Callback& callback);
+
+    WaveBankReader&             mReader;
+    size_t                      mQueueDepth;
+    uint32_t                    mMaxReadSize;
+    size_t                      mReadCount;
+
+    std::vector<EntryRequest>   mEntries;
+    std::vector<ReadRequest>    mReads;
+};
+
+
+HRESULT WaveBankBatchReader::Impl::ReadEntries(const uint32_t* indices, size_t count, const Callback& callback)
+{
+    if (!indices && count > 0)
+        return E_INVALIDARG;
+
+    if (!callback)
+        return E_INVALIDARG;
+
+    mReadCount = 0;
+    mEntries.clear();
+    mReads.clear();
+
+    HRESULT result = S_OK;
+
+    // Entries that can't be located fail right away
+    mEntries.reserve(count);
+    for (size_t j = 0; j < count; ++j)
+    {
+        WaveBankReader::Metadata metadata = {};
+        HRESULT hr = mReader.GetMetadata(indices[j], metadata);
+        if (SUCCEEDED(hr) && !metadata.lengthBytes)
+        {
+            hr = E_FAIL;
+        }
+
+        if (FAILED(hr))
+        {
+            callback(indices[j], hr, nullptr, 0);
+            if (SUCCEEDED(result))
+                result = hr;
+            continue;
+        }
+
+        mEntries.push_back(EntryRequest{ indices[j], metadata.offsetBytes, metadata.lengthBytes });
+    }
+
+    if (mEntries.empty())
+        return result;
+
+    // Coalesce entries that are adjacent (or repeated) in file order
+    std::stable_sort(mEntries.begin(), mEntries.end(),
+        [](const EntryRequest& a, const EntryRequest& b) { return a.offset < b.offset; });
+
+    size_t bufferSize = 0;
+    for (size_t j = 0; j < mEntries.size(); ++j)
+    {
+        const uint64_t start = AlignDown(mEntries[j].offset, c_ReadAlignment);
+        const uint64_t end = AlignUp(uint64_t(mEntries[j].offset) + mEntries[j].length, c_ReadAlignment);
+
+        if (!mReads.empty())
+        {
+            auto& read = mReads.back();
+            const uint64_t readEnd = read.offset + read.length;
+            if (start <= readEnd && (std::max(end, readEnd) - read.offset) <= mMaxReadSize)
+            {
+                read.length = static_cast<uint32_t>(std::max(end, readEnd) - read.offset);
+                read.lastEntry = j + 1;
+                bufferSize = std::max<size_t>(bufferSize, read.length);
+                continue;
+            }
+        }
+
+        mReads.push_back(ReadRequest{ start, static_cast<uint32_t>(end - start), j, j + 1 });
+        bufferSize = std::max<size_t>(bufferSize, mReads.back().length);
+    }
+
+    mReadCount = mReads.size();
+
+    HRESULT hr = Execute(bufferSize, callback);
+    if (FAILED(hr) && SUCCEEDED(result))
+        result = hr;
+
+    return result;
+}
+
+
+// Makes the callbacks for one finished read
+HRESULT WaveBankBatchReader::Impl::Complete(const ReadRequest& read, const uint8_t* buffer, HRESULT hr, size_t bytesRead, const Callback& callback)
+{
+    HRESULT result = hr;
+
+    for (size_t j = read.firstEntry; j < read.lastEntry; ++j)
+    {
+        const auto& entry = mEntries[j];
+        const size_t start = static_cast<size_t>(entry.offset - read.offset);
+
+        if (SUCCEEDED(hr) && (start + entry.length) > bytesRead)
+        {
+            // The file ended before the entry did
+            result = HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+            callback(entry.index, result, nullptr, 0);
+        }
+        else if (FAILED(hr))
+        {
+            callback(entry.index, hr, nullptr, 0);
+        }
+        else
+        {
+            callback(entry.index, S_OK, buffer + start, entry.length);
+        }
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Overlapped reads on the bank's async handle, up to queueDepth in flight
+HRESULT WaveBankBatchReader::Impl::Execute(size_t bufferSize, const Callback& callback)
+{
+    struct handle_closer { void operator()(HANDLE h) noexcept { if (h) CloseHandle(h); } };
+
+    using ScopedHandle = std::unique_ptr<void, handle_closer>;
+
+    struct Slot
+    {
+        OVERLAPPED              request;
+        ScopedHandle            event;
+        ScopedAlignedArrayUInt8 buffer;
+        size_t                  read;
+    };
+
+    HANDLE async = mReader.GetAsyncHandle();
+    if (!async || async == INVALID_HANDLE_VALUE)
+        return HRESULT_FROM_WIN32(ERROR_INVALID_HANDLE);
+
+    const size_t nslots = std::min(mQueueDepth, mReads.size());
+
+    std::vector<Slot> slots(nslots);
+    for (auto& it : slots)
+    {
+        it.event.reset(CreateEventEx(nullptr, nullptr, 0, EVENT_MODIFY_STATE | SYNCHRONIZE));
+        it.buffer = AllocateAligned(bufferSize, c_ReadAlignment);
+        if (!it.event || !it.buffer)
+            return E_OUTOFMEMORY;
+    }
+
+    HRESULT result = S_OK;
+
+    size_t nextRead = 0;
+    std::vector<size_t> inflight;
+    inflight.reserve(nslots);
+
+    std::vector<HANDLE> events;
+    events.reserve(nslots);
+
+    // Reads still in flight when this returns or unwinds, such as when a callback throws, are
+    // cancelled and waited for before their slots are freed
+    struct InflightDrain
+    {
+        HANDLE                      async;
+        std::vector<Slot>&          slots;
+        const std::vector<size_t>&  inflight;
+
+        ~InflightDrain()
+        {
+            for (auto it : inflight)
+            {
+                std::ignore = CancelIoEx(async, &slots[it].request);
+            }
+
+            for (auto it : inflight)
+            {
+                DWORD cb = 0;
+                std::ignore = GetOverlappedResult(async, &slots[it].request, &cb, TRUE);
+            }
+        }
+    } drain{ async, slots, inflight };
+
+    // Starts the next read in a slot, or completes it right away if it can't be issued
+    auto issue = [&](size_t slotIndex)
+    {
+        while (nextRead < mReads.size())
+        {
+            auto& slot = slots[slotIndex];
+            slot.read = nextRead++;
+
+            const auto& read = mReads[slot.read];
+
+            memset(&slot.request, 0, sizeof(OVERLAPPED));
+            slot.request.Offset = static_cast<DWORD>(read.offset);
+            slot.request.OffsetHigh = static_cast<DWORD>(read.offset >> 32);
+            slot.request.hEvent = slot.event.get();
+
+            if (ReadFile(async, slot.buffer.get(), read.length, nullptr, &slot.request)
+                || GetLastError() == ERROR_IO_PENDING)
+            {
+                inflight.push_back(slotIndex);
+                return;
+            }
+
+            HRESULT hr = Complete(read, nullptr, HRESULT_FROM_WIN32(GetLastError()), 0, callback);
+            if (FAILED(hr) && SUCCEEDED(result))
+                result = hr;
+        }
+    };
+
+    for (size_t j = 0; j < nslots; ++j)
+    {
+        issue(j);
+    }
+
+    while (!inflight.empty())
+    {
+        events.clear();
+        for (auto it : inflight)
+        {
+            events.push_back(slots[it].event.get());
+        }
+
+        const DWORD wait = WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(), FALSE, INFINITE);
+        if (wait >= WAIT_OBJECT_0 + events.size())
+        {
+            // Nothing can be recovered if waiting fails; the drain cancels everything in flight
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        const size_t slotIndex = inflight[wait - WAIT_OBJECT_0];
+        inflight.erase(inflight.begin() + (wait - WAIT_OBJECT_0));
+
+        auto& slot = slots[slotIndex];
+
+        DWORD cb = 0;
+        HRESULT hr = S_OK;
+        if (!GetOverlappedResult(async, &slot.request, &cb, FALSE))
+        {
+            hr = HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        hr = Complete(mReads[slot.read], slot.buffer.get(), hr, cb, callback);
+        if (FAILED(hr) && SUCCEEDED(result))
+            result = hr;
+
+        issue(slotIndex);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------
+WaveBankBatchReader::WaveBankBatchReader(
+    WaveBankReader& reader,
+    size_t queueDepth,
+    uint32_t maxReadSize) :
+    pImpl(std::make_unique<Impl>(reader, queueDepth, maxReadSize))
+{
+}
+
+WaveBankBatchReader::~WaveBankBatchReader() = default;
+
+_Use_decl_annotations_
+HRESULT WaveBankBatchReader::ReadEntries(const uint32_t* indices, size_t count, const Callback& callback)
+{
+    return pImpl->ReadEntries(indices, count, callback);
+}
+
+size_t WaveBankBatchReader::GetReadCount() const noexcept
+{
+    return pImpl->GetReadCount();
+}
+
+size_t WaveBankBatchReader::GetQueueDepth() const noexcept
+{
+    return pImpl->GetQueueDepth();
+}
@@ -0,0 +1,74 @@
+//--------------------------------------------------------------------------------------
+// File: WaveBankBatchReader.h
+//
+// Batched asynchronous reads of streaming wave bank entries
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "WaveBankReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+
+namespace DirectX
+{
+    // Reads many entries of an open wave bank with a bounded number of reads in flight. Entries
+    // that are adjacent in the file are coalesced into a single aligned read of up to
+    // maxReadSize bytes. Reads use the bank's overlapped handle.
+    class WaveBankBatchReader
+    {
+    public:
+        static constexpr size_t c_DefaultQueueDepth = 8;
+        static constexpr uint32_t c_DefaultMaxReadSize = 1024 * 1024;
+
+        // Reads are multiples of this size at offsets aligned to it, which satisfies unbuffered
+        // I/O on both 512-byte and 4Kn sector drives
+        static constexpr uint32_t c_ReadAlignment = 4096;
+
+        // Called once per requested entry, on the thread that called ReadEntries. 'data' is only
+        // valid for the duration of the call, and is null if the entry failed. If a callback
+        // throws, the reads still in flight are cancelled and waited for, and the exception
+        // propagates out of ReadEntries without further callbacks.
+        using Callback = std::function<void(uint32_t index, HRESULT hr, _In_reads_bytes_opt_(audioBytes) const uint8_t* data, uint32_t audioBytes)>;
+
+        // queueDepth is clamped to [1, MAXIMUM_WAIT_OBJECTS], since completions are waited on
+        // together
+        WaveBankBatchReader(
+            WaveBankReader& reader,
+            size_t queueDepth = c_DefaultQueueDepth,
+            uint32_t maxReadSize = c_DefaultMaxReadSize);
+
+        WaveBankBatchReader(WaveBankBatchReader&&) = default;
+        WaveBankBatchReader& operator= (WaveBankBatchReader&&) = default;
+
+        WaveBankBatchReader(WaveBankBatchReader const&) = delete;
+        WaveBankBatchReader& operator= (WaveBankBatchReader const&) = delete;
+
+        ~WaveBankBatchReader();
+
+        // Reads the given entries, in any order, and returns once every callback has been made.
+        // Returns the first failure, if any.
+        HRESULT ReadEntries(
+            _In_reads_(count) const uint32_t* indices,
+            size_t count,
+            const Callback& callback);
+
+        // Number of file reads issued by the last ReadEntries call
+        size_t GetReadCount() const noexcept;
+
+        // Maximum number of reads in flight, after clamping
+        size_t GetQueueDepth() const noexcept;
+
+    private:
+        class Impl;
+
+        std::unique_ptr<Impl> pImpl;
+    };
+}
@@ -0,0 +1,314 @@
+//--------------------------------------------------------------------------------------
+// File: WaveBankMapping.cpp
+//
+// Zero-copy access to in-memory wave bank entries through a file mapping
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//--------------------------------------------------------------------------------------
+
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX 1
+#define NODRAWTEXT
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+#pragma warning(pop)
+
+#include <Windows.h>
+
+#include "WaveBankMapping.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+using namespace DirectX;
+
+namespace
+{
+    // XWB layout, as read by WaveBankReader
+    constexpr uint32_t c_Signature = 0x444E4257; // 'WBND'
+    constexpr uint32_t c_SignatureBigEndian = 0x57424E44; // 'DNBW'
+    constexpr uint32_t c_ContentVersion = 46;
+
+    // Signature, versions, then an offset and length for each segment
+    enum SEGIDX
+    {
+        SEGIDX_BANKDATA = 0,
+        SEGIDX_ENTRYMETADATA,
+        SEGIDX_SEEKTABLES,
+        SEGIDX_ENTRYNAMES,
+        SEGIDX_ENTRYWAVEDATA,
+        SEGIDX_COUNT
+    };
+
+    constexpr size_t c_HeaderSize = 12 + SEGIDX_COUNT * 8;
+
+    // BANKDATA fields used here
+    constexpr size_t c_BankDataSize = 96;
+    constexpr size_t c_BankFlags = 0;
+    constexpr size_t c_BankEntryCount = 4;
+    constexpr size_t c_BankEntryMetaDataElementSize = 72;
+    constexpr size_t c_BankAlignment = 80;
+
+    constexpr uint32_t c_BankTypeStreaming = 0x00000001;
+    constexpr uint32_t c_BankFlagsCompact = 0x00020000;
+
+    constexpr uint32_t c_AlignmentMin = 4;
+
+    // ENTRY: flags and duration, format, play region, loop region
+    constexpr uint32_t c_EntrySize = 24;
+    constexpr size_t c_EntryPlayOffset = 8;
+    constexpr size_t c_EntryPlayLength = 12;
+
+    // ENTRYCOMPACT: offset in units of the alignment:21, length deviation:11
+    constexpr uint32_t c_EntryCompactSize = 4;
+    constexpr uint32_t c_CompactOffsetMask = 0x001FFFFF;
+    constexpr uint32_t c_CompactDeviationShift = 21;
+}
+
+
+WaveBankMapping::WaveBankMapping() noexcept :
+    mData(nullptr),
+    mSize(0),
+    mBank{}
+{
+}
+
+WaveBankMapping::WaveBankMapping(WaveBankMapping&& other) noexcept :
+    mData(std::exchange(other.mData, nullptr)),
+    mSize(std::exchange(other.mSize, 0)),
+    mBank(std::exchange(other.mBank, BankLayout{}))
+{
+}
+
+WaveBankMapping& WaveBankMapping::operator= (WaveBankMapping&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        mData = std::exchange(other.mData, nullptr);
+        mSize = std::exchange(other.mSize, 0);
+        mBank = std::exchange(other.mBank, BankLayout{});
+    }
+    return *this;
+}
+
+WaveBankMapping::~WaveBankMapping()
+{
+    Close();
+}
+
+
+_Use_decl_annotations_
+HRESULT WaveBankMapping::Open(const wchar_t* szFileName) noexcept
+{
+    Close();
+
+    if (!szFileName)
+        return E_INVALIDARG;
+
+    HANDLE hFile = CreateFile2(szFileName, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return HRESULT_FROM_WIN32(GetLastError());
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(hFile, &fileSize))
+    {
+        const HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+        CloseHandle(hFile);
+        return hr;
+    }
+
+    if (fileSize.QuadPart <= 0 || static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX)
+    {
+        CloseHandle(hFile);
+        return E_FAIL;
+    }
+
+    // The view keeps the section alive, and the section keeps the file open
+    HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const DWORD mappingError = GetLastError();
+    CloseHandle(hFile);
+    if (!hMapping)
+        return HRESULT_FROM_WIN32(mappingError);
+
+    void* view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    const DWORD viewError = GetLastError();
+    CloseHandle(hMapping);
+    if (!view)
+        return HRESULT_FROM_WIN32(viewError);
+
+    mData = static_cast<const uint8_t*>(view);
+    mSize = static_cast<size_t>(fileSize.QuadPart);
+
+    HRESULT hr = Parse();
+    if (FAILED(hr))
+    {
+        Close();
+        return hr;
+    }
+
+    return S_OK;
+}
+
+
+void WaveBankMapping::Close() noexcept
+{
+    if (mData)
+    {
+        std::ignore = UnmapViewOfFile(mData);
+        mData = nullptr;
+        mSize = 0;
+    }
+
+    mBank = {};
+}
+
+
+uint32_t WaveBankMapping::ReadU32(size_t offset) const noexcept
+{
+    uint32_t value = 0;
+    memcpy(&value, mData + offset, sizeof(value));
+    return mBank.bigEndian ? _byteswap_ulong(value) : value;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Validates the header and locates the entry table and wave data in the mapping
+HRESULT WaveBankMapping::Parse() noexcept
+{
+    mBank = {};
+
+    if (mSize < c_HeaderSize)
+        return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+
+    uint32_t signature = 0;
+    memcpy(&signature, mData, sizeof(signature));
+    if (signature == c_SignatureBigEndian)
+    {
+        mBank.bigEndian = true;
+    }
+    else if (signature != c_Signature)
+    {
+        return E_FAIL;
+    }
+
+    if (ReadU32(4) != c_ContentVersion)
+        return E_FAIL;
+
+    uint32_t segmentOffset[SEGIDX_COUNT] = {};
+    uint32_t segmentLength[SEGIDX_COUNT] = {};
+    for (size_t j = 0; j < SEGIDX_COUNT; ++j)
+    {
+        segmentOffset[j] = ReadU32(12 + j * 8);
+        segmentLength[j] = ReadU32(16 + j * 8);
+
+        if (uint64_t(segmentOffset[j]) + segmentLength[j] > mSize)
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+    }
+
+    const size_t bankData = segmentOffset[SEGIDX_BANKDATA];
+    if (segmentLength[SEGIDX_BANKDATA] < c_BankDataSize)
+        return E_FAIL;
+
+    const uint32_t flags = ReadU32(bankData + c_BankFlags);
+    const uint32_t entryCount = ReadU32(bankData + c_BankEntryCount);
+    const uint32_t entryStride = ReadU32(bankData + c_BankEntryMetaDataElementSize);
+    const uint32_t alignment = ReadU32(bankData + c_BankAlignment);
+    const bool compact = (flags & c_BankFlagsCompact) != 0;
+
+    if (entryStride != (compact ? c_EntryCompactSize : c_EntrySize))
+        return E_FAIL;
+
+    if (uint64_t(entryCount) * entryStride > segmentLength[SEGIDX_ENTRYMETADATA])
+        return E_FAIL;
+
+    if (compact)
+    {
+        if (alignment < c_AlignmentMin
+            || segmentLength[SEGIDX_ENTRYWAVEDATA] > uint64_t(c_CompactOffsetMask) * alignment)
+            return E_FAIL;
+    }
+
+    mBank.entryOffset = segmentOffset[SEGIDX_ENTRYMETADATA];
+    mBank.entryCount = entryCount;
+    mBank.entryStride = entryStride;
+    mBank.waveOffset = segmentOffset[SEGIDX_ENTRYWAVEDATA];
+    mBank.waveLength = segmentLength[SEGIDX_ENTRYWAVEDATA];
+    mBank.alignment = alignment;
+    mBank.compact = compact;
+    mBank.streaming = (flags & c_BankTypeStreaming) != 0;
+
+    return S_OK;
+}
+
+
+_Use_decl_annotations_
+HRESULT WaveBankMapping::GetWaveData(
+    uint32_t index,
+    const uint8_t** pData,
+    uint32_t& dataSize,
+    bool prefetch) const noexcept
+{
+    if (!pData)
+        return E_INVALIDARG;
+
+    *pData = nullptr;
+    dataSize = 0;
+
+    if (!mData)
+        return E_UNEXPECTED;
+
+    if (index >= mBank.entryCount)
+        return E_INVALIDARG;
+
+    const size_t entry = size_t(mBank.entryOffset) + size_t(index) * mBank.entryStride;
+
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    if (mBank.compact)
+    {
+        // A compact entry's length runs to the next entry, or to the end of the wave data
+        const uint32_t value = ReadU32(entry);
+        offset = uint64_t(value & c_CompactOffsetMask) * mBank.alignment;
+
+        const uint64_t end = (index + 1 < mBank.entryCount)
+            ? uint64_t(ReadU32(entry + c_EntryCompactSize) & c_CompactOffsetMask) * mBank.alignment
+            : mBank.waveLength;
+
+        const uint32_t deviation = value >> c_CompactDeviationShift;
+        if (end < offset + deviation)
+            return E_FAIL;
+
+        length = end - offset - deviation;
+    }
+    else
+    {
+        offset = ReadU32(entry + c_EntryPlayOffset);
+        length = ReadU32(entry + c_EntryPlayLength);
+    }
+
+    if (offset + length > mBank.waveLength)
+        return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+
+    const uint8_t* data = mData + mBank.waveOffset + offset;
+    const auto dataLength = static_cast<uint32_t>(length);
+
+    if (prefetch && dataLength > 0)
+    {
+    #if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+        WIN32_MEMORY_RANGE_ENTRY range = { const_cast<uint8_t*>(data), dataLength };
+        std::ignore = PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    #endif
+    }
+
+    *pData = data;
+    dataSize = dataLength;
+
+    return S_OK;
+}
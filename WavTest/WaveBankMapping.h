@@ -0,0 +1,74 @@
+//--------------------------------------------------------------------------------------
+// File: WaveBankMapping.h
+//
+// Zero-copy access to in-memory wave bank entries through a file mapping
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace DirectX
+{
+    // Maps a wave bank file read-only so entry data can be used in place, instead of from the
+    // copy WaveBankReader makes of the whole wave data region. The bank header and entry table
+    // are parsed directly from the mapping, so no WaveBankReader is needed.
+    class WaveBankMapping
+    {
+    public:
+        WaveBankMapping() noexcept;
+
+        WaveBankMapping(WaveBankMapping&&) noexcept;
+        WaveBankMapping& operator= (WaveBankMapping&&) noexcept;
+
+        WaveBankMapping(WaveBankMapping const&) = delete;
+        WaveBankMapping& operator= (WaveBankMapping const&) = delete;
+
+        ~WaveBankMapping();
+
+        HRESULT Open(_In_z_ const wchar_t* szFileName) noexcept;
+        void Close() noexcept;
+
+        // Returns a pointer into the mapping for an entry. Unless 'prefetch' is false, the OS is
+        // asked to start paging in the entry so that first use doesn't fault one page at a time.
+        HRESULT GetWaveData(
+            uint32_t index,
+            _Outptr_ const uint8_t** pData,
+            _Out_ uint32_t& dataSize,
+            bool prefetch = true) const noexcept;
+
+        uint32_t Count() const noexcept { return mBank.entryCount; }
+        bool IsStreamingBank() const noexcept { return mBank.streaming; }
+        uint32_t BankAudioSize() const noexcept { return mBank.waveLength; }
+
+        const uint8_t* GetData() const noexcept { return mData; }
+        size_t GetSize() const noexcept { return mSize; }
+
+    private:
+        // Layout of the mapped bank, from its header and bank data
+        struct BankLayout
+        {
+            uint32_t    entryOffset;
+            uint32_t    entryCount;
+            uint32_t    entryStride;
+            uint32_t    waveOffset;
+            uint32_t    waveLength;
+            uint32_t    alignment;
+            bool        compact;
+            bool        streaming;
+            bool        bigEndian;
+        };
+
+        HRESULT Parse() noexcept;
+        uint32_t ReadU32(size_t offset) const noexcept;
+
+        const uint8_t*  mData;
+        size_t          mSize;
+        BankLayout      mBank;
+    };
+}
@@ -0,0 +1,769 @@
+//-------------------------------------------------------------------------------------
+// benchmark.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX 1
+#define NODRAWTEXT
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+#pragma warning(pop)
+
+#include <Windows.h>
+
+#include "WAVFileReader.h"
+#include "WaveBankReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace DirectX;
+
+extern double ElapsedMilliseconds(std::chrono::steady_clock::time_point start);
+
+namespace
+{
+    //---------------------------------------------------------------------------------
+    // Synthetic corpora
+
+    enum CORPUS_FORMAT : uint32_t
+    {
+        CORPUS_PCM = 0,
+        CORPUS_FLOAT,
+        CORPUS_ADPCM,
+        CORPUS_XWMA,
+    };
+
+    const char* GetCorpusFormatName(CORPUS_FORMAT format)
+    {
+        switch (format)
+        {
+        case CORPUS_PCM: return "PCM";
+        case CORPUS_FLOAT: return "float";
+        case CORPUS_ADPCM: return "ADPCM";
+        case CORPUS_XWMA: return "xWMA";
+        default: return "?";
+        }
+    }
+
+    // All corpora are mono 44.1 kHz, with the ADPCM block size and xWMA packet size and rate
+    // of the sample banks
+    constexpr uint32_t c_SampleRate = 44100;
+    constexpr uint32_t c_ADPCMBlockAlign = 70;
+    constexpr uint32_t c_ADPCMSamplesPerBlock = (c_ADPCMBlockAlign - 7) * 2 + 2;
+    constexpr uint32_t c_WMABlockAlign = 2230;
+    constexpr uint32_t c_WMABytesPerSec = 6000;
+    constexpr uint32_t c_WMABytesPerPacket = 4096;
+
+    uint32_t GetBlockAlign(CORPUS_FORMAT format)
+    {
+        switch (format)
+        {
+        case CORPUS_FLOAT: return 4;
+        case CORPUS_ADPCM: return c_ADPCMBlockAlign;
+        case CORPUS_XWMA: return c_WMABlockAlign;
+        default: return 2;
+        }
+    }
+
+    // Rounds a payload size down to whole blocks
+    uint32_t GetPayloadSize(CORPUS_FORMAT format, uint32_t size)
+    {
+        const uint32_t blockAlign = GetBlockAlign(format);
+        return std::max(blockAlign, size - (size % blockAlign));
+    }
+
+    uint32_t GetDuration(CORPUS_FORMAT format, uint32_t payloadSize)
+    {
+        const uint32_t blocks = payloadSize / GetBlockAlign(format);
+        switch (format)
+        {
+        case CORPUS_ADPCM: return blocks * c_ADPCMSamplesPerBlock;
+        case CORPUS_XWMA: return blocks * (c_WMABytesPerPacket / 2);
+        default: return blocks;
+        }
+    }
+
+    // Audio content is never decoded by the readers, so any bytes will do
+    void FillPayload(std::vector<uint8_t>& data, uint32_t seed)
+    {
+        uint32_t state = seed * 2654435761u + 1;
+        for (auto& it : data)
+        {
+            state = state * 1664525u + 1013904223u;
+            it = static_cast<uint8_t>(state >> 24);
+        }
+    }
+
+    void Append(std::vector<uint8_t>& out, const void* data, size_t size)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    void AppendU16(std::vector<uint8_t>& out, uint32_t value)
+    {
+        const uint16_t v = static_cast<uint16_t>(value);
+        Append(out, &v, sizeof(v));
+    }
+
+    void AppendU32(std::vector<uint8_t>& out, uint32_t value)
+    {
+        Append(out, &value, sizeof(value));
+    }
+
+    void PatchU32(std::vector<uint8_t>& out, size_t offset, uint32_t value)
+    {
+        memcpy(out.data() + offset, &value, sizeof(value));
+    }
+
+    std::vector<uint8_t> CreateWAV(CORPUS_FORMAT format, uint32_t size, uint32_t seed)
+    {
+        const uint32_t payloadSize = GetPayloadSize(format, size);
+
+        std::vector<uint8_t> out;
+        out.reserve(size_t(payloadSize) + 1024);
+
+        Append(out, "RIFF", 4);
+        AppendU32(out, 0);
+        Append(out, (format == CORPUS_XWMA) ? "XWMA" : "WAVE", 4);
+
+        // fmt: WAVEFORMATEX, plus the MS-ADPCM coefficient table
+        Append(out, "fmt ", 4);
+        AppendU32(out, (format == CORPUS_ADPCM) ? 50u : 18u);
+        switch (format)
+        {
+        case CORPUS_FLOAT:
+            AppendU16(out, WAVE_FORMAT_IEEE_FLOAT);
+            AppendU16(out, 1);
+            AppendU32(out, c_SampleRate);
+            AppendU32(out, c_SampleRate * 4);
+            AppendU16(out, 4);
+            AppendU16(out, 32);
+            AppendU16(out, 0);
+            break;
+
+        case CORPUS_ADPCM:
+            {
+                static const int16_t s_coefs[7][2] = { { 256, 0 }, { 512, -256 }, { 0, 0 }, { 192, 64 }, { 240, 0 }, { 460, -208 }, { 392, -232 } };
+
+                AppendU16(out, WAVE_FORMAT_ADPCM);
+                AppendU16(out, 1);
+                AppendU32(out, c_SampleRate);
+                AppendU32(out, c_SampleRate * c_ADPCMBlockAlign / c_ADPCMSamplesPerBlock);
+                AppendU16(out, c_ADPCMBlockAlign);
+                AppendU16(out, 4);
+                AppendU16(out, 32);
+                AppendU16(out, c_ADPCMSamplesPerBlock);
+                AppendU16(out, 7);
+                Append(out, s_coefs, sizeof(s_coefs));
+            }
+            break;
+
+        case CORPUS_XWMA:
+            AppendU16(out, WAVE_FORMAT_WMAUDIO2);
+            AppendU16(out, 1);
+            AppendU32(out, c_SampleRate);
+            AppendU32(out, c_WMABytesPerSec);
+            AppendU16(out, c_WMABlockAlign);
+            AppendU16(out, 16);
+            AppendU16(out, 0);
+            break;
+
+        default:
+            AppendU16(out, WAVE_FORMAT_PCM);
+            AppendU16(out, 1);
+            AppendU32(out, c_SampleRate);
+            AppendU32(out, c_SampleRate * 2);
+            AppendU16(out, 2);
+            AppendU16(out, 16);
+            AppendU16(out, 0);
+            break;
+        }
+
+        // dpds: cumulative decoded bytes at the end of each xWMA packet
+        if (format == CORPUS_XWMA)
+        {
+            const uint32_t packets = payloadSize / c_WMABlockAlign;
+            Append(out, "dpds", 4);
+            AppendU32(out, packets * sizeof(uint32_t));
+            for (uint32_t j = 0; j < packets; ++j)
+            {
+                AppendU32(out, (j + 1) * c_WMABytesPerPacket);
+            }
+        }
+
+        Append(out, "data", 4);
+        AppendU32(out, payloadSize);
+
+        std::vector<uint8_t> payload(payloadSize);
+        FillPayload(payload, seed);
+        Append(out, payload.data(), payload.size());
+
+        PatchU32(out, 4, static_cast<uint32_t>(out.size() - 8));
+
+        return out;
+    }
+
+    //---------------------------------------------------------------------------------
+    // XACT3 wave bank layout, as written by XWBTool
+
+    constexpr uint32_t XWB_SIGNATURE = 0x444E4257; // 'WBND'
+    constexpr uint32_t XWB_CONTENT_VERSION = 46;
+    constexpr uint32_t XWB_HEADER_VERSION = 44;
+    constexpr uint32_t XWB_SEGMENTS = 5;
+    constexpr uint32_t XWB_HEADER_SIZE = 12 + XWB_SEGMENTS * 8;
+    constexpr uint32_t XWB_BANKDATA_SIZE = 96;
+    constexpr uint32_t XWB_ENTRY_SIZE = 24;
+
+    constexpr uint32_t XWB_TYPE_STREAMING = 0x00000001;
+    constexpr uint32_t XWB_FLAGS_SEEKTABLES = 0x00080000;
+
+    // MINIWAVEFORMAT: tag:2, channels:3, rate:18, blockAlign:8, bitsPerSample:1
+    uint32_t GetMiniFormat(CORPUS_FORMAT format)
+    {
+        uint32_t tag = 0;
+        uint32_t blockAlign = 2;
+        uint32_t bits16 = 1;
+        switch (format)
+        {
+        case CORPUS_ADPCM:
+            tag = 2;
+            blockAlign = c_ADPCMBlockAlign - 22; // ADPCM_BLOCKALIGN_CONVERSION_OFFSET
+            bits16 = 0;
+            break;
+
+        case CORPUS_XWMA:
+            tag = 3;
+            blockAlign = (3u << 5) | 3u; // 6000 bytes/sec, 2230-byte packets
+            bits16 = 0;
+            break;
+
+        default:
+            break;
+        }
+
+        return tag | (1u << 2) | (c_SampleRate << 5) | (blockAlign << 23) | (bits16 << 31);
+    }
+
+    // PCM float is not an XWB format, so float corpora are only written as WAV files
+    std::vector<uint8_t> CreateXWB(CORPUS_FORMAT format, uint32_t entryCount, uint32_t entrySize, uint32_t alignment, bool streaming)
+    {
+        const uint32_t payloadSize = GetPayloadSize(format, entrySize);
+        const uint32_t alignedSize = (payloadSize + alignment - 1) & ~(alignment - 1);
+        const bool seekTables = (format == CORPUS_XWMA);
+
+        // Segments: bank data, entry metadata, seek tables, entry names (none), wave data
+        uint32_t offsets[XWB_SEGMENTS] = {};
+        uint32_t lengths[XWB_SEGMENTS] = {};
+
+        offsets[0] = XWB_HEADER_SIZE;
+        lengths[0] = XWB_BANKDATA_SIZE;
+        offsets[1] = offsets[0] + lengths[0];
+        lengths[1] = XWB_ENTRY_SIZE * entryCount;
+        offsets[2] = offsets[1] + lengths[1];
+
+        const uint32_t packets = payloadSize / c_WMABlockAlign;
+        if (seekTables)
+        {
+            lengths[2] = entryCount * sizeof(uint32_t) + entryCount * (packets + 1) * sizeof(uint32_t);
+        }
+
+        offsets[4] = offsets[2] + lengths[2];
+        offsets[4] = (offsets[4] + alignment - 1) & ~(alignment - 1);
+        lengths[4] = alignedSize * entryCount;
+
+        std::vector<uint8_t> out;
+        out.reserve(size_t(offsets[4]) + lengths[4]);
+
+        AppendU32(out, XWB_SIGNATURE);
+        AppendU32(out, XWB_CONTENT_VERSION);
+        AppendU32(out, XWB_HEADER_VERSION);
+        for (uint32_t j = 0; j < XWB_SEGMENTS; ++j)
+        {
+            AppendU32(out, offsets[j]);
+            AppendU32(out, lengths[j]);
+        }
+
+        // BANKDATA
+        AppendU32(out, (streaming ? XWB_TYPE_STREAMING : 0u) | (seekTables ? XWB_FLAGS_SEEKTABLES : 0u));
+        AppendU32(out, entryCount);
+        char bankName[64] = "Benchmark";
+        Append(out, bankName, sizeof(bankName));
+        AppendU32(out, XWB_ENTRY_SIZE);
+        AppendU32(out, 0);
+        AppendU32(out, alignment);
+        AppendU32(out, 0);
+        AppendU32(out, 0);
+        AppendU32(out, 0);
+
+        // ENTRY: flags:4 + duration:28, format, play region, loop region
+        for (uint32_t j = 0; j < entryCount; ++j)
+        {
+            AppendU32(out, GetDuration(format, payloadSize) << 4);
+            AppendU32(out, GetMiniFormat(format));
+            AppendU32(out, j * alignedSize);
+            AppendU32(out, payloadSize);
+            AppendU32(out, 0);
+            AppendU32(out, 0);
+        }
+
+        if (seekTables)
+        {
+            for (uint32_t j = 0; j < entryCount; ++j)
+            {
+                AppendU32(out, j * (packets + 1) * sizeof(uint32_t));
+            }
+
+            for (uint32_t j = 0; j < entryCount; ++j)
+            {
+                AppendU32(out, packets);
+                for (uint32_t k = 0; k < packets; ++k)
+                {
+                    AppendU32(out, (k + 1) * c_WMABytesPerPacket);
+                }
+            }
+        }
+
+        out.resize(offsets[4], 0);
+
+        std::vector<uint8_t> payload(alignedSize);
+        for (uint32_t j = 0; j < entryCount; ++j)
+        {
+            FillPayload(payload, j);
+            std::fill(payload.begin() + payloadSize, payload.end(), uint8_t(0));
+            Append(out, payload.data(), payload.size());
+        }
+
+        return out;
+    }
+
+    //---------------------------------------------------------------------------------
+    // Files
+
+    std::wstring GetCorpusPath(const wchar_t* name)
+    {
+        wchar_t temp[MAX_PATH] = {};
+        if (!GetTempPathW(MAX_PATH, temp))
+            return name;
+
+        return std::wstring(temp) + name;
+    }
+
+    FILE* OpenStdioFile(const std::wstring& path, const wchar_t* mode)
+    {
+        FILE* file = nullptr;
+        if (_wfopen_s(&file, path.c_str(), mode) != 0)
+            return nullptr;
+        return file;
+    }
+
+    bool WriteCorpusFile(const std::wstring& path, const std::vector<uint8_t>& data)
+    {
+        FILE* file = OpenStdioFile(path, L"wb");
+        if (!file)
+            return false;
+
+        const size_t written = fwrite(data.data(), 1, data.size(), file);
+        return (fclose(file) == 0) && (written == data.size());
+    }
+
+    void DeleteTempFile(const std::wstring& path)
+    {
+        std::ignore = DeleteFileW(path.c_str());
+    }
+
+    // Drops the file from the system file cache without elevation: opening an unbuffered handle
+    // makes the cache manager flush and purge the file's cached pages, provided no other handle
+    // to it is open. Returns false if the file could not be evicted.
+    bool EvictFromCache(const std::wstring& path)
+    {
+        CREATEFILE2_EXTENDED_PARAMETERS params = { sizeof(CREATEFILE2_EXTENDED_PARAMETERS), 0 };
+        params.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+        params.dwFileFlags = FILE_FLAG_NO_BUFFERING;
+
+        HANDLE hFile = CreateFile2(path.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, &params);
+        if (hFile == INVALID_HANDLE_VALUE)
+            return false;
+
+        CloseHandle(hFile);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------
+    // Results
+
+    struct BenchmarkResult
+    {
+        std::string operation;
+        std::string corpus;
+        std::string format;
+        uint32_t    files;
+        uint64_t    bytes;
+        double      coldTime;
+        double      warmTime;
+    };
+
+    std::vector<BenchmarkResult> g_Results;
+
+    constexpr uint32_t c_WarmRuns = 5;
+
+    double Median(std::vector<double>& values)
+    {
+        std::sort(values.begin(), values.end());
+        return values.empty() ? 0.0 : values[values.size() / 2];
+    }
+
+    void AddResult(const char* operation, const char* corpus, CORPUS_FORMAT format, uint32_t files, uint64_t bytes, double coldTime, double warmTime)
+    {
+        g_Results.push_back(BenchmarkResult{ operation, corpus, GetCorpusFormatName(format), files, bytes, coldTime, warmTime });
+
+        const double mb = double(bytes) / (1024.0 * 1024.0);
+        if (coldTime >= 0.0)
+        {
+            printf("\t%-28s %-22s %-6s %10.3f ms cold %8.1f MB/s  %10.3f ms warm %8.1f MB/s\n",
+                operation, corpus, GetCorpusFormatName(format),
+                coldTime, mb / (coldTime / 1000.0), warmTime, mb / (warmTime / 1000.0));
+        }
+        else
+        {
+            printf("\t%-28s %-22s %-6s %10s                          %10.3f ms warm %8.1f MB/s\n",
+                operation, corpus, GetCorpusFormatName(format), "-", warmTime, mb / (warmTime / 1000.0));
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------
+// LoadWAVAudioFromFileEx throughput, cold and warm
+bool Benchmark01()
+{
+    struct Corpus
+    {
+        const char*     name;
+        CORPUS_FORMAT   format;
+        uint32_t        files;
+        uint32_t        fileSize;
+    };
+
+    static const Corpus s_corpora[] =
+    {
+        { "many small", CORPUS_PCM, 1000, 16 * 1024 },
+        { "many small", CORPUS_ADPCM, 1000, 8 * 1024 },
+        { "music", CORPUS_PCM, 4, 16 * 1024 * 1024 },
+        { "music", CORPUS_FLOAT, 4, 16 * 1024 * 1024 },
+        { "music", CORPUS_ADPCM, 4, 4 * 1024 * 1024 },
+        { "music", CORPUS_XWMA, 4, 1024 * 1024 },
+    };
+
+    bool success = true;
+
+    printf("\n");
+
+    for (const auto& corpus : s_corpora)
+    {
+        std::vector<std::wstring> paths(corpus.files);
+        uint64_t totalBytes = 0;
+        uint32_t audioBytes = 0;
+
+        for (uint32_t j = 0; j < corpus.files; ++j)
+        {
+            wchar_t name[64] = {};
+            swprintf(name, 64, L"wavbench_%u_%u.wav", static_cast<unsigned int>(corpus.format), j);
+            paths[j] = GetCorpusPath(name);
+
+            auto data = CreateWAV(corpus.format, corpus.fileSize, j);
+            if (!WriteCorpusFile(paths[j], data))
+            {
+                printf("ERROR: Failed writing benchmark corpus:\n%ls\n", paths[j].c_str());
+                return false;
+            }
+
+            totalBytes += data.size();
+            audioBytes = GetPayloadSize(corpus.format, corpus.fileSize);
+        }
+
+        auto loadAll = [&]() -> bool
+        {
+            for (const auto& path : paths)
+            {
+                std::unique_ptr<uint8_t[]> wavData;
+                WAVData result = {};
+                HRESULT hr = LoadWAVAudioFromFileEx(path.c_str(), wavData, result);
+                if (FAILED(hr) || result.audioBytes != audioBytes)
+                {
+                    printf("ERROR: Failed loading benchmark wav (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), path.c_str());
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        bool evicted = true;
+        for (const auto& path : paths)
+        {
+            evicted &= EvictFromCache(path);
+        }
+
+        // Without eviction the first pass is not a cold load, so it is not reported as one
+        auto start = std::chrono::steady_clock::now();
+        bool pass = loadAll();
+        const double coldTime = (evicted) ? ElapsedMilliseconds(start) : -1.0;
+
+        std::vector<double> warmTimes;
+        for (uint32_t run = 0; pass && run < c_WarmRuns; ++run)
+        {
+            start = std::chrono::steady_clock::now();
+            pass = loadAll();
+            warmTimes.push_back(ElapsedMilliseconds(start));
+        }
+
+        if (pass)
+        {
+            AddResult("LoadWAVAudioFromFileEx", corpus.name, corpus.format, corpus.files, totalBytes, coldTime, Median(warmTimes));
+        }
+        else
+        {
+            success = false;
+        }
+
+        for (const auto& path : paths)
+        {
+            DeleteTempFile(path);
+        }
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// WaveBankReader Open, GetMetadata and GetWaveData throughput, cold and warm
+bool Benchmark02()
+{
+    struct Corpus
+    {
+        const char*     name;
+        CORPUS_FORMAT   format;
+        uint32_t        entries;
+        uint32_t        entrySize;
+        uint32_t        alignment;
+        bool            streaming;
+    };
+
+    static const Corpus s_corpora[] =
+    {
+        { "in-memory SFX", CORPUS_PCM, 256, 32 * 1024, 4, false },
+        { "in-memory SFX", CORPUS_ADPCM, 256, 16 * 1024, 4, false },
+        { "in-memory SFX", CORPUS_XWMA, 64, 32 * 1024, 4, false },
+        { "in-memory music", CORPUS_PCM, 8, 8 * 1024 * 1024, 4, false },
+        { "streaming", CORPUS_PCM, 16, 4 * 1024 * 1024, 2048, true },
+        { "streaming 4Kn", CORPUS_PCM, 16, 4 * 1024 * 1024, 4096, true },
+        { "streaming 4Kn", CORPUS_ADPCM, 16, 1024 * 1024, 4096, true },
+        { "streaming", CORPUS_XWMA, 16, 512 * 1024, 2048, true },
+    };
+
+    bool success = true;
+
+    printf("\n");
+
+    for (const auto& corpus : s_corpora)
+    {
+        wchar_t name[64] = {};
+        swprintf(name, 64, L"wavbench_%u_%u_%u.xwb", static_cast<unsigned int>(corpus.format), corpus.alignment, corpus.streaming ? 1u : 0u);
+        const std::wstring path = GetCorpusPath(name);
+
+        auto data = CreateXWB(corpus.format, corpus.entries, corpus.entrySize, corpus.alignment, corpus.streaming);
+        if (!WriteCorpusFile(path, data))
+        {
+            printf("ERROR: Failed writing benchmark corpus:\n%ls\n", path.c_str());
+            return false;
+        }
+
+        const uint64_t fileBytes = data.size();
+        const uint32_t payloadSize = GetPayloadSize(corpus.format, corpus.entrySize);
+        data.clear();
+        data.shrink_to_fit();
+
+        auto open = [&](WaveBankReader& wb) -> bool
+        {
+            HRESULT hr = wb.Open(path.c_str());
+            if (FAILED(hr))
+            {
+                printf("ERROR: Failed loading benchmark wavebank (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), path.c_str());
+                return false;
+            }
+
+            wb.WaitOnPrepare();
+
+            if (wb.Count() != corpus.entries || wb.IsStreamingBank() != corpus.streaming)
+            {
+                printf("ERROR: Metadata error in benchmark wavebank:\n%ls\n", path.c_str());
+                return false;
+            }
+            return true;
+        };
+
+        const bool evicted = EvictFromCache(path);
+
+        bool pass = true;
+        double coldTime = -1.0;
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto wb = std::make_unique<WaveBankReader>();
+            pass = open(*wb);
+            if (evicted)
+            {
+                coldTime = ElapsedMilliseconds(start);
+            }
+        }
+
+        std::vector<double> warmTimes;
+        for (uint32_t run = 0; pass && run < c_WarmRuns; ++run)
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto wb = std::make_unique<WaveBankReader>();
+            pass = open(*wb);
+            warmTimes.push_back(ElapsedMilliseconds(start));
+        }
+
+        // In-memory banks read the whole file on Open; streaming banks only read the headers
+        const uint64_t openBytes = corpus.streaming ? uint64_t(fileBytes) - uint64_t(payloadSize) * corpus.entries : fileBytes;
+        if (pass)
+        {
+            AddResult("WaveBankReader::Open", corpus.name, corpus.format, 1, openBytes, coldTime, Median(warmTimes));
+        }
+
+        // Per-entry queries on an open bank
+        auto wb = std::make_unique<WaveBankReader>();
+        if (pass && open(*wb))
+        {
+            warmTimes.clear();
+            for (uint32_t run = 0; pass && run < c_WarmRuns; ++run)
+            {
+                auto start = std::chrono::steady_clock::now();
+                for (uint32_t j = 0; j < corpus.entries; ++j)
+                {
+                    WaveBankReader::Metadata metadata = {};
+                    if (FAILED(wb->GetMetadata(j, metadata)) || metadata.lengthBytes != payloadSize)
+                    {
+                        printf("ERROR: Failed get wave metadata for entry %u:\n%ls\n", j, path.c_str());
+                        pass = false;
+                        break;
+                    }
+                }
+                warmTimes.push_back(ElapsedMilliseconds(start));
+            }
+
+            if (pass)
+            {
+                AddResult("WaveBankReader::GetMetadata", corpus.name, corpus.format, corpus.entries,
+                    uint64_t(XWB_ENTRY_SIZE) * corpus.entries, -1.0, Median(warmTimes));
+            }
+
+            if (pass && !corpus.streaming)
+            {
+                warmTimes.clear();
+                for (uint32_t run = 0; pass && run < c_WarmRuns; ++run)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    for (uint32_t j = 0; j < corpus.entries; ++j)
+                    {
+                        const uint8_t* wavData = nullptr;
+                        uint32_t audioBytes = 0;
+                        if (FAILED(wb->GetWaveData(j, &wavData, audioBytes)) || !wavData || audioBytes != payloadSize)
+                        {
+                            printf("ERROR: Failed get wave data for entry %u:\n%ls\n", j, path.c_str());
+                            pass = false;
+                            break;
+                        }
+                    }
+                    warmTimes.push_back(ElapsedMilliseconds(start));
+                }
+
+                if (pass)
+                {
+                    AddResult("WaveBankReader::GetWaveData", corpus.name, corpus.format, corpus.entries,
+                        uint64_t(payloadSize) * corpus.entries, -1.0, Median(warmTimes));
+                }
+            }
+        }
+        else
+        {
+            pass = false;
+        }
+
+        if (!pass)
+            success = false;
+
+        wb.reset();
+        DeleteTempFile(path);
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Writes the collected benchmark results as CSV, or JSON if the name doesn't end in .csv
+bool WriteBenchmarkReport(const wchar_t* fileName)
+{
+    const size_t len = wcslen(fileName);
+    const bool csv = (len >= 4) && (wcscmp(fileName + len - 4, L".csv") == 0 || wcscmp(fileName + len - 4, L".CSV") == 0);
+
+    FILE* file = OpenStdioFile(fileName, L"wt");
+    if (!file)
+    {
+        printf("ERROR: Failed creating benchmark report:\n%ls\n", fileName);
+        return false;
+    }
+
+    if (csv)
+    {
+        fprintf(file, "operation,corpus,format,files,bytes,cold_ms,warm_ms\n");
+        for (const auto& it : g_Results)
+        {
+            fprintf(file, "%s,%s,%s,%u,%llu,", it.operation.c_str(), it.corpus.c_str(), it.format.c_str(),
+                it.files, static_cast<unsigned long long>(it.bytes));
+            if (it.coldTime >= 0.0)
+                fprintf(file, "%.4f", it.coldTime);
+            fprintf(file, ",%.4f\n", it.warmTime);
+        }
+    }
+    else
+    {
+        fprintf(file, "{\n  \"benchmarks\": [\n");
+        for (size_t j = 0; j < g_Results.size(); ++j)
+        {
+            const auto& it = g_Results[j];
+            fprintf(file, "    { \"operation\": \"%s\", \"corpus\": \"%s\", \"format\": \"%s\", \"files\": %u, \"bytes\": %llu, ",
+                it.operation.c_str(), it.corpus.c_str(), it.format.c_str(), it.files, static_cast<unsigned long long>(it.bytes));
+            if (it.coldTime >= 0.0)
+                fprintf(file, "\"cold_ms\": %.4f, ", it.coldTime);
+            else
+                fprintf(file, "\"cold_ms\": null, ");
+            fprintf(file, "\"warm_ms\": %.4f }%s\n", it.warmTime, (j + 1 < g_Results.size()) ? "," : "");
+        }
+        fprintf(file, "  ]\n}\n");
+    }
+
+    if (fclose(file) != 0)
+    {
+        printf("ERROR: Failed writing benchmark report:\n%ls\n", fileName);
+        return false;
+    }
+
+    return true;
+}
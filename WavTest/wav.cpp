@@ -18,8 +18,15 @@
 
 #include "WAVFileReader.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "SoundCommon.h"
 
@@ -29,6 +36,17 @@
 
 using namespace DirectX;
 
+//-------------------------------------------------------------------------------------
+
+extern HRESULT MD5Checksum( _In_reads_(dataSize) const uint8_t *data, size_t dataSize, _Out_bytecap_x_(16) uint8_t *digest );
+extern void ParallelForEach(size_t count, const std::function<void(size_t)>& func);
+extern void AppendLog(std::string& log, _In_z_ _Printf_format_string_ const char* format, ...);
+extern bool GetMediaPath(_In_z_ const wchar_t* fname, _Out_writes_(count) wchar_t* path, size_t count);
+extern uint64_t GetMediaFileSize(_In_z_ const wchar_t* path);
+extern double ElapsedMilliseconds(std::chrono::steady_clock::time_point start);
+extern void LogTiming(std::string& log, _In_z_ const wchar_t* fname, uint64_t fileBytes, double parseTime);
+extern void FlushLogs(const std::vector<std::string>& logs, double wallTime);
+
 namespace
 {
     const uint32_t WAVE_FAIL_CASE = 0;
@@ -66,7 +84,7 @@ namespace
         { WAVE_FAIL_CASE, 0, 0, 0, 0, 0, L"WavTest\\crash-16ddb25a6080f6f5a40e30d521b8e5b476ab8c10.wav", {} },
     };
 
-#define printdigest(str,digest) printf( "%s:\n0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x\n", str, \
+#define printdigest(log,str,digest) AppendLog( log, "%s:\n0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x\n", str, \
                                        digest[0], digest[1], digest[2], digest[3], digest[4], digest[5], digest[6], digest[7], \
                                        digest[8], digest[9], digest[10], digest[11], digest[12], digest[13], digest[14], digest[15] );
 
@@ -107,42 +125,31 @@ namespace
         }
     }
 
-    void printwaveex(_In_ const WAVEFORMATEX* wfx)
+    void printwaveex(std::string& log, _In_ const WAVEFORMATEX* wfx)
     {
         if (wfx->wFormatTag == WAVE_FORMAT_EXTENSIBLE
             && (wfx->cbSize >= (sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX))))
         {
             auto wext = reinterpret_cast<const WAVEFORMATEXTENSIBLE*>(&wfx);
 
-            wprintf(L" (%hs %u channels, %u-bit, %lu Hz, CMask:%hs)", GetFormatTagName(wfx->wFormatTag), wfx->nChannels, wfx->wBitsPerSample, wfx->nSamplesPerSec, ChannelDesc(wext->dwChannelMask));
+            AppendLog(log, " (%s %u channels, %u-bit, %lu Hz, CMask:%s)", GetFormatTagName(wfx->wFormatTag), wfx->nChannels, wfx->wBitsPerSample, wfx->nSamplesPerSec, ChannelDesc(wext->dwChannelMask));
         }
         else
         {
-            wprintf(L" (%hs %u channels, %u-bit, %lu Hz)", GetFormatTagName(wfx->wFormatTag), wfx->nChannels, wfx->wBitsPerSample, wfx->nSamplesPerSec);
+            AppendLog(log, " (%s %u channels, %u-bit, %lu Hz)", GetFormatTagName(wfx->wFormatTag), wfx->nChannels, wfx->wBitsPerSample, wfx->nSamplesPerSec);
         }
     }
 }
 
-//-------------------------------------------------------------------------------------
-
-extern HRESULT MD5Checksum( _In_reads_(dataSize) const uint8_t *data, size_t dataSize, _Out_bytecap_x_(16) uint8_t *digest );
-
-//-------------------------------------------------------------------------------------
-//
-bool Test01()
+namespace
 {
-    bool success = true;
-
-    size_t ncount = 0;
-    size_t npass = 0;
-
-    for( size_t index=0; index < std::size(g_TestMedia); ++index )
+    // Validates one entry of g_TestMedia, returning true if it passed. Output goes to 'log'.
+    bool TestWaveFile(size_t index, std::string& log)
     {
         wchar_t szPath[MAX_PATH] = {};
-        DWORD ret = ExpandEnvironmentStringsW(g_TestMedia[index].fname, szPath, MAX_PATH);
-        if ( !ret || ret > MAX_PATH )
+        if ( !GetMediaPath(g_TestMedia[index].fname, szPath, MAX_PATH) )
         {
-            printf( "ERROR: ExpandEnvironmentStrings FAILED\n" );
+            AppendLog( log, "ERROR: ExpandEnvironmentStrings FAILED\n" );
             return false;
         }
 
@@ -151,70 +158,94 @@ bool Test01()
         OutputDebugStringA("\n");
 #endif
 
+        auto start = std::chrono::steady_clock::now();
+
         std::unique_ptr<uint8_t[]> wavData;
         WAVData result = {};
         HRESULT hr = LoadWAVAudioFromFileEx(szPath, wavData, result);
+
+        const double parseTime = ElapsedMilliseconds(start);
+
         if ( FAILED(hr) )
         {
             if (hr != HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) && g_TestMedia[index].tag == WAVE_FAIL_CASE)
             {
-                ++npass;
-            }
-            else
-            {
-                success = false;
-                printf( "Failed loading wav from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+                return true;
             }
+
+            AppendLog( log, "Failed loading wav from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+            return false;
         }
-        else if (!result.wfx || !result.startAudio)
+
+        LogTiming( log, szPath, GetMediaFileSize(szPath), parseTime );
+
+        if (!result.wfx || !result.startAudio)
         {
-            success = false;
-            printf( "Bad metadata read from (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+            AppendLog( log, "Bad metadata read from (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+            return false;
         }
-        else if (GetFormatTag(result.wfx) != g_TestMedia[index].tag
-                 || result.wfx->nChannels != g_TestMedia[index].channels
-                 || result.wfx->wBitsPerSample != g_TestMedia[index].bits
-                 || result.wfx->nSamplesPerSec != g_TestMedia[index].rate
-                 || result.seekCount != g_TestMedia[index].seek
-                 || result.loopLength != g_TestMedia[index].loop)
+
+        if (GetFormatTag(result.wfx) != g_TestMedia[index].tag
+            || result.wfx->nChannels != g_TestMedia[index].channels
+            || result.wfx->wBitsPerSample != g_TestMedia[index].bits
+            || result.wfx->nSamplesPerSec != g_TestMedia[index].rate
+            || result.seekCount != g_TestMedia[index].seek
+            || result.loopLength != g_TestMedia[index].loop)
         {
-            success = false;
-            printf( "Metadata error in wav file:\n%ls\n", szPath );
-            printwaveex(result.wfx);
+            AppendLog( log, "Metadata error in wav file:\n%ls\n", szPath );
+            printwaveex(log, result.wfx);
             if (result.seekCount > 0)
             {
-                printf("\nSeekCount = %u\n", result.seekCount);
+                AppendLog(log, "\nSeekCount = %u\n", result.seekCount);
             }
             if (result.loopLength > 0)
             {
-                printf("\nLoop = %u..%u\n", result.loopStart, result.loopLength);
+                AppendLog(log, "\nLoop = %u..%u\n", result.loopStart, result.loopLength);
             }
-            printf("\n");
+            AppendLog(log, "\n");
+            return false;
         }
-        else
+
+        uint8_t digest[16];
+        hr = MD5Checksum( wavData.get(), result.audioBytes, digest );
+        if ( FAILED(hr) )
         {
-            uint8_t digest[16];
-            hr = MD5Checksum( wavData.get(), result.audioBytes, digest );
-            if ( FAILED(hr) )
-            {
-                success = false;
-                printf( "Failed computing MD5 checksum of wave data (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
-            }
-            else if ( memcmp( digest, g_TestMedia[index].md5, 16 ) != 0 )
-            {
-                success = false;
-                printf( "Failed comparing MD5 checksum:\n%ls\n", szPath );
-                printdigest( "computed", digest );
-                printdigest( "expected", g_TestMedia[index].md5 );
-            }
-            else
-                ++npass;
+            AppendLog( log, "Failed computing MD5 checksum of wave data (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+            return false;
+        }
+        else if ( memcmp( digest, g_TestMedia[index].md5, 16 ) != 0 )
+        {
+            AppendLog( log, "Failed comparing MD5 checksum:\n%ls\n", szPath );
+            printdigest( log, "computed", digest );
+            printdigest( log, "expected", g_TestMedia[index].md5 );
+            return false;
         }
 
-        ++ncount;
+        return true;
     }
+}
+
+//-------------------------------------------------------------------------------------
+//
+bool Test01()
+{
+    const size_t ncount = std::size(g_TestMedia);
+
+    std::vector<std::string> logs(ncount);
+    std::unique_ptr<bool[]> passed(new bool[ncount]());
+
+    auto start = std::chrono::steady_clock::now();
+
+    ParallelForEach(ncount, [&](size_t index)
+        {
+            passed[index] = TestWaveFile(index, logs[index]);
+        });
+
+    FlushLogs(logs, ElapsedMilliseconds(start));
+
+    const size_t npass = static_cast<size_t>(std::count(passed.get(), passed.get() + ncount, true));
 
     printf("%zu files tested, %zu files passed ", ncount, npass );
 
-    return success;
+    return (npass == ncount);
 }
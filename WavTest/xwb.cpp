@@ -15,15 +15,36 @@
 #pragma warning(pop)
 
 #include <Windows.h>
+#include <psapi.h>
 
 #include "WaveBankReader.h"
+#include "WaveBankBatchReader.h"
+#include "WaveBankMapping.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
+#include <string>
 #include <tuple>
+#include <vector>
 
 using namespace DirectX;
 
+//-------------------------------------------------------------------------------------
+
+extern HRESULT MD5Checksum( _In_reads_(dataSize) const uint8_t *data, size_t dataSize, _Out_bytecap_x_(16) uint8_t *digest );
+extern void ParallelForEach(size_t count, const std::function<void(size_t)>& func);
+extern void AppendLog(std::string& log, _In_z_ _Printf_format_string_ const char* format, ...);
+extern bool GetMediaPath(_In_z_ const wchar_t* fname, _Out_writes_(count) wchar_t* path, size_t count);
+extern uint64_t GetMediaFileSize(_In_z_ const wchar_t* path);
+extern double ElapsedMilliseconds(std::chrono::steady_clock::time_point start);
+extern void LogTiming(std::string& log, _In_z_ const wchar_t* fname, uint64_t fileBytes, double parseTime);
+extern void FlushLogs(const std::vector<std::string>& logs, double wallTime);
+
 namespace
 {
     struct TestMedia
@@ -53,7 +74,7 @@ namespace
         { true, 3, 667648, L"StreamingAudioTest\\WaveBankxWMA4Kn.xwb", {0x75,0x3f,0x19,0xa5,0x28,0x07,0xd5,0xda,0xe9,0x83,0xa0,0xc2,0x18,0x11,0xaf,0xbd} },
     };
 
-#define printdigest(str,digest) printf( "%s:\n0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x\n", str, \
+#define printdigest(log,str,digest) AppendLog( log, "%s:\n0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x,0x%02x\n", str, \
                                        digest[0], digest[1], digest[2], digest[3], digest[4], digest[5], digest[6], digest[7], \
                                        digest[8], digest[9], digest[10], digest[11], digest[12], digest[13], digest[14], digest[15] );
 
@@ -69,26 +90,63 @@ namespace
     }
 }
 
-//-------------------------------------------------------------------------------------
+namespace
+{
+    // Reads a streaming entry the way the streaming voices do: one aligned read at the entry's offset
+    HRESULT ReadStreamingData(
+        WaveBankReader& wb,
+        uint32_t offset,
+        _Out_writes_bytes_(readLength) uint8_t* wavData,
+        uint32_t readLength)
+    {
+        HANDLE async = wb.GetAsyncHandle();
 
-extern HRESULT MD5Checksum( _In_reads_(dataSize) const uint8_t *data, size_t dataSize, _Out_bytecap_x_(16) uint8_t *digest );
+        OVERLAPPED request = {};
+        request.hEvent = CreateEventEx(nullptr, nullptr, 0, EVENT_MODIFY_STATE | SYNCHRONIZE);
+        if (!request.hEvent)
+            return HRESULT_FROM_WIN32(GetLastError());
 
-//-------------------------------------------------------------------------------------
-// 
-bool Test02()
-{
-    bool success = true;
+        request.Offset = offset;
 
-    size_t ncount = 0;
-    size_t npass = 0;
+        HRESULT hr = S_OK;
+        if (!ReadFile(async, wavData, readLength, nullptr, &request))
+        {
+            const DWORD error = GetLastError();
+            if (error != ERROR_IO_PENDING)
+            {
+                hr = HRESULT_FROM_WIN32(error);
+            }
+        }
 
-    for( size_t index=0; index < std::size(g_TestMedia); ++index )
+        if (SUCCEEDED(hr))
+        {
+            std::ignore = WaitForSingleObject(request.hEvent, INFINITE);
+
+            DWORD cb = 0;
+            #if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+                const BOOL result = GetOverlappedResultEx(async, &request, &cb, 0, FALSE);
+            #else
+                const BOOL result = GetOverlappedResult(async, &request, &cb, FALSE);
+            #endif
+
+            if (!result)
+            {
+                hr = HRESULT_FROM_WIN32(GetLastError());
+            }
+        }
+
+        CloseHandle(request.hEvent);
+
+        return hr;
+    }
+
+    // Validates one entry of g_TestMedia, returning true if it passed. Output goes to 'log'.
+    bool TestWaveBank(size_t index, std::string& log)
     {
         wchar_t szPath[MAX_PATH] = {};
-        DWORD ret = ExpandEnvironmentStringsW(g_TestMedia[index].fname, szPath, MAX_PATH);
-        if ( !ret || ret > MAX_PATH )
+        if ( !GetMediaPath(g_TestMedia[index].fname, szPath, MAX_PATH) )
         {
-            printf( "ERROR: ExpandEnvironmentStrings FAILED\n" );
+            AppendLog( log, "ERROR: ExpandEnvironmentStrings FAILED\n" );
             return false;
         }
 
@@ -97,147 +155,558 @@ bool Test02()
         OutputDebugStringA("\n");
 #endif
 
+        auto start = std::chrono::steady_clock::now();
+
         auto wb = std::make_unique<DirectX::WaveBankReader>();
         HRESULT hr = wb->Open(szPath);
         if ( FAILED(hr) )
         {
-            success = false;
-            printf( "Failed loading wavebank from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+            AppendLog( log, "Failed loading wavebank from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+            return false;
+        }
+
+        wb->WaitOnPrepare();
+
+        LogTiming( log, szPath, GetMediaFileSize(szPath), ElapsedMilliseconds(start) );
+
+        if (wb->Count() != g_TestMedia[index].entries
+            || wb->IsStreamingBank() != g_TestMedia[index].streaming
+            || wb->BankAudioSize() != g_TestMedia[index].audioBytes)
+        {
+            AppendLog( log, "Metadata error in wavebank file:\n%ls\n%u entries   %u audioBytes\n", szPath, wb->Count(), wb->BankAudioSize() );
+            return false;
+        }
+
+        const uint8_t* wavData = nullptr;
+        uint32_t audioBytes = 0;
+        std::unique_ptr<uint8_t[]> streamData;
+
+        if (wb->IsStreamingBank())
+        {
+            WaveBankReader::Metadata metadata;
+            hr = wb->GetMetadata(0, metadata);
+            if ( FAILED(hr) )
+            {
+                AppendLog( log, "Failed get wave metadata for entry 0 (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+                return false;
+            }
+            else if (!metadata.duration || !metadata.offsetBytes || !metadata.lengthBytes)
+            {
+                AppendLog( log, "Metadata error in wavebank entry:\n%ls\n%u duration  %u offset  %u length\n", szPath,
+                    metadata.duration, metadata.offsetBytes, metadata.lengthBytes);
+                return false;
+            }
+
+            const uint32_t readLength = AlignUp(metadata.lengthBytes, 4096);
+            streamData = std::make_unique<uint8_t[]>(readLength);
+
+            hr = ReadStreamingData(*wb, metadata.offsetBytes, streamData.get(), readLength);
+            if ( FAILED(hr) )
+            {
+                AppendLog( log, "ERROR: Async read failed %08X:\n%ls\n%u duration  %u offset  %u length\n",
+                    static_cast<unsigned int>(hr),
+                    szPath,
+                    metadata.duration, metadata.offsetBytes, metadata.lengthBytes);
+                return false;
+            }
+
+            wavData = streamData.get();
+            audioBytes = metadata.lengthBytes;
         }
         else
         {
-            wb->WaitOnPrepare();
-            if (wb->Count() != g_TestMedia[index].entries
-                || wb->IsStreamingBank() != g_TestMedia[index].streaming
-                || wb->BankAudioSize() != g_TestMedia[index].audioBytes)
+            hr = wb->GetWaveData(0, &wavData, audioBytes);
+            if ( FAILED(hr) )
             {
-                success = false;
-                printf( "Metadata error in wavebank file:\n%ls\n%u entries   %u audioBytes\n", szPath, wb->Count(), wb->BankAudioSize() );
+                AppendLog( log, "Failed get wave data for entry 0 (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+                return false;
+            }
+        }
+
+        uint8_t digest[16];
+        hr = MD5Checksum( wavData, audioBytes, digest );
+        if ( FAILED(hr) )
+        {
+            AppendLog( log, "Failed computing MD5 checksum of wavebank (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+            return false;
+        }
+        else if ( memcmp( digest, g_TestMedia[index].md5, 16 ) != 0 )
+        {
+            AppendLog( log, "Failed comparing MD5 checksum:\n%ls\n", szPath );
+            printdigest( log, "computed", digest );
+            printdigest( log, "expected", g_TestMedia[index].md5 );
+            return false;
+        }
+
+        return true;
+    }
+
+    // Streams every entry of a g_TestMedia streaming bank through WaveBankBatchReader, checking
+    // each against a single synchronous read and entry 0 against the expected MD5.
+    bool TestWaveBankBatch(size_t index, std::string& log)
+    {
+        wchar_t szPath[MAX_PATH] = {};
+        if ( !GetMediaPath(g_TestMedia[index].fname, szPath, MAX_PATH) )
+        {
+            AppendLog( log, "ERROR: ExpandEnvironmentStrings FAILED\n" );
+            return false;
+        }
+
+        auto wb = std::make_unique<DirectX::WaveBankReader>();
+        HRESULT hr = wb->Open(szPath);
+        if ( FAILED(hr) )
+        {
+            AppendLog( log, "Failed loading wavebank from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+            return false;
+        }
+
+        wb->WaitOnPrepare();
+
+        const uint32_t nentries = wb->Count();
+
+        // Reference digests from one read per entry
+        std::vector<uint8_t> expected(size_t(nentries) * 16);
+        for (uint32_t j = 0; j < nentries; ++j)
+        {
+            WaveBankReader::Metadata metadata;
+            hr = wb->GetMetadata(j, metadata);
+            if ( FAILED(hr) )
+            {
+                AppendLog( log, "Failed get wave metadata for entry %u (HRESULT %08X):\n%ls\n", j, static_cast<unsigned int>(hr), szPath );
+                return false;
             }
-            else if (wb->IsStreamingBank())
+
+            const uint32_t readLength = AlignUp(metadata.lengthBytes, 4096);
+            auto streamData = std::make_unique<uint8_t[]>(readLength);
+
+            hr = ReadStreamingData(*wb, metadata.offsetBytes, streamData.get(), readLength);
+            if ( SUCCEEDED(hr) )
             {
-                WaveBankReader::Metadata metadata;
-                hr = wb->GetMetadata(0, metadata);
-                if ( FAILED(hr) )
-                {
-                    success = false;
-                    printf( "Failed get wave metadata for entry 0 (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
-                }
-                else if (!metadata.duration || !metadata.offsetBytes || !metadata.lengthBytes)
-                {
-                    success = false;
-                    printf( "Metadata error in wavebank entry:\n%ls\n%u duration  %u offset  %u length\n", szPath,
-                        metadata.duration, metadata.offsetBytes, metadata.lengthBytes);
-                }
-                else
-                {
-                    size_t memSize = AlignUp(metadata.lengthBytes, 4096);
-                    auto wavData = std::make_unique<uint8_t[]>(memSize);
+                hr = MD5Checksum( streamData.get(), metadata.lengthBytes, &expected[size_t(j) * 16] );
+            }
+
+            if ( FAILED(hr) )
+            {
+                AppendLog( log, "ERROR: Reference read of entry %u failed %08X:\n%ls\n", j, static_cast<unsigned int>(hr), szPath );
+                return false;
+            }
+        }
+
+        if ( memcmp( expected.data(), g_TestMedia[index].md5, 16 ) != 0 )
+        {
+            AppendLog( log, "Failed comparing MD5 checksum:\n%ls\n", szPath );
+            printdigest( log, "computed", expected.data() );
+            printdigest( log, "expected", g_TestMedia[index].md5 );
+            return false;
+        }
+
+        // Back to front, with entry 0 repeated, so the reader has to sort and merge
+        std::vector<uint32_t> indices;
+        for (uint32_t j = nentries; j > 0; --j)
+        {
+            indices.push_back(j - 1);
+        }
+        indices.push_back(0);
+
+        bool success = true;
+
+        // Queue depth, and a read size limit with and without coalescing. Depths beyond
+        // MAXIMUM_WAIT_OBJECTS are clamped.
+        const std::pair<size_t, uint32_t> configs[] =
+        {
+            { 1, WaveBankBatchReader::c_ReadAlignment },
+            { 4, WaveBankBatchReader::c_ReadAlignment },
+            { 1, WaveBankBatchReader::c_DefaultMaxReadSize },
+            { 4, WaveBankBatchReader::c_DefaultMaxReadSize },
+            { 256, WaveBankBatchReader::c_ReadAlignment },
+        };
+
+        for (const auto& config : configs)
+        {
+            WaveBankBatchReader reader(*wb, config.first, config.second);
 
-                    HANDLE async = wb->GetAsyncHandle();
+            if (reader.GetQueueDepth() != std::min<size_t>(config.first, MAXIMUM_WAIT_OBJECTS))
+            {
+                AppendLog( log, "ERROR: Queue depth %zu was not clamped (got %zu)\n", config.first, reader.GetQueueDepth() );
+                success = false;
+            }
 
-                    OVERLAPPED request = {};
-                    request.hEvent = CreateEventEx(nullptr, nullptr, 0, EVENT_MODIFY_STATE | SYNCHRONIZE);
-                    request.Offset = metadata.offsetBytes;
+            std::vector<uint32_t> calls(nentries);
+            bool entriesOk = true;
 
-                    bool pass = true;
-                    uint32_t readLength = AlignUp(metadata.lengthBytes, 4096);
-                    if (!ReadFile(async, wavData.get(), readLength, nullptr, &request))
+            hr = reader.ReadEntries(indices.data(), indices.size(),
+                [&](uint32_t entry, HRESULT hrEntry, const uint8_t* data, uint32_t audioBytes)
+                {
+                    if (entry >= nentries)
                     {
-                        const DWORD error = GetLastError();
-                        if (error != ERROR_IO_PENDING)
-                        {
-                            success = false;
-                            pass = false;
-                            printf( "ERROR: Async read failed %08X:\n%ls\n%u duration  %u offset  %u length\n",
-                                static_cast<unsigned int>(HRESULT_FROM_WIN32(error)),
-                                szPath,
-                                metadata.duration, metadata.offsetBytes, metadata.lengthBytes);
-                        }
+                        AppendLog( log, "ERROR: Callback for unexpected entry %u (queue depth %zu):\n%ls\n", entry, config.first, szPath );
+                        entriesOk = false;
+                        return;
                     }
 
-                    if (pass)
+                    ++calls[entry];
+
+                    uint8_t digest[16] = {};
+                    if ( SUCCEEDED(hrEntry) )
                     {
-                        std::ignore = WaitForSingleObject(request.hEvent, INFINITE);
-
-                        DWORD cb = 0;
-                        #if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
-                            const BOOL result = GetOverlappedResultEx(async, &request, &cb, 0, FALSE);
-                        #else
-                            const BOOL result = GetOverlappedResult(async, &request, &cb, FALSE);
-                        #endif
-
-                        if (!result)
-                        {
-                            success = false;
-                            pass = false;
-                            const DWORD error = GetLastError();
-                            printf("ERROR: Async read failed %08X\n", static_cast<unsigned int>(HRESULT_FROM_WIN32(error)));
-                        }
+                        hrEntry = MD5Checksum( data, audioBytes, digest );
                     }
 
-                    if (pass)
+                    if ( FAILED(hrEntry) )
                     {
-                        uint8_t digest[16];
-                        hr = MD5Checksum( wavData.get(), metadata.lengthBytes, digest );
-                        if ( FAILED(hr) )
-                        {
-                            success = false;
-                            pass = false;
-                            printf( "Failed computing MD5 checksum of wavebank (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
-                        }
-                        else if ( memcmp( digest, g_TestMedia[index].md5, 16 ) != 0 )
-                        {
-                            success = false;
-                            pass = false;
-                            printf( "Failed comparing MD5 checksum:\n%ls\n", szPath );
-                            printdigest( "computed", digest );
-                            printdigest( "expected", g_TestMedia[index].md5 );
-                        }
+                        AppendLog( log, "ERROR: Batched read of entry %u failed %08X (queue depth %zu):\n%ls\n",
+                            entry, static_cast<unsigned int>(hrEntry), config.first, szPath );
+                        entriesOk = false;
                     }
+                    else if ( memcmp( digest, &expected[size_t(entry) * 16], 16 ) != 0 )
+                    {
+                        AppendLog( log, "Failed comparing MD5 checksum of entry %u (queue depth %zu, max read %u):\n%ls\n",
+                            entry, config.first, config.second, szPath );
+                        printdigest( log, "computed", digest );
+                        printdigest( log, "expected", (&expected[size_t(entry) * 16]) );
+                        entriesOk = false;
+                    }
+                });
 
-                    CloseHandle(request.hEvent);
-
-                    if (pass)
-                        ++npass;
-                }
+            if ( FAILED(hr) || !entriesOk )
+            {
+                AppendLog( log, "ERROR: Batched read failed %08X (queue depth %zu, max read %u):\n%ls\n",
+                    static_cast<unsigned int>(hr), config.first, config.second, szPath );
+                success = false;
+                continue;
             }
-            else
+
+            for (uint32_t j = 0; j < nentries; ++j)
             {
-                const uint8_t* wavData = nullptr;
-                uint32_t audioBytes = 0;
-                hr = wb->GetWaveData(0, &wavData, audioBytes);
-                if ( FAILED(hr) )
+                const uint32_t want = (j == 0) ? 2u : 1u;
+                if (calls[j] != want)
                 {
+                    AppendLog( log, "ERROR: Entry %u completed %u times, expected %u (queue depth %zu):\n%ls\n",
+                        j, calls[j], want, config.first, szPath );
                     success = false;
-                    printf( "Failed get wave data for entry 0 (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
                 }
-                else
-                {                
-                    uint8_t digest[16];
-                    hr = MD5Checksum( wavData, audioBytes, digest );
-                    if ( FAILED(hr) )
-                    {
-                        success = false;
-                        printf( "Failed computing MD5 checksum of wavebank (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
-                    }
-                    else if ( memcmp( digest, g_TestMedia[index].md5, 16 ) != 0 )
+            }
+
+            if (reader.GetReadCount() == 0 || reader.GetReadCount() > indices.size())
+            {
+                AppendLog( log, "ERROR: Unexpected read count %zu for %zu entries:\n%ls\n",
+                    reader.GetReadCount(), indices.size(), szPath );
+                success = false;
+            }
+        }
+
+        // A bad index fails its own callback without affecting the rest
+        {
+            WaveBankBatchReader reader(*wb);
+
+            const uint32_t badIndices[] = { 0, nentries };
+            size_t failures = 0;
+            size_t completions = 0;
+            hr = reader.ReadEntries(badIndices, std::size(badIndices),
+                [&](uint32_t, HRESULT hrEntry, const uint8_t*, uint32_t)
+                {
+                    ++completions;
+                    if (FAILED(hrEntry))
+                        ++failures;
+                });
+
+            if ( SUCCEEDED(hr) || completions != 2 || failures != 1 )
+            {
+                AppendLog( log, "ERROR: Expected failure for invalid entry (HRESULT %08X, %zu completions, %zu failures):\n%ls\n",
+                    static_cast<unsigned int>(hr), completions, failures, szPath );
+                success = false;
+            }
+        }
+
+        // A throwing callback stops the batch with reads still in flight, and the reader stays usable
+        {
+            WaveBankBatchReader reader(*wb, MAXIMUM_WAIT_OBJECTS, WaveBankBatchReader::c_ReadAlignment);
+
+            bool thrown = false;
+            try
+            {
+                std::ignore = reader.ReadEntries(indices.data(), indices.size(),
+                    [](uint32_t, HRESULT, const uint8_t*, uint32_t)
                     {
-                        success = false;
-                        printf( "Failed comparing MD5 checksum:\n%ls\n", szPath );
-                        printdigest( "computed", digest );
-                        printdigest( "expected", g_TestMedia[index].md5 );
-                    }
-                    else
-                        ++npass;
-                }
+                        throw std::runtime_error("callback failure");
+                    });
+            }
+            catch (const std::runtime_error&)
+            {
+                thrown = true;
+            }
+
+            size_t completions = 0;
+            hr = reader.ReadEntries(indices.data(), indices.size(),
+                [&](uint32_t, HRESULT hrEntry, const uint8_t*, uint32_t)
+                {
+                    if (SUCCEEDED(hrEntry))
+                        ++completions;
+                });
+
+            if ( !thrown || FAILED(hr) || completions != indices.size() )
+            {
+                AppendLog( log, "ERROR: Batched read after a throwing callback failed (HRESULT %08X, %zu of %zu completions):\n%ls\n",
+                    static_cast<unsigned int>(hr), completions, indices.size(), szPath );
+                success = false;
+            }
+        }
+
+        return success;
+    }
+
+    // Resident memory of the whole process, in bytes
+    uint64_t GetResidentMemory()
+    {
+        PROCESS_MEMORY_COUNTERS counters = {};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return 0;
+
+        return counters.WorkingSetSize;
+    }
+
+    inline int64_t ResidentDelta(uint64_t before, uint64_t after) noexcept
+    {
+        return (static_cast<int64_t>(after) - static_cast<int64_t>(before)) / 1024;
+    }
+
+    // Checks that every entry of a g_TestMedia in-memory bank reads the same through a file mapping
+    // as through WaveBankReader's copy, and reports what each costs in resident memory. The mapping
+    // is read first, without any reader open.
+    bool TestWaveBankMapping(size_t index, std::string& log)
+    {
+        wchar_t szPath[MAX_PATH] = {};
+        if ( !GetMediaPath(g_TestMedia[index].fname, szPath, MAX_PATH) )
+        {
+            AppendLog( log, "ERROR: ExpandEnvironmentStrings FAILED\n" );
+            return false;
+        }
+
+        WaveBankMapping mapping;
+
+        {
+            const uint8_t* wavData = nullptr;
+            uint32_t audioBytes = 0;
+            HRESULT hr = mapping.GetWaveData(0, &wavData, audioBytes);
+            if ( SUCCEEDED(hr) || wavData )
+            {
+                AppendLog( log, "ERROR: Expected failure reading an unopened mapping (HRESULT %08X)\n", static_cast<unsigned int>(hr) );
+                return false;
+            }
+        }
+
+        const uint64_t baseline = GetResidentMemory();
+
+        HRESULT hr = mapping.Open(szPath);
+        if ( FAILED(hr) )
+        {
+            AppendLog( log, "Failed mapping wavebank file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+            return false;
+        }
+
+        const uint64_t mapped = GetResidentMemory();
+
+        const uint32_t nentries = mapping.Count();
+        if ( nentries != g_TestMedia[index].entries || mapping.IsStreamingBank() )
+        {
+            AppendLog( log, "ERROR: Unexpected mapped wavebank (%u entries, %s):\n%ls\n",
+                nentries, mapping.IsStreamingBank() ? "streaming" : "in-memory", szPath );
+            return false;
+        }
+
+        bool success = true;
+
+        std::vector<uint8_t> digests(size_t(nentries) * 16);
+        for (uint32_t j = 0; j < nentries; ++j)
+        {
+            const uint8_t* wavData = nullptr;
+            uint32_t audioBytes = 0;
+            hr = mapping.GetWaveData(j, &wavData, audioBytes);
+            if ( FAILED(hr) )
+            {
+                AppendLog( log, "Failed get mapped wave data for entry %u (HRESULT %08X):\n%ls\n", j, static_cast<unsigned int>(hr), szPath );
+                success = false;
+                continue;
+            }
+
+            if ( wavData < mapping.GetData() || (wavData + audioBytes) > (mapping.GetData() + mapping.GetSize()) )
+            {
+                AppendLog( log, "ERROR: Mapped wave data for entry %u is outside the mapping:\n%ls\n", j, szPath );
+                success = false;
+                continue;
+            }
+
+            hr = MD5Checksum( wavData, audioBytes, &digests[size_t(j) * 16] );
+            if ( FAILED(hr) )
+            {
+                AppendLog( log, "Failed computing MD5 checksum of wavebank (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+                success = false;
+            }
+            else if ( j == 0 && memcmp( digests.data(), g_TestMedia[index].md5, 16 ) != 0 )
+            {
+                AppendLog( log, "Failed comparing MD5 checksum:\n%ls\n", szPath );
+                printdigest( log, "computed", digests.data() );
+                printdigest( log, "expected", g_TestMedia[index].md5 );
+                success = false;
+            }
+        }
+
+        {
+            const uint8_t* wavData = nullptr;
+            uint32_t audioBytes = 0;
+            hr = mapping.GetWaveData(nentries, &wavData, audioBytes);
+            if ( SUCCEEDED(hr) || wavData || audioBytes )
+            {
+                AppendLog( log, "ERROR: Expected failure for invalid mapped entry (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+                success = false;
+            }
+        }
+
+        const uint64_t touched = GetResidentMemory();
+
+        // WaveBankReader's copy of the same bank is the reference
+        auto wb = std::make_unique<DirectX::WaveBankReader>();
+        hr = wb->Open(szPath);
+        if ( FAILED(hr) )
+        {
+            AppendLog( log, "Failed loading wavebank from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), szPath );
+            return false;
+        }
+
+        wb->WaitOnPrepare();
+
+        const uint64_t copied = GetResidentMemory();
+
+        if ( wb->Count() != nentries || wb->BankAudioSize() != mapping.BankAudioSize() )
+        {
+            AppendLog( log, "ERROR: Mapped wavebank differs from WaveBankReader (%u vs. %u entries, %u vs. %u audio bytes):\n%ls\n",
+                nentries, wb->Count(), mapping.BankAudioSize(), wb->BankAudioSize(), szPath );
+            return false;
+        }
+
+        for (uint32_t j = 0; j < nentries; ++j)
+        {
+            const uint8_t* wavData = nullptr;
+            uint32_t audioBytes = 0;
+            uint8_t digest[16] = {};
+            hr = wb->GetWaveData(j, &wavData, audioBytes);
+            if ( SUCCEEDED(hr) )
+            {
+                hr = MD5Checksum( wavData, audioBytes, digest );
+            }
+
+            if ( FAILED(hr) )
+            {
+                AppendLog( log, "Failed get wave data for entry %u (HRESULT %08X):\n%ls\n", j, static_cast<unsigned int>(hr), szPath );
+                success = false;
+            }
+            else if ( memcmp( digest, &digests[size_t(j) * 16], 16 ) != 0 )
+            {
+                AppendLog( log, "Failed comparing mapped MD5 checksum of entry %u:\n%ls\n", j, szPath );
+                printdigest( log, "computed", (&digests[size_t(j) * 16]) );
+                printdigest( log, "expected", digest );
+                success = false;
             }
         }
 
-        ++ncount;
+        AppendLog( log, "%ls: %u KB audio, resident KB: mapped %+lld, mapped and read %+lld, copy %+lld\n",
+            szPath,
+            mapping.BankAudioSize() / 1024,
+            static_cast<long long>(ResidentDelta(baseline, mapped)),
+            static_cast<long long>(ResidentDelta(baseline, touched)),
+            static_cast<long long>(ResidentDelta(touched, copied)) );
+
+        return success;
+    }
+}
+
+//-------------------------------------------------------------------------------------
+// 
+bool Test02()
+{
+    const size_t ncount = std::size(g_TestMedia);
+
+    std::vector<std::string> logs(ncount);
+    std::unique_ptr<bool[]> passed(new bool[ncount]());
+
+    auto start = std::chrono::steady_clock::now();
+
+    ParallelForEach(ncount, [&](size_t index)
+        {
+            passed[index] = TestWaveBank(index, logs[index]);
+        });
+
+    FlushLogs(logs, ElapsedMilliseconds(start));
+
+    const size_t npass = static_cast<size_t>(std::count(passed.get(), passed.get() + ncount, true));
+
+    printf("%zu files tested, %zu files passed ", ncount, npass );
+
+    return (npass == ncount);
+}
+
+
+//-------------------------------------------------------------------------------------
+// 
+bool Test04()
+{
+    std::vector<size_t> streaming;
+    for (size_t index = 0; index < std::size(g_TestMedia); ++index)
+    {
+        if (g_TestMedia[index].streaming)
+            streaming.push_back(index);
     }
 
+    const size_t ncount = streaming.size();
+
+    std::vector<std::string> logs(ncount);
+    std::unique_ptr<bool[]> passed(new bool[ncount]());
+
+    auto start = std::chrono::steady_clock::now();
+
+    ParallelForEach(ncount, [&](size_t index)
+        {
+            passed[index] = TestWaveBankBatch(streaming[index], logs[index]);
+        });
+
+    FlushLogs(logs, ElapsedMilliseconds(start));
+
+    const size_t npass = static_cast<size_t>(std::count(passed.get(), passed.get() + ncount, true));
+
+    printf("%zu files tested, %zu files passed ", ncount, npass );
+
+    return (npass == ncount);
+}
+
+
+//-------------------------------------------------------------------------------------
+// 
+bool Test05()
+{
+    std::vector<size_t> inMemory;
+    for (size_t index = 0; index < std::size(g_TestMedia); ++index)
+    {
+        if (!g_TestMedia[index].streaming)
+            inMemory.push_back(index);
+    }
+
+    const size_t ncount = inMemory.size();
+
+    std::vector<std::string> logs(ncount);
+    size_t npass = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Serial, since the resident memory figures are for the whole process
+    for (size_t index = 0; index < ncount; ++index)
+    {
+        if (TestWaveBankMapping(inMemory[index], logs[index]))
+            ++npass;
+    }
+
+    FlushLogs(logs, ElapsedMilliseconds(start));
+
     printf("%zu files tested, %zu files passed ", ncount, npass );
 
-    return success;
+    return (npass == ncount);
 }
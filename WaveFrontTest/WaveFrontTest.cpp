@@ -0,0 +1,302 @@
+//-------------------------------------------------------------------------------------
+// WaveFrontTest.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include "WaveFrontReader.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+//-------------------------------------------------------------------------------------
+// Types and globals
+
+using TestFN = bool (*)();
+
+struct TestInfo
+{
+    const char *name;
+    TestFN func;
+};
+
+extern bool Test01();
+extern bool Test02();
+extern bool Test03();
+extern bool Test04();
+extern bool Test05();
+extern bool Test06();
+extern bool Test07();
+extern bool Benchmark01();
+extern bool Benchmark02();
+extern bool Benchmark03();
+extern bool Benchmark04();
+extern bool Benchmark05();
+
+TestInfo g_Tests[] =
+{
+    { "WaveFrontReader", Test01 },
+    { "WaveFrontReader (mapped)", Test02 },
+    { "WaveFrontReader (parallel)", Test03 },
+    { "VertexCache", Test04 },
+    { "WaveFrontReader (binary cache)", Test05 },
+    { "WaveFrontReader (streaming)", Test06 },
+    { "MeshOptimizer", Test07 },
+};
+
+TestInfo g_Benchmarks[] =
+{
+    { "WaveFrontReader load throughput", Benchmark01 },
+    { "WaveFrontReader parallel scaling", Benchmark02 },
+    { "VertexCache welding throughput", Benchmark03 },
+    { "WaveFrontReader binary cache load", Benchmark04 },
+    { "MeshOptimizer post-processing", Benchmark05 },
+};
+
+
+//-------------------------------------------------------------------------------------
+bool RunTests(const TestInfo* tests, size_t count)
+{
+    size_t nPass = 0;
+    size_t nFail = 0;
+
+    for(size_t i=0; i < count; ++i)
+    {
+        printf("%s: ", tests[i].name );
+
+        if ( tests[i].func() )
+        {
+            ++nPass;
+            printf("PASS\n");
+        }
+        else
+        {
+            ++nFail;
+            printf("FAIL\n");
+        }
+    }
+
+    printf("Ran %zu tests, %zu pass, %zu fail\n", nPass+nFail, nPass, nFail);
+
+    return (nFail == 0);
+}
+
+
+//-------------------------------------------------------------------------------------
+#ifdef _WIN32
+int __cdecl wmain(int argc, wchar_t* argv[])
+#else
+int main(int argc, char* argv[])
+#endif
+{
+    printf("**************************************************************\n");
+    printf("*** WaveFrontTest\n" );
+    printf("**************************************************************\n");
+
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i)
+    {
+#ifdef _WIN32
+        if (!_wcsicmp(argv[i], L"-bench"))
+#else
+        if (!strcmp(argv[i], "-bench"))
+#endif
+        {
+            benchmark = true;
+        }
+    }
+
+    if (benchmark)
+    {
+        if ( !RunTests(g_Benchmarks, std::size(g_Benchmarks)) )
+            return -1;
+    }
+    else if ( !RunTests(g_Tests, std::size(g_Tests)) )
+        return -1;
+
+    return 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Writes a procedural grid mesh that exercises the common OBJ statement forms
+bool WriteSyntheticOBJ(const std::filesystem::path& path, uint32_t gridSize)
+{
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out)
+        return false;
+
+    char buff[256] = {};
+
+    out << "# Synthetic WaveFront OBJ for WaveFrontTest\n";
+    out << "o synthetic\n";
+
+    const uint32_t count = gridSize + 1;
+    for (uint32_t y = 0; y < count; ++y)
+    {
+        for (uint32_t x = 0; x < count; ++x)
+        {
+            const float fx = float(x) / float(gridSize) - 0.5f;
+            const float fy = float(y) / float(gridSize) - 0.5f;
+            const float fz = 0.25f * std::sin(fx * 6.2831853f) * std::cos(fy * 6.2831853f);
+
+            if ((x + y) % 7)
+            {
+                snprintf(buff, sizeof(buff), "v %.6f %.6f %.6f\n", double(fx), double(fy), double(fz));
+            }
+            else
+            {
+                snprintf(buff, sizeof(buff), "v %e %.9g %g\n", double(fx), double(fy), double(fz) * 1e-9);
+            }
+            out << buff;
+
+            snprintf(buff, sizeof(buff), "vt %.5f %.5f\n", double(x) / double(gridSize), double(y) / double(gridSize));
+            out << buff;
+
+            snprintf(buff, sizeof(buff), "vn %.7f %.7f %.7f\n", double(-fz), double(fx * 0.5f), 1.0);
+            out << buff;
+        }
+    }
+
+    static const char* s_materials[] = { "red", "green", "blue" };
+
+    for (uint32_t y = 0; y < gridSize; ++y)
+    {
+        if (!(y % 16))
+        {
+            out << "g row" << y << "\nusemtl " << s_materials[(y / 16) % std::size(s_materials)] << "\n";
+        }
+
+        for (uint32_t x = 0; x < gridSize; ++x)
+        {
+            const uint32_t i0 = y * count + x + 1;
+            const uint32_t i1 = i0 + 1;
+            const uint32_t i2 = i0 + count + 1;
+            const uint32_t i3 = i0 + count;
+
+            switch ((x + y) % 4)
+            {
+            case 0:
+                // Quad with full position/texcoord/normal indices
+                snprintf(buff, sizeof(buff), "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n", i0, i0, i0, i1, i1, i1, i2, i2, i2, i3, i3, i3);
+                break;
+
+            case 1:
+                // Two triangles with position//normal
+                snprintf(buff, sizeof(buff), "f %u//%u %u//%u %u//%u\nf %u//%u %u//%u %u//%u\n", i0, i0, i1, i1, i2, i2, i0, i0, i2, i2, i3, i3);
+                break;
+
+            case 2:
+                // Quad with position/texcoord
+                snprintf(buff, sizeof(buff), "f %u/%u %u/%u %u/%u %u/%u\n", i0, i0, i1, i1, i2, i2, i3, i3);
+                break;
+
+            default:
+                // Triangle fan using position-only indices, then a comment
+                snprintf(buff, sizeof(buff), "f  %u %u\t%u %u  # fan\n", i0, i1, i2, i3);
+                break;
+            }
+            out << buff;
+        }
+    }
+
+    // Trailing face using negative (relative) indices
+    out << "f -1/-1/-1 -2/-2/-2 -" << (count + 1) << "/-" << (count + 1) << "/-" << (count + 1) << "\n";
+
+    out.close();
+    return !out.fail();
+}
+
+
+//-------------------------------------------------------------------------------------
+// Returns true if both readers hold byte-identical results
+template<class index_t>
+bool CompareResults(const WaveFrontReader<index_t>& a, const WaveFrontReader<index_t>& b)
+{
+    if (a.vertices.size() != b.vertices.size()
+        || a.indices.size() != b.indices.size()
+        || a.attributes.size() != b.attributes.size()
+        || a.materials.size() != b.materials.size())
+    {
+        printf("ERROR: Size mismatch (%zu, %zu, %zu, %zu) vs. (%zu, %zu, %zu, %zu)\n",
+            a.vertices.size(), a.indices.size(), a.attributes.size(), a.materials.size(),
+            b.vertices.size(), b.indices.size(), b.attributes.size(), b.materials.size());
+        return false;
+    }
+
+    if (a.hasNormals != b.hasNormals || a.hasTexcoords != b.hasTexcoords || a.name != b.name)
+    {
+        printf("ERROR: Metadata mismatch\n");
+        return false;
+    }
+
+    if (!a.vertices.empty() && memcmp(a.vertices.data(), b.vertices.data(), sizeof(typename WaveFrontReader<index_t>::Vertex) * a.vertices.size()) != 0)
+    {
+        printf("ERROR: Vertex data mismatch\n");
+        return false;
+    }
+
+    if (a.indices != b.indices)
+    {
+        printf("ERROR: Index data mismatch\n");
+        return false;
+    }
+
+    if (a.attributes != b.attributes)
+    {
+        printf("ERROR: Attribute data mismatch\n");
+        return false;
+    }
+
+    for (size_t j = 0; j < a.materials.size(); ++j)
+    {
+        const auto& ma = a.materials[j];
+        const auto& mb = b.materials[j];
+        if (memcmp(&ma.vAmbient, &mb.vAmbient, sizeof(DirectX::XMFLOAT3)) != 0
+            || memcmp(&ma.vDiffuse, &mb.vDiffuse, sizeof(DirectX::XMFLOAT3)) != 0
+            || memcmp(&ma.vSpecular, &mb.vSpecular, sizeof(DirectX::XMFLOAT3)) != 0
+            || memcmp(&ma.vEmissive, &mb.vEmissive, sizeof(DirectX::XMFLOAT3)) != 0
+            || ma.nShininess != mb.nShininess
+            || ma.fAlpha != mb.fAlpha
+            || ma.bSpecular != mb.bSpecular
+            || ma.bEmissive != mb.bEmissive
+            || wcscmp(ma.strName, mb.strName) != 0
+            || wcscmp(ma.strTexture, mb.strTexture) != 0
+            || wcscmp(ma.strNormalTexture, mb.strNormalTexture) != 0
+            || wcscmp(ma.strSpecularTexture, mb.strSpecularTexture) != 0
+            || wcscmp(ma.strEmissiveTexture, mb.strEmissiveTexture) != 0
+            || wcscmp(ma.strRMATexture, mb.strRMATexture) != 0)
+        {
+            printf("ERROR: Material %zu mismatch\n", j);
+            return false;
+        }
+    }
+
+    if (memcmp(&a.bounds, &b.bounds, sizeof(DirectX::BoundingBox)) != 0)
+    {
+        printf("ERROR: Bounds mismatch\n");
+        return false;
+    }
+
+    return true;
+}
+
+template bool CompareResults<uint16_t>(const WaveFrontReader<uint16_t>&, const WaveFrontReader<uint16_t>&);
+template bool CompareResults<uint32_t>(const WaveFrontReader<uint32_t>&, const WaveFrontReader<uint32_t>&);
+
+
+//-------------------------------------------------------------------------------------
+double ElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,436 @@
+//-------------------------------------------------------------------------------------
+// cache.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include "WaveFrontReader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <system_error>
+
+namespace
+{
+    constexpr uint32_t c_SyntheticGrid = 96;
+    constexpr uint32_t c_BenchmarkGrid = 1024;
+
+    const wchar_t* c_CupMedia = L"ModelTest/cup._obj";
+
+    // Pushes the file's modification time away from 'now' so cache freshness checks do not
+    // depend on the file system's timestamp granularity
+    bool SetFileAge(const std::filesystem::path& path, std::chrono::seconds offset)
+    {
+        std::error_code ec;
+        const auto now = std::filesystem::last_write_time(path, ec);
+        if (ec)
+            return false;
+
+        std::filesystem::last_write_time(path, now + offset, ec);
+        return !ec;
+    }
+
+    bool WriteText(const std::filesystem::path& path, const char* text)
+    {
+        std::ofstream out(path, std::ios::out | std::ios::trunc);
+        out << text;
+        return !out.fail();
+    }
+
+    template<class index_t>
+    bool CompareView(const typename WaveFrontReader<index_t>::CacheView& view, const WaveFrontReader<index_t>& obj)
+    {
+        return view.vertexCount == obj.vertices.size()
+            && view.indexCount == obj.indices.size()
+            && view.attributeCount == obj.attributes.size()
+            && view.materialCount == obj.materials.size()
+            && obj.name.compare(0, std::wstring::npos, view.name, view.nameLength) == 0
+            && view.hasNormals == obj.hasNormals
+            && view.hasTexcoords == obj.hasTexcoords
+            && memcmp(view.vertices, obj.vertices.data(), sizeof(typename WaveFrontReader<index_t>::Vertex) * view.vertexCount) == 0
+            && memcmp(view.indices, obj.indices.data(), sizeof(index_t) * view.indexCount) == 0
+            && memcmp(view.attributes, obj.attributes.data(), sizeof(uint32_t) * view.attributeCount) == 0
+            && memcmp(&view.bounds, &obj.bounds, sizeof(DirectX::BoundingBox)) == 0;
+    }
+}
+
+//-------------------------------------------------------------------------------------
+
+extern bool WriteSyntheticOBJ(const std::filesystem::path& path, uint32_t gridSize);
+
+template<class index_t>
+bool CompareResults(const WaveFrontReader<index_t>& a, const WaveFrontReader<index_t>& b);
+
+extern double ElapsedMilliseconds(std::chrono::steady_clock::time_point start);
+
+//-------------------------------------------------------------------------------------
+// Binary cache round-trip and freshness handling
+bool Test05()
+{
+    bool success = true;
+
+    const auto tempDir = std::filesystem::temp_directory_path();
+    const auto cachePath = tempDir / L"wavefronttest_cup.wfrcache";
+
+    // Round-trip with materials, in both windings
+    for (const bool ccw : { true, false })
+    {
+        auto ref = std::make_unique<WaveFrontReader<uint16_t>>();
+        auto obj = std::make_unique<WaveFrontReader<uint16_t>>();
+
+        HRESULT hr = ref->Load(c_CupMedia, ccw);
+        if (SUCCEEDED(hr))
+        {
+            hr = ref->SaveCache(cachePath.wstring().c_str(), ccw);
+        }
+        if (SUCCEEDED(hr))
+        {
+            hr = obj->LoadCache(cachePath.wstring().c_str(), ccw);
+        }
+
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed cache round-trip (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), c_CupMedia);
+        }
+        else if (!CompareResults(*ref, *obj))
+        {
+            success = false;
+            printf("Cache round-trip mismatch (%s):\n%ls\n", ccw ? "ccw" : "cw", c_CupMedia);
+        }
+
+        // Loading with the opposite winding must match a fresh parse with that winding
+        hr = ref->Load(c_CupMedia, !ccw);
+        if (SUCCEEDED(hr))
+        {
+            hr = obj->LoadCache(cachePath.wstring().c_str(), !ccw);
+        }
+
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed cache winding load (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+        else if (!CompareResults(*ref, *obj))
+        {
+            success = false;
+            printf("Cache winding mismatch (%s)\n", ccw ? "ccw" : "cw");
+        }
+    }
+
+    // Zero-copy view of the mapped cache
+    {
+        auto ref = std::make_unique<WaveFrontReader<uint16_t>>();
+        WaveFrontReader<uint16_t>::CacheView view;
+
+        HRESULT hr = ref->Load(c_CupMedia);
+        if (SUCCEEDED(hr))
+        {
+            hr = ref->SaveCache(cachePath.wstring().c_str());
+        }
+        if (SUCCEEDED(hr))
+        {
+            hr = view.Open(cachePath.wstring().c_str());
+        }
+
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed opening cache view (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+        else if (!CompareView(view, *ref) || !view.ccw
+            || (reinterpret_cast<uintptr_t>(view.vertices) % 16) != 0
+            || (reinterpret_cast<uintptr_t>(view.materials) % 16) != 0
+            || wcscmp(view.materials[1].strName, ref->materials[1].strName) != 0)
+        {
+            success = false;
+            printf("Cache view mismatch\n");
+        }
+    }
+
+    // A cache written for a different index format must be rejected
+    {
+        WaveFrontReader<uint32_t> obj;
+        HRESULT hr = obj.LoadCache(cachePath.wstring().c_str());
+        if (SUCCEEDED(hr))
+        {
+            success = false;
+            printf("ERROR: Expected failure for index format mismatch\n");
+        }
+    }
+
+    // Caches with out-of-range indices or attributes must be rejected
+    for (const bool badIndex : { true, false })
+    {
+        WaveFrontReader<uint16_t> obj;
+        HRESULT hr = obj.Load(c_CupMedia);
+        if (SUCCEEDED(hr))
+        {
+            if (badIndex)
+                obj.indices[obj.indices.size() / 2] = static_cast<uint16_t>(obj.vertices.size());
+            else
+                obj.attributes.back() = static_cast<uint32_t>(obj.materials.size());
+
+            hr = obj.SaveCache(cachePath.wstring().c_str());
+        }
+
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed writing corrupt cache (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            continue;
+        }
+
+        WaveFrontReader<uint16_t>::CacheView view;
+        hr = view.Open(cachePath.wstring().c_str());
+        if (SUCCEEDED(hr) || view.indices || SUCCEEDED(obj.LoadCache(cachePath.wstring().c_str())))
+        {
+            success = false;
+            printf("ERROR: Expected failure for out-of-range %s\n", badIndex ? "index" : "attribute");
+        }
+    }
+
+    // Truncated caches must be rejected
+    {
+        std::error_code ec;
+        std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 1, ec);
+
+        WaveFrontReader<uint16_t> obj;
+        HRESULT hr = obj.LoadCache(cachePath.wstring().c_str());
+        if (ec || SUCCEEDED(hr))
+        {
+            success = false;
+            printf("ERROR: Expected failure for truncated cache\n");
+        }
+    }
+
+    // LoadCached must write the sidecar, use it while fresh, and re-parse once it is stale
+    const auto path = tempDir / L"wavefronttest_cached.obj";
+    std::filesystem::path sidecar = path;
+    sidecar += L".wfrcache";
+
+    std::error_code ec;
+    std::filesystem::remove(sidecar, ec);
+
+    if (!WriteSyntheticOBJ(path, c_SyntheticGrid) || !SetFileAge(path, std::chrono::seconds(-60)))
+    {
+        printf("ERROR: Failed writing synthetic OBJ:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    {
+        auto ref = std::make_unique<WaveFrontReader<uint32_t>>();
+        auto obj = std::make_unique<WaveFrontReader<uint32_t>>();
+
+        HRESULT hr = ref->LoadMapped(path.wstring().c_str());
+        if (FAILED(hr))
+        {
+            printf("Failed loading synthetic OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            return false;
+        }
+
+        hr = obj->LoadCached(path.wstring().c_str());
+        if (hr != S_OK || !std::filesystem::exists(sidecar) || !CompareResults(*ref, *obj))
+        {
+            success = false;
+            printf("ERROR: LoadCached did not parse and write the cache (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+
+        hr = obj->LoadCached(path.wstring().c_str());
+        if (hr != S_FALSE || !CompareResults(*ref, *obj))
+        {
+            success = false;
+            printf("ERROR: LoadCached did not use the fresh cache (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+
+        // Modify the source so it is newer than the cache
+        if (!WriteSyntheticOBJ(path, c_SyntheticGrid / 2) || !SetFileAge(path, std::chrono::seconds(60)))
+        {
+            printf("ERROR: Failed rewriting synthetic OBJ\n");
+            return false;
+        }
+
+        hr = ref->LoadMapped(path.wstring().c_str());
+        if (SUCCEEDED(hr))
+        {
+            hr = obj->LoadCached(path.wstring().c_str());
+        }
+
+        if (hr != S_OK || !CompareResults(*ref, *obj))
+        {
+            success = false;
+            printf("ERROR: LoadCached did not refresh the stale cache (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+    }
+
+    // Editing only the material library must also make the cache stale, for both the
+    // copying and the zero-copy overloads
+    const auto mtlObjPath = tempDir / L"wavefronttest_cachedmtl.obj";
+    const auto mtlPath = tempDir / L"wavefronttest_cachedmtl.mtl";
+    std::filesystem::path mtlSidecar = mtlObjPath;
+    mtlSidecar += L".wfrcache";
+    std::filesystem::remove(mtlSidecar, ec);
+
+    if (!WriteText(mtlObjPath, "mtllib wavefronttest_cachedmtl.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl paint\nf 1 2 3\n")
+        || !WriteText(mtlPath, "newmtl paint\nKd 1 0 0\n")
+        || !SetFileAge(mtlObjPath, std::chrono::seconds(-60))
+        || !SetFileAge(mtlPath, std::chrono::seconds(-60)))
+    {
+        printf("ERROR: Failed writing OBJ with material library:\n%ls\n", mtlObjPath.wstring().c_str());
+        return false;
+    }
+
+    {
+        auto obj = std::make_unique<WaveFrontReader<uint16_t>>();
+
+        HRESULT hr = obj->LoadCached(mtlObjPath.wstring().c_str());
+        if (hr != S_OK || obj->materials.size() != 2 || obj->materials[1].vDiffuse.x != 1.f)
+        {
+            success = false;
+            printf("ERROR: LoadCached did not parse the material library (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+
+        hr = obj->LoadCached(mtlObjPath.wstring().c_str());
+        if (hr != S_FALSE)
+        {
+            success = false;
+            printf("ERROR: LoadCached did not use the fresh cache with a material library (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+
+        if (!WriteText(mtlPath, "newmtl paint\nKd 0 1 0\n") || !SetFileAge(mtlPath, std::chrono::seconds(-30)))
+        {
+            printf("ERROR: Failed rewriting material library\n");
+            return false;
+        }
+
+        hr = obj->LoadCached(mtlObjPath.wstring().c_str());
+        if (hr != S_OK || obj->materials.size() != 2 || obj->materials[1].vDiffuse.y != 1.f)
+        {
+            success = false;
+            printf("ERROR: LoadCached did not refresh after the material library changed (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+
+        WaveFrontReader<uint16_t>::CacheView view;
+        hr = obj->LoadCached(mtlObjPath.wstring().c_str(), view);
+        if (hr != S_FALSE || !obj->vertices.empty() || view.materialCount != 2 || view.materials[1].vDiffuse.y != 1.f)
+        {
+            success = false;
+            printf("ERROR: LoadCached did not map the fresh cache (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+
+        view.Close();
+
+        if (!WriteText(mtlPath, "newmtl paint\nKd 0 0 1\n") || !SetFileAge(mtlPath, std::chrono::seconds(-15)))
+        {
+            printf("ERROR: Failed rewriting material library\n");
+            return false;
+        }
+
+        hr = obj->LoadCached(mtlObjPath.wstring().c_str(), view);
+        if (hr != S_OK || !obj->vertices.empty() || view.materialCount != 2 || view.materials[1].vDiffuse.z != 1.f)
+        {
+            success = false;
+            printf("ERROR: LoadCached did not remap after the material library changed (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+
+        // The mapped cache was written for the default winding
+        hr = obj->LoadCached(mtlObjPath.wstring().c_str(), view, false);
+        if (hr != S_OK || view.ccw || view.indexCount != 3)
+        {
+            success = false;
+            printf("ERROR: LoadCached did not rewrite the cache for the other winding (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+    }
+
+    std::filesystem::remove(path, ec);
+    std::filesystem::remove(sidecar, ec);
+    std::filesystem::remove(mtlObjPath, ec);
+    std::filesystem::remove(mtlPath, ec);
+    std::filesystem::remove(mtlSidecar, ec);
+    std::filesystem::remove(cachePath, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Parse time vs. binary cache load time
+bool Benchmark04()
+{
+    const auto tempDir = std::filesystem::temp_directory_path();
+    const auto path = tempDir / L"wavefronttest_benchmark.obj";
+    const auto cachePath = tempDir / L"wavefronttest_benchmark.wfrcache";
+
+    if (!WriteSyntheticOBJ(path, c_BenchmarkGrid))
+    {
+        printf("ERROR: Failed writing benchmark OBJ:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    auto ref = std::make_unique<WaveFrontReader<uint32_t>>();
+    auto obj = std::make_unique<WaveFrontReader<uint32_t>>();
+
+    auto start = std::chrono::steady_clock::now();
+    HRESULT hr = ref->LoadMapped(path.wstring().c_str());
+    const double parseTime = ElapsedMilliseconds(start);
+
+    if (FAILED(hr))
+    {
+        printf("Failed loading benchmark OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        return false;
+    }
+
+    start = std::chrono::steady_clock::now();
+    hr = ref->SaveCache(cachePath.wstring().c_str());
+    const double saveTime = ElapsedMilliseconds(start);
+
+    if (FAILED(hr))
+    {
+        printf("Failed writing benchmark cache (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        return false;
+    }
+
+    start = std::chrono::steady_clock::now();
+    hr = obj->LoadCache(cachePath.wstring().c_str());
+    const double loadTime = ElapsedMilliseconds(start);
+
+    if (FAILED(hr))
+    {
+        printf("Failed loading benchmark cache (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        return false;
+    }
+
+    bool success = CompareResults(*ref, *obj);
+
+    WaveFrontReader<uint32_t>::CacheView view;
+    start = std::chrono::steady_clock::now();
+    hr = view.Open(cachePath.wstring().c_str());
+    const double viewTime = ElapsedMilliseconds(start);
+
+    if (FAILED(hr) || !CompareView(view, *ref))
+    {
+        printf("Failed opening benchmark cache view (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        success = false;
+    }
+
+    const double sizeMB = double(std::filesystem::file_size(cachePath)) / (1024.0 * 1024.0);
+
+    printf("\n\t%zu vertices, %zu faces, %.1f MB cache\n", ref->vertices.size(), ref->attributes.size(), sizeMB);
+    printf("\tparse:      %10.2f ms\n", parseTime);
+    printf("\tsave cache: %10.2f ms\n", saveTime);
+    printf("\tload cache: %10.2f ms  (%.2fx)\n", loadTime, parseTime / loadTime);
+    printf("\tmap view:   %10.2f ms\n", viewTime);
+
+    view.Close();
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    std::filesystem::remove(cachePath, ec);
+
+    return success;
+}
@@ -0,0 +1,343 @@
+//-------------------------------------------------------------------------------------
+// dedup.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include "WaveFrontReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using Reader = WaveFrontReader<uint32_t>;
+using Vertex = Reader::Vertex;
+
+namespace
+{
+    // Synthetic welded mesh: a pool of unique vertices plus the face corners that reference them
+    struct SyntheticCorners
+    {
+        std::vector<uint32_t>   positionIndex;
+        std::vector<Vertex>     pool;
+        std::vector<uint32_t>   corners;
+        size_t                  positionCount;
+    };
+
+    // Builds a grid with 6 corners per quad. Every 8th column carries a texture seam, which
+    // duplicates those positions with a second texture coordinate as real assets do.
+    void CreateSyntheticCorners(size_t cornerCount, SyntheticCorners& result)
+    {
+        const auto grid = static_cast<uint32_t>(std::max(1.0, std::floor(std::sqrt(double(cornerCount) / 6.0))));
+        const uint32_t count = grid + 1;
+
+        result.positionCount = size_t(count) * size_t(count);
+        result.pool.clear();
+        result.positionIndex.clear();
+        result.pool.reserve(result.positionCount + result.positionCount / 8);
+        result.positionIndex.reserve(result.pool.capacity());
+
+        std::vector<uint32_t> seam(result.positionCount, UINT32_MAX);
+
+        for (uint32_t y = 0; y < count; ++y)
+        {
+            for (uint32_t x = 0; x < count; ++x)
+            {
+                Vertex v = {};
+                v.position = DirectX::XMFLOAT3(float(x), float(y), float((x * 7 + y * 13) % 5));
+                v.normal = DirectX::XMFLOAT3(0.f, 0.f, 1.f);
+                v.textureCoordinate = DirectX::XMFLOAT2(float(x) / float(grid), float(y) / float(grid));
+
+                const uint32_t pos = y * count + x;
+                result.positionIndex.push_back(pos);
+                result.pool.push_back(v);
+
+                if (!(x % 8))
+                {
+                    v.textureCoordinate.x += 1.f;
+                    seam[pos] = static_cast<uint32_t>(result.pool.size());
+                    result.positionIndex.push_back(pos);
+                    result.pool.push_back(v);
+                }
+            }
+        }
+
+        // Map position -> first pool entry
+        std::vector<uint32_t> first(result.positionCount);
+        for (size_t j = result.pool.size(); j-- > 0; )
+        {
+            first[result.positionIndex[j]] = static_cast<uint32_t>(j);
+        }
+
+        result.corners.clear();
+        result.corners.reserve(size_t(grid) * size_t(grid) * 6);
+
+        for (uint32_t y = 0; y < grid; ++y)
+        {
+            for (uint32_t x = 0; x < grid; ++x)
+            {
+                const uint32_t p0 = y * count + x;
+                const uint32_t p1 = p0 + 1;
+                const uint32_t p2 = p0 + count + 1;
+                const uint32_t p3 = p0 + count;
+
+                // Quads left of a seam column use the seam copy of its vertices
+                const bool useSeam = ((x + 1) % 8) == 0;
+                const uint32_t v0 = first[p0];
+                const uint32_t v1 = (useSeam && seam[p1] != UINT32_MAX) ? seam[p1] : first[p1];
+                const uint32_t v2 = (useSeam && seam[p2] != UINT32_MAX) ? seam[p2] : first[p2];
+                const uint32_t v3 = first[p3];
+
+                const uint32_t quad[6] = { v0, v1, v2, v0, v2, v3 };
+                result.corners.insert(result.corners.end(), quad, quad + 6);
+            }
+        }
+    }
+
+    // The previous welding scheme: multimap keyed on the position index
+    size_t LegacyWeld(const SyntheticCorners& mesh, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        std::unordered_multimap<uint32_t, uint32_t> cache;
+
+        vertices.clear();
+        indices.clear();
+        indices.reserve(mesh.corners.size());
+
+        for (const auto corner : mesh.corners)
+        {
+            const Vertex& vertex = mesh.pool[corner];
+            const uint32_t hash = mesh.positionIndex[corner];
+
+            uint32_t index = UINT32_MAX;
+
+            auto f = cache.equal_range(hash);
+            for (auto it = f.first; it != f.second; ++it)
+            {
+                if (0 == memcmp(&vertex, &vertices[it->second], sizeof(Vertex)))
+                {
+                    index = it->second;
+                    break;
+                }
+            }
+
+            if (index == UINT32_MAX)
+            {
+                index = static_cast<uint32_t>(vertices.size());
+                vertices.emplace_back(vertex);
+                cache.insert(std::make_pair(hash, index));
+            }
+
+            indices.push_back(index);
+        }
+
+        return vertices.size();
+    }
+
+    // Writes the corners as an OBJ with one texture coordinate per pool entry, so the reader
+    // welds them back through its vertex cache
+    bool WriteCornersOBJ(const std::filesystem::path& path, const SyntheticCorners& mesh)
+    {
+        FILE* file = nullptr;
+#ifdef _WIN32
+        if (_wfopen_s(&file, path.c_str(), L"wt") != 0)
+            return false;
+#else
+        file = fopen(path.c_str(), "wt");
+#endif
+        if (!file)
+            return false;
+
+        std::vector<uint32_t> first(mesh.positionCount, UINT32_MAX);
+        for (size_t j = 0; j < mesh.pool.size(); ++j)
+        {
+            if (first[mesh.positionIndex[j]] == UINT32_MAX)
+                first[mesh.positionIndex[j]] = static_cast<uint32_t>(j);
+        }
+
+        for (const auto j : first)
+        {
+            const auto& pos = mesh.pool[j].position;
+            fprintf(file, "v %.9g %.9g %.9g\n", double(pos.x), double(pos.y), double(pos.z));
+        }
+
+        for (const auto& v : mesh.pool)
+        {
+            fprintf(file, "vt %.9g %.9g\n", double(v.textureCoordinate.x), double(v.textureCoordinate.y));
+        }
+
+        fprintf(file, "vn 0 0 1\n");
+
+        for (size_t j = 0; j + 2 < mesh.corners.size(); j += 3)
+        {
+            fprintf(file, "f");
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const uint32_t corner = mesh.corners[j + k];
+                fprintf(file, " %u/%u/1", mesh.positionIndex[corner] + 1, corner + 1);
+            }
+            fprintf(file, "\n");
+        }
+
+        const bool success = !ferror(file);
+        fclose(file);
+        return success;
+    }
+
+    bool WriteText(const std::filesystem::path& path, const char* text)
+    {
+        std::ofstream out(path, std::ios::out | std::ios::trunc);
+        out << text;
+        return !out.fail();
+    }
+}
+
+extern double ElapsedMilliseconds(std::chrono::steady_clock::time_point start);
+
+//-------------------------------------------------------------------------------------
+// Vertex welding table must match the previous welding results
+bool Test04()
+{
+    bool success = true;
+
+    SyntheticCorners mesh;
+    CreateSyntheticCorners(100000, mesh);
+
+    std::vector<Vertex> refVertices;
+    std::vector<uint32_t> refIndices;
+    std::ignore = LegacyWeld(mesh, refVertices, refIndices);
+
+    const auto path = std::filesystem::temp_directory_path() / L"wavefronttest_weld.obj";
+    if (!WriteCornersOBJ(path, mesh))
+    {
+        printf("ERROR: Failed writing welding OBJ:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    static const char* s_loaders[] = { "Load", "LoadMapped", "LoadParallel" };
+    for (size_t loader = 0; loader < std::size(s_loaders); ++loader)
+    {
+        auto obj = std::make_unique<Reader>();
+
+        HRESULT hr = E_FAIL;
+        switch (loader)
+        {
+        case 0: hr = obj->Load(path.wstring().c_str()); break;
+        case 1: hr = obj->LoadMapped(path.wstring().c_str()); break;
+        default: hr = obj->LoadParallel(path.wstring().c_str()); break;
+        }
+
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("ERROR: %s failed on welding OBJ (HRESULT %08X)\n", s_loaders[loader], static_cast<unsigned int>(hr));
+        }
+        else if (obj->vertices.size() != refVertices.size()
+            || obj->indices != refIndices
+            || memcmp(obj->vertices.data(), refVertices.data(), sizeof(Vertex) * refVertices.size()) != 0)
+        {
+            success = false;
+            printf("ERROR: %s welding mismatch (%zu vs. %zu vertices)\n", s_loaders[loader], obj->vertices.size(), refVertices.size());
+        }
+    }
+
+    // Welding is bitwise, so signed zeros stay distinct
+    if (!WriteText(path, "v 0 0 0\nv 1 0 0\nvn 0 0 0\nvn 0 0 -0\nf 1//1 1//2 2//1\nf 1//1 2//1 1//2\n"))
+    {
+        printf("ERROR: Failed writing signed zero OBJ:\n%ls\n", path.wstring().c_str());
+        success = false;
+    }
+    else
+    {
+        auto obj = std::make_unique<Reader>();
+        HRESULT hr = obj->LoadMapped(path.wstring().c_str());
+
+        const std::vector<uint32_t> expected = { 0, 1, 2, 0, 2, 1 };
+        if (FAILED(hr) || obj->vertices.size() != 3 || obj->indices != expected)
+        {
+            success = false;
+            printf("ERROR: Unexpected welding of signed zeros (HRESULT %08X, %zu vertices)\n", static_cast<unsigned int>(hr), obj->vertices.size());
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Vertex welding throughput on 1M - 10M face corners. The flat table is only reachable
+// through the loaders, so its numbers include parsing; the legacy numbers are welding only.
+bool Benchmark03()
+{
+    static const size_t s_cornerCounts[] = { 1000000, 5000000, 10000000 };
+
+    bool success = true;
+
+    printf("\n");
+
+    const auto path = std::filesystem::temp_directory_path() / L"wavefronttest_weldbench.obj";
+
+    for (const size_t cornerCount : s_cornerCounts)
+    {
+        SyntheticCorners mesh;
+        CreateSyntheticCorners(cornerCount, mesh);
+
+        const double corners = double(mesh.corners.size());
+
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+
+        printf("\t%zu corners, %zu positions\n", mesh.corners.size(), mesh.positionCount);
+
+        {
+            auto start = std::chrono::steady_clock::now();
+            const size_t count = LegacyWeld(mesh, vertices, indices);
+            const double time = ElapsedMilliseconds(start);
+            printf("\t\tunordered_multimap (weld only):    %10.2f ms  %8.2f Mcorners/s  (%zu vertices)\n", time, corners / (time * 1000.0), count);
+        }
+
+        if (!WriteCornersOBJ(path, mesh))
+        {
+            printf("ERROR: Failed writing welding OBJ:\n%ls\n", path.wstring().c_str());
+            return false;
+        }
+
+        auto obj = std::make_unique<Reader>();
+
+        auto start = std::chrono::steady_clock::now();
+        HRESULT hr = obj->LoadMapped(path.wstring().c_str());
+        const double time = ElapsedMilliseconds(start);
+
+        if (FAILED(hr))
+        {
+            printf("ERROR: LoadMapped failed on welding OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            success = false;
+            break;
+        }
+
+        printf("\t\tLoadMapped (parse + weld):         %10.2f ms  %8.2f Mcorners/s  (%zu vertices)\n", time, corners / (time * 1000.0), obj->vertices.size());
+
+        if (obj->indices != indices)
+        {
+            success = false;
+            printf("ERROR: Welding mismatch\n");
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
@@ -0,0 +1,409 @@
+//-------------------------------------------------------------------------------------
+// obj.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include "WaveFrontReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+
+namespace
+{
+    struct TestMedia
+    {
+        size_t vertices;
+        size_t faces;
+        size_t materials;
+        const wchar_t *fname;
+    };
+
+    const TestMedia g_TestMedia[] =
+    {
+        // Vertices | Faces | Materials | Filename
+        { 1340, 1880, 3, L"ModelTest/cup._obj" },
+    };
+
+    constexpr uint32_t c_SyntheticGrid = 96;
+    constexpr uint32_t c_BenchmarkGrid = 1024;
+}
+
+//-------------------------------------------------------------------------------------
+
+extern bool WriteSyntheticOBJ(const std::filesystem::path& path, uint32_t gridSize);
+
+template<class index_t>
+bool CompareResults(const WaveFrontReader<index_t>& a, const WaveFrontReader<index_t>& b);
+
+extern double ElapsedMilliseconds(std::chrono::steady_clock::time_point start);
+
+//-------------------------------------------------------------------------------------
+// Stream loader
+bool Test01()
+{
+    bool success = true;
+
+    for (size_t index = 0; index < std::size(g_TestMedia); ++index)
+    {
+        auto obj = std::make_unique<WaveFrontReader<uint16_t>>();
+        HRESULT hr = obj->Load(g_TestMedia[index].fname);
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed loading OBJ from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), g_TestMedia[index].fname);
+        }
+        else if (obj->vertices.size() != g_TestMedia[index].vertices
+            || obj->attributes.size() != g_TestMedia[index].faces
+            || obj->indices.size() != g_TestMedia[index].faces * 3
+            || obj->materials.size() != g_TestMedia[index].materials)
+        {
+            success = false;
+            printf("Metadata error in OBJ file:\n%ls\n%zu vertices  %zu faces  %zu materials\n", g_TestMedia[index].fname,
+                obj->vertices.size(), obj->attributes.size(), obj->materials.size());
+        }
+    }
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Memory-mapped loader must produce the same results as the stream loader
+bool Test02()
+{
+    bool success = true;
+
+    for (size_t index = 0; index < std::size(g_TestMedia); ++index)
+    {
+        auto ref = std::make_unique<WaveFrontReader<uint16_t>>();
+        auto obj = std::make_unique<WaveFrontReader<uint16_t>>();
+
+        HRESULT hr = ref->Load(g_TestMedia[index].fname);
+        if (SUCCEEDED(hr))
+        {
+            hr = obj->LoadMapped(g_TestMedia[index].fname);
+        }
+
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed loading OBJ from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), g_TestMedia[index].fname);
+        }
+        else if (!CompareResults(*ref, *obj))
+        {
+            success = false;
+            printf("Mapped load mismatch:\n%ls\n", g_TestMedia[index].fname);
+        }
+    }
+
+    // Procedural mesh exercising all the face index forms
+    const auto path = std::filesystem::temp_directory_path() / L"wavefronttest_synthetic.obj";
+    if (!WriteSyntheticOBJ(path, c_SyntheticGrid))
+    {
+        printf("ERROR: Failed writing synthetic OBJ:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    for (const bool ccw : { true, false })
+    {
+        auto ref = std::make_unique<WaveFrontReader<uint32_t>>();
+        auto obj = std::make_unique<WaveFrontReader<uint32_t>>();
+
+        HRESULT hr = ref->Load(path.wstring().c_str(), ccw);
+        if (SUCCEEDED(hr))
+        {
+            hr = obj->LoadMapped(path.wstring().c_str(), ccw);
+        }
+
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed loading synthetic OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+        else if (!CompareResults(*ref, *obj))
+        {
+            success = false;
+            printf("Mapped load mismatch for synthetic OBJ (%s)\n", ccw ? "ccw" : "cw");
+        }
+    }
+
+    // Floats outside the range of a float: overflow stops the parse, underflow rounds to zero.
+    // The value is last on the line, since Load leaves the components after a failure unset.
+    const auto edgePath = std::filesystem::temp_directory_path() / L"wavefronttest_floats.obj";
+    for (const char* line : { "v 0 0 3.4028236e38", "v 0 0 -1e39", "vt 0 1e39", "v 0 0 1e-50", "v 0 0 1e-40", "v 0 0 3.4028234e38" })
+    {
+        {
+            std::ofstream file(edgePath, std::ios::out | std::ios::trunc);
+            file << line << "\nv 0 1 0\nv 0 0 1\nf 1 2 3\n";
+        }
+
+        auto ref = std::make_unique<WaveFrontReader<uint16_t>>();
+        auto obj = std::make_unique<WaveFrontReader<uint16_t>>();
+        auto par = std::make_unique<WaveFrontReader<uint16_t>>();
+
+        const HRESULT hrRef = ref->Load(edgePath.wstring().c_str());
+        const HRESULT hrObj = obj->LoadMapped(edgePath.wstring().c_str());
+        const HRESULT hrPar = par->LoadParallel(edgePath.wstring().c_str());
+        if (hrRef != hrObj || hrRef != hrPar
+            || (SUCCEEDED(hrRef) && (!CompareResults(*ref, *obj) || !CompareResults(*ref, *par))))
+        {
+            success = false;
+            printf("ERROR: Mapped/parallel load differs from stream load for '%s'\n", line);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(edgePath, ec);
+
+    // Missing files must fail
+    {
+        WaveFrontReader<uint16_t> obj;
+        HRESULT hr = obj.LoadMapped(L"ModelTest/missing._obj");
+        if (SUCCEEDED(hr))
+        {
+            success = false;
+            printf("ERROR: Expected failure for missing file\n");
+        }
+    }
+
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Throughput of the stream loader vs. the memory-mapped loader
+bool Benchmark01()
+{
+    const auto path = std::filesystem::temp_directory_path() / L"wavefronttest_benchmark.obj";
+    if (!WriteSyntheticOBJ(path, c_BenchmarkGrid))
+    {
+        printf("ERROR: Failed writing benchmark OBJ:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    const double sizeMB = double(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+
+    auto ref = std::make_unique<WaveFrontReader<uint32_t>>();
+    auto obj = std::make_unique<WaveFrontReader<uint32_t>>();
+
+    auto start = std::chrono::steady_clock::now();
+    HRESULT hr = ref->Load(path.wstring().c_str());
+    const double streamTime = ElapsedMilliseconds(start);
+
+    if (FAILED(hr))
+    {
+        printf("Failed loading benchmark OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        return false;
+    }
+
+    start = std::chrono::steady_clock::now();
+    hr = obj->LoadMapped(path.wstring().c_str());
+    const double mappedTime = ElapsedMilliseconds(start);
+
+    if (FAILED(hr))
+    {
+        printf("Failed loading benchmark OBJ with mapped path (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        return false;
+    }
+
+    const bool success = CompareResults(*ref, *obj);
+
+    printf("\n\t%.1f MB, %zu vertices, %zu faces\n", sizeMB, ref->vertices.size(), ref->attributes.size());
+    printf("\tstream: %10.2f ms  %8.2f MB/s\n", streamTime, sizeMB * 1000.0 / streamTime);
+    printf("\tmapped: %10.2f ms  %8.2f MB/s  (%.2fx)\n", mappedTime, sizeMB * 1000.0 / mappedTime, streamTime / mappedTime);
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Multi-threaded loader must produce the same results as the stream loader
+bool Test03()
+{
+    bool success = true;
+
+    static const size_t s_threadCounts[] = { 1, 2, 3, 7, 16, 0 };
+
+    for (size_t index = 0; index < std::size(g_TestMedia); ++index)
+    {
+        auto ref = std::make_unique<WaveFrontReader<uint16_t>>();
+        HRESULT hr = ref->Load(g_TestMedia[index].fname);
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed loading OBJ from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), g_TestMedia[index].fname);
+            continue;
+        }
+
+        for (const size_t threads : s_threadCounts)
+        {
+            auto obj = std::make_unique<WaveFrontReader<uint16_t>>();
+            hr = obj->LoadParallel(g_TestMedia[index].fname, true, threads);
+            if (FAILED(hr))
+            {
+                success = false;
+                printf("Failed loading OBJ with %zu threads (HRESULT %08X):\n%ls\n", threads, static_cast<unsigned int>(hr), g_TestMedia[index].fname);
+            }
+            else if (!CompareResults(*ref, *obj))
+            {
+                success = false;
+                printf("Parallel load mismatch with %zu threads:\n%ls\n", threads, g_TestMedia[index].fname);
+            }
+        }
+    }
+
+    const auto path = std::filesystem::temp_directory_path() / L"wavefronttest_parallel.obj";
+    if (!WriteSyntheticOBJ(path, c_SyntheticGrid))
+    {
+        printf("ERROR: Failed writing synthetic OBJ:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    for (const bool ccw : { true, false })
+    {
+        auto ref = std::make_unique<WaveFrontReader<uint32_t>>();
+        HRESULT hr = ref->Load(path.wstring().c_str(), ccw);
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed loading synthetic OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            continue;
+        }
+
+        for (const size_t threads : s_threadCounts)
+        {
+            auto obj = std::make_unique<WaveFrontReader<uint32_t>>();
+            hr = obj->LoadParallel(path.wstring().c_str(), ccw, threads);
+            if (FAILED(hr))
+            {
+                success = false;
+                printf("Failed loading synthetic OBJ with %zu threads (HRESULT %08X)\n", threads, static_cast<unsigned int>(hr));
+            }
+            else if (!CompareResults(*ref, *obj))
+            {
+                success = false;
+                printf("Parallel load mismatch for synthetic OBJ with %zu threads (%s)\n", threads, ccw ? "ccw" : "cw");
+            }
+        }
+    }
+
+    // Malformed trailing statements must report the same error as the stream loader
+    static const char* s_badFaces[] =
+    {
+        "f 1 2 0\n",
+        "f 1 2 99999999\n",
+        "f 1 2\n",
+        "f 1/1/1 2/2/2 3/3/-99999999\n",
+    };
+
+    for (const char* badFace : s_badFaces)
+    {
+        {
+            std::ofstream out(path, std::ios::out | std::ios::app);
+            out << badFace;
+        }
+
+        WaveFrontReader<uint32_t> ref;
+        const HRESULT hrRef = ref.Load(path.wstring().c_str());
+
+        WaveFrontReader<uint32_t> obj;
+        const HRESULT hr = obj.LoadParallel(path.wstring().c_str(), true, 4);
+
+        if (hr != hrRef || SUCCEEDED(hr))
+        {
+            success = false;
+            printf("ERROR: Expected HRESULT %08X for '%s', got %08X\n", static_cast<unsigned int>(hrRef), badFace, static_cast<unsigned int>(hr));
+        }
+
+        std::ignore = WriteSyntheticOBJ(path, c_SyntheticGrid);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Multi-threaded loader scaling from 1 to N threads
+bool Benchmark02()
+{
+    const auto path = std::filesystem::temp_directory_path() / L"wavefronttest_scaling.obj";
+    if (!WriteSyntheticOBJ(path, c_BenchmarkGrid))
+    {
+        printf("ERROR: Failed writing benchmark OBJ:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    const double sizeMB = double(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+
+    auto ref = std::make_unique<WaveFrontReader<uint32_t>>();
+
+    auto start = std::chrono::steady_clock::now();
+    HRESULT hr = ref->LoadMapped(path.wstring().c_str());
+    const double mappedTime = ElapsedMilliseconds(start);
+
+    if (FAILED(hr))
+    {
+        printf("Failed loading benchmark OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        return false;
+    }
+
+    printf("\n\t%.1f MB, %zu vertices, %zu faces\n", sizeMB, ref->vertices.size(), ref->attributes.size());
+    printf("\tmapped:     %10.2f ms  %8.2f MB/s\n", mappedTime, sizeMB * 1000.0 / mappedTime);
+
+    bool success = true;
+
+    const size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    double baseTime = 0.0;
+    for (size_t threads = 1; ; threads = std::min(threads * 2, maxThreads))
+    {
+        auto obj = std::make_unique<WaveFrontReader<uint32_t>>();
+
+        start = std::chrono::steady_clock::now();
+        hr = obj->LoadParallel(path.wstring().c_str(), true, threads);
+        const double time = ElapsedMilliseconds(start);
+
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed loading benchmark OBJ with %zu threads (HRESULT %08X)\n", threads, static_cast<unsigned int>(hr));
+        }
+        else if (!CompareResults(*ref, *obj))
+        {
+            success = false;
+            printf("Parallel load mismatch with %zu threads\n", threads);
+        }
+
+        if (threads == 1)
+        {
+            baseTime = time;
+        }
+
+        printf("\tthreads %3zu: %10.2f ms  %8.2f MB/s  (%.2fx)\n", threads, time, sizeMB * 1000.0 / time, baseTime / time);
+
+        if (threads >= maxThreads)
+            break;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
@@ -0,0 +1,404 @@
+//-------------------------------------------------------------------------------------
+// optimize.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include "WaveFrontReader.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <system_error>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+    constexpr uint32_t c_SyntheticGrid = 96;
+    constexpr uint32_t c_BenchmarkGrid = 1024;
+
+    const wchar_t* c_CupMedia = L"ModelTest/cup._obj";
+
+    template<class index_t>
+    std::vector<uint8_t> ExpandCorners(const WaveFrontReader<index_t>& obj)
+    {
+        using Vertex = typename WaveFrontReader<index_t>::Vertex;
+
+        std::vector<uint8_t> corners(obj.indices.size() * sizeof(Vertex));
+        for (size_t j = 0; j < obj.indices.size(); ++j)
+        {
+            memcpy(&corners[j * sizeof(Vertex)], &obj.vertices[obj.indices[j]], sizeof(Vertex));
+        }
+        return corners;
+    }
+
+    template<class index_t>
+    bool IsPermutation(const uint32_t* remap, size_t count)
+    {
+        std::vector<bool> seen(count);
+        for (size_t j = 0; j < count; ++j)
+        {
+            if (remap[j] >= count || seen[remap[j]])
+                return false;
+            seen[remap[j]] = true;
+        }
+        return true;
+    }
+
+    bool CheckBounds(const XMFLOAT3* positions, size_t count, size_t stride)
+    {
+        BoundingBox box;
+        BoundingSphere sphere;
+        MeshOptimizer::ComputeBounds(positions, count, stride, box, sphere);
+
+        BoundingBox ref;
+        BoundingBox::CreateFromPoints(ref, count, positions, stride);
+
+        if (memcmp(&box, &ref, sizeof(BoundingBox)) != 0)
+        {
+            printf("ERROR: Bounding box mismatch for %zu points\n", count);
+            return false;
+        }
+
+        BoundingSphere refSphere;
+        BoundingSphere::CreateFromPoints(refSphere, count, positions, stride);
+
+        if (memcmp(&sphere, &refSphere, sizeof(BoundingSphere)) != 0)
+        {
+            printf("ERROR: Bounding sphere mismatch for %zu points\n", count);
+            return false;
+        }
+
+        auto ptr = reinterpret_cast<const uint8_t*>(positions);
+        for (size_t j = 0; j < count; ++j)
+        {
+            auto p = reinterpret_cast<const XMFLOAT3*>(ptr + j * stride);
+            const float dx = p->x - sphere.Center.x;
+            const float dy = p->y - sphere.Center.y;
+            const float dz = p->z - sphere.Center.z;
+            if (std::sqrt(dx * dx + dy * dy + dz * dz) > sphere.Radius * 1.0001f + 1e-6f)
+            {
+                printf("ERROR: Bounding sphere does not contain point %zu of %zu\n", j, count);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template<class index_t>
+    bool CheckOptimize(WaveFrontReader<index_t>& obj, const wchar_t* label)
+    {
+        const size_t nFaces = obj.attributes.size();
+        const size_t nVerts = obj.vertices.size();
+
+        float acmrBefore, atvrBefore;
+        HRESULT hr = MeshOptimizer::ComputeVertexCacheMissRate(obj.indices.data(), nFaces, nVerts, MeshOptimizer::c_MetricCacheSize, acmrBefore, atvrBefore);
+        if (FAILED(hr))
+        {
+            printf("ERROR: ComputeVertexCacheMissRate failed (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            return false;
+        }
+
+        // Face reordering keeps every triangle and the attribute sequence
+        std::vector<uint32_t> faceRemap(nFaces);
+        hr = MeshOptimizer::OptimizeFaces(obj.indices.data(), nFaces, nVerts, obj.attributes.data(), faceRemap.data());
+        if (FAILED(hr) || !IsPermutation<index_t>(faceRemap.data(), nFaces))
+        {
+            printf("ERROR: OptimizeFaces failed for %ls (HRESULT %08X)\n", label, static_cast<unsigned int>(hr));
+            return false;
+        }
+
+        const auto originalIndices = obj.indices;
+        const auto originalAttributes = obj.attributes;
+
+        hr = MeshOptimizer::ReorderFaces(obj.indices, obj.attributes, faceRemap.data());
+        if (FAILED(hr))
+        {
+            printf("ERROR: ReorderFaces failed (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            return false;
+        }
+
+        for (size_t j = 0; j < nFaces; ++j)
+        {
+            const size_t face = faceRemap[j];
+            if (memcmp(&obj.indices[j * 3], &originalIndices[face * 3], sizeof(index_t) * 3) != 0
+                || obj.attributes[j] != originalAttributes[face])
+            {
+                printf("ERROR: Face %zu was not moved intact for %ls\n", j, label);
+                return false;
+            }
+        }
+
+        if (obj.attributes != originalAttributes)
+        {
+            printf("ERROR: Attribute runs were not preserved for %ls\n", label);
+            return false;
+        }
+
+        // Vertex reordering keeps the triangles' vertex data and orders vertices by first use
+        const auto corners = ExpandCorners(obj);
+
+        std::vector<uint32_t> vertexRemap(nVerts);
+        hr = MeshOptimizer::OptimizeVertices(obj.indices.data(), nFaces, nVerts, vertexRemap.data());
+        if (SUCCEEDED(hr))
+        {
+            hr = MeshOptimizer::ReorderVertices(obj.vertices, obj.indices, vertexRemap.data());
+        }
+
+        if (FAILED(hr) || !IsPermutation<index_t>(vertexRemap.data(), nVerts))
+        {
+            printf("ERROR: OptimizeVertices failed for %ls (HRESULT %08X)\n", label, static_cast<unsigned int>(hr));
+            return false;
+        }
+
+        if (ExpandCorners(obj) != corners)
+        {
+            printf("ERROR: Vertex reordering changed the triangles for %ls\n", label);
+            return false;
+        }
+
+        size_t next = 0;
+        for (const auto it : obj.indices)
+        {
+            if (size_t(it) > next)
+            {
+                printf("ERROR: Vertices not in first-use order for %ls\n", label);
+                return false;
+            }
+            else if (size_t(it) == next)
+            {
+                ++next;
+            }
+        }
+
+        float acmrAfter, atvrAfter;
+        hr = MeshOptimizer::ComputeVertexCacheMissRate(obj.indices.data(), nFaces, nVerts, MeshOptimizer::c_MetricCacheSize, acmrAfter, atvrAfter);
+        if (FAILED(hr) || acmrAfter > acmrBefore || atvrAfter > atvrBefore || atvrAfter < 1.f)
+        {
+            printf("ERROR: Cache statistics did not improve for %ls (ACMR %f -> %f, ATVR %f -> %f)\n", label,
+                double(acmrBefore), double(acmrAfter), double(atvrBefore), double(atvrAfter));
+            return false;
+        }
+
+        return true;
+    }
+
+    template<class index_t>
+    void ShuffleFaces(WaveFrontReader<index_t>& obj, uint32_t seed)
+    {
+        std::vector<uint32_t> remap(obj.attributes.size());
+        std::iota(remap.begin(), remap.end(), 0u);
+        std::shuffle(remap.begin(), remap.end(), std::mt19937(seed));
+
+        std::ignore = MeshOptimizer::ReorderFaces(obj.indices, obj.attributes, remap.data());
+    }
+}
+
+//-------------------------------------------------------------------------------------
+
+extern bool WriteSyntheticOBJ(const std::filesystem::path& path, uint32_t gridSize);
+
+extern double ElapsedMilliseconds(std::chrono::steady_clock::time_point start);
+
+//-------------------------------------------------------------------------------------
+// Bounds, vertex cache and vertex fetch optimization
+bool Test07()
+{
+    bool success = true;
+
+    // Cache metrics for known cases
+    {
+        const uint16_t tri[] = { 0, 1, 2 };
+        float acmr, atvr;
+        HRESULT hr = MeshOptimizer::ComputeVertexCacheMissRate(tri, 1, 3, MeshOptimizer::c_MetricCacheSize, acmr, atvr);
+        if (FAILED(hr) || acmr != 3.f || atvr != 1.f)
+        {
+            success = false;
+            printf("ERROR: Unexpected metrics for a single triangle (%f, %f)\n", double(acmr), double(atvr));
+        }
+
+        const uint16_t bad[] = { 0, 1, 3 };
+        hr = MeshOptimizer::ComputeVertexCacheMissRate(bad, 1, 3, MeshOptimizer::c_MetricCacheSize, acmr, atvr);
+        if (hr != E_UNEXPECTED)
+        {
+            success = false;
+            printf("ERROR: Expected E_UNEXPECTED for an out of range index (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+
+        uint32_t remap[1] = {};
+        hr = MeshOptimizer::OptimizeFaces(bad, 1, 3, nullptr, remap);
+        if (hr != E_UNEXPECTED)
+        {
+            success = false;
+            printf("ERROR: Expected E_UNEXPECTED from OptimizeFaces (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+    }
+
+    auto cup = std::make_unique<WaveFrontReader<uint16_t>>();
+    HRESULT hr = cup->Load(c_CupMedia);
+    if (FAILED(hr))
+    {
+        printf("Failed loading OBJ from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), c_CupMedia);
+        return false;
+    }
+
+    // Bounds for every tail length of the unrolled loop, packed and strided
+    for (size_t count = 1; count <= 9; ++count)
+    {
+        if (!CheckBounds(&cup->vertices[0].position, count, sizeof(WaveFrontReader<uint16_t>::Vertex)))
+            success = false;
+    }
+
+    if (!CheckBounds(&cup->vertices[0].position, cup->vertices.size(), sizeof(WaveFrontReader<uint16_t>::Vertex)))
+        success = false;
+
+    {
+        std::vector<XMFLOAT3> packed;
+        for (const auto& it : cup->vertices)
+        {
+            packed.push_back(it.position);
+        }
+
+        if (!CheckBounds(packed.data(), packed.size(), sizeof(XMFLOAT3)))
+            success = false;
+    }
+
+    // Subset-sorted cup, as prepared by CreateModelFromOBJ
+    {
+        std::vector<uint32_t> order(cup->attributes.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return cup->attributes[a] < cup->attributes[b]; });
+        std::ignore = MeshOptimizer::ReorderFaces(cup->indices, cup->attributes, order.data());
+
+        if (!CheckOptimize(*cup, c_CupMedia))
+            success = false;
+    }
+
+    // Procedural mesh in file order and with shuffled faces
+    const auto path = std::filesystem::temp_directory_path() / L"wavefronttest_optimize.obj";
+    if (!WriteSyntheticOBJ(path, c_SyntheticGrid))
+    {
+        printf("ERROR: Failed writing synthetic OBJ:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    for (const bool shuffle : { false, true })
+    {
+        auto obj = std::make_unique<WaveFrontReader<uint32_t>>();
+        hr = obj->LoadMapped(path.wstring().c_str());
+        if (FAILED(hr))
+        {
+            success = false;
+            printf("Failed loading synthetic OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            break;
+        }
+
+        if (shuffle)
+        {
+            ShuffleFaces(*obj, 42);
+
+            // Shuffling mixes the attribute runs, so reorder across the whole mesh
+            std::fill(obj->attributes.begin(), obj->attributes.end(), 0u);
+        }
+
+        if (!CheckOptimize(*obj, shuffle ? L"synthetic (shuffled)" : L"synthetic"))
+            success = false;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Post-processing cost and post-transform cache statistics on a large mesh
+bool Benchmark05()
+{
+    const auto path = std::filesystem::temp_directory_path() / L"wavefronttest_benchmark.obj";
+    if (!WriteSyntheticOBJ(path, c_BenchmarkGrid))
+    {
+        printf("ERROR: Failed writing benchmark OBJ:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    auto obj = std::make_unique<WaveFrontReader<uint32_t>>();
+    HRESULT hr = obj->LoadMapped(path.wstring().c_str());
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    if (FAILED(hr))
+    {
+        printf("Failed loading benchmark OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        return false;
+    }
+
+    using Vertex = WaveFrontReader<uint32_t>::Vertex;
+
+    printf("\n\t%zu vertices, %zu faces\n", obj->vertices.size(), obj->attributes.size());
+
+    // Bounds
+    {
+        BoundingBox box;
+        BoundingSphere sphere;
+
+        auto start = std::chrono::steady_clock::now();
+        BoundingSphere::CreateFromPoints(sphere, obj->vertices.size(), &obj->vertices[0].position, sizeof(Vertex));
+        BoundingBox::CreateFromPoints(box, obj->vertices.size(), &obj->vertices[0].position, sizeof(Vertex));
+        const double separateTime = ElapsedMilliseconds(start);
+
+        start = std::chrono::steady_clock::now();
+        MeshOptimizer::ComputeBounds(&obj->vertices[0].position, obj->vertices.size(), sizeof(Vertex), box, sphere);
+        const double fusedTime = ElapsedMilliseconds(start);
+
+        printf("\tbounds: CreateFromPoints %8.2f ms, ComputeBounds %8.2f ms\n", separateTime, fusedTime);
+    }
+
+    bool success = true;
+    for (const bool shuffle : { false, true })
+    {
+        auto copy = std::make_unique<WaveFrontReader<uint32_t>>();
+        copy->vertices = obj->vertices;
+        copy->indices = obj->indices;
+        copy->attributes = obj->attributes;
+
+        if (shuffle)
+        {
+            ShuffleFaces(*copy, 7);
+            std::fill(copy->attributes.begin(), copy->attributes.end(), 0u);
+        }
+
+        MeshOptimizer::Statistics stats = {};
+        auto start = std::chrono::steady_clock::now();
+        hr = MeshOptimizer::Optimize(copy->vertices, copy->indices, copy->attributes, &stats);
+        const double optimizeTime = ElapsedMilliseconds(start);
+
+        if (FAILED(hr))
+        {
+            printf("ERROR: Optimize failed (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            success = false;
+            continue;
+        }
+
+        printf("\t%-14s optimize %8.2f ms  ACMR %.3f -> %.3f  ATVR %.3f -> %.3f\n",
+            shuffle ? "shuffled:" : "file order:", optimizeTime,
+            double(stats.acmrBefore), double(stats.acmrAfter), double(stats.atvrBefore), double(stats.atvrAfter));
+
+        if (stats.acmrAfter > stats.acmrBefore)
+            success = false;
+    }
+
+    return success;
+}
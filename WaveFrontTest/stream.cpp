@@ -0,0 +1,272 @@
+//-------------------------------------------------------------------------------------
+// stream.cpp
+//
+// Copyright (c) Microsoft Corporation.
+//-------------------------------------------------------------------------------------
+
+#include "WaveFrontReader.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t c_StreamGrid = 256;
+    constexpr size_t c_MemoryLimit = 1024 * 1024;
+
+    const wchar_t* c_CupMedia = L"ModelTest/cup._obj";
+
+    // Triangle corners expanded to vertex data, which is independent of how vertices are welded
+    struct ExpandedMesh
+    {
+        std::vector<uint8_t>    corners;
+        std::vector<uint32_t>   attributes;
+    };
+
+    template<class index_t>
+    void Expand(const WaveFrontReader<index_t>& obj, ExpandedMesh& mesh)
+    {
+        using Vertex = typename WaveFrontReader<index_t>::Vertex;
+
+        mesh.corners.resize(obj.indices.size() * sizeof(Vertex));
+        for (size_t j = 0; j < obj.indices.size(); ++j)
+        {
+            memcpy(&mesh.corners[j * sizeof(Vertex)], &obj.vertices[obj.indices[j]], sizeof(Vertex));
+        }
+        mesh.attributes = obj.attributes;
+    }
+
+    template<class index_t>
+    struct StreamCollector
+    {
+        using Reader = WaveFrontReader<index_t>;
+
+        ExpandedMesh    mesh;
+        size_t          maxVertices = 0;
+        size_t          maxFaces = 0;
+        bool            valid = true;
+
+        HRESULT operator()(const typename Reader::StreamBatch& batch)
+        {
+            using Vertex = typename Reader::Vertex;
+
+            const size_t faces = batch.indexCount / 3;
+            if (!faces
+                || (batch.indexCount % 3) != 0
+                || batch.vertexCount > maxVertices
+                || faces > maxFaces
+                || batch.baseFace != mesh.attributes.size())
+            {
+                printf("ERROR: Invalid batch (%zu vertices, %zu indices, base %zu)\n", batch.vertexCount, batch.indexCount, batch.baseFace);
+                valid = false;
+                return E_FAIL;
+            }
+
+            const size_t offset = mesh.corners.size();
+            mesh.corners.resize(offset + batch.indexCount * sizeof(Vertex));
+            for (size_t j = 0; j < batch.indexCount; ++j)
+            {
+                if (batch.indices[j] >= batch.vertexCount)
+                {
+                    printf("ERROR: Batch index out of range\n");
+                    valid = false;
+                    return E_FAIL;
+                }
+
+                memcpy(&mesh.corners[offset + j * sizeof(Vertex)], &batch.vertices[batch.indices[j]], sizeof(Vertex));
+            }
+
+            mesh.attributes.insert(mesh.attributes.end(), batch.attributes, batch.attributes + faces);
+            return S_OK;
+        }
+    };
+
+    bool CompareMesh(const ExpandedMesh& a, const ExpandedMesh& b)
+    {
+        if (a.corners != b.corners)
+        {
+            printf("ERROR: Streamed triangles differ (%zu vs. %zu bytes)\n", a.corners.size(), b.corners.size());
+            return false;
+        }
+
+        if (a.attributes != b.attributes)
+        {
+            printf("ERROR: Streamed attributes differ\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    template<class index_t, class ref_t>
+    bool CompareMetadata(const WaveFrontReader<index_t>& obj, const WaveFrontReader<ref_t>& ref)
+    {
+        if (!obj.vertices.empty() || !obj.indices.empty() || !obj.attributes.empty()
+            || obj.materials.size() != ref.materials.size()
+            || obj.name != ref.name
+            || obj.hasNormals != ref.hasNormals
+            || obj.hasTexcoords != ref.hasTexcoords
+            || memcmp(&obj.bounds, &ref.bounds, sizeof(DirectX::BoundingBox)) != 0)
+        {
+            printf("ERROR: Streamed metadata mismatch\n");
+            return false;
+        }
+
+        for (size_t j = 0; j < obj.materials.size(); ++j)
+        {
+            if (wcscmp(obj.materials[j].strName, ref.materials[j].strName) != 0
+                || wcscmp(obj.materials[j].strTexture, ref.materials[j].strTexture) != 0)
+            {
+                printf("ERROR: Streamed material %zu mismatch\n", j);
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+//-------------------------------------------------------------------------------------
+
+extern bool WriteSyntheticOBJ(const std::filesystem::path& path, uint32_t gridSize);
+
+//-------------------------------------------------------------------------------------
+// Streaming loader with bounded memory
+bool Test06()
+{
+    bool success = true;
+
+    // Small batches without a memory limit
+    for (const bool ccw : { true, false })
+    {
+        auto ref = std::make_unique<WaveFrontReader<uint16_t>>();
+        HRESULT hr = ref->Load(c_CupMedia, ccw);
+        if (FAILED(hr))
+        {
+            printf("Failed loading OBJ from file (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), c_CupMedia);
+            return false;
+        }
+
+        ExpandedMesh expected;
+        Expand(*ref, expected);
+
+        WaveFrontReader<uint16_t>::StreamOptions options;
+        options.maxBatchVertices = 64;
+        options.maxBatchFaces = 124;
+        options.ccw = ccw;
+
+        StreamCollector<uint16_t> collector;
+        collector.maxVertices = options.maxBatchVertices;
+        collector.maxFaces = options.maxBatchFaces;
+
+        auto obj = std::make_unique<WaveFrontReader<uint16_t>>();
+        WaveFrontReader<uint16_t>::StreamStats stats = {};
+        hr = obj->LoadStreaming(c_CupMedia, std::ref(collector), options, &stats);
+        if (FAILED(hr) || !collector.valid)
+        {
+            success = false;
+            printf("Failed streaming OBJ (HRESULT %08X):\n%ls\n", static_cast<unsigned int>(hr), c_CupMedia);
+        }
+        else if (!CompareMesh(collector.mesh, expected)
+            || !CompareMetadata(*obj, *ref)
+            || stats.faces != ref->attributes.size()
+            || stats.batches < (ref->attributes.size() / options.maxBatchFaces)
+            || stats.spilledBytes != 0)
+        {
+            success = false;
+            printf("Streaming mismatch (%s):\n%ls\n", ccw ? "ccw" : "cw", c_CupMedia);
+        }
+    }
+
+    // Mesh whose attribute arrays exceed the memory limit must spill to disk
+    const auto path = std::filesystem::temp_directory_path() / L"wavefronttest_stream.obj";
+    if (!WriteSyntheticOBJ(path, c_StreamGrid))
+    {
+        printf("ERROR: Failed writing synthetic OBJ:\n%ls\n", path.wstring().c_str());
+        return false;
+    }
+
+    {
+        auto ref = std::make_unique<WaveFrontReader<uint32_t>>();
+        HRESULT hr = ref->LoadMapped(path.wstring().c_str());
+        if (FAILED(hr))
+        {
+            printf("Failed loading synthetic OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+            return false;
+        }
+
+        ExpandedMesh expected;
+        Expand(*ref, expected);
+
+        WaveFrontReader<uint16_t>::StreamOptions options;
+        options.maxBatchVertices = 4096;
+        options.maxBatchFaces = 8192;
+        options.memoryLimit = c_MemoryLimit;
+
+        StreamCollector<uint16_t> collector;
+        collector.maxVertices = options.maxBatchVertices;
+        collector.maxFaces = options.maxBatchFaces;
+
+        auto obj = std::make_unique<WaveFrontReader<uint16_t>>();
+        WaveFrontReader<uint16_t>::StreamStats stats = {};
+        hr = obj->LoadStreaming(path.wstring().c_str(), std::ref(collector), options, &stats);
+
+        const size_t attributeBytes = ref->vertices.size() * sizeof(DirectX::XMFLOAT3) * 2;
+        if (FAILED(hr) || !collector.valid)
+        {
+            success = false;
+            printf("Failed streaming synthetic OBJ (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+        else if (!CompareMesh(collector.mesh, expected) || !CompareMetadata(*obj, *ref))
+        {
+            success = false;
+            printf("Streaming mismatch for synthetic OBJ\n");
+        }
+        else if (attributeBytes <= c_MemoryLimit || stats.peakMemory > c_MemoryLimit || !stats.spilledBytes)
+        {
+            success = false;
+            printf("ERROR: Memory limit not honored (peak %zu, spilled %zu, limit %zu)\n", stats.peakMemory, stats.spilledBytes, c_MemoryLimit);
+        }
+    }
+
+    // Callback failures stop the load
+    {
+        WaveFrontReader<uint16_t> obj;
+        size_t calls = 0;
+        HRESULT hr = obj.LoadStreaming(path.wstring().c_str(),
+            [&](const WaveFrontReader<uint16_t>::StreamBatch&) -> HRESULT
+            {
+                ++calls;
+                return E_ABORT;
+            });
+        if (hr != E_ABORT || calls != 1)
+        {
+            success = false;
+            printf("ERROR: Expected E_ABORT from callback (HRESULT %08X, %zu calls)\n", static_cast<unsigned int>(hr), calls);
+        }
+    }
+
+    // Invalid batch limits
+    {
+        WaveFrontReader<uint16_t> obj;
+        WaveFrontReader<uint16_t>::StreamOptions options;
+        options.maxBatchVertices = 3;
+
+        HRESULT hr = obj.LoadStreaming(path.wstring().c_str(),
+            [](const WaveFrontReader<uint16_t>::StreamBatch&) -> HRESULT { return S_OK; }, options);
+        if (hr != E_INVALIDARG)
+        {
+            success = false;
+            printf("ERROR: Expected E_INVALIDARG for batch limits (HRESULT %08X)\n", static_cast<unsigned int>(hr));
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    return success;
+}
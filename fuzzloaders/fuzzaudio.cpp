@@ -0,0 +1,254 @@
+//--------------------------------------------------------------------------------------
+// File: fuzzaudio.cpp
+//
+// Fuzz target for the WAV and XWB file parsers which doesn't need Direct3D.
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248929
+//--------------------------------------------------------------------------------------
+
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#define NODRAWTEXT
+#define NOGDI
+#define NOBITMAP
+#define NOMCX
+#define NOSERVICE
+#define NOHELP
+#pragma warning(pop)
+
+#include <Windows.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "WaveBankReader.h"
+#include "WAVFileReader.h"
+
+namespace
+{
+    //----------------------------------------------------------------------------------
+    // WaveBankReader only parses from a path, so wave bank inputs go through one scratch file
+    // that is reused for the whole run.
+    class ScratchFile
+    {
+    public:
+        ScratchFile() noexcept : m_path{}
+        {
+            wchar_t tempPath[MAX_PATH] = {};
+            if (GetTempPathW(MAX_PATH, tempPath))
+            {
+                std::ignore = GetTempFileNameW(tempPath, L"fuzz", 0, m_path);
+            }
+        }
+
+        ScratchFile(ScratchFile&&) = delete;
+        ScratchFile& operator= (ScratchFile&&) = delete;
+
+        ScratchFile(ScratchFile const&) = delete;
+        ScratchFile& operator= (ScratchFile const&) = delete;
+
+        ~ScratchFile()
+        {
+            if (*m_path)
+            {
+                std::ignore = DeleteFileW(m_path);
+            }
+        }
+
+        bool Write(const uint8_t* data, size_t size) noexcept
+        {
+            if (!*m_path)
+                return false;
+
+            HANDLE hFile = CreateFileW(m_path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                FILE_ATTRIBUTE_TEMPORARY, nullptr);
+            if (hFile == INVALID_HANDLE_VALUE)
+                return false;
+
+            DWORD bytesWritten = 0;
+            const BOOL result = WriteFile(hFile, data, static_cast<DWORD>(size), &bytesWritten, nullptr);
+            CloseHandle(hFile);
+
+            return result && (bytesWritten == size);
+        }
+
+        const wchar_t* GetPath() const noexcept { return m_path; }
+
+    private:
+        wchar_t m_path[MAX_PATH];
+    };
+
+    //----------------------------------------------------------------------------------
+    // Runs one input through both parsers
+    int FuzzOneInput(const uint8_t* data, size_t size)
+    {
+        {
+            DirectX::WAVData result = {};
+            std::ignore = DirectX::LoadWAVAudioInMemoryEx(data, size, result);
+        }
+
+        // Everything without a wave bank signature (in either byte order) fails the reader's
+        // first check, so there's nothing to gain from writing it out
+        if (size < 4 || (memcmp(data, "WBND", 4) != 0 && memcmp(data, "DNBW", 4) != 0))
+            return 0;
+
+        static ScratchFile s_scratch;
+        if (!s_scratch.Write(data, size))
+            return 0;
+
+        auto wb = std::make_unique<DirectX::WaveBankReader>();
+        if (FAILED(wb->Open(s_scratch.GetPath())))
+            return 0;
+
+        wb->WaitOnPrepare();
+
+        // Walk every entry, as playing the bank would
+        const bool streaming = wb->IsStreamingBank();
+        for (uint32_t j = 0; j < wb->Count(); ++j)
+        {
+            uint8_t format[64] = {};
+            std::ignore = wb->GetFormat(j, reinterpret_cast<WAVEFORMATEX*>(format), sizeof(format));
+
+            DirectX::WaveBankReader::Metadata metadata = {};
+            std::ignore = wb->GetMetadata(j, metadata);
+
+            if (!streaming)
+            {
+                const uint8_t* wavData = nullptr;
+                uint32_t audioBytes = 0;
+                std::ignore = wb->GetWaveData(j, &wavData, audioBytes);
+            }
+        }
+
+        return 0;
+    }
+
+#ifndef FUZZING_BUILD_MODE
+    bool ReadInput(const wchar_t* path, std::vector<uint8_t>& data)
+    {
+        FILE* file = nullptr;
+        if (_wfopen_s(&file, path, L"rb") != 0 || !file)
+            return false;
+
+        data.clear();
+
+        uint8_t buffer[65536];
+        size_t bytes = 0;
+        while ((bytes = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            data.insert(data.end(), buffer, buffer + bytes);
+        }
+
+        fclose(file);
+        return true;
+    }
+
+    void PrintUsage()
+    {
+        wprintf(L"DirectX Tool Kit for DX11\n\n");
+        wprintf(L"Usage: fuzzaudio [-iterations <n>] <files>\n");
+        wprintf(L"\n");
+        wprintf(L"   -iterations <n>     passes over the inputs, for measuring exec/s (defaults to 1)\n");
+    }
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry-point
+//--------------------------------------------------------------------------------------
+#ifndef FUZZING_BUILD_MODE
+
+// Without libFuzzer this replays inputs and reports parser throughput
+int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
+{
+    size_t iterations = 1;
+    std::vector<std::vector<uint8_t>> inputs;
+
+    for (int iArg = 1; iArg < argc; ++iArg)
+    {
+        const wchar_t* arg = argv[iArg];
+
+        if (!wcscmp(arg, L"-iterations"))
+        {
+            if (iArg + 1 >= argc)
+            {
+                PrintUsage();
+                return 1;
+            }
+
+            iterations = static_cast<size_t>(_wtoi(argv[++iArg]));
+            if (!iterations)
+            {
+                PrintUsage();
+                return 1;
+            }
+            continue;
+        }
+
+        std::vector<uint8_t> data;
+        if (!ReadInput(arg, data))
+        {
+            wprintf(L"ERROR: Failed reading input:\n%ls\n", arg);
+            return 1;
+        }
+
+        inputs.emplace_back(std::move(data));
+    }
+
+    if (inputs.empty())
+    {
+        wprintf(L"ERROR: Need at least 1 input to fuzz\n\n");
+        PrintUsage();
+        return 0;
+    }
+
+    size_t totalBytes = 0;
+    for (const auto& it : inputs)
+    {
+        totalBytes += it.size();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t pass = 0; pass < iterations; ++pass)
+    {
+        for (const auto& it : inputs)
+        {
+            std::ignore = FuzzOneInput(it.data(), it.size());
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const size_t execs = inputs.size() * iterations;
+
+    wprintf(L"%zu inputs (%zu bytes), %zu execs in %.3f s: %.0f exec/s\n",
+        inputs.size(), totalBytes, execs, seconds,
+        (seconds > 0) ? double(execs) / seconds : 0.0);
+
+    return 0;
+}
+
+#else // FUZZING_BUILD_MODE
+
+//--------------------------------------------------------------------------------------
+// Libfuzzer entry-point
+//--------------------------------------------------------------------------------------
+extern "C" __declspec(dllexport) int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    return FuzzOneInput(data, size);
+}
+
+#endif // FUZZING_BUILD_MODE
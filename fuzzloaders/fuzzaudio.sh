@@ -0,0 +1,99 @@
+#!/bin/bash
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+#
+# Runs parallel libFuzzer workers against fuzzaudio (built with BUILD_FUZZING), then merges
+# what they found into one corpus.
+#
+# Usage: fuzzaudio.sh <fuzzaudio> [workers] [seconds] [outdir]
+#
+#   workers     number of fuzzer processes (defaults to the number of CPUs)
+#   seconds     how long each worker runs (defaults to 600)
+#   outdir      corpus, worker logs, and crash artifacts (defaults to ./fuzzaudio-out)
+#
+# The seed corpus is the WAV and XWB media used by WavTest plus its crash-*.wav reproducers.
+# An existing <outdir>/corpus is kept, so repeated runs build on each other.
+#
+# fuzzaudio is a Windows target; run this from a bash shell such as the one in Git for Windows.
+
+set -u
+
+if [ $# -lt 1 ]; then
+    sed -n '8,15p' "$0" | cut -c3-
+    exit 1
+fi
+
+FUZZER=$(realpath "$1")
+WORKERS=${2:-$(nproc)}
+SECONDS_PER_WORKER=${3:-600}
+OUTDIR=${4:-fuzzaudio-out}
+MAX_LEN=${MAX_LEN:-1048576}
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+
+mkdir -p "$OUTDIR/corpus" "$OUTDIR/artifacts"
+
+# Seed from the files named in WavTest's media tables
+SEEDS=0
+for media in $(grep -ho 'L"[^"]*\.\(wav\|xwb\)"' "$ROOT/WavTest/wav.cpp" "$ROOT/WavTest/xwb.cpp" | sed -e 's/^L"//' -e 's/"$//' -e 's/\\\\/\//g'); do
+    if [ -f "$ROOT/$media" ]; then
+        cp "$ROOT/$media" "$OUTDIR/corpus/seed-${media//\//-}"
+        SEEDS=$((SEEDS + 1))
+    fi
+done
+
+for crash in "$ROOT"/WavTest/crash-*.wav; do
+    if [ -f "$crash" ]; then
+        cp "$crash" "$OUTDIR/corpus/seed-$(basename "$crash")"
+        SEEDS=$((SEEDS + 1))
+    fi
+done
+
+BEFORE=$(ls "$OUTDIR/corpus" | wc -l)
+echo "fuzzaudio: $SEEDS seeds, $BEFORE corpus entries, $WORKERS worker(s) for ${SECONDS_PER_WORKER}s"
+
+# Each worker reads the shared corpus but only adds to its own directory
+PIDS=()
+for ((i = 0; i < WORKERS; i++)); do
+    mkdir -p "$OUTDIR/worker$i"
+    "$FUZZER" -max_len="$MAX_LEN" -max_total_time="$SECONDS_PER_WORKER" -print_final_stats=1 \
+        -seed=$((i + 1)) -artifact_prefix="$OUTDIR/artifacts/" \
+        "$OUTDIR/worker$i" "$OUTDIR/corpus" > "$OUTDIR/worker$i.log" 2>&1 &
+    PIDS+=($!)
+done
+
+FAILED=0
+for ((i = 0; i < WORKERS; i++)); do
+    if ! wait "${PIDS[$i]}"; then
+        echo "worker$i: FAILED, see $OUTDIR/worker$i.log"
+        FAILED=1
+    fi
+done
+
+# Throughput, from libFuzzer's final stats
+TOTAL_RATE=0
+TOTAL_EXECS=0
+for ((i = 0; i < WORKERS; i++)); do
+    EXECS=$(grep -o 'stat::number_of_executed_units: *[0-9]*' "$OUTDIR/worker$i.log" | grep -o '[0-9]*$')
+    RATE=$(grep -o 'stat::average_exec_per_sec: *[0-9]*' "$OUTDIR/worker$i.log" | grep -o '[0-9]*$')
+    echo "worker$i: ${EXECS:-0} execs, ${RATE:-0} exec/s"
+    TOTAL_EXECS=$((TOTAL_EXECS + ${EXECS:-0}))
+    TOTAL_RATE=$((TOTAL_RATE + ${RATE:-0}))
+done
+echo "total: $TOTAL_EXECS execs, $TOTAL_RATE exec/s"
+
+# Keep only the inputs that add coverage
+"$FUZZER" -merge=1 -max_len="$MAX_LEN" "$OUTDIR/corpus" "$OUTDIR"/worker* > "$OUTDIR/merge.log" 2>&1 \
+    || { echo "merge: FAILED, see $OUTDIR/merge.log"; FAILED=1; }
+rm -rf "$OUTDIR"/worker*/
+
+AFTER=$(ls "$OUTDIR/corpus" | wc -l)
+echo "corpus: $BEFORE -> $AFTER entries"
+
+CRASHES=$(ls "$OUTDIR/artifacts" | wc -l)
+if [ "$CRASHES" -gt 0 ]; then
+    echo "$CRASHES artifact(s) in $OUTDIR/artifacts"
+    FAILED=1
+fi
+
+exit $FAILED
@@ -26,13 +26,20 @@
 #include <d3d11_1.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cwchar>
 #include <iterator>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <system_error>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -72,6 +79,8 @@ namespace
         OPT_WAV,
         OPT_WIC,
         OPT_XWB,
+        OPT_THREADS,
+        OPT_CHECKPOINT,
         OPT_MAX
     };
 
@@ -99,6 +108,8 @@ namespace
         { L"wav",       OPT_WAV },
         { L"wic",       OPT_WIC },
         { L"xwb",       OPT_XWB },
+        { L"j",         OPT_THREADS },
+        { L"checkpoint", OPT_CHECKPOINT },
         { nullptr,      0 }
     };
 
@@ -207,6 +218,8 @@ namespace
         wprintf(L"   -wav                force use of WAVFileReader\n");
         wprintf(L"   -wic                force use of WICTextureLoader\n");
         wprintf(L"   -xwb                force use of WaveBankReader\n");
+        wprintf(L"   -j <count>          validate files on <count> threads (0 for one per CPU)\n");
+        wprintf(L"   -checkpoint <file>  record finished files, and skip those already recorded\n");
     }
 
 #endif // !FUZZING_BUILD_MODE
@@ -247,109 +260,64 @@ namespace
     }
 }
 
-//--------------------------------------------------------------------------------------
-// Entry-point
-//--------------------------------------------------------------------------------------
 #ifndef FUZZING_BUILD_MODE
 
-#ifdef _PREFAST_
-#pragma prefast(disable : 28198, "Command-line tool, frees all memory on exit")
-#endif
-
-int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
+namespace
 {
-    // Initialize COM (needed for WIC)
-    HRESULT hr = hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    if (FAILED(hr))
-    {
-        wprintf(L"Failed to initialize COM (%08X)\n", static_cast<unsigned int>(hr));
-        return 1;
-    }
-
-    // Process command line
-    DWORD dwOptions = 0;
-    std::list<SConversion> conversion;
+    //////////////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////////////
 
-    for (int iArg = 1; iArg < argc; iArg++)
+    enum FORMAT
     {
-        PWSTR pArg = argv[iArg];
-
-        if (('-' == pArg[0]) || ('/' == pArg[0]))
-        {
-            pArg++;
-            PWSTR pValue;
-
-            for (pValue = pArg; *pValue && (':' != *pValue); pValue++);
-
-            if (*pValue)
-                *pValue++ = 0;
+        FORMAT_DDS,
+        FORMAT_WAV,
+        FORMAT_XWB,
+        FORMAT_WIC,
+        FORMAT_MAX
+    };
 
-            DWORD dwOption = LookupByName(pArg, g_pOptions);
+    const wchar_t* const g_FormatNames[FORMAT_MAX] = { L"DDS", L"WAV", L"XWB", L"WIC" };
 
-            if (!dwOption || (dwOptions & (1 << dwOption)))
-            {
-                PrintUsage();
-                return 1;
-            }
+    // Files are handed to threads in shards of this many
+    constexpr size_t c_ShardSize = 16;
 
-            dwOptions |= 1 << dwOption;
+    struct FormatStats
+    {
+        size_t      files;
+        size_t      failures;
+        uint64_t    bytes;
+        double      seconds;
+    };
 
-            switch (dwOption)
-            {
-            case OPT_DDS:
-            case OPT_WAV:
-            case OPT_WIC:
-            case OPT_XWB:
-                if ((dwOptions & ((1 << OPT_DDS) | (1 << OPT_WAV) | (1 << OPT_WIC) | (1 << OPT_XWB))) & ~(1 << dwOption))
-                {
-                    wprintf(L"-dds, -wav, -wic, and -xwb are mutually exclusive options\n");
-                    return 1;
-                }
-                break;
+    // Everything a thread needs to validate files. The device is only created for the first
+    // DDS or WIC file, so audio-only runs never need one.
+    struct LoaderState
+    {
+        ComPtr<ID3D11Device>    device;
+        HRESULT                 deviceResult = S_FALSE;
+        FormatStats             stats[FORMAT_MAX] = {};
 
-            default:
-                break;
-            }
-        }
-        else if (wcspbrk(pArg, L"?*") != nullptr)
+        ID3D11Device* GetDevice()
         {
-            size_t count = conversion.size();
-            SearchForFiles(pArg, conversion, (dwOptions & (1 << OPT_RECURSIVE)) != 0);
-            if (conversion.size() <= count)
+            if (deviceResult == S_FALSE)
             {
-                wprintf(L"No matching files found for %ls\n", pArg);
-                return 1;
+                ComPtr<ID3D11DeviceContext> context;
+                deviceResult = CreateDevice(device.GetAddressOf(), context.GetAddressOf());
             }
-        }
-        else
-        {
-            SConversion conv;
-            wcscpy_s(conv.szSrc, MAX_PATH, pArg);
 
-            conversion.push_back(conv);
+            return SUCCEEDED(deviceResult) ? device.Get() : nullptr;
         }
-    }
-
-    if (conversion.empty())
-    {
-        wprintf(L"ERROR: Need at least 1 image file to fuzz\n\n");
-        PrintUsage();
-        return 0;
-    }
-
-    ComPtr<ID3D11Device> device;
-    ComPtr<ID3D11DeviceContext> context;
-    hr = CreateDevice(device.GetAddressOf(), context.GetAddressOf());
-    if (FAILED(hr))
-    {
-        wprintf(L"ERROR: Failed to create required Direct3D device to fuzz: %08X\n", static_cast<unsigned int>(hr));
-        return 1;
-    }
+    };
 
-    for (auto& pConv : conversion)
+    //----------------------------------------------------------------------------------
+    // Loads one file with the loader its extension (or the options) select. Returns the
+    // progress mark: '*' loaded, '.' rejected as expected, '!' unexpected failure. Returns 0
+    // if the run can't continue, having printed why.
+    wchar_t ValidateFile(const wchar_t* szSrc, DWORD dwOptions, LoaderState& state, bool progress)
     {
         wchar_t ext[_MAX_EXT];
-        _wsplitpath_s(pConv.szSrc, nullptr, 0, nullptr, 0, nullptr, 0, ext, _MAX_EXT);
+        _wsplitpath_s(szSrc, nullptr, 0, nullptr, 0, nullptr, 0, ext, _MAX_EXT);
         bool isdds = (_wcsicmp(ext, L".dds") == 0);
         bool iswav = (_wcsicmp(ext, L".wav") == 0);
         bool isxwb = (_wcsicmp(ext, L".xwb") == 0);
@@ -378,20 +346,37 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
         // Load source image
 #ifdef _DEBUG
-        OutputDebugStringW(pConv.szSrc);
+        OutputDebugStringW(szSrc);
         OutputDebugStringA("\n");
 #endif
 
+        const FORMAT format = usedds ? FORMAT_DDS : (usewav ? FORMAT_WAV : (usexwb ? FORMAT_XWB : FORMAT_WIC));
+
+        ID3D11Device* device = nullptr;
+        if (format == FORMAT_DDS || format == FORMAT_WIC)
+        {
+            device = state.GetDevice();
+            if (!device)
+            {
+                wprintf(L"ERROR: Failed to create required Direct3D device to fuzz: %08X\n", static_cast<unsigned int>(state.deviceResult));
+                return 0;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        wchar_t mark = L'.';
+        HRESULT hr = S_OK;
         ComPtr<ID3D11Resource> tex;
         if (usedds)
         {
-            hr = DirectX::CreateDDSTextureFromFileEx(device.Get(), pConv.szSrc, 0,
+            hr = DirectX::CreateDDSTextureFromFileEx(device, szSrc, 0,
                 D3D11_USAGE_STAGING, 0, D3D11_CPU_ACCESS_WRITE, 0,
                 DirectX::DDS_LOADER_DEFAULT, tex.GetAddressOf(), nullptr, nullptr);
             if (hr == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND))
             {
-                wprintf(L"ERROR: DDSTexture file not not found:\n%ls\n", pConv.szSrc);
-                return 1;
+                wprintf(L"ERROR: DDSTexture file not not found:\n%ls\n", szSrc);
+                return 0;
             }
             else if (FAILED(hr) && hr != E_INVALIDARG && hr != HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED) && hr != E_OUTOFMEMORY && hr != HRESULT_FROM_WIN32(ERROR_HANDLE_EOF) && (hr != E_FAIL || (hr == E_FAIL && isdds)))
             {
@@ -400,22 +385,22 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 sprintf_s(buff, "DDSTexture failed with %08X\n", static_cast<unsigned int>(hr));
                 OutputDebugStringA(buff);
 #endif
-                wprintf(L"!");
+                mark = L'!';
             }
             else
             {
-                wprintf(L"%ls", SUCCEEDED(hr) ? L"*" : L".");
+                mark = SUCCEEDED(hr) ? L'*' : L'.';
             }
         }
         else if (usewav)
         {
             std::unique_ptr<uint8_t[]> data;
             DirectX::WAVData result = {};
-            hr = DirectX::LoadWAVAudioFromFileEx(pConv.szSrc, data, result);
+            hr = DirectX::LoadWAVAudioFromFileEx(szSrc, data, result);
             if (hr == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND))
             {
-                wprintf(L"ERROR: WAVAudio file not not found:\n%ls\n", pConv.szSrc);
-                return 1;
+                wprintf(L"ERROR: WAVAudio file not not found:\n%ls\n", szSrc);
+                return 0;
             }
             else if (FAILED(hr) && hr != E_INVALIDARG && hr != HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED) && hr != E_OUTOFMEMORY && hr != HRESULT_FROM_WIN32(ERROR_INVALID_DATA) && hr != HRESULT_FROM_WIN32(ERROR_HANDLE_EOF) && (hr != E_FAIL || (hr == E_FAIL && iswav)))
             {
@@ -424,21 +409,21 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 sprintf_s(buff, "WAVAudio failed with %08X\n", static_cast<unsigned int>(hr));
                 OutputDebugStringA(buff);
 #endif
-                wprintf(L"!");
+                mark = L'!';
             }
             else
             {
-                wprintf(L"%ls", SUCCEEDED(hr) ? L"*" : L".");
+                mark = SUCCEEDED(hr) ? L'*' : L'.';
             }
         }
         else if (usexwb)
         {
             auto wb = std::make_unique<DirectX::WaveBankReader>();
-            hr = wb->Open(pConv.szSrc);
+            hr = wb->Open(szSrc);
             if (hr == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND))
             {
-                wprintf(L"ERROR: XWBAudio file not not found:\n%ls\n", pConv.szSrc);
-                return 1;
+                wprintf(L"ERROR: XWBAudio file not not found:\n%ls\n", szSrc);
+                return 0;
             }
             else if (FAILED(hr) && hr != E_INVALIDARG && hr != HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED) && hr != E_OUTOFMEMORY && hr != HRESULT_FROM_WIN32(ERROR_HANDLE_EOF) && (hr != E_FAIL || (hr == E_FAIL && isxwb)))
             {
@@ -447,26 +432,29 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 sprintf_s(buff, "XWBAudio failed with %08X\n", static_cast<unsigned int>(hr));
                 OutputDebugStringA(buff);
 #endif
-                wprintf(L"!");
+                mark = L'!';
             }
             else if (SUCCEEDED(hr))
             {
-                wprintf(L"w");
+                if (progress)
+                {
+                    wprintf(L"w");
+                }
                 wb->WaitOnPrepare();
-                wprintf(L"\b*");
-            }
-            else
-            {
-                wprintf(L".");
+                if (progress)
+                {
+                    wprintf(L"\b");
+                }
+                mark = L'*';
             }
         }
         else
         {
-            hr = DirectX::CreateWICTextureFromFileEx(device.Get(), pConv.szSrc, 0, D3D11_USAGE_STAGING, 0, D3D11_CPU_ACCESS_WRITE, 0, DirectX::WIC_LOADER_DEFAULT, tex.GetAddressOf(), nullptr);
+            hr = DirectX::CreateWICTextureFromFileEx(device, szSrc, 0, D3D11_USAGE_STAGING, 0, D3D11_CPU_ACCESS_WRITE, 0, DirectX::WIC_LOADER_DEFAULT, tex.GetAddressOf(), nullptr);
             if (hr == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND))
             {
-                wprintf(L"ERROR: WICTexture file not found:\n%ls\n", pConv.szSrc);
-                return 1;
+                wprintf(L"ERROR: WICTexture file not found:\n%ls\n", szSrc);
+                return 0;
             }
             else if (FAILED(hr) && hr != E_INVALIDARG && hr != HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED) && hr != WINCODEC_ERR_COMPONENTNOTFOUND && hr != E_OUTOFMEMORY && hr != WINCODEC_ERR_BADHEADER)
             {
@@ -475,18 +463,388 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 sprintf_s(buff, "WICTexture failed with %08X\n", static_cast<unsigned int>(hr));
                 OutputDebugStringA(buff);
 #endif
-                wprintf(L"!");
+                mark = L'!';
             }
             else
             {
-                wprintf(L"%ls", SUCCEEDED(hr) ? L"*" : L".");
+                mark = SUCCEEDED(hr) ? L'*' : L'.';
+            }
+        }
+
+        auto& stats = state.stats[format];
+        stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats.files++;
+        if (mark == L'!')
+        {
+            stats.failures++;
+        }
+
+        WIN32_FILE_ATTRIBUTE_DATA fileAttr = {};
+        if (GetFileAttributesExW(szSrc, GetFileExInfoStandard, &fileAttr))
+        {
+            stats.bytes += (uint64_t(fileAttr.nFileSizeHigh) << 32) | fileAttr.nFileSizeLow;
+        }
+
+        return mark;
+    }
+
+    //----------------------------------------------------------------------------------
+    // Progress file of "<mark> <path>" lines, one per finished file, so a run that was
+    // stopped can pick up where it left off.
+    class Checkpoint
+    {
+    public:
+        Checkpoint() noexcept : m_file(nullptr), m_pending(0) {}
+
+        Checkpoint(Checkpoint&&) = delete;
+        Checkpoint& operator= (Checkpoint&&) = delete;
+
+        Checkpoint(Checkpoint const&) = delete;
+        Checkpoint& operator= (Checkpoint const&) = delete;
+
+        ~Checkpoint()
+        {
+            if (m_file)
+            {
+                fclose(m_file);
+            }
+        }
+
+        // Reads the files already finished, then opens the checkpoint for appending
+        bool Open(const wchar_t* fileName, std::set<std::wstring>& finished)
+        {
+            FILE* file = nullptr;
+            if (!_wfopen_s(&file, fileName, L"rt, ccs=UTF-8") && file)
+            {
+                wchar_t line[MAX_PATH + 4] = {};
+                while (fgetws(line, static_cast<int>(std::size(line)), file))
+                {
+                    size_t len = wcslen(line);
+                    while (len > 0 && (line[len - 1] == L'\n' || line[len - 1] == L'\r'))
+                    {
+                        line[--len] = 0;
+                    }
+
+                    if (len > 2 && line[1] == L' ')
+                    {
+                        finished.insert(line + 2);
+                    }
+                }
+
+                fclose(file);
+            }
+
+            return !_wfopen_s(&m_file, fileName, L"at, ccs=UTF-8") && m_file;
+        }
+
+        void Record(wchar_t mark, const wchar_t* path)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (!m_file)
+                return;
+
+            fwprintf(m_file, L"%lc %ls\n", mark, path);
+
+            if (++m_pending >= c_ShardSize)
+            {
+                fflush(m_file);
+                m_pending = 0;
+            }
+        }
+
+    private:
+        std::mutex  m_mutex;
+        FILE*       m_file;
+        size_t      m_pending;
+    };
+
+    void PrintSummary(const std::vector<LoaderState>& states, double wallTime)
+    {
+        FormatStats totals[FORMAT_MAX] = {};
+        for (const auto& state : states)
+        {
+            for (size_t j = 0; j < FORMAT_MAX; ++j)
+            {
+                totals[j].files += state.stats[j].files;
+                totals[j].failures += state.stats[j].failures;
+                totals[j].bytes += state.stats[j].bytes;
+                totals[j].seconds += state.stats[j].seconds;
+            }
+        }
+
+        // Per-format rates are over the time spent in that loader, summed across threads
+        wprintf(L"\nFormat      Files   Failures        MB      Files/s       MB/s\n");
+
+        FormatStats all = {};
+        for (size_t j = 0; j < FORMAT_MAX; ++j)
+        {
+            const auto& it = totals[j];
+            if (!it.files)
+                continue;
+
+            const double mb = double(it.bytes) / (1024.0 * 1024.0);
+            const double perThread = it.seconds / double(states.size());
+            wprintf(L"%-6ls %10zu %10zu %9.1f %12.1f %10.1f\n",
+                g_FormatNames[j], it.files, it.failures, mb,
+                (perThread > 0) ? double(it.files) / perThread : 0.0,
+                (perThread > 0) ? mb / perThread : 0.0);
+
+            all.files += it.files;
+            all.failures += it.failures;
+            all.bytes += it.bytes;
+        }
+
+        const double mb = double(all.bytes) / (1024.0 * 1024.0);
+        wprintf(L"%-6ls %10zu %10zu %9.1f %12.1f %10.1f   (%.3f s wall, %zu thread(s))\n",
+            L"Total", all.files, all.failures, mb,
+            (wallTime > 0) ? double(all.files) / wallTime : 0.0,
+            (wallTime > 0) ? mb / wallTime : 0.0,
+            wallTime, states.size());
+    }
+}
+
+#endif // !FUZZING_BUILD_MODE
+
+
+//--------------------------------------------------------------------------------------
+// Entry-point
+//--------------------------------------------------------------------------------------
+#ifndef FUZZING_BUILD_MODE
+
+#ifdef _PREFAST_
+#pragma prefast(disable : 28198, "Command-line tool, frees all memory on exit")
+#endif
+
+int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
+{
+    // Initialize COM (needed for WIC)
+    HRESULT hr = hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    if (FAILED(hr))
+    {
+        wprintf(L"Failed to initialize COM (%08X)\n", static_cast<unsigned int>(hr));
+        return 1;
+    }
+
+    // Process command line
+    DWORD dwOptions = 0;
+    size_t threadCount = 1;
+    const wchar_t* checkpointFile = nullptr;
+    std::list<SConversion> conversion;
+
+    for (int iArg = 1; iArg < argc; iArg++)
+    {
+        PWSTR pArg = argv[iArg];
+
+        if (('-' == pArg[0]) || ('/' == pArg[0]))
+        {
+            pArg++;
+            PWSTR pValue;
+
+            for (pValue = pArg; *pValue && (':' != *pValue); pValue++);
+
+            if (*pValue)
+                *pValue++ = 0;
+
+            DWORD dwOption = LookupByName(pArg, g_pOptions);
+
+            if (!dwOption || (dwOptions & (1 << dwOption)))
+            {
+                PrintUsage();
+                return 1;
             }
+
+            dwOptions |= 1 << dwOption;
+
+            // Handle options with additional value parameter
+            switch (dwOption)
+            {
+            case OPT_THREADS:
+            case OPT_CHECKPOINT:
+                if (!*pValue)
+                {
+                    if ((iArg + 1 >= argc))
+                    {
+                        PrintUsage();
+                        return 1;
+                    }
+
+                    iArg++;
+                    pValue = argv[iArg];
+                }
+                break;
+
+            default:
+                break;
+            }
+
+            switch (dwOption)
+            {
+            case OPT_DDS:
+            case OPT_WAV:
+            case OPT_WIC:
+            case OPT_XWB:
+                if ((dwOptions & ((1 << OPT_DDS) | (1 << OPT_WAV) | (1 << OPT_WIC) | (1 << OPT_XWB))) & ~(1 << dwOption))
+                {
+                    wprintf(L"-dds, -wav, -wic, and -xwb are mutually exclusive options\n");
+                    return 1;
+                }
+                break;
+
+            case OPT_THREADS:
+                if (swscanf_s(pValue, L"%zu", &threadCount) != 1)
+                {
+                    wprintf(L"Invalid value specified with -j (%ls)\n", pValue);
+                    return 1;
+                }
+                if (!threadCount)
+                {
+                    threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+                }
+                break;
+
+            case OPT_CHECKPOINT:
+                checkpointFile = pValue;
+                break;
+
+            default:
+                break;
+            }
+        }
+        else if (wcspbrk(pArg, L"?*") != nullptr)
+        {
+            size_t count = conversion.size();
+            SearchForFiles(pArg, conversion, (dwOptions & (1 << OPT_RECURSIVE)) != 0);
+            if (conversion.size() <= count)
+            {
+                wprintf(L"No matching files found for %ls\n", pArg);
+                return 1;
+            }
+        }
+        else
+        {
+            SConversion conv;
+            wcscpy_s(conv.szSrc, MAX_PATH, pArg);
+
+            conversion.push_back(conv);
+        }
+    }
+
+    if (conversion.empty())
+    {
+        wprintf(L"ERROR: Need at least 1 image file to fuzz\n\n");
+        PrintUsage();
+        return 0;
+    }
+
+    // Skip whatever a previous run already finished
+    Checkpoint checkpoint;
+    std::vector<const wchar_t*> files;
+    {
+        std::set<std::wstring> finished;
+        if (checkpointFile && !checkpoint.Open(checkpointFile, finished))
+        {
+            wprintf(L"ERROR: Failed to open checkpoint file:\n%ls\n", checkpointFile);
+            return 1;
+        }
+
+        files.reserve(conversion.size());
+        for (const auto& pConv : conversion)
+        {
+            if (finished.find(pConv.szSrc) == finished.end())
+            {
+                files.push_back(pConv.szSrc);
+            }
+        }
+
+        if (files.size() < conversion.size())
+        {
+            wprintf(L"Skipping %zu file(s) already in checkpoint\n", conversion.size() - files.size());
         }
-        fflush(stdout);
     }
 
+    threadCount = std::min(threadCount, std::max<size_t>(1, (files.size() + c_ShardSize - 1) / c_ShardSize));
+
+    std::vector<LoaderState> states(threadCount);
+    std::atomic<size_t> nextFile(0);
+    std::atomic<bool> stop(false);
+    std::mutex outputLock;
+
+    auto worker = [&](LoaderState& state, bool progress)
+    {
+        const HRESULT hrCOM = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+        while (!stop)
+        {
+            const size_t first = nextFile.fetch_add(c_ShardSize);
+            if (first >= files.size())
+                break;
+
+            const size_t last = std::min(first + c_ShardSize, files.size());
+            for (size_t j = first; j < last && !stop; ++j)
+            {
+                const wchar_t mark = ValidateFile(files[j], dwOptions, state, progress);
+                if (!mark)
+                {
+                    stop = true;
+                    break;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(outputLock);
+                    wprintf(L"%lc", mark);
+                    fflush(stdout);
+                }
+
+                checkpoint.Record(mark, files[j]);
+            }
+        }
+
+        if (SUCCEEDED(hrCOM))
+        {
+            CoUninitialize();
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (threadCount > 1)
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        try
+        {
+            for (auto& state : states)
+            {
+                threads.emplace_back(worker, std::ref(state), false);
+            }
+        }
+        catch (const std::system_error& e)
+        {
+            // Carry on with the threads that did start, and this one takes the next unused state
+            wprintf(L"WARNING: Started %zu of %zu threads (%hs)\n", threads.size(), threadCount, e.what());
+            worker(states[threads.size()], false);
+        }
+
+        for (auto& it : threads)
+        {
+            it.join();
+        }
+    }
+    else
+    {
+        worker(states[0], true);
+    }
+
+    if (stop)
+        return 1;
+
+    const double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
     wprintf(L"\n*** FUZZING COMPLETE ***\n");
 
+    PrintSummary(states, wallTime);
+
     return 0;
 }
 
@@ -532,6 +890,11 @@ extern "C" __declspec(dllexport) int LLVMFuzzerTestOneInput(const uint8_t *data,
                 DirectX::DDS_LOADER_DEFAULT, tex.GetAddressOf(), nullptr, nullptr);
     }
 
+    {
+        DirectX::WAVData result = {};
+        std::ignore = DirectX::LoadWAVAudioInMemoryEx(data, size, result);
+    }
+
     // Disk version
     wchar_t tempFileName[MAX_PATH] = {};
     wchar_t tempPath[MAX_PATH] = {};